@@ -0,0 +1,178 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageBufferAllocator_h
+#define itkImageBufferAllocator_h
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace itk
+{
+/** \class ImageBufferAllocator
+ * \brief Allocates aligned, recyclable memory for pixel buffers.
+ *
+ * ImageBufferAllocator provides the memory of an ImportImageContainer
+ * when one is assigned to it with ImportImageContainer::SetBufferAllocator,
+ * or globally with SetGlobalDefaultAllocator. Subclasses can override
+ * Allocate and Deallocate to plug in another memory source.
+ *
+ * Buffers are aligned to Alignment (64) bytes, so vectorized loops over
+ * pixels may use aligned loads. When Pooling is on, released buffers are
+ * kept in size-bucketed free lists instead of being returned to the
+ * operating system, and are handed out again for requests of the same
+ * bucket. Buckets are a quarter octave wide, so a buffer is at most 25%
+ * larger than requested. A pipeline that runs repeatedly on images of the
+ * same size therefore only pays for page faults on its first run. The
+ * buffers of an image are released, and so recycled, when its pipeline
+ * calls DataObject::ReleaseData, or when the image is destroyed.
+ * MaximumPoolSize limits the number of bytes kept in the free lists.
+ *
+ * When UseHugePages is on, buffers of at least 2 MiB are mapped with
+ * transparent huge page backing (Linux only), which reduces TLB misses on
+ * large volumes.
+ *
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+class ITKCommon_EXPORT ImageBufferAllocator : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ImageBufferAllocator);
+
+  /** Standard class type aliases. */
+  using Self = ImageBufferAllocator;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageBufferAllocator, Object);
+
+  /** Alignment of the returned buffers, in bytes. */
+  static constexpr SizeValueType Alignment = 64;
+
+  /** Counters describing the use of an allocator. */
+  struct Statistics
+  {
+    /** Number of Allocate calls. */
+    SizeValueType NumberOfAllocations{ 0 };
+    /** Number of Allocate calls served from the pool. */
+    SizeValueType NumberOfPoolHits{ 0 };
+    /** Number of Deallocate calls. */
+    SizeValueType NumberOfDeallocations{ 0 };
+    /** Bytes currently handed out, and the maximum thereof. */
+    SizeValueType BytesInUse{ 0 };
+    SizeValueType PeakBytesInUse{ 0 };
+    /** Bytes currently kept in the free lists. */
+    SizeValueType BytesPooled{ 0 };
+  };
+
+  /** Allocate a buffer of at least numberOfBytes bytes, aligned to
+   * Alignment. Throws MemoryAllocationError on failure. */
+  virtual void *
+  Allocate(SizeValueType numberOfBytes);
+
+  /** Release a buffer returned by Allocate. numberOfBytes must be the
+   * size that was passed to Allocate. Any other buffer is left untouched
+   * and reported with a warning, since this is called from destructors. */
+  virtual void
+  Deallocate(void * buffer, SizeValueType numberOfBytes);
+
+  /** Return all buffers in the free lists to the operating system. */
+  void
+  ReleasePool();
+
+  /** Get a snapshot of the statistics. */
+  Statistics
+  GetStatistics() const;
+
+  /** Set/Get whether released buffers are kept for reuse. Default is on.
+   * Turning pooling off releases the pool. */
+  virtual void
+  SetPooling(bool pooling);
+  itkGetConstMacro(Pooling, bool);
+  itkBooleanMacro(Pooling);
+
+  /** Set/Get the maximum number of bytes kept in the free lists.
+   * Default is 4 GiB on 64 bit platforms and 512 MiB otherwise. */
+  itkSetMacro(MaximumPoolSize, SizeValueType);
+  itkGetConstMacro(MaximumPoolSize, SizeValueType);
+
+  /** Set/Get whether large buffers are backed by huge pages. Default is off.
+   * Only has an effect on Linux. */
+  itkSetMacro(UseHugePages, bool);
+  itkGetConstMacro(UseHugePages, bool);
+  itkBooleanMacro(UseHugePages);
+
+  /** Set/Get the allocator which newly created ImportImageContainers use.
+   * The default is nullptr, in which case containers allocate with new[].
+   * Setting the environment variable ITK_USE_IMAGE_BUFFER_ALLOCATOR to ON
+   * installs a default constructed ImageBufferAllocator. */
+  static void
+  SetGlobalDefaultAllocator(ImageBufferAllocator * allocator);
+  static ImageBufferAllocator *
+  GetGlobalDefaultAllocator();
+
+protected:
+  ImageBufferAllocator();
+  ~ImageBufferAllocator() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The size of the bucket a request of numberOfBytes bytes falls into. */
+  static SizeValueType
+  ComputeBucketSize(SizeValueType numberOfBytes);
+
+private:
+  void *
+  AllocateFromSystem(SizeValueType numberOfBytes, bool & isHugePage);
+  static void
+  DeallocateToSystem(void * buffer, SizeValueType numberOfBytes, bool isHugePage);
+
+  struct BufferInformation
+  {
+    SizeValueType BucketSize;
+    bool          IsHugePage;
+  };
+
+  mutable std::mutex m_Mutex;
+
+  /** Free buffers, by bucket size. */
+  std::map<SizeValueType, std::vector<void *>> m_FreeLists;
+
+  /** All buffers handed out or pooled, to release them correctly. */
+  std::unordered_map<void *, BufferInformation> m_Buffers;
+
+  Statistics m_Statistics;
+
+  bool          m_Pooling{ true };
+  bool          m_UseHugePages{ false };
+  SizeValueType m_MaximumPoolSize;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageRegionSplitterTiled_h
+#define itkImageRegionSplitterTiled_h
+
+#include "itkImageRegionSplitterBase.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+
+/** \class ImageRegionSplitterTiled
+ * \brief Divide an image region into small, cache sized tiles.
+ *
+ * ImageRegionSplitterTiled divides an ImageRegion into tiles of
+ * about PixelsPerTile pixels each. Tiles are grown along the fastest
+ * dimension first, so a tile consists of whole scanlines whenever a
+ * scanline fits into a tile. For a 512x512x512 volume and the default of
+ * 16384 pixels per tile, a tile is 512x32x1 pixels.
+ *
+ * Unlike the other splitters, the number of pieces is a property of the
+ * region rather than of the requested number of pieces: a region is
+ * typically divided into many more tiles than there are threads, and the
+ * tiles are meant to be handed out to the threads dynamically (see
+ * MultiThreaderBase::SetUseTiledSplitting). If fewer pieces are requested
+ * than there are tiles, tiles are merged along the slowest dimension first.
+ *
+ * \sa ImageRegionSplitterMultidimensional
+ * \sa ImageRegionSplitterSlowDimension
+ *
+ * \ingroup ITKSystemObjects
+ * \ingroup DataProcessing
+ * \ingroup ITKCommon
+ */
+
+class ITKCommon_EXPORT ImageRegionSplitterTiled : public ImageRegionSplitterBase
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ImageRegionSplitterTiled);
+
+  /** Standard class type aliases. */
+  using Self = ImageRegionSplitterTiled;
+  using Superclass = ImageRegionSplitterBase;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageRegionSplitterTiled, ImageRegionSplitterBase);
+
+  /** Set/Get the target number of pixels of a tile. The default of 16384
+   * pixels keeps the input and output of a tile of float pixels, plus
+   * the neighboring rows, within a typical 256 KiB L2 cache. */
+  itkSetClampMacro(PixelsPerTile, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(PixelsPerTile, SizeValueType);
+
+protected:
+  ImageRegionSplitterTiled();
+
+  unsigned int
+  GetNumberOfSplitsInternal(unsigned int         dim,
+                            const IndexValueType regionIndex[],
+                            const SizeValueType  regionSize[],
+                            unsigned int         requestedNumber) const override;
+
+  unsigned int
+  GetSplitInternal(unsigned int   dim,
+                   unsigned int   i,
+                   unsigned int   numberOfPieces,
+                   IndexValueType regionIndex[],
+                   SizeValueType  regionSize[]) const override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** Computes the number of tiles along each dimension,
+   * and returns the total number of tiles. */
+  unsigned int
+  ComputeSplits(unsigned int dim, unsigned int requestedNumber, const SizeValueType regionSize[], unsigned int splits[])
+    const;
+
+  SizeValueType m_PixelsPerTile{ 16384 };
+};
+} // end namespace itk
+
+#endif
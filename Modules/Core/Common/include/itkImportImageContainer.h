@@ -20,6 +20,7 @@
 
 #include "itkObject.h"
 #include "itkObjectFactory.h"
+#include "itkImageBufferAllocator.h"
 #include <utility>
 
 namespace itk
@@ -151,6 +152,14 @@ public:
   itkGetConstMacro(ContainerManageMemory, bool);
   itkBooleanMacro(ContainerManageMemory);
 
+  /** Set/Get the allocator used for buffers allocated by this container
+   * from now on. If it is nullptr, buffers are allocated with new[]. The
+   * default is ImageBufferAllocator::GetGlobalDefaultAllocator(). A buffer
+   * is always released through the allocator it was allocated with.
+   * \sa ImageBufferAllocator */
+  itkSetObjectMacro(BufferAllocator, ImageBufferAllocator);
+  itkGetModifiableObjectMacro(BufferAllocator, ImageBufferAllocator);
+
 protected:
   ImportImageContainer();
   ~ImportImageContainer() override;
@@ -203,6 +212,10 @@ private:
   TElementIdentifier m_Size;
   TElementIdentifier m_Capacity;
   bool               m_ContainerManageMemory;
+
+  /** The allocator for new buffers, and the one m_ImportPointer came from. */
+  ImageBufferAllocator::Pointer m_BufferAllocator;
+  ImageBufferAllocator::Pointer m_ImportPointerAllocator;
 };
 } // end namespace itk
 
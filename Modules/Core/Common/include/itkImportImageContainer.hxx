@@ -30,6 +30,8 @@
 
 #include "itkImportImageContainer.h"
 #include <algorithm> // For copy_n.
+#include <new>
+#include <type_traits>
 
 namespace itk
 {
@@ -40,6 +42,7 @@ ImportImageContainer<TElementIdentifier, TElement>::ImportImageContainer()
   m_ContainerManageMemory = true;
   m_Capacity = 0;
   m_Size = 0;
+  m_BufferAllocator = ImageBufferAllocator::GetGlobalDefaultAllocator();
 }
 
 template <typename TElementIdentifier, typename TElement>
@@ -70,6 +73,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerAllocator = m_BufferAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -84,6 +88,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Reserve(ElementIdentifier si
   else
   {
     m_ImportPointer = this->AllocateElements(size, UseDefaultConstructor);
+    m_ImportPointerAllocator = m_BufferAllocator;
     m_Capacity = size;
     m_Size = size;
     m_ContainerManageMemory = true;
@@ -110,6 +115,7 @@ ImportImageContainer<TElementIdentifier, TElement>::Squeeze()
       DeallocateManagedMemory();
 
       m_ImportPointer = temp;
+      m_ImportPointerAllocator = m_BufferAllocator;
       m_ContainerManageMemory = true;
       m_Capacity = size;
       m_Size = size;
@@ -153,6 +159,7 @@ ImportImageContainer<TElementIdentifier, TElement>::SetImportPointer(TElement *
 {
   DeallocateManagedMemory();
   m_ImportPointer = ptr;
+  m_ImportPointerAllocator = nullptr; // externally allocated, release with delete[]
   m_ContainerManageMemory = LetContainerManageMemory;
   m_Capacity = num;
   m_Size = num;
@@ -170,6 +177,38 @@ ImportImageContainer<TElementIdentifier, TElement>::AllocateElements(ElementIden
   // does not do this by default.
   TElement * data;
 
+  if (m_BufferAllocator)
+  {
+    // throws MemoryAllocationError on failure
+    data = static_cast<TElement *>(m_BufferAllocator->Allocate(size * sizeof(TElement)));
+    ElementIdentifier i = 0;
+    try
+    {
+      for (; i < size; ++i)
+      {
+        if (UseDefaultConstructor)
+        {
+          new (data + i) TElement(); // POD types initialized to 0, others use default constructor.
+        }
+        else
+        {
+          new (data + i) TElement; // No-op for POD types
+        }
+      }
+    }
+    catch (...)
+    {
+      // Like new[], destroy the elements constructed so far and release the buffer
+      while (i > 0)
+      {
+        data[--i].~TElement();
+      }
+      m_BufferAllocator->Deallocate(data, size * sizeof(TElement));
+      throw;
+    }
+    return data;
+  }
+
   try
   {
     if (UseDefaultConstructor)
@@ -201,9 +240,24 @@ ImportImageContainer<TElementIdentifier, TElement>::DeallocateManagedMemory()
   // Encapsulate all image memory deallocation here
   if (m_ContainerManageMemory)
   {
-    delete[] m_ImportPointer;
+    if (m_ImportPointerAllocator)
+    {
+      if (!std::is_trivially_destructible<TElement>::value)
+      {
+        for (ElementIdentifier i = 0; i < m_Capacity; ++i)
+        {
+          m_ImportPointer[i].~TElement();
+        }
+      }
+      m_ImportPointerAllocator->Deallocate(m_ImportPointer, m_Capacity * sizeof(TElement));
+    }
+    else
+    {
+      delete[] m_ImportPointer;
+    }
   }
   m_ImportPointer = nullptr;
+  m_ImportPointerAllocator = nullptr;
   m_Capacity = 0;
   m_Size = 0;
 }
@@ -218,6 +272,7 @@ ImportImageContainer<TElementIdentifier, TElement>::PrintSelf(std::ostream & os,
   os << indent << "Container manages memory: " << (m_ContainerManageMemory ? "true" : "false") << std::endl;
   os << indent << "Size: " << m_Size << std::endl;
   os << indent << "Capacity: " << m_Capacity << std::endl;
+  itkPrintSelfObjectMacro(BufferAllocator);
 }
 } // end namespace itk
 
@@ -34,6 +34,7 @@
 #include "itkIntTypes.h"
 #include "itkImageRegion.h"
 #include "itkImageIORegion.h"
+#include "itkImageRegionSplitterTiled.h"
 #include "itkSingletonMacro.h"
 #include <functional>
 #include <thread>
@@ -116,7 +117,8 @@ public:
     First = Platform,
     Pool,
     TBB,
-    Last = TBB,
+    WorkStealing,
+    Last = WorkStealing,
     Unknown = -1
   };
 #if !defined(ITK_LEGACY_REMOVE)
@@ -142,6 +144,9 @@ public:
       case ThreaderEnum::TBB:
         return "TBB";
         break;
+      case ThreaderEnum::WorkStealing:
+        return "WorkStealing";
+        break;
       case ThreaderEnum::Unknown:
       default:
         return "Unknown";
@@ -165,6 +170,33 @@ public:
   static ThreaderEnum
   GetGlobalDefaultThreader();
 
+  /** Set/Get whether ParallelizeImageRegion divides the region into many
+   * small, cache sized tiles (see ImageRegionSplitterTiled), which the work
+   * units then take from a shared queue one at a time, instead of into one
+   * piece per work unit. This improves the load balance and cache locality
+   * of DynamicThreadedGenerateData filters with expensive per-pixel work,
+   * such as neighborhood filters. Initialized from
+   * GlobalDefaultUseTiledSplitting. */
+  itkSetMacro(UseTiledSplitting, bool);
+  itkGetConstMacro(UseTiledSplitting, bool);
+  itkBooleanMacro(UseTiledSplitting);
+
+  /** The splitter used when UseTiledSplitting is on.
+   * Its PixelsPerTile can be adjusted to the cache size. */
+  ImageRegionSplitterTiled *
+  GetTiledSplitter()
+  {
+    return m_TiledSplitter;
+  }
+
+  /** Set/Get the value which is used to initialize UseTiledSplitting in the
+   * constructor. The default is picked up from the environment variable
+   * ITK_GLOBAL_DEFAULT_TILED_SPLITTING, and is off if that is not set. */
+  static void
+  SetGlobalDefaultUseTiledSplitting(bool useTiledSplitting);
+  static bool
+  GetGlobalDefaultUseTiledSplitting();
+
   /** Set/Get the value which is used to initialize the NumberOfThreads in the
    * constructor.  It will be clamped to the range [1, m_GlobalMaximumNumberOfThreads ].
    * Therefore the caller of this method should check that the requested number
@@ -418,6 +450,18 @@ protected:
   static ITK_THREAD_RETURN_FUNCTION_CALL_CONVENTION
   ParallelizeImageRegionHelper(void * arg);
 
+  /** Implements ParallelizeImageRegion for UseTiledSplitting on. The tiles
+   * are processed through ParallelizeArray, with one array element per work
+   * unit, each of which takes tiles from the queue until it is empty.
+   * Implementations of ParallelizeImageRegion should delegate to this
+   * method when m_UseTiledSplitting is set. */
+  void
+  ParallelizeImageRegionTiled(unsigned int         dimension,
+                              const IndexValueType index[],
+                              const SizeValueType  size[],
+                              ThreadingFunctorType funcP,
+                              ProcessObject *      filter);
+
   /** The number of work units to create. */
   ThreadIdType m_NumberOfWorkUnits;
 
@@ -446,6 +490,10 @@ protected:
   /** The data to be passed as argument. */
   void * m_SingleData;
 
+  /** Whether to split regions into tiles, and the splitter doing it. */
+  bool                              m_UseTiledSplitting;
+  ImageRegionSplitterTiled::Pointer m_TiledSplitter;
+
 private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(MultiThreaderBaseGlobals, PimplGlobals);
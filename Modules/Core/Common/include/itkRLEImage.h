@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRLEImage_h
+#define itkRLEImage_h
+
+#include "itkImageBase.h"
+#include "itkWeakPointer.h"
+
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace itk
+{
+/** \class RLEImage
+ *  \brief Templated n-dimensional image storing its lines as runs of pixels.
+ *
+ * RLEImage stores each line of pixels along the first axis as a list of
+ * runs: a length and a value. Label images, where long runs of the same
+ * label are the rule, are stored in a small fraction of the memory of an
+ * itk::Image.
+ *
+ * RLEImage shares the methods of itk::Image needed to use it as the input
+ * or the output of an itk::ImageToImageFilter, but it has no pixel buffer:
+ * GetPixel() and SetPixel() run in O(R), where R is the number of runs in
+ * the line of the pixel. ImageRegionConstIterator and ImageRegionIterator
+ * are specialized for RLEImage and walk the runs, so that filters written
+ * with these iterators accept an RLEImage. LabelImageToLabelMapFilter and
+ * LabelMapToLabelImageFilter read and write the runs directly.
+ *
+ * The length of the runs is stored in TRunLength, so the buffered region may
+ * not be larger than the maximum of TRunLength along the first axis.
+ *
+ * \sa Image, LabelMap
+ * \ingroup ImageObjects
+ * \ingroup ITKCommon
+ */
+template <typename TPixel, unsigned int VImageDimension = 3, typename TRunLength = unsigned short>
+class ITK_TEMPLATE_EXPORT RLEImage : public ImageBase<VImageDimension>
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(RLEImage);
+
+  /** Standard class type aliases */
+  using Self = RLEImage;
+  using Superclass = ImageBase<VImageDimension>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+  using ConstWeakPointer = WeakPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(RLEImage, ImageBase);
+
+  /** Pixel type alias support. */
+  using PixelType = TPixel;
+  using ValueType = TPixel;
+  using InternalPixelType = TPixel;
+
+  /** A run of RunType::first pixels of value RunType::second. */
+  using RunLengthType = TRunLength;
+  using RunType = std::pair<RunLengthType, PixelType>;
+
+  /** The runs of a line, along the first axis, and the lines of the
+   * buffered region, in the order of the pixels of an itk::Image. */
+  using LineType = std::vector<RunType>;
+  using LineContainerType = std::vector<LineType>;
+
+  /** Dimension of the image. */
+  static constexpr unsigned int ImageDimension = VImageDimension;
+
+  using IndexType = typename Superclass::IndexType;
+  using IndexValueType = typename Superclass::IndexValueType;
+  using OffsetType = typename Superclass::OffsetType;
+  using OffsetValueType = typename Superclass::OffsetValueType;
+  using SizeType = typename Superclass::SizeType;
+  using SizeValueType = typename Superclass::SizeValueType;
+  using DirectionType = typename Superclass::DirectionType;
+  using RegionType = typename Superclass::RegionType;
+  using SpacingType = typename Superclass::SpacingType;
+  using PointType = typename Superclass::PointType;
+
+  static_assert(std::is_integral<RunLengthType>::value && std::is_unsigned<RunLengthType>::value,
+                "The run length type must be an unsigned integer type");
+
+  /** Restore the data object to its initial state. This means releasing
+   * memory. */
+  void
+  Initialize() override;
+
+  /** Allocate the lines of the buffered region. Each line is a single run
+   * of zero, whatever the value of initialize, since a run always holds a
+   * value. */
+  void
+  Allocate(bool initialize = false) override;
+
+  /** Set all the pixels of the buffered region to value. */
+  void
+  FillBuffer(const PixelType & value);
+
+  virtual void
+  Graft(const Self * image);
+
+  /** \return the value of the pixel at index, which must be in the
+   * buffered region. */
+  const PixelType &
+  GetPixel(const IndexType & index) const;
+
+  /** Set the value of the pixel at index, which must be in the buffered
+   * region. The runs of its line are split or merged as needed. */
+  void
+  SetPixel(const IndexType & index, const PixelType & value);
+
+  /** \return the number of the line of index in the buffered region. */
+  SizeValueType
+  ComputeLineNumber(const IndexType & index) const
+  {
+    const RegionType & bufferedRegion = this->GetBufferedRegion();
+    SizeValueType      lineNumber = 0;
+    SizeValueType      stride = 1;
+    for (unsigned int j = 1; j < ImageDimension; ++j)
+    {
+      lineNumber += static_cast<SizeValueType>(index[j] - bufferedRegion.GetIndex(j)) * stride;
+      stride *= bufferedRegion.GetSize(j);
+    }
+    return lineNumber;
+  }
+
+  /** Access to the runs of a line of the buffered region. A line modified
+   * through the non const version must keep covering the whole line, and
+   * should not hold adjacent runs of the same value (see CleanUpLine()). */
+  LineType &
+  GetLine(SizeValueType lineNumber)
+  {
+    return m_Lines[lineNumber];
+  }
+  const LineType &
+  GetLine(SizeValueType lineNumber) const
+  {
+    return m_Lines[lineNumber];
+  }
+
+  /** \return the number of lines of the buffered region. */
+  SizeValueType
+  GetNumberOfLines() const
+  {
+    return static_cast<SizeValueType>(m_Lines.size());
+  }
+
+  /** \return the number of runs in the image. The memory used by the pixels
+   * is about GetNumberOfRuns() * sizeof(RunType). */
+  SizeValueType
+  GetNumberOfRuns() const;
+
+  /** Merge the adjacent runs of the same value, and remove the empty runs. */
+  static void
+  CleanUpLine(LineType & line);
+
+  /** Set the value of the pixel at position positionInRun of the run
+   * runIndex of line. \return the index of the run which holds the pixel
+   * afterwards, and update positionInRun to its position in that run. */
+  static SizeValueType
+  SetPixelInLine(LineType & line, SizeValueType runIndex, RunLengthType & positionInRun, const PixelType & value);
+
+protected:
+  RLEImage() = default;
+  ~RLEImage() override = default;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+  void
+  Graft(const DataObject * data) override;
+  using Superclass::Graft;
+
+private:
+  LineContainerType m_Lines;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkRLEImage.hxx"
+#endif
+
+// The iterators must be specialized wherever RLEImage is used
+#include "itkRLEImageRegionIterator.h"
+
+#endif
@@ -0,0 +1,268 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRLEImage_hxx
+#define itkRLEImage_hxx
+
+#include "itkRLEImage.h"
+#include "itkNumericTraits.h"
+
+namespace itk
+{
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::Initialize()
+{
+  // Call the superclass which should initialize the BufferedRegion ivar.
+  Superclass::Initialize();
+
+  LineContainerType().swap(m_Lines);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::Allocate(bool)
+{
+  const RegionType & bufferedRegion = this->GetBufferedRegion();
+  if (bufferedRegion.GetSize(0) > static_cast<SizeValueType>(NumericTraits<RunLengthType>::max()))
+  {
+    itkExceptionMacro(<< "The buffered region is " << bufferedRegion.GetSize(0)
+                      << " pixels long along the first axis, which is more than the maximum run length "
+                      << static_cast<SizeValueType>(NumericTraits<RunLengthType>::max()));
+  }
+
+  this->ComputeOffsetTable();
+  this->FillBuffer(NumericTraits<PixelType>::ZeroValue());
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::FillBuffer(const PixelType & value)
+{
+  const RegionType &  bufferedRegion = this->GetBufferedRegion();
+  const SizeValueType lineLength = bufferedRegion.GetSize(0);
+  const SizeValueType numberOfLines = (lineLength == 0) ? 0 : bufferedRegion.GetNumberOfPixels() / lineLength;
+
+  LineContainerType lines(numberOfLines, LineType(1, RunType(static_cast<RunLengthType>(lineLength), value)));
+  m_Lines.swap(lines);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::Graft(const Self * image)
+{
+  if (image == nullptr)
+  {
+    return; // nothing to do
+  }
+  // call the superclass' implementation
+  Superclass::Graft(image);
+
+  // Now copy anything remaining that is needed
+  if (&m_Lines != &(image->m_Lines))
+  {
+    m_Lines = image->m_Lines;
+  }
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::Graft(const DataObject * data)
+{
+  if (data == nullptr)
+  {
+    return; // nothing to do
+  }
+
+  // Attempt to cast data to an RLEImage
+  const auto * image = dynamic_cast<const Self *>(data);
+
+  if (image == nullptr)
+  {
+    // pointer could not be cast back down
+    itkExceptionMacro(<< "itk::RLEImage::Graft() cannot cast " << typeid(data).name() << " to "
+                      << typeid(const Self *).name());
+  }
+  this->Graft(image);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+auto
+RLEImage<TPixel, VImageDimension, TRunLength>::GetPixel(const IndexType & index) const -> const PixelType &
+{
+  const LineType & line = m_Lines[this->ComputeLineNumber(index)];
+  SizeValueType    x = static_cast<SizeValueType>(index[0] - this->GetBufferedRegion().GetIndex(0));
+
+  auto run = line.begin();
+  while (x >= run->first)
+  {
+    x -= run->first;
+    ++run;
+  }
+  return run->second;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::SetPixel(const IndexType & index, const PixelType & value)
+{
+  LineType &    line = m_Lines[this->ComputeLineNumber(index)];
+  SizeValueType x = static_cast<SizeValueType>(index[0] - this->GetBufferedRegion().GetIndex(0));
+
+  SizeValueType runIndex = 0;
+  while (x >= line[runIndex].first)
+  {
+    x -= line[runIndex].first;
+    ++runIndex;
+  }
+  auto positionInRun = static_cast<RunLengthType>(x);
+  SetPixelInLine(line, runIndex, positionInRun, value);
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+auto
+RLEImage<TPixel, VImageDimension, TRunLength>::GetNumberOfRuns() const -> SizeValueType
+{
+  SizeValueType numberOfRuns = 0;
+  for (const LineType & line : m_Lines)
+  {
+    numberOfRuns += static_cast<SizeValueType>(line.size());
+  }
+  return numberOfRuns;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::CleanUpLine(LineType & line)
+{
+  auto last = line.begin();
+  for (auto run = line.begin(); run != line.end(); ++run)
+  {
+    if (run->first == 0)
+    {
+      continue;
+    }
+    if (last != line.begin() && (last - 1)->second == run->second)
+    {
+      (last - 1)->first += run->first;
+    }
+    else
+    {
+      *last++ = *run;
+    }
+  }
+  line.erase(last, line.end());
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+auto
+RLEImage<TPixel, VImageDimension, TRunLength>::SetPixelInLine(LineType &        line,
+                                                             SizeValueType     runIndex,
+                                                             RunLengthType &   positionInRun,
+                                                             const PixelType & value) -> SizeValueType
+{
+  if (line[runIndex].second == value)
+  {
+    return runIndex;
+  }
+
+  const RunLengthType before = positionInRun;
+  const auto          after = static_cast<RunLengthType>(line[runIndex].first - positionInRun - 1);
+  const bool          mergePrevious = before == 0 && runIndex > 0 && line[runIndex - 1].second == value;
+  const bool          mergeNext = after == 0 && runIndex + 1 < line.size() && line[runIndex + 1].second == value;
+
+  if (mergePrevious && mergeNext)
+  {
+    // The pixel was alone in its run, between two runs of value
+    positionInRun = line[runIndex - 1].first;
+    line[runIndex - 1].first += 1 + line[runIndex + 1].first;
+    line.erase(line.begin() + runIndex, line.begin() + runIndex + 2);
+    return runIndex - 1;
+  }
+  if (mergePrevious)
+  {
+    positionInRun = line[runIndex - 1].first;
+    ++line[runIndex - 1].first;
+    if (--line[runIndex].first == 0)
+    {
+      line.erase(line.begin() + runIndex);
+    }
+    return runIndex - 1;
+  }
+
+  positionInRun = 0;
+  if (mergeNext)
+  {
+    ++line[runIndex + 1].first;
+    if (--line[runIndex].first == 0)
+    {
+      line.erase(line.begin() + runIndex);
+      return runIndex;
+    }
+    return runIndex + 1;
+  }
+
+  // Split the run around the pixel
+  if (before == 0 && after == 0)
+  {
+    line[runIndex].second = value;
+    return runIndex;
+  }
+  if (before == 0)
+  {
+    --line[runIndex].first;
+    line.insert(line.begin() + runIndex, RunType(1, value));
+    return runIndex;
+  }
+  const PixelType runValue = line[runIndex].second;
+  line[runIndex].first = before;
+  if (after == 0)
+  {
+    line.insert(line.begin() + runIndex + 1, RunType(1, value));
+  }
+  else
+  {
+    const RunType runs[] = { RunType(1, value), RunType(after, runValue) };
+    line.insert(line.begin() + runIndex + 1, runs, runs + 2);
+  }
+  return runIndex + 1;
+}
+
+
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+void
+RLEImage<TPixel, VImageDimension, TRunLength>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "NumberOfLines: " << this->GetNumberOfLines() << std::endl;
+  os << indent << "NumberOfRuns: " << this->GetNumberOfRuns() << std::endl;
+}
+
+} // end namespace itk
+
+#endif
@@ -0,0 +1,283 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRLEImageRegionConstIterator_h
+#define itkRLEImageRegionConstIterator_h
+
+#include "itkImageRegionConstIterator.h"
+
+namespace itk
+{
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+class RLEImage;
+
+/** \class ImageRegionConstIterator<RLEImage>
+ * \brief A multi-dimensional iterator walking a region of an RLEImage.
+ *
+ * This specialization of ImageRegionConstIterator offers the same interface
+ * and walks the region in the same order, so that code templated over the
+ * image type accepts an RLEImage. It follows the runs of the lines instead of
+ * a pixel buffer: operator++ is constant time, and the run of the first pixel
+ * of each line of the region is found in O(R), R being the number of runs in
+ * the line.
+ *
+ * \sa RLEImage, ImageRegionConstIterator
+ * \ingroup ImageIterators
+ * \ingroup ITKCommon
+ */
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+class ITK_TEMPLATE_EXPORT ImageRegionConstIterator<RLEImage<TPixel, VImageDimension, TRunLength>>
+{
+public:
+  /** Standard class type alias. */
+  using Self = ImageRegionConstIterator;
+
+  /** Dimension of the image that the iterator walks. */
+  static constexpr unsigned int ImageIteratorDimension = VImageDimension;
+
+  using ImageType = RLEImage<TPixel, VImageDimension, TRunLength>;
+  using IndexType = typename ImageType::IndexType;
+  using IndexValueType = typename ImageType::IndexValueType;
+  using SizeType = typename ImageType::SizeType;
+  using SizeValueType = typename ImageType::SizeValueType;
+  using OffsetType = typename ImageType::OffsetType;
+  using OffsetValueType = typename ImageType::OffsetValueType;
+  using RegionType = typename ImageType::RegionType;
+  using PixelType = typename ImageType::PixelType;
+  using InternalPixelType = typename ImageType::InternalPixelType;
+  using RunLengthType = typename ImageType::RunLengthType;
+  using LineType = typename ImageType::LineType;
+
+  /** Default constructor. Needed since we provide a cast constructor. */
+  ImageRegionConstIterator()
+  {
+    m_PositionIndex.Fill(0);
+    m_EndIndex.Fill(0);
+  }
+
+  /** Constructor establishes an iterator to walk a particular image and a
+   * particular region of that image. */
+  ImageRegionConstIterator(const ImageType * ptr, const RegionType & region)
+    : m_Image(ptr)
+    , m_Region(region)
+  {
+    if (region.GetNumberOfPixels() > 0)
+    {
+      const RegionType & bufferedRegion = ptr->GetBufferedRegion();
+      itkAssertOrThrowMacro((bufferedRegion.IsInside(region)),
+                            "Region " << region << " is outside of buffered region " << bufferedRegion);
+    }
+    for (unsigned int j = 0; j < ImageIteratorDimension; ++j)
+    {
+      m_EndIndex[j] = region.GetIndex(j) + static_cast<IndexValueType>(region.GetSize(j));
+    }
+    this->GoToBegin();
+  }
+
+  /** Get the image that this iterator walks. */
+  const ImageType *
+  GetImage() const
+  {
+    return m_Image.GetPointer();
+  }
+
+  /** Get the region that this iterator walks. */
+  const RegionType &
+  GetRegion() const
+  {
+    return m_Region;
+  }
+
+  /** Get the index of the current pixel. */
+  const IndexType &
+  GetIndex() const
+  {
+    return m_PositionIndex;
+  }
+
+  /** Move the iterator to ind, which must be in the region. */
+  void
+  SetIndex(const IndexType & ind)
+  {
+    m_PositionIndex = ind;
+    this->LocateRun();
+  }
+
+  /** Move the iterator to the first pixel of the region. */
+  void
+  GoToBegin()
+  {
+    m_PositionIndex = m_Region.GetIndex();
+    if (m_Region.GetNumberOfPixels() == 0)
+    {
+      m_PositionIndex[0] = m_EndIndex[0];
+      return;
+    }
+    this->LocateRun();
+  }
+
+  /** Move the iterator one pixel past the last pixel of the region. */
+  void
+  GoToEnd()
+  {
+    for (unsigned int j = 1; j < ImageIteratorDimension; ++j)
+    {
+      m_PositionIndex[j] = m_EndIndex[j] - 1;
+    }
+    m_PositionIndex[0] = m_EndIndex[0];
+  }
+
+  /** Is the iterator at the first pixel of the region? */
+  bool
+  IsAtBegin() const
+  {
+    return m_PositionIndex == m_Region.GetIndex();
+  }
+
+  /** Is the iterator past the last pixel of the region? */
+  bool
+  IsAtEnd() const
+  {
+    return m_PositionIndex[0] >= m_EndIndex[0];
+  }
+
+  /** Get the value of the current pixel. */
+  PixelType
+  Get() const
+  {
+    return (*m_Line)[m_RunIndex].second;
+  }
+
+  /** Get a reference to the value of the current pixel, which is shared by
+   * all the pixels of its run. */
+  const PixelType &
+  Value() const
+  {
+    return (*m_Line)[m_RunIndex].second;
+  }
+
+  /** Move to the next pixel, wrapping to the next line at the end of a line
+   * of the region. */
+  Self &
+  operator++()
+  {
+    if (++m_PositionIndex[0] < m_EndIndex[0])
+    {
+      if (++m_PositionInRun == (*m_Line)[m_RunIndex].first)
+      {
+        ++m_RunIndex;
+        m_PositionInRun = 0;
+      }
+      return *this;
+    }
+
+    // Next line, unless this is the last one
+    for (unsigned int j = 1; j < ImageIteratorDimension; ++j)
+    {
+      if (m_PositionIndex[j] + 1 < m_EndIndex[j])
+      {
+        ++m_PositionIndex[j];
+        m_PositionIndex[0] = m_Region.GetIndex(0);
+        this->LocateRun();
+        return *this;
+      }
+      m_PositionIndex[j] = m_Region.GetIndex(j);
+    }
+
+    this->GoToEnd();
+    return *this;
+  }
+
+  /** Move to the previous pixel, wrapping to the previous line at the
+   * beginning of a line of the region. */
+  Self &
+  operator--()
+  {
+    if (m_PositionIndex[0] > m_Region.GetIndex(0) && m_PositionIndex[0] < m_EndIndex[0])
+    {
+      --m_PositionIndex[0];
+      if (m_PositionInRun == 0)
+      {
+        --m_RunIndex;
+        m_PositionInRun = (*m_Line)[m_RunIndex].first;
+      }
+      --m_PositionInRun;
+      return *this;
+    }
+
+    if (m_PositionIndex[0] == m_Region.GetIndex(0))
+    {
+      // Previous line
+      for (unsigned int j = 1; j < ImageIteratorDimension; ++j)
+      {
+        if (m_PositionIndex[j] > m_Region.GetIndex(j))
+        {
+          --m_PositionIndex[j];
+          break;
+        }
+        m_PositionIndex[j] = m_EndIndex[j] - 1;
+      }
+    }
+    m_PositionIndex[0] = m_EndIndex[0] - 1;
+    this->LocateRun();
+    return *this;
+  }
+
+  bool
+  operator==(const Self & it) const
+  {
+    return m_PositionIndex == it.m_PositionIndex;
+  }
+
+  bool
+  operator!=(const Self & it) const
+  {
+    return !(*this == it);
+  }
+
+protected:
+  /** Find the run of the current pixel. */
+  void
+  LocateRun()
+  {
+    const ImageType * image = m_Image.GetPointer();
+    m_Line = &image->GetLine(image->ComputeLineNumber(m_PositionIndex));
+
+    auto x = static_cast<SizeValueType>(m_PositionIndex[0] - image->GetBufferedRegion().GetIndex(0));
+    m_RunIndex = 0;
+    while (x >= (*m_Line)[m_RunIndex].first)
+    {
+      x -= (*m_Line)[m_RunIndex].first;
+      ++m_RunIndex;
+    }
+    m_PositionInRun = static_cast<RunLengthType>(x);
+  }
+
+  typename ImageType::ConstWeakPointer m_Image;
+
+  RegionType m_Region;
+
+  IndexType m_PositionIndex;
+  IndexType m_EndIndex;
+
+  const LineType * m_Line{ nullptr };
+  SizeValueType    m_RunIndex{ 0 };
+  RunLengthType    m_PositionInRun{ 0 };
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,79 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkRLEImageRegionIterator_h
+#define itkRLEImageRegionIterator_h
+
+#include "itkRLEImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+
+namespace itk
+{
+/** \class ImageRegionIterator<RLEImage>
+ * \brief A multi-dimensional iterator walking a region of an RLEImage, with
+ * write access.
+ *
+ * Set() splits or merges the runs of the current line as needed, in O(R)
+ * where R is the number of runs in the line. There is no non const Value():
+ * the value of a pixel is shared by all the pixels of its run.
+ *
+ * \sa RLEImage, ImageRegionIterator
+ * \ingroup ImageIterators
+ * \ingroup ITKCommon
+ */
+template <typename TPixel, unsigned int VImageDimension, typename TRunLength>
+class ITK_TEMPLATE_EXPORT ImageRegionIterator<RLEImage<TPixel, VImageDimension, TRunLength>>
+  : public ImageRegionConstIterator<RLEImage<TPixel, VImageDimension, TRunLength>>
+{
+public:
+  /** Standard class type alias. */
+  using Self = ImageRegionIterator;
+  using Superclass = ImageRegionConstIterator<RLEImage<TPixel, VImageDimension, TRunLength>>;
+
+  using ImageType = typename Superclass::ImageType;
+  using RegionType = typename Superclass::RegionType;
+  using PixelType = typename Superclass::PixelType;
+  using LineType = typename Superclass::LineType;
+
+  /** Default constructor. Needed since we provide a cast constructor. */
+  ImageRegionIterator() = default;
+
+  /** Constructor establishes an iterator to walk a particular image and a
+   * particular region of that image. */
+  ImageRegionIterator(ImageType * ptr, const RegionType & region)
+    : Superclass(ptr, region)
+  {}
+
+  /** Set the value of the current pixel. */
+  void
+  Set(const PixelType & value)
+  {
+    // The line belongs to the non const image given to the constructor
+    auto * line = const_cast<LineType *>(this->m_Line);
+    this->m_RunIndex = ImageType::SetPixelInLine(*line, this->m_RunIndex, this->m_PositionInRun, value);
+  }
+
+  /** Get the image that this iterator walks. */
+  ImageType *
+  GetImage() const
+  {
+    return const_cast<ImageType *>(this->m_Image.GetPointer());
+  }
+};
+} // end namespace itk
+
+#endif
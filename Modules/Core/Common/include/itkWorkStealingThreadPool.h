@@ -0,0 +1,209 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkWorkStealingThreadPool_h
+#define itkWorkStealingThreadPool_h
+
+#include "itkConfigure.h"
+#include "itkIntTypes.h"
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <condition_variable>
+#include <memory>
+#include <thread>
+
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkSingletonMacro.h"
+
+
+namespace itk
+{
+
+/**
+ * \class WorkStealingThreadPool
+ * \brief Thread pool with one work queue per worker thread.
+ *
+ * Unlike ThreadPool, which serializes all submissions through a single
+ * queue and mutex, every worker owns a double-ended queue. Jobs are submitted
+ * to a specific worker via AddWork. A worker takes jobs from the front of
+ * its own queue, and when that runs dry it steals from the back of the queues
+ * of the other workers, visiting its nearest neighbours first.
+ *
+ * Submitting related jobs to the same worker keeps them on the same core.
+ * When PinThreads is enabled, worker i is bound to logical processor i, so
+ * that with a first-touch memory policy the pages written by a worker stay
+ * on its NUMA node, and neighbouring workers (the first steal victims) share
+ * the same socket.
+ *
+ * Threads waiting for the result of a job should call WaitForFuture instead
+ * of std::future::get, so that they execute pending jobs while waiting. This
+ * makes nested parallelism deadlock free.
+ *
+ * \ingroup OSSystemObjects
+ * \ingroup ITKCommon
+ */
+
+struct WorkStealingThreadPoolGlobals;
+
+class ITKCommon_EXPORT WorkStealingThreadPool : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(WorkStealingThreadPool);
+
+  /** Standard class type aliases. */
+  using Self = WorkStealingThreadPool;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(WorkStealingThreadPool, Object);
+
+  /** Returns the global instance */
+  static Pointer
+  New();
+
+  /** Returns the global singleton instance of the WorkStealingThreadPool */
+  static Pointer
+  GetInstance();
+
+  /** Add this job to the queue of the given worker. The worker index is
+   * taken modulo the number of workers.
+   *
+   * This method returns an std::future. Use WaitForFuture to wait for it. */
+  template <class Function, class... Arguments>
+  auto
+  AddWork(ThreadIdType worker, Function && function, Arguments &&... arguments)
+    -> std::future<typename std::result_of<Function(Arguments...)>::type>
+  {
+    using return_type = typename std::result_of<Function(Arguments...)>::type;
+
+    auto task = std::make_shared<std::packaged_task<return_type()>>(
+      std::bind(std::forward<Function>(function), std::forward<Arguments>(arguments)...));
+
+    std::future<return_type> res = task->get_future();
+    this->PushWork(worker, [task]() { (*task)(); });
+    return res;
+  }
+
+  /** Block until the future is ready, executing queued jobs in the meantime.
+   * Does not call get(), so the caller can still retrieve the result or
+   * the exception stored in the future. */
+  template <typename TResult>
+  void
+  WaitForFuture(const std::future<TResult> & future)
+  {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+    {
+      if (!this->ExecutePendingWork())
+      {
+        future.wait_for(std::chrono::microseconds(50));
+      }
+    }
+  }
+
+  /** Execute one queued job, if any. Returns false if all queues were empty. */
+  bool
+  ExecutePendingWork();
+
+  /** Can call this method if we want to add extra threads to the pool. */
+  void
+  AddThreads(ThreadIdType count);
+
+  ThreadIdType
+  GetMaximumNumberOfThreads() const
+  {
+    return m_NumberOfWorkers.load();
+  }
+
+  /** The index of the worker executing the calling thread,
+   * or GetMaximumNumberOfThreads() if called from outside the pool. */
+  ThreadIdType
+  GetCurrentWorker() const;
+
+  /** Set/Get whether worker threads are bound to a logical processor each.
+   * Only affects threads created afterwards, so it must be set before the
+   * first use of the pool. Also initialized from the environment variable
+   * ITK_WORK_STEALING_PIN_THREADS. Only implemented on Linux. */
+  static void
+  SetPinThreads(bool pinThreads);
+  static bool
+  GetPinThreads();
+
+protected:
+  WorkStealingThreadPool();
+  ~WorkStealingThreadPool() override;
+
+  /** Put a job at the back of the queue of the given worker. */
+  void
+  PushWork(ThreadIdType worker, std::function<void()> && job);
+
+  /** Start count more worker threads. The caller must hold the mutex. */
+  void
+  StartThreads(ThreadIdType count);
+
+  /** Pop a job from the own queue, or steal one from another worker. */
+  bool
+  PopWork(ThreadIdType worker, std::function<void()> & job);
+
+private:
+  /** Only used to synchronize the global variable across static libraries.*/
+  itkGetGlobalDeclarationMacro(WorkStealingThreadPoolGlobals, PimplGlobals);
+
+  /** The queue of a single worker. Padded to avoid false sharing. */
+  struct WorkerQueue
+  {
+    std::mutex                        m_Mutex;
+    std::deque<std::function<void()>> m_Jobs;
+    char                              m_Padding[64];
+  };
+
+  /** Queues are allocated up front for ITK_MAX_THREADS workers,
+   * so AddThreads never moves a queue another thread is using. */
+  std::unique_ptr<WorkerQueue[]> m_Queues;
+
+  /** Number of queued, not yet started jobs in all queues. */
+  std::atomic<SizeValueType> m_NumberOfQueuedJobs{ 0 };
+
+  std::atomic<ThreadIdType> m_NumberOfWorkers{ 0 };
+
+  /** Idle workers wait on m_Condition, guarded by m_SleepMutex. */
+  std::mutex              m_SleepMutex;
+  std::condition_variable m_Condition;
+
+  /** Vector to hold all thread handles.
+   * Thread handles are used to delete (join) the threads. */
+  std::vector<std::thread> m_Threads;
+
+  /* Has destruction started? */
+  std::atomic<bool> m_Stopping{ false };
+
+  /** To lock on the internal variables */
+  static WorkStealingThreadPoolGlobals * m_PimplGlobals;
+
+  /** The continuously running thread function */
+  void
+  ThreadExecute(ThreadIdType worker);
+};
+
+} // namespace itk
+#endif
@@ -0,0 +1,282 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageBufferAllocator.h"
+#include "itkMacro.h"
+#include "itksys/SystemTools.hxx"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#  include <malloc.h>
+#endif
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  define ITK_IMAGE_BUFFER_ALLOCATOR_HUGE_PAGES 1
+#endif
+
+namespace itk
+{
+
+constexpr SizeValueType ImageBufferAllocator::Alignment;
+
+namespace
+{
+std::mutex                    globalDefaultAllocatorLock;
+bool                          globalDefaultAllocatorIsInitialized = false;
+ImageBufferAllocator::Pointer globalDefaultAllocator;
+
+// Buffers of at least this size are candidates for huge pages
+constexpr SizeValueType HugePageSize = 2 * 1024 * 1024;
+} // namespace
+
+ImageBufferAllocator::ImageBufferAllocator()
+  : m_MaximumPoolSize(sizeof(void *) >= 8 ? SizeValueType(1) << 32 : SizeValueType(512) << 20)
+{}
+
+ImageBufferAllocator::~ImageBufferAllocator()
+{
+  // Buffers still in use are owned by containers which hold a reference
+  // to this allocator, so only pooled buffers can remain.
+  this->ReleasePool();
+}
+
+void
+ImageBufferAllocator::SetGlobalDefaultAllocator(ImageBufferAllocator * allocator)
+{
+  std::lock_guard<std::mutex> lock(globalDefaultAllocatorLock);
+  globalDefaultAllocator = allocator;
+  globalDefaultAllocatorIsInitialized = true;
+}
+
+ImageBufferAllocator *
+ImageBufferAllocator::GetGlobalDefaultAllocator()
+{
+  std::lock_guard<std::mutex> lock(globalDefaultAllocatorLock);
+  if (!globalDefaultAllocatorIsInitialized)
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_USE_IMAGE_BUFFER_ALLOCATOR", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      if (envVar != "NO" && envVar != "OFF" && envVar != "FALSE" && envVar != "0")
+      {
+        globalDefaultAllocator = ImageBufferAllocator::New();
+      }
+    }
+    globalDefaultAllocatorIsInitialized = true;
+  }
+  return globalDefaultAllocator;
+}
+
+SizeValueType
+ImageBufferAllocator::ComputeBucketSize(SizeValueType numberOfBytes)
+{
+  numberOfBytes = std::max(numberOfBytes, Alignment);
+
+  // round up to a quarter of the largest power of two not exceeding the size
+  SizeValueType powerOfTwo = Alignment;
+  while (powerOfTwo <= numberOfBytes / 2)
+  {
+    powerOfTwo *= 2;
+  }
+  const SizeValueType granularity = std::max(powerOfTwo / 4, Alignment);
+  return ((numberOfBytes + granularity - 1) / granularity) * granularity;
+}
+
+void *
+ImageBufferAllocator::AllocateFromSystem(SizeValueType numberOfBytes, bool & isHugePage)
+{
+  isHugePage = false;
+#if defined(ITK_IMAGE_BUFFER_ALLOCATOR_HUGE_PAGES)
+  if (m_UseHugePages && numberOfBytes >= HugePageSize)
+  {
+    void * buffer = mmap(nullptr, numberOfBytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buffer != MAP_FAILED)
+    {
+#  if defined(MADV_HUGEPAGE)
+      madvise(buffer, numberOfBytes, MADV_HUGEPAGE);
+#  endif
+      isHugePage = true;
+      return buffer;
+    }
+  }
+#else
+  (void)HugePageSize;
+#endif
+  void * buffer = nullptr;
+#if defined(_WIN32)
+  buffer = _aligned_malloc(numberOfBytes, Alignment);
+#else
+  if (posix_memalign(&buffer, Alignment, numberOfBytes) != 0)
+  {
+    buffer = nullptr;
+  }
+#endif
+  if (!buffer)
+  {
+    // We cannot construct an error string here because we may be out
+    // of memory.  Do not use the exception macro.
+    throw MemoryAllocationError(__FILE__, __LINE__, "Failed to allocate memory for image.", ITK_LOCATION);
+  }
+  return buffer;
+}
+
+void
+ImageBufferAllocator::DeallocateToSystem(void * buffer, SizeValueType numberOfBytes, bool isHugePage)
+{
+#if defined(ITK_IMAGE_BUFFER_ALLOCATOR_HUGE_PAGES)
+  if (isHugePage)
+  {
+    munmap(buffer, numberOfBytes);
+    return;
+  }
+#else
+  (void)numberOfBytes;
+  (void)isHugePage;
+#endif
+#if defined(_WIN32)
+  _aligned_free(buffer);
+#else
+  free(buffer);
+#endif
+}
+
+void *
+ImageBufferAllocator::Allocate(SizeValueType numberOfBytes)
+{
+  const SizeValueType bucketSize = ComputeBucketSize(numberOfBytes);
+
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    ++m_Statistics.NumberOfAllocations;
+
+    auto freeList = m_FreeLists.find(bucketSize);
+    if (freeList != m_FreeLists.end() && !freeList->second.empty())
+    {
+      void * buffer = freeList->second.back();
+      freeList->second.pop_back();
+      ++m_Statistics.NumberOfPoolHits;
+      m_Statistics.BytesPooled -= bucketSize;
+      m_Statistics.BytesInUse += bucketSize;
+      m_Statistics.PeakBytesInUse = std::max(m_Statistics.PeakBytesInUse, m_Statistics.BytesInUse);
+      return buffer;
+    }
+  }
+
+  // Allocate outside of the lock, this may take a while for large buffers
+  bool   isHugePage;
+  void * buffer = this->AllocateFromSystem(bucketSize, isHugePage);
+
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  m_Buffers[buffer] = BufferInformation{ bucketSize, isHugePage };
+  m_Statistics.BytesInUse += bucketSize;
+  m_Statistics.PeakBytesInUse = std::max(m_Statistics.PeakBytesInUse, m_Statistics.BytesInUse);
+  return buffer;
+}
+
+void
+ImageBufferAllocator::Deallocate(void * buffer, SizeValueType itkNotUsed(numberOfBytes))
+{
+  if (buffer == nullptr)
+  {
+    return;
+  }
+
+  BufferInformation information;
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    auto                        it = m_Buffers.find(buffer);
+    if (it == m_Buffers.end())
+    {
+      // Do not throw: this is called from the destructor of ImportImageContainer
+      itkWarningMacro("Buffer " << buffer << " was not allocated by this allocator, it is not released!");
+      return;
+    }
+    information = it->second;
+    ++m_Statistics.NumberOfDeallocations;
+    m_Statistics.BytesInUse -= information.BucketSize;
+
+    if (m_Pooling && m_Statistics.BytesPooled + information.BucketSize <= m_MaximumPoolSize)
+    {
+      m_FreeLists[information.BucketSize].push_back(buffer);
+      m_Statistics.BytesPooled += information.BucketSize;
+      return;
+    }
+    m_Buffers.erase(it);
+  }
+  DeallocateToSystem(buffer, information.BucketSize, information.IsHugePage);
+}
+
+void
+ImageBufferAllocator::ReleasePool()
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  for (auto & freeList : m_FreeLists)
+  {
+    for (void * buffer : freeList.second)
+    {
+      auto it = m_Buffers.find(buffer);
+      DeallocateToSystem(buffer, it->second.BucketSize, it->second.IsHugePage);
+      m_Buffers.erase(it);
+    }
+  }
+  m_FreeLists.clear();
+  m_Statistics.BytesPooled = 0;
+}
+
+ImageBufferAllocator::Statistics
+ImageBufferAllocator::GetStatistics() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_Statistics;
+}
+
+void
+ImageBufferAllocator::SetPooling(bool pooling)
+{
+  if (m_Pooling != pooling)
+  {
+    m_Pooling = pooling;
+    if (!m_Pooling)
+    {
+      this->ReleasePool();
+    }
+    this->Modified();
+  }
+}
+
+void
+ImageBufferAllocator::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  const Statistics statistics = this->GetStatistics();
+  os << indent << "Pooling: " << (m_Pooling ? "On" : "Off") << std::endl;
+  os << indent << "UseHugePages: " << (m_UseHugePages ? "On" : "Off") << std::endl;
+  os << indent << "MaximumPoolSize: " << m_MaximumPoolSize << std::endl;
+  os << indent << "NumberOfAllocations: " << statistics.NumberOfAllocations << std::endl;
+  os << indent << "NumberOfPoolHits: " << statistics.NumberOfPoolHits << std::endl;
+  os << indent << "NumberOfDeallocations: " << statistics.NumberOfDeallocations << std::endl;
+  os << indent << "BytesInUse: " << statistics.BytesInUse << std::endl;
+  os << indent << "PeakBytesInUse: " << statistics.PeakBytesInUse << std::endl;
+  os << indent << "BytesPooled: " << statistics.BytesPooled << std::endl;
+}
+
+} // end namespace itk
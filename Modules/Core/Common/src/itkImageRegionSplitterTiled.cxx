@@ -0,0 +1,111 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionSplitterTiled.h"
+#include "itkMath.h"
+
+namespace itk
+{
+
+ImageRegionSplitterTiled ::ImageRegionSplitterTiled() = default;
+
+void
+ImageRegionSplitterTiled ::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "PixelsPerTile: " << m_PixelsPerTile << std::endl;
+}
+
+unsigned int
+ImageRegionSplitterTiled ::GetNumberOfSplitsInternal(unsigned int         dim,
+                                                     const IndexValueType itkNotUsed(regionIndex)[],
+                                                     const SizeValueType  regionSize[],
+                                                     unsigned int         requestedNumber) const
+{
+  std::vector<unsigned int> splits(dim); // Note: stack allocation preferred
+
+  return this->ComputeSplits(dim, requestedNumber, regionSize, &splits[0]);
+}
+
+unsigned int
+ImageRegionSplitterTiled ::GetSplitInternal(unsigned int   dim,
+                                            unsigned int   splitI,
+                                            unsigned int   numberOfPieces,
+                                            IndexValueType regionIndex[],
+                                            SizeValueType  regionSize[]) const
+{
+  std::vector<unsigned int> splits(dim); // Note: stack allocation preferred
+
+  numberOfPieces = this->ComputeSplits(dim, numberOfPieces, regionSize, &splits[0]);
+
+  // tiles are numbered with the fastest dimension varying fastest,
+  // so consecutive tiles are adjacent in memory
+  unsigned int offset = splitI;
+  for (unsigned int i = 0; i < dim; ++i)
+  {
+    const unsigned int  tileIndex = offset % splits[i];
+    const SizeValueType inputRegionSize = regionSize[i];
+    offset /= splits[i];
+
+    const auto indexOffset = Math::Floor<IndexValueType>(tileIndex * (inputRegionSize / double(splits[i])));
+    regionIndex[i] += indexOffset;
+    if (tileIndex < splits[i] - 1)
+    {
+      regionSize[i] =
+        Math::Floor<SizeValueType>((tileIndex + 1) * (inputRegionSize / double(splits[i]))) - indexOffset;
+    }
+    else
+    {
+      // the last tile takes the remainder
+      regionSize[i] = inputRegionSize - indexOffset;
+    }
+  }
+
+  return numberOfPieces;
+}
+
+unsigned int
+ImageRegionSplitterTiled ::ComputeSplits(unsigned int        dim,
+                                         unsigned int        requestedNumber,
+                                         const SizeValueType regionSize[],
+                                         unsigned int        splits[]) const
+{
+  // grow the tile along the fastest dimensions first
+  SizeValueType remainingPixels = m_PixelsPerTile;
+  SizeValueType numberOfPieces = 1;
+  for (unsigned int i = 0; i < dim; ++i)
+  {
+    const SizeValueType tileSize = std::max<SizeValueType>(1, std::min(remainingPixels, regionSize[i]));
+    splits[i] = std::max<SizeValueType>(1, (regionSize[i] + tileSize - 1) / tileSize);
+    remainingPixels = std::max<SizeValueType>(1, remainingPixels / tileSize);
+    numberOfPieces *= splits[i];
+  }
+
+  // merge tiles along the slowest dimensions if there are too many
+  requestedNumber = std::max(1u, requestedNumber);
+  for (int i = dim - 1; i >= 0 && numberOfPieces > requestedNumber; --i)
+  {
+    const SizeValueType otherPieces = numberOfPieces / splits[i];
+    splits[i] = std::max<SizeValueType>(1, requestedNumber / otherPieces);
+    numberOfPieces = otherPieces * splits[i];
+  }
+
+  return static_cast<unsigned int>(numberOfPieces);
+}
+
+} // end namespace itk
@@ -30,6 +30,7 @@
 #if defined(ITK_USE_PTHREADS) || defined(ITK_USE_WIN32_THREADS)
 #  define POOL_MULTI_THREADER_AVAILABLE 1
 #  include "itkPoolMultiThreader.h"
+#  include "itkWorkStealingMultiThreader.h"
 #endif
 #include "itkNumericTraits.h"
 #include <mutex>
@@ -74,7 +75,15 @@ struct MultiThreaderBaseGlobals
     m_GlobalMaximumNumberOfThreads(ITK_MAX_THREADS)
     ,
     // Global default number of threads : 0 => Not initialized.
-    m_GlobalDefaultNumberOfThreads(0){};
+    m_GlobalDefaultNumberOfThreads(0)
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_GLOBAL_DEFAULT_TILED_SPLITTING", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      m_GlobalDefaultUseTiledSplitting = (envVar != "NO" && envVar != "OFF" && envVar != "FALSE" && envVar != "0");
+    }
+  };
   // GlobalDefaultThreaderTypeIsInitialized is used only in this
   // file to ensure that the ITK_GLOBAL_DEFAULT_THREADER or
   // ITK_USE_THREADPOOL environmenal variables are
@@ -101,6 +110,9 @@ struct MultiThreaderBaseGlobals
   //  m_GlobalMaximumNumberOfThreads and larger or equal to 1 once it has been
   //  initialized in the constructor of the first MultiThreaderBase instantiation.
   ThreadIdType m_GlobalDefaultNumberOfThreads;
+
+  // Global variable defining the initial value of UseTiledSplitting.
+  bool m_GlobalDefaultUseTiledSplitting{ false };
 };
 
 itkGetGlobalSimpleMacro(MultiThreaderBase, MultiThreaderBaseGlobals, PimplGlobals);
@@ -207,6 +219,10 @@ MultiThreaderBase ::ThreaderTypeFromString(std::string threaderString)
   {
     return ThreaderEnum::TBB;
   }
+  else if (threaderString == "WORKSTEALING")
+  {
+    return ThreaderEnum::WorkStealing;
+  }
   else
   {
     return ThreaderEnum::Unknown;
@@ -252,6 +268,20 @@ MultiThreaderBase::SetGlobalDefaultNumberOfThreads(ThreadIdType val)
     std::max(m_PimplGlobals->m_GlobalDefaultNumberOfThreads, NumericTraits<ThreadIdType>::OneValue());
 }
 
+void
+MultiThreaderBase::SetGlobalDefaultUseTiledSplitting(bool useTiledSplitting)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->m_GlobalDefaultUseTiledSplitting = useTiledSplitting;
+}
+
+bool
+MultiThreaderBase::GetGlobalDefaultUseTiledSplitting()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_GlobalDefaultUseTiledSplitting;
+}
+
 void
 MultiThreaderBase::SetMaximumNumberOfThreads(ThreadIdType numberOfThreads)
 {
@@ -421,6 +451,12 @@ MultiThreaderBase::New()
         return TBBMultiThreader::New();
 #else
         itkGenericExceptionMacro("ITK has been built without TBB support!");
+#endif
+      case ThreaderEnum::WorkStealing:
+#if defined(POOL_MULTI_THREADER_AVAILABLE)
+        return WorkStealingMultiThreader::New();
+#else
+        itkGenericExceptionMacro("ITK has been built without WorkStealingMultiThreader support!");
 #endif
       default:
         itkGenericExceptionMacro("MultiThreaderBase::GetGlobalDefaultThreader returned Unknown!");
@@ -434,6 +470,8 @@ MultiThreaderBase::New()
 MultiThreaderBase::MultiThreaderBase()
   : m_SingleMethod{ nullptr }
   , m_SingleData{ nullptr }
+  , m_UseTiledSplitting{ MultiThreaderBase::GetGlobalDefaultUseTiledSplitting() }
+  , m_TiledSplitter{ ImageRegionSplitterTiled::New() }
 {
   m_MaximumNumberOfThreads = MultiThreaderBase::GetGlobalDefaultNumberOfThreads();
   m_NumberOfWorkUnits = m_MaximumNumberOfThreads;
@@ -569,6 +607,12 @@ MultiThreaderBase ::ParallelizeImageRegion(unsigned int
                                            MultiThreaderBase::ThreadingFunctorType funcP,
                                            ProcessObject *                         filter)
 {
+  if (m_UseTiledSplitting)
+  {
+    this->ParallelizeImageRegionTiled(dimension, index, size, funcP, filter);
+    return;
+  }
+
   // This implementation simply delegates parallelization to the old interface
   // SetSingleMethod+SingleMethodExecute. This method is meant to be overloaded!
   MultiThreaderBase::HandleFilterProgress(filter, 0.0f);
@@ -626,6 +670,61 @@ MultiThreaderBase ::ParallelizeImageRegionHelper(void * arg)
   return ITK_THREAD_RETURN_DEFAULT_VALUE;
 }
 
+void
+MultiThreaderBase ::ParallelizeImageRegionTiled(unsigned int                            dimension,
+                                                const IndexValueType                    index[],
+                                                const SizeValueType                     size[],
+                                                MultiThreaderBase::ThreadingFunctorType funcP,
+                                                ProcessObject *                         filter)
+{
+  MultiThreaderBase::HandleFilterProgress(filter, 0.0f);
+
+  ImageIORegion region(dimension);
+  for (unsigned d = 0; d < dimension; d++)
+  {
+    region.SetIndex(d, index[d]);
+    region.SetSize(d, size[d]);
+  }
+  const ThreadIdType tileCount = m_TiledSplitter->GetNumberOfSplits(region, NumericTraits<ThreadIdType>::max());
+
+  if (m_NumberOfWorkUnits == 1 || tileCount <= 1)
+  {
+    funcP(index, size); // process whole region
+  }
+  else
+  {
+    const SizeValueType        pixelCount = region.GetNumberOfPixels();
+    const std::thread::id      callingThread = std::this_thread::get_id();
+    std::atomic<ThreadIdType>  nextTile{ 0 };
+    std::atomic<SizeValueType> pixelProgress{ 0 };
+
+    // each work unit processes tiles until the queue is exhausted
+    this->ParallelizeArray(
+      0,
+      std::min(m_NumberOfWorkUnits, tileCount),
+      [&](SizeValueType) {
+        for (ThreadIdType tile = nextTile++; tile < tileCount; tile = nextTile++)
+        {
+          ImageIORegion tileRegion = region;
+          m_TiledSplitter->GetSplit(tile, tileCount, tileRegion);
+          funcP(&tileRegion.GetIndex()[0], &tileRegion.GetSize()[0]);
+          if (filter)
+          {
+            pixelProgress += tileRegion.GetNumberOfPixels();
+            // make sure we are updating progress only from the thead which invoked filter->Update();
+            if (callingThread == std::this_thread::get_id())
+            {
+              MultiThreaderBase::HandleFilterProgress(filter, float(pixelProgress) / pixelCount);
+            }
+          }
+        }
+      },
+      nullptr);
+  }
+
+  MultiThreaderBase::HandleFilterProgress(filter, 1.0f);
+}
+
 std::ostream &
 operator<<(std::ostream & os, const MultiThreaderBase::ThreaderEnum & threader)
 {
@@ -646,6 +745,8 @@ MultiThreaderBase::PrintSelf(std::ostream & os, Indent indent) const
   os << indent << "Global Default Threader Type: " << m_PimplGlobals->m_GlobalDefaultThreader << std::endl;
   os << indent << "SingleMethod: " << m_SingleMethod << std::endl;
   os << indent << "SingleData: " << m_SingleData << std::endl;
+  os << indent << "UseTiledSplitting: " << m_UseTiledSplitting << std::endl;
+  itkPrintSelfObjectMacro(TiledSplitter);
 }
 
 MultiThreaderBaseGlobals * MultiThreaderBase::m_PimplGlobals;
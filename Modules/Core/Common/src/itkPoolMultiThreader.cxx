@@ -224,6 +224,12 @@ PoolMultiThreader ::ParallelizeImageRegion(unsigned int         dimension,
                                            ThreadingFunctorType funcP,
                                            ProcessObject *      filter)
 {
+  if (m_UseTiledSplitting)
+  {
+    this->ParallelizeImageRegionTiled(dimension, index, size, funcP, filter);
+    return;
+  }
+
   MultiThreaderBase::HandleFilterProgress(filter, 0.0f);
 
   if (m_NumberOfWorkUnits == 1) // no multi-threading wanted
@@ -0,0 +1,268 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+
+#include "itkWorkStealingThreadPool.h"
+#include "itksys/SystemTools.hxx"
+#include "itkThreadSupport.h"
+#include "itkNumericTraits.h"
+#include "itkMultiThreaderBase.h"
+#include "itkSingleton.h"
+
+#include <algorithm>
+
+#if defined(__linux__) && defined(ITK_USE_PTHREADS)
+#  include <pthread.h>
+#  include <sched.h>
+#  define ITK_WORK_STEALING_CAN_PIN_THREADS 1
+#endif
+
+
+namespace itk
+{
+
+struct WorkStealingThreadPoolGlobals
+{
+  WorkStealingThreadPoolGlobals()
+  {
+    std::string envVar;
+    if (itksys::SystemTools::GetEnv("ITK_WORK_STEALING_PIN_THREADS", envVar))
+    {
+      envVar = itksys::SystemTools::UpperCase(envVar);
+      m_PinThreads = (envVar != "NO" && envVar != "OFF" && envVar != "FALSE" && envVar != "0");
+    }
+  }
+  // To lock on the internal variables.
+  std::mutex                      m_Mutex;
+  WorkStealingThreadPool::Pointer m_ThreadPoolInstance;
+  bool                            m_PinThreads{ false };
+};
+
+itkGetGlobalSimpleMacro(WorkStealingThreadPool, WorkStealingThreadPoolGlobals, PimplGlobals);
+
+namespace
+{
+// Index of the pool worker running on this thread, if any.
+thread_local ThreadIdType currentWorker = ITK_MAX_THREADS;
+} // namespace
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool ::New()
+{
+  return Self::GetInstance();
+}
+
+
+WorkStealingThreadPool::Pointer
+WorkStealingThreadPool ::GetInstance()
+{
+  // This is called once, on-demand to ensure that m_PimplGlobals is
+  // initialized.
+  itkInitGlobalsMacro(PimplGlobals);
+
+  if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+  {
+    std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+    // After we have the lock, double check the initialization
+    // flag to ensure it hasn't been changed by another thread.
+    if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+    {
+      m_PimplGlobals->m_ThreadPoolInstance = ObjectFactory<Self>::Create();
+      if (m_PimplGlobals->m_ThreadPoolInstance.IsNull())
+      {
+        new WorkStealingThreadPool(); // constructor sets m_PimplGlobals->m_ThreadPoolInstance
+      }
+    }
+  }
+  return m_PimplGlobals->m_ThreadPoolInstance;
+}
+
+void
+WorkStealingThreadPool ::SetPinThreads(bool pinThreads)
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  m_PimplGlobals->m_PinThreads = pinThreads;
+}
+
+bool
+WorkStealingThreadPool ::GetPinThreads()
+{
+  itkInitGlobalsMacro(PimplGlobals);
+  return m_PimplGlobals->m_PinThreads;
+}
+
+WorkStealingThreadPool ::WorkStealingThreadPool()
+  : m_Queues(new WorkerQueue[ITK_MAX_THREADS])
+{
+  m_PimplGlobals->m_ThreadPoolInstance = this;        // threads need this
+  m_PimplGlobals->m_ThreadPoolInstance->UnRegister(); // Remove extra reference
+  // GetInstance holds the mutex while constructing, so do not call AddThreads
+  this->StartThreads(MultiThreaderBase::GetGlobalDefaultNumberOfThreads());
+}
+
+void
+WorkStealingThreadPool ::AddThreads(ThreadIdType count)
+{
+  std::unique_lock<std::mutex> mutexHolder(m_PimplGlobals->m_Mutex);
+  this->StartThreads(count);
+}
+
+void
+WorkStealingThreadPool ::StartThreads(ThreadIdType count)
+{
+  const auto first = static_cast<ThreadIdType>(m_Threads.size());
+  count = std::min<ThreadIdType>(count, ITK_MAX_THREADS - first);
+  m_Threads.reserve(m_Threads.size() + count);
+  for (ThreadIdType i = first; i < first + count; ++i)
+  {
+    m_Threads.emplace_back(&WorkStealingThreadPool::ThreadExecute, this, i);
+#if defined(ITK_WORK_STEALING_CAN_PIN_THREADS)
+    if (m_PimplGlobals->m_PinThreads)
+    {
+      const unsigned int processorCount = std::max(1u, std::thread::hardware_concurrency());
+      cpu_set_t          cpuSet;
+      CPU_ZERO(&cpuSet);
+      CPU_SET(i % processorCount, &cpuSet);
+      pthread_setaffinity_np(m_Threads.back().native_handle(), sizeof(cpu_set_t), &cpuSet);
+    }
+#endif
+  }
+  // Publish the new workers only once their threads exist
+  m_NumberOfWorkers = first + count;
+}
+
+ThreadIdType
+WorkStealingThreadPool ::GetCurrentWorker() const
+{
+  return std::min(currentWorker, this->GetMaximumNumberOfThreads());
+}
+
+void
+WorkStealingThreadPool ::PushWork(ThreadIdType worker, std::function<void()> && job)
+{
+  worker %= m_NumberOfWorkers.load();
+  {
+    std::lock_guard<std::mutex> lock(m_Queues[worker].m_Mutex);
+    m_Queues[worker].m_Jobs.emplace_back(std::move(job));
+    ++m_NumberOfQueuedJobs;
+  }
+
+  // Taking the sleep mutex orders the increment above before the predicate
+  // check of a worker about to wait, so the notification cannot get lost.
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+  }
+  m_Condition.notify_one();
+}
+
+bool
+WorkStealingThreadPool ::PopWork(ThreadIdType worker, std::function<void()> & job)
+{
+  if (m_NumberOfQueuedJobs.load() == 0)
+  {
+    return false;
+  }
+
+  const ThreadIdType workerCount = m_NumberOfWorkers.load();
+  if (worker < workerCount)
+  {
+    WorkerQueue &               own = m_Queues[worker];
+    std::lock_guard<std::mutex> lock(own.m_Mutex);
+    if (!own.m_Jobs.empty())
+    {
+      job = std::move(own.m_Jobs.front());
+      own.m_Jobs.pop_front();
+      --m_NumberOfQueuedJobs;
+      return true;
+    }
+  }
+  else
+  {
+    worker = 0;
+  }
+
+  // Steal from the far end of the other queues, nearest neighbours first
+  for (ThreadIdType distance = 1; distance <= workerCount; ++distance)
+  {
+    WorkerQueue &               victim = m_Queues[(worker + distance) % workerCount];
+    std::lock_guard<std::mutex> lock(victim.m_Mutex);
+    if (!victim.m_Jobs.empty())
+    {
+      job = std::move(victim.m_Jobs.back());
+      victim.m_Jobs.pop_back();
+      --m_NumberOfQueuedJobs;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool
+WorkStealingThreadPool ::ExecutePendingWork()
+{
+  std::function<void()> job;
+  if (this->PopWork(this->GetCurrentWorker(), job))
+  {
+    job();
+    return true;
+  }
+  return false;
+}
+
+WorkStealingThreadPool ::~WorkStealingThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+
+  for (auto & thread : m_Threads)
+  {
+    thread.join();
+  }
+}
+
+
+void
+WorkStealingThreadPool ::ThreadExecute(ThreadIdType worker)
+{
+  currentWorker = worker;
+
+  std::function<void()> job;
+  while (true)
+  {
+    if (this->PopWork(worker, job))
+    {
+      job(); // execute the job
+      job = nullptr;
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_SleepMutex);
+    m_Condition.wait(lock, [this] { return m_Stopping || m_NumberOfQueuedJobs.load() > 0; });
+    if (m_Stopping && m_NumberOfQueuedJobs.load() == 0)
+    {
+      return;
+    }
+  }
+}
+
+WorkStealingThreadPoolGlobals * WorkStealingThreadPool::m_PimplGlobals;
+
+} // namespace itk
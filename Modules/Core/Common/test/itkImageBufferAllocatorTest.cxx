@@ -0,0 +1,175 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageBufferAllocator.h"
+#include "itkImage.h"
+#include "itkImportImageContainer.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+#include <iostream>
+
+namespace
+{
+bool
+IsAligned(const void * pointer)
+{
+  return reinterpret_cast<uintptr_t>(pointer) % itk::ImageBufferAllocator::Alignment == 0;
+}
+
+// Throws from its constructor after ThrowAt elements have been constructed
+struct ThrowingElement
+{
+  static constexpr int ThrowAt = 10;
+  static int           m_NumberOfConstructions;
+  static int           m_NumberOfDestructions;
+
+  ThrowingElement()
+  {
+    if (m_NumberOfConstructions == ThrowAt)
+    {
+      itkGenericExceptionMacro("ThrowingElement");
+    }
+    ++m_NumberOfConstructions;
+  }
+  ~ThrowingElement() { ++m_NumberOfDestructions; }
+};
+constexpr int ThrowingElement::ThrowAt;
+int           ThrowingElement::m_NumberOfConstructions = 0;
+int           ThrowingElement::m_NumberOfDestructions = 0;
+} // namespace
+
+int
+itkImageBufferAllocatorTest(int, char *[])
+{
+  itk::ImageBufferAllocator::Pointer allocator = itk::ImageBufferAllocator::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(allocator, ImageBufferAllocator, Object);
+
+  ITK_TEST_SET_GET_BOOLEAN(allocator, Pooling, true);
+  ITK_TEST_SET_GET_BOOLEAN(allocator, UseHugePages, false);
+
+  // Raw allocation, alignment and recycling
+  void * buffer = allocator->Allocate(1000);
+  ITK_TEST_EXPECT_TRUE(IsAligned(buffer));
+  allocator->Deallocate(buffer, 1000);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesInUse, 0);
+  ITK_TEST_EXPECT_TRUE(allocator->GetStatistics().BytesPooled >= 1000);
+
+  // a slightly different size falls into the same bucket
+  void * recycled = allocator->Allocate(990);
+  ITK_TEST_EXPECT_EQUAL(recycled, buffer);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().NumberOfPoolHits, 1);
+  allocator->Deallocate(recycled, 990);
+
+  // A foreign buffer is left alone, without throwing
+  const itk::SizeValueType numberOfDeallocations = allocator->GetStatistics().NumberOfDeallocations;
+  ITK_TRY_EXPECT_NO_EXCEPTION(allocator->Deallocate(&buffer, 8));
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().NumberOfDeallocations, numberOfDeallocations);
+
+  allocator->ReleasePool();
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesPooled, 0);
+
+  // Images allocated through the allocator
+  using ImageType = itk::Image<float, 3>;
+  ImageType::SizeType size;
+  size.Fill(17);
+
+  ImageType::Pointer image = ImageType::New();
+  image->GetPixelContainer()->SetBufferAllocator(allocator);
+  ITK_TEST_SET_GET_VALUE(allocator.GetPointer(), image->GetPixelContainer()->GetBufferAllocator());
+  image->SetRegions(size);
+  image->Allocate(true);
+  ITK_TEST_EXPECT_TRUE(IsAligned(image->GetBufferPointer()));
+  const float * firstBuffer = image->GetBufferPointer();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    if (firstBuffer[i] != 0.0f)
+    {
+      std::cerr << "Test failed!" << std::endl;
+      std::cerr << "Pixel " << i << " was not initialized to zero" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  image = nullptr;
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesInUse, 0);
+
+  // The buffer of the released image is reused for the next one
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(allocator);
+  ITK_TEST_SET_GET_VALUE(allocator.GetPointer(), itk::ImageBufferAllocator::GetGlobalDefaultAllocator());
+  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  ITK_TEST_EXPECT_EQUAL(image->GetBufferPointer(), firstBuffer);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().NumberOfPoolHits, 2);
+
+  // ReleaseData gives the buffer back to the pool
+  image->ReleaseData();
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesInUse, 0);
+  image->SetRegions(size);
+  image->Allocate();
+  ITK_TEST_EXPECT_EQUAL(image->GetBufferPointer(), firstBuffer);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().NumberOfPoolHits, 3);
+
+  // Non trivial pixel types are constructed and destroyed
+  using VectorImageType = itk::Image<itk::Vector<double, 3>, 2>;
+  VectorImageType::Pointer vectorImage = VectorImageType::New();
+  VectorImageType::SizeType vectorSize;
+  vectorSize.Fill(9);
+  vectorImage->SetRegions(vectorSize);
+  vectorImage->Allocate(true);
+  ITK_TEST_EXPECT_EQUAL(vectorImage->GetPixel({ { 4, 4 } })[2], 0.0);
+  ITK_TEST_EXPECT_TRUE(IsAligned(vectorImage->GetBufferPointer()));
+  vectorImage = nullptr;
+
+  // When an element constructor throws, the constructed elements are
+  // destroyed and the buffer is given back
+  using ThrowingContainerType = itk::ImportImageContainer<itk::SizeValueType, ThrowingElement>;
+  ThrowingContainerType::Pointer throwingContainer = ThrowingContainerType::New();
+  throwingContainer->SetBufferAllocator(allocator);
+  const itk::SizeValueType bytesInUse = allocator->GetStatistics().BytesInUse;
+  ThrowingElement::m_NumberOfConstructions = 0;
+  ThrowingElement::m_NumberOfDestructions = 0;
+  ITK_TRY_EXPECT_EXCEPTION(throwingContainer->Reserve(100));
+  ITK_TEST_EXPECT_EQUAL(ThrowingElement::m_NumberOfConstructions, ThrowingElement::ThrowAt);
+  ITK_TEST_EXPECT_EQUAL(ThrowingElement::m_NumberOfDestructions, ThrowingElement::ThrowAt);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesInUse, bytesInUse);
+
+  // An imported buffer is not released through the allocator
+  image->GetPixelContainer()->SetImportPointer(new float[8], 8, true);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesInUse, 0);
+  image = nullptr;
+
+  // Without pooling buffers are returned to the system
+  allocator->PoolingOff();
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesPooled, 0);
+  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  image = nullptr;
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().BytesPooled, 0);
+  ITK_TEST_EXPECT_EQUAL(allocator->GetStatistics().NumberOfAllocations,
+                        allocator->GetStatistics().NumberOfDeallocations);
+
+  // Containers created afterwards use new[] again
+  itk::ImageBufferAllocator::SetGlobalDefaultAllocator(nullptr);
+  image = ImageType::New();
+  ITK_TEST_EXPECT_TRUE(image->GetPixelContainer()->GetBufferAllocator() == nullptr);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
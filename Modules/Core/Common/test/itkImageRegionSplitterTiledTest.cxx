@@ -0,0 +1,114 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegionSplitterTiled.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkMultiThreaderBase.h"
+#include "itkTestingMacros.h"
+#include <iostream>
+
+int
+itkImageRegionSplitterTiledTest(int, char *[])
+{
+
+  itk::ImageRegionSplitterTiled::Pointer splitter = itk::ImageRegionSplitterTiled::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(splitter, ImageRegionSplitterTiled, ImageRegionSplitterBase);
+
+  ITK_TEST_SET_GET_VALUE(16384, splitter->GetPixelsPerTile());
+  splitter->SetPixelsPerTile(100);
+  ITK_TEST_SET_GET_VALUE(100, splitter->GetPixelsPerTile());
+
+  itk::ImageRegion<3> region;
+  region.SetSize(0, 40);
+  region.SetSize(1, 11);
+  region.SetSize(2, 7);
+
+  region.SetIndex(0, 1);
+  region.SetIndex(1, 10);
+  region.SetIndex(2, -3);
+
+  const itk::ImageRegion<3> lpRegion = region;
+
+  // tiles of 40x2x1 pixels: 6 along dimension 1, 7 along dimension 2
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 1000), 42);
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 42), 42);
+  // fewer pieces requested: tiles are merged along the slowest dimension
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 20), 18);
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 5), 5);
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 1), 1);
+
+  region = lpRegion;
+  splitter->GetSplit(0, 42, region);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(0), 1);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(1), 10);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(2), -3);
+  ITK_TEST_EXPECT_EQUAL(region.GetSize(0), 40);
+  ITK_TEST_EXPECT_EQUAL(region.GetSize(1), 1);
+  ITK_TEST_EXPECT_EQUAL(region.GetSize(2), 1);
+
+  // consecutive tiles are adjacent along the fastest split dimension
+  region = lpRegion;
+  splitter->GetSplit(1, 42, region);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(1), 11);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(2), -3);
+
+  region = lpRegion;
+  splitter->GetSplit(41, 42, region);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(1), 19);
+  ITK_TEST_EXPECT_EQUAL(region.GetIndex(2), 3);
+  ITK_TEST_EXPECT_EQUAL(region.GetSize(1), 2);
+  ITK_TEST_EXPECT_EQUAL(region.GetSize(2), 1);
+
+  // scanlines longer than a tile are split too
+  splitter->SetPixelsPerTile(16);
+  ITK_TEST_EXPECT_EQUAL(splitter->GetNumberOfSplits(lpRegion, 10000), 3 * 11 * 7);
+
+  // every pixel has to be visited exactly once with tiled splitting
+  using ImageType = itk::Image<unsigned int, 3>;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(lpRegion);
+  image->Allocate(true);
+
+  itk::MultiThreaderBase::Pointer threader = itk::MultiThreaderBase::New();
+  ITK_TEST_SET_GET_BOOLEAN(threader, UseTiledSplitting, false);
+  threader->UseTiledSplittingOn();
+  threader->GetTiledSplitter()->SetPixelsPerTile(64);
+  threader->SetNumberOfWorkUnits(5);
+  threader->ParallelizeImageRegion<3>(
+    lpRegion,
+    [image](const itk::ImageRegion<3> & tile) {
+      for (itk::ImageRegionIterator<ImageType> it(image, tile); !it.IsAtEnd(); ++it)
+      {
+        ++it.Value();
+      }
+    },
+    nullptr);
+
+  for (itk::ImageRegionIterator<ImageType> it(image, lpRegion); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != 1)
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " was visited " << it.Get() << " times" << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  return EXIT_SUCCESS;
+}
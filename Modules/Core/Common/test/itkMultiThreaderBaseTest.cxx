@@ -19,6 +19,7 @@
 #include "itkMultiThreaderBase.h"
 #include "itkPlatformMultiThreader.h"
 #include "itkPoolMultiThreader.h"
+#include "itkWorkStealingMultiThreader.h"
 #ifdef ITK_USE_TBB
 #  include "itkTBBMultiThreader.h"
 #endif
@@ -115,6 +116,7 @@ itkMultiThreaderBaseTest(int argc, char * argv[])
   bool result = true;
   TEST_SINGLE_CLASS(PlatformMultiThreader);
   TEST_SINGLE_CLASS(PoolMultiThreader);
+  TEST_SINGLE_CLASS(WorkStealingMultiThreader);
 #ifdef ITK_USE_TBB
   TEST_SINGLE_CLASS(TBBMultiThreader);
 #endif
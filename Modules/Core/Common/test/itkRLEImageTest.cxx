@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRLEImage.h"
+#include "itkImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Check RLEImage and its region iterators against an itk::Image holding
+// the same pixels.
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using PixelType = unsigned short;
+using ImageType = itk::Image<PixelType, Dimension>;
+using RLEImageType = itk::RLEImage<PixelType, Dimension, unsigned char>;
+using RegionType = ImageType::RegionType;
+
+bool
+SameImages(const ImageType * image, const RLEImageType * rleImage, const RegionType & region, const char * what)
+{
+  itk::ImageRegionConstIterator<ImageType>    it(image, region);
+  itk::ImageRegionConstIterator<RLEImageType> rit(rleImage, region);
+  for (; !it.IsAtEnd(); ++it, ++rit)
+  {
+    if (rit.IsAtEnd() || rit.GetIndex() != it.GetIndex() || rit.Get() != it.Get() ||
+        rleImage->GetPixel(it.GetIndex()) != it.Get())
+    {
+      std::cerr << "Test failed for " << what << " at index " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  if (!rit.IsAtEnd())
+  {
+    std::cerr << "Test failed for " << what << ": the iterator is not at the end" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkRLEImageTest(int, char *[])
+{
+  RegionType region;
+  region.SetIndex({ { -2, 3, 1 } });
+  region.SetSize({ { 40, 7, 5 } });
+
+  RLEImageType::Pointer rleImage = RLEImageType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(rleImage, RLEImage, ImageBase);
+
+  rleImage->SetRegions(region);
+  rleImage->Allocate();
+  ITK_TEST_EXPECT_EQUAL(rleImage->GetNumberOfLines(), 7 * 5);
+  ITK_TEST_EXPECT_EQUAL(rleImage->GetNumberOfRuns(), 7 * 5);
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate(true);
+
+  bool testPassed = true;
+
+  // Few labels, so that both long runs and runs of a single pixel occur
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(42);
+  itk::ImageRegionIterator<ImageType>    it(image, region);
+  itk::ImageRegionIterator<RLEImageType> rit(rleImage, region);
+  PixelType                              label = 0;
+  for (; !it.IsAtEnd(); ++it, ++rit)
+  {
+    if (generator->GetUniformVariate(0.0, 1.0) < 0.3)
+    {
+      label = static_cast<PixelType>(generator->GetIntegerVariate(3));
+    }
+    it.Set(label);
+    rit.Set(label);
+  }
+  testPassed &= SameImages(image, rleImage, region, "region iterator");
+
+  // Adjacent runs of the same value are merged, and empty runs removed
+  using RunType = RLEImageType::RunType;
+  RLEImageType::LineType line = { RunType(2, 1), RunType(0, 3), RunType(3, 1), RunType(1, 2), RunType(0, 2) };
+  RLEImageType::CleanUpLine(line);
+  ITK_TEST_EXPECT_TRUE((line == RLEImageType::LineType{ RunType(5, 1), RunType(1, 2) }));
+
+  // Runs are merged as the pixels are set
+  for (RLEImageType::SizeValueType lineNumber = 0; lineNumber < rleImage->GetNumberOfLines(); ++lineNumber)
+  {
+    line = rleImage->GetLine(lineNumber);
+    RLEImageType::CleanUpLine(line);
+    if (line != rleImage->GetLine(lineNumber))
+    {
+      std::cerr << "Test failed: line " << lineNumber << " holds adjacent runs of the same value" << std::endl;
+      testPassed = false;
+    }
+  }
+
+  // Random writes
+  for (unsigned int n = 0; n < 2000; ++n)
+  {
+    ImageType::IndexType index;
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      index[j] = region.GetIndex(j) + generator->GetIntegerVariate(region.GetSize(j) - 1);
+    }
+    label = static_cast<PixelType>(generator->GetIntegerVariate(3));
+    image->SetPixel(index, label);
+    rleImage->SetPixel(index, label);
+  }
+  testPassed &= SameImages(image, rleImage, region, "SetPixel");
+
+  // Writes through an iterator on a sub region
+  RegionType subRegion;
+  subRegion.SetIndex({ { 5, 4, 2 } });
+  subRegion.SetSize({ { 10, 3, 2 } });
+  it = itk::ImageRegionIterator<ImageType>(image, subRegion);
+  rit = itk::ImageRegionIterator<RLEImageType>(rleImage, subRegion);
+  for (; !it.IsAtEnd(); ++it, ++rit)
+  {
+    const auto value = static_cast<PixelType>(it.GetIndex()[0] % 3 == 0 ? 7 : it.Get());
+    it.Set(value);
+    rit.Set(value);
+  }
+  testPassed &= SameImages(image, rleImage, subRegion, "sub region");
+  testPassed &= SameImages(image, rleImage, region, "region after sub region");
+
+  // Backward iteration
+  itk::ImageRegionConstIterator<ImageType>    bit(image, subRegion);
+  itk::ImageRegionConstIterator<RLEImageType> rbit(rleImage, subRegion);
+  bit.GoToEnd();
+  rbit.GoToEnd();
+  while (!bit.IsAtBegin())
+  {
+    --bit;
+    --rbit;
+    if (rbit.GetIndex() != bit.GetIndex() || rbit.Get() != bit.Get())
+    {
+      std::cerr << "Test failed: backward iteration at index " << bit.GetIndex() << std::endl;
+      testPassed = false;
+      break;
+    }
+  }
+  ITK_TEST_EXPECT_TRUE(rbit.IsAtBegin());
+
+  // Graft
+  RLEImageType::Pointer grafted = RLEImageType::New();
+  grafted->Graft(rleImage);
+  testPassed &= SameImages(image, grafted, region, "graft");
+
+  rleImage->FillBuffer(5);
+  ITK_TEST_EXPECT_EQUAL(rleImage->GetNumberOfRuns(), 7 * 5);
+  ITK_TEST_EXPECT_EQUAL(rleImage->GetPixel(region.GetIndex()), 5);
+
+  // Lines longer than the maximum run length
+  RegionType longRegion = region;
+  longRegion.SetSize(0, 256);
+  rleImage->SetRegions(longRegion);
+  ITK_TRY_EXPECT_EXCEPTION(rleImage->Allocate());
+
+  rleImage->Initialize();
+  ITK_TEST_EXPECT_EQUAL(rleImage->GetNumberOfLines(), 0);
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,96 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkWorkStealingThreadPool.h"
+#include "itkTestingMacros.h"
+
+#include <vector>
+
+// One worker blocks in a job while more jobs are queued behind it. They can
+// only run if the other workers steal them from its queue.
+
+int
+itkWorkStealingThreadPoolTest(int, char *[])
+{
+  itk::WorkStealingThreadPool::Pointer pool = itk::WorkStealingThreadPool::GetInstance();
+  if (pool->GetMaximumNumberOfThreads() < 2)
+  {
+    pool->AddThreads(2 - pool->GetMaximumNumberOfThreads());
+  }
+  const itk::ThreadIdType numberOfWorkers = pool->GetMaximumNumberOfThreads();
+  std::cout << "Workers: " << numberOfWorkers << std::endl;
+
+  // The caller waits with a time out instead of WaitForFuture, which would
+  // execute the queued jobs itself.
+  const auto timeOut = std::chrono::seconds(30);
+
+  std::promise<void>              release;
+  std::shared_future<void>        released = release.get_future().share();
+  std::promise<itk::ThreadIdType> started;
+  std::future<itk::ThreadIdType>  startedFuture = started.get_future();
+
+  std::future<void> blocking = pool->AddWork(0, [&started, released, &pool]() {
+    started.set_value(pool->GetCurrentWorker());
+    released.wait();
+  });
+  if (startedFuture.wait_for(timeOut) != std::future_status::ready)
+  {
+    std::cerr << "Test failed: the blocking job did not start" << std::endl;
+    release.set_value();
+    return EXIT_FAILURE;
+  }
+  const itk::ThreadIdType blockedWorker = startedFuture.get();
+  ITK_TEST_EXPECT_TRUE(blockedWorker < numberOfWorkers);
+
+  // Queue jobs on the blocked worker
+  constexpr unsigned int                      numberOfJobs = 100;
+  std::vector<std::future<itk::ThreadIdType>> jobs;
+  for (unsigned int i = 0; i < numberOfJobs; ++i)
+  {
+    jobs.push_back(pool->AddWork(blockedWorker, [&pool]() { return pool->GetCurrentWorker(); }));
+  }
+
+  bool testPassed = true;
+  for (auto & job : jobs)
+  {
+    if (job.wait_for(timeOut) != std::future_status::ready)
+    {
+      std::cerr << "Test failed: the jobs queued on the blocked worker were not stolen" << std::endl;
+      testPassed = false;
+      break;
+    }
+    const itk::ThreadIdType worker = job.get();
+    if (worker == blockedWorker || worker >= numberOfWorkers)
+    {
+      std::cerr << "Test failed: a job ran on worker " << worker << std::endl;
+      testPassed = false;
+    }
+  }
+
+  release.set_value();
+  pool->WaitForFuture(blocking);
+  blocking.get();
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
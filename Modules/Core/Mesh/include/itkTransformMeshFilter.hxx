@@ -89,12 +89,29 @@ TransformMeshFilter<TInputMesh, TOutputMesh, TTransform>::GenerateData()
   typename InputPointsContainer::ConstIterator inputPoint = inPoints->Begin();
   typename OutputPointsContainer::Iterator     outputPoint = outPoints->Begin();
 
+  // Transform the points in blocks so that the transform can process a batch at once
+  constexpr SizeValueType blockSize = 256;
+
+  std::vector<typename TransformType::InputPointType>  transformInputPoints(blockSize);
+  std::vector<typename TransformType::OutputPointType> transformOutputPoints(blockSize);
+
   while (inputPoint != inPoints->End())
   {
-    outputPoint.Value() = m_Transform->TransformPoint(inputPoint.Value());
+    SizeValueType numberOfPoints = 0;
+    for (auto it = inputPoint; it != inPoints->End() && numberOfPoints < blockSize; ++it)
+    {
+      transformInputPoints[numberOfPoints++] = it.Value();
+    }
+
+    m_Transform->TransformPoints(transformInputPoints.data(), transformOutputPoints.data(), numberOfPoints);
+
+    for (SizeValueType i = 0; i < numberOfPoints; ++i)
+    {
+      outputPoint.Value() = transformOutputPoints[i];
 
-    ++inputPoint;
-    ++outputPoint;
+      ++inputPoint;
+      ++outputPoint;
+    }
   }
 
   // Create duplicate references to the rest of data on the mesh
@@ -265,6 +265,18 @@ public:
   Metric() const;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
+  bool
+  JacobianUsesMatrixAndOffsetParameters() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   /** Construct an AffineTransform object
    *
    * This method constructs a new AffineTransform object and
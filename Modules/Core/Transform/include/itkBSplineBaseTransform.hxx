@@ -325,5 +325,22 @@ BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>::Transform
   return outputPoint;
 }
 
+template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineBaseTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  WeightsType             weights(this->m_WeightsFunction->GetNumberOfWeights());
+  ParameterIndexArrayType indices(this->m_WeightsFunction->GetNumberOfWeights());
+  bool                    inside;
+
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    this->TransformPoint(inputPoints[i], outputPoints[i], weights, indices, inside);
+  }
+}
+
 } // namespace itk
 #endif
@@ -239,6 +239,18 @@ public:
                  ParameterIndexArrayType & indices,
                  bool &                    inside) const override;
 
+  /** Transform a batch of points, e.g. a scanline of an image. The support
+   * node offsets into the coefficient buffers are computed once per batch,
+   * and the one-dimensional B-spline weights of a dimension are only
+   * recomputed when the continuous grid index along that dimension changes
+   * from one point to the next. For points along an image row that is
+   * aligned with the B-spline grid, only the weights along the row change.
+   * The result is identical to that of TransformPoint. */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const override;
+
   /** Compute the Jacobian in one position. */
   void
   ComputeJacobianWithRespectToParameters(const InputPointType &, JacobianType &) const override;
@@ -23,6 +23,10 @@
 #include "itkContinuousIndex.h"
 #include "itkImageScanlineConstIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
+#include "itkIndexRange.h"
+#include "itkBSplineKernelFunction.h"
+
+#include <vector>
 
 namespace itk
 {
@@ -606,6 +610,124 @@ BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoin
   }
 }
 
+template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
+void
+BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  const ImageType * const coefficientImage = this->m_CoefficientImages[0];
+  if (!coefficientImage->GetBufferPointer())
+  {
+    Superclass::TransformPoints(inputPoints, outputPoints, numberOfPoints);
+    return;
+  }
+
+  constexpr unsigned int SupportLength = SplineOrder + 1;
+  const unsigned int     numberOfWeights = this->m_WeightsFunction->GetNumberOfWeights();
+
+  // Offsets of the support nodes from the first node of the support region,
+  // in the order of the weights computed by the weights function
+  SizeType supportSize;
+  supportSize.Fill(SupportLength);
+  const OffsetValueType * const offsetTable = coefficientImage->GetOffsetTable();
+  std::vector<OffsetValueType>  supportOffsets(numberOfWeights);
+  std::vector<unsigned int>     supportNodes(numberOfWeights * SpaceDimension);
+  unsigned int                  counter = 0;
+  for (const IndexType node : Experimental::ZeroBasedIndexRange<SpaceDimension>(supportSize))
+  {
+    supportOffsets[counter] = 0;
+    for (unsigned int j = 0; j < SpaceDimension; j++)
+    {
+      supportOffsets[counter] += node[j] * offsetTable[j];
+      supportNodes[counter * SpaceDimension + j] = static_cast<unsigned int>(node[j]);
+    }
+    ++counter;
+  }
+
+  const ParametersValueType * coefficients[SpaceDimension];
+  for (unsigned int j = 0; j < SpaceDimension; j++)
+  {
+    coefficients[j] = this->m_CoefficientImages[j]->GetBufferPointer();
+  }
+
+  using KernelType = BSplineKernelFunction<SplineOrder>;
+  const typename KernelType::Pointer kernel = KernelType::New();
+
+  // One-dimensional weights, together with the continuous index they were computed for
+  double              weights1D[SpaceDimension][SupportLength];
+  IndexType           supportIndex;
+  ContinuousIndexType cachedIndex;
+  bool                cached[SpaceDimension];
+  std::fill_n(cached, SpaceDimension, false);
+
+  WeightsType weights(numberOfWeights);
+
+  for (SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    const InputPointType & point = inputPoints[n];
+    OutputPointType &      outputPoint = outputPoints[n];
+
+    ContinuousIndexType index;
+    coefficientImage->TransformPhysicalPointToContinuousIndex(point, index);
+
+    // NOTE: if the support region does not lie totally within the grid
+    // we assume zero displacement and return the input point
+    if (!this->InsideValidRegion(index))
+    {
+      outputPoint = point;
+      continue;
+    }
+
+    // Compute the weights the same way as the weights function does, reusing
+    // the one-dimensional weights of dimensions along which the index is unchanged
+    for (unsigned int j = 0; j < SpaceDimension; j++)
+    {
+      if (cached[j] && index[j] == cachedIndex[j])
+      {
+        continue;
+      }
+      supportIndex[j] = Math::Floor<IndexValueType>(index[j] + 0.5 - SplineOrder / 2.0);
+
+      double x = index[j] - static_cast<double>(supportIndex[j]);
+      for (unsigned int k = 0; k < SupportLength; k++)
+      {
+        weights1D[j][k] = kernel->Evaluate(x);
+        x -= 1.0;
+      }
+      cachedIndex[j] = index[j];
+      cached[j] = true;
+    }
+
+    for (unsigned int k = 0; k < numberOfWeights; k++)
+    {
+      weights[k] = 1.0;
+      for (unsigned int j = 0; j < SpaceDimension; j++)
+      {
+        weights[k] *= weights1D[j][supportNodes[k * SpaceDimension + j]];
+      }
+    }
+
+    // For each dimension, correlate coefficient with weights
+    const OffsetValueType supportStart = coefficientImage->ComputeOffset(supportIndex);
+    outputPoint.Fill(NumericTraits<ScalarType>::ZeroValue());
+    for (unsigned int k = 0; k < numberOfWeights; k++)
+    {
+      const OffsetValueType offset = supportStart + supportOffsets[k];
+      for (unsigned int j = 0; j < SpaceDimension; j++)
+      {
+        outputPoint[j] += static_cast<ScalarType>(weights[k] * coefficients[j][offset]);
+      }
+    }
+
+    for (unsigned int j = 0; j < SpaceDimension; j++)
+    {
+      outputPoint[j] += point[j];
+    }
+  }
+}
+
 template <typename TParametersValueType, unsigned int NDimensions, unsigned int VSplineOrder>
 void
 BSplineTransform<TParametersValueType, NDimensions, VSplineOrder>::ComputeJacobianWithRespectToParameters(
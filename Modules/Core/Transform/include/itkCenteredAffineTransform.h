@@ -111,6 +111,12 @@ public:
   GetInverseTransform() const override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   /** Construct an CenteredAffineTransform object */
   CenteredAffineTransform();
 
@@ -120,6 +120,12 @@ public:
   GetInverseTransform() const override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   CenteredEuler3DTransform();
   CenteredEuler3DTransform(const MatrixType & matrix, const OutputPointType & offset);
   CenteredEuler3DTransform(unsigned int ParametersDimension);
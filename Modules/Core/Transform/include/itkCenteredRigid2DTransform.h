@@ -168,6 +168,12 @@ public:
   CloneTo(Pointer & clone) const;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   CenteredRigid2DTransform();
   ~CenteredRigid2DTransform() override = default;
 
@@ -174,6 +174,12 @@ public:
   CloneTo(Pointer & clone) const;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   CenteredSimilarity2DTransform();
   CenteredSimilarity2DTransform(unsigned int spaceDimension, unsigned int parametersDimension);
 
@@ -151,6 +151,12 @@ public:
   ComputeJacobianWithRespectToParameters(const InputPointType & p, JacobianType & jacobian) const override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   ComposeScaleSkewVersor3DTransform();
   ComposeScaleSkewVersor3DTransform(const MatrixType & matrix, const OutputVectorType & offset);
   ComposeScaleSkewVersor3DTransform(unsigned int paramDims);
@@ -84,6 +84,34 @@ CompositeTransform<TParametersValueType, NDimensions>::TransformPoint(const Inpu
 }
 
 
+template <typename TParametersValueType, unsigned int NDimensions>
+void
+CompositeTransform<TParametersValueType, NDimensions>::TransformPoints(const InputPointType * inputPoints,
+                                                                      OutputPointType *      outputPoints,
+                                                                      SizeValueType          numberOfPoints) const
+{
+  if (this->m_TransformQueue.empty())
+  {
+    std::copy(inputPoints, inputPoints + numberOfPoints, outputPoints);
+    return;
+  }
+
+  /* Apply in reverse queue order.  */
+  typename TransformQueueType::const_reverse_iterator it = this->m_TransformQueue.rbegin();
+  (*it)->TransformPoints(inputPoints, outputPoints, numberOfPoints);
+  if (++it == this->m_TransformQueue.rend())
+  {
+    return;
+  }
+  std::vector<OutputPointType> intermediatePoints(numberOfPoints);
+  for (; it != this->m_TransformQueue.rend(); ++it)
+  {
+    std::copy(outputPoints, outputPoints + numberOfPoints, intermediatePoints.begin());
+    (*it)->TransformPoints(intermediatePoints.data(), outputPoints, numberOfPoints);
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int NDimensions>
 typename CompositeTransform<TParametersValueType, NDimensions>::OutputVectorType
 CompositeTransform<TParametersValueType, NDimensions>::TransformVector(const InputVectorType & inputVector) const
@@ -125,6 +125,12 @@ public:
   }
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   Euler2DTransform(unsigned int parametersDimension);
   Euler2DTransform();
   ~Euler2DTransform() override = default;
@@ -135,6 +135,12 @@ public:
   SetIdentity() override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   Euler3DTransform(const MatrixType & matrix, const OutputPointType & offset);
   Euler3DTransform(unsigned int paramsSpaceDims);
   Euler3DTransform();
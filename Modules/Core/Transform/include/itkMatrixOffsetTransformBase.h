@@ -386,6 +386,15 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & point) const override;
 
+  /** Transform a batch of points with the matrix and offset held in local
+   * variables, so that the loop over the points can be vectorized. Only
+   * classes for which TransformPointUsesMatrixAndOffset() is true take this
+   * path; any other subclass gets the per-point loop of the superclass. */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const override;
+
   using Superclass::TransformVector;
 
   OutputVectorType
@@ -433,6 +442,15 @@ public:
   void
   ComputeJacobianWithRespectToParameters(const InputPointType & x, JacobianType & j) const override;
 
+  /** Compute the Jacobians at a batch of points without a virtual call per
+   * point. Only classes for which JacobianUsesMatrixAndOffsetParameters() is
+   * true take this path; any other subclass gets the per-point loop of the
+   * superclass. */
+  void
+  ComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                          JacobianType *         jacobians,
+                                          SizeValueType          numberOfPoints) const override;
+
 
   /** Get the jacobian with respect to position. This simply returns
    * the current Matrix. jac will be resized as needed, but it's
@@ -486,6 +504,28 @@ public:
   }
 
 protected:
+  /** Whether TransformPoint of this object is the matrix and offset mapping
+   * of this class, so that TransformPoints may evaluate it in a batch. Each
+   * class of the affine family that does not customize TransformPoint
+   * returns true for exactly its own type, so that a further subclass,
+   * which may override TransformPoint, falls back to the per-point loop
+   * unless it opts in by overriding this method as well. */
+  virtual bool
+  TransformPointUsesMatrixAndOffset() const
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
+  /** Whether ComputeJacobianWithRespectToParameters of this object is the
+   * one of this class, so that ComputeJacobiansWithRespectToParameters may
+   * evaluate it without virtual calls. Opted into the same way as
+   * TransformPointUsesMatrixAndOffset(). */
+  virtual bool
+  JacobianUsesMatrixAndOffsetParameters() const
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   /** \deprecated Use GetInverse for public API instead.
    * Method will eventually be made a protected member function */
   const InverseMatrixType &
@@ -183,6 +183,48 @@ MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensi
 }
 
 
+template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensions>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  if (!this->TransformPointUsesMatrixAndOffset())
+  {
+    Superclass::TransformPoints(inputPoints, outputPoints, numberOfPoints);
+    return;
+  }
+
+  // Same operations, in the same order, as TransformPoint
+  TParametersValueType matrix[NOutputDimensions][NInputDimensions];
+  TParametersValueType offset[NOutputDimensions];
+  for (unsigned int i = 0; i < NOutputDimensions; ++i)
+  {
+    for (unsigned int j = 0; j < NInputDimensions; ++j)
+    {
+      matrix[i][j] = m_Matrix[i][j];
+    }
+    offset[i] = m_Offset[i];
+  }
+
+  for (SizeValueType p = 0; p < numberOfPoints; ++p)
+  {
+    const InputPointType & inputPoint = inputPoints[p];
+    OutputPointType &      outputPoint = outputPoints[p];
+    for (unsigned int i = 0; i < NOutputDimensions; ++i)
+    {
+      TParametersValueType sum = NumericTraits<TParametersValueType>::ZeroValue();
+      for (unsigned int j = 0; j < NInputDimensions; ++j)
+      {
+        sum += matrix[i][j] * inputPoint[j];
+      }
+      outputPoint[i] = sum + offset[i];
+    }
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 typename MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensions>::OutputVectorType
 MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensions>::TransformVector(
@@ -628,6 +670,49 @@ MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensi
 }
 
 
+template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensions>::
+  ComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                          JacobianType *         jacobians,
+                                          SizeValueType          numberOfPoints) const
+{
+  if (!this->JacobianUsesMatrixAndOffsetParameters())
+  {
+    Superclass::ComputeJacobiansWithRespectToParameters(points, jacobians, numberOfPoints);
+    return;
+  }
+
+  // Same values as ComputeJacobianWithRespectToParameters, with the center
+  // and the number of parameters looked up once
+  const InputPointType                              center = this->GetCenter();
+  const typename Superclass::NumberOfParametersType numberOfLocalParameters = this->GetNumberOfLocalParameters();
+  for (SizeValueType p = 0; p < numberOfPoints; ++p)
+  {
+    JacobianType & jacobian = jacobians[p];
+    jacobian.SetSize(NOutputDimensions, numberOfLocalParameters);
+    jacobian.Fill(0.0);
+
+    const InputVectorType v = points[p] - center;
+
+    unsigned int blockOffset = 0;
+    for (unsigned int block = 0; block < NInputDimensions; block++)
+    {
+      for (unsigned int dim = 0; dim < NOutputDimensions; dim++)
+      {
+        jacobian(block, blockOffset + dim) = v[dim];
+      }
+
+      blockOffset += NInputDimensions;
+    }
+    for (unsigned int dim = 0; dim < NOutputDimensions; dim++)
+    {
+      jacobian(dim, blockOffset + dim) = 1.0;
+    }
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 void
 MatrixOffsetTransformBase<TParametersValueType, NInputDimensions, NOutputDimensions>::
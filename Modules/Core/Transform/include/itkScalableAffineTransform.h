@@ -128,6 +128,18 @@ public:
   GetInverseTransform() const override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
+  bool
+  JacobianUsesMatrixAndOffsetParameters() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   /** Construct an ScalableAffineTransform object
    *
    * This method constructs a new AffineTransform object and
@@ -139,6 +139,12 @@ public:
   ComputeJacobianWithRespectToParameters(const InputPointType & p, JacobianType & jacobian) const override;
 
 protected:
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return typeid(*this) == typeid(Self);
+  }
+
   ScaleVersor3DTransform();
   ScaleVersor3DTransform(const MatrixType & matrix, const OutputVectorType & offset);
   ScaleVersor3DTransform(unsigned int paramDims);
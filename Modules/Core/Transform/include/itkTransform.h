@@ -178,6 +178,17 @@ public:
   virtual OutputPointType
   TransformPoint(const InputPointType &) const = 0;
 
+  /** Transform \c numberOfPoints points at once, writing
+   * TransformPoint( inputPoints[i] ) to outputPoints[i]. Callers that
+   * transform many points, e.g. a scanline of an image, avoid a virtual call
+   * per point, and transforms may override this to set up their evaluation
+   * once per batch. The input and output arrays must not overlap.
+   * \warning This method must be thread-safe. */
+  virtual void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const;
+
   /**  Method to transform a vector. */
   virtual OutputVectorType
   TransformVector(const InputVectorType &) const
@@ -513,6 +524,17 @@ public:
     this->ComputeJacobianWithRespectToParameters(p, jacobian);
   }
 
+  /** Compute the Jacobians with respect to the parameters at a batch of
+   * points, as ComputeJacobianWithRespectToParameters does for each of them.
+   * The default implementation calls it point by point; subclasses may
+   * override this to compute what the points share once per batch.
+   * \c jacobians must hold \c numberOfPoints thread-local matrices, which
+   * are sized as needed. */
+  virtual void
+  ComputeJacobiansWithRespectToParameters(const InputPointType * points,
+                                          JacobianType *         jacobians,
+                                          SizeValueType          numberOfPoints) const;
+
 
   /** This provides the ability to get a local jacobian value
    *  in a dense/local transform, e.g. DisplacementFieldTransform. For such
@@ -132,6 +132,34 @@ Transform<TParametersValueType, NInputDimensions, NOutputDimensions>::UpdateTran
 }
 
 
+template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+Transform<TParametersValueType, NInputDimensions, NOutputDimensions>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    outputPoints[i] = this->TransformPoint(inputPoints[i]);
+  }
+}
+
+
+template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
+void
+Transform<TParametersValueType, NInputDimensions, NOutputDimensions>::ComputeJacobiansWithRespectToParameters(
+  const InputPointType * points,
+  JacobianType *         jacobians,
+  SizeValueType          numberOfPoints) const
+{
+  for (SizeValueType i = 0; i < numberOfPoints; ++i)
+  {
+    this->ComputeJacobianWithRespectToParameters(points[i], jacobians[i]);
+  }
+}
+
+
 template <typename TParametersValueType, unsigned int NInputDimensions, unsigned int NOutputDimensions>
 typename Transform<TParametersValueType, NInputDimensions, NOutputDimensions>::OutputVectorType
 Transform<TParametersValueType, NInputDimensions, NOutputDimensions>::TransformVector(
@@ -0,0 +1,331 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkGTest.h"
+#include "itkAffineTransform.h"
+#include "itkAzimuthElevationToCartesianTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkEuler3DTransform.h"
+#include "itkScalableAffineTransform.h"
+#include "itkScaleTransform.h"
+#include "itkTranslationTransform.h"
+
+#include <vector>
+
+namespace
+{
+
+// Generate points spread over, and slightly beyond, [-10, 10]^NDimensions
+template <typename TPoint>
+std::vector<TPoint>
+MakeTestPoints(unsigned int numberOfPoints)
+{
+  std::vector<TPoint> points(numberOfPoints);
+  for (unsigned int i = 0; i < numberOfPoints; ++i)
+  {
+    for (unsigned int d = 0; d < TPoint::PointDimension; ++d)
+    {
+      points[i][d] = -12.0 + 24.0 * ((i * (7 + 3 * d) + d) % numberOfPoints) / numberOfPoints;
+    }
+  }
+  return points;
+}
+
+// Check that the batched TransformPoints gives exactly the results of TransformPoint
+template <typename TTransform>
+void
+ExpectTransformPointsEqual(const TTransform * transform, const std::string & description)
+{
+  using InputPointType = typename TTransform::InputPointType;
+  using OutputPointType = typename TTransform::OutputPointType;
+
+  const unsigned int                numberOfPoints = 97;
+  const std::vector<InputPointType> inputPoints = MakeTestPoints<InputPointType>(numberOfPoints);
+  std::vector<OutputPointType>      outputPoints(numberOfPoints);
+
+  transform->TransformPoints(inputPoints.data(), outputPoints.data(), numberOfPoints);
+
+  for (unsigned int i = 0; i < numberOfPoints; ++i)
+  {
+    EXPECT_EQ(outputPoints[i], transform->TransformPoint(inputPoints[i])) << description << " point " << i;
+  }
+
+  // An empty batch must not touch the output
+  transform->TransformPoints(inputPoints.data(), outputPoints.data(), 0);
+}
+
+// Check that the batched ComputeJacobiansWithRespectToParameters gives exactly
+// the results of ComputeJacobianWithRespectToParameters
+template <typename TTransform>
+void
+ExpectJacobiansEqual(const TTransform * transform, const std::string & description)
+{
+  using InputPointType = typename TTransform::InputPointType;
+  using JacobianType = typename TTransform::JacobianType;
+
+  const unsigned int                numberOfPoints = 23;
+  const std::vector<InputPointType> points = MakeTestPoints<InputPointType>(numberOfPoints);
+  std::vector<JacobianType>         jacobians(numberOfPoints);
+
+  transform->ComputeJacobiansWithRespectToParameters(points.data(), jacobians.data(), numberOfPoints);
+
+  JacobianType expected;
+  for (unsigned int i = 0; i < numberOfPoints; ++i)
+  {
+    transform->ComputeJacobianWithRespectToParameters(points[i], expected);
+    EXPECT_EQ(jacobians[i].rows(), expected.rows()) << description << " point " << i;
+    EXPECT_EQ(jacobians[i].cols(), expected.cols()) << description << " point " << i;
+    EXPECT_TRUE(jacobians[i] == expected) << description << " point " << i;
+  }
+}
+
+// An affine transform that customizes TransformPoint and the Jacobian
+// without knowing about their batched variants
+class ShiftedAffineTransform : public itk::AffineTransform<double, 3>
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ShiftedAffineTransform);
+
+  using Self = ShiftedAffineTransform;
+  using Superclass = itk::AffineTransform<double, 3>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(ShiftedAffineTransform, AffineTransform);
+
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override
+  {
+    OutputPointType result = Superclass::TransformPoint(point);
+    result[0] += 1.0;
+    return result;
+  }
+
+  void
+  ComputeJacobianWithRespectToParameters(const InputPointType & point, JacobianType & jacobian) const override
+  {
+    Superclass::ComputeJacobianWithRespectToParameters(point, jacobian);
+    jacobian *= 2.0;
+  }
+
+protected:
+  ShiftedAffineTransform() = default;
+  ~ShiftedAffineTransform() override = default;
+};
+
+template <unsigned int NDimensions>
+typename itk::BSplineTransform<double, NDimensions, 3>::Pointer
+MakeBSplineTransform()
+{
+  using BSplineType = itk::BSplineTransform<double, NDimensions, 3>;
+
+  auto                                         bspline = BSplineType::New();
+  typename BSplineType::PhysicalDimensionsType physicalDimensions;
+  typename BSplineType::MeshSizeType           meshSize;
+  typename BSplineType::OriginType             origin;
+  for (unsigned int d = 0; d < NDimensions; ++d)
+  {
+    physicalDimensions[d] = 20.0;
+    meshSize[d] = 4;
+    origin[d] = -10.0;
+  }
+  bspline->SetTransformDomainOrigin(origin);
+  bspline->SetTransformDomainPhysicalDimensions(physicalDimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+
+  typename BSplineType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int i = 0; i < parameters.GetSize(); ++i)
+  {
+    parameters[i] = 0.1 * static_cast<double>(i % 11) - 0.5;
+  }
+  bspline->SetParametersByValue(parameters);
+  return bspline;
+}
+
+} // namespace
+
+TEST(ITKTransformPoints, Affine)
+{
+  using AffineType = itk::AffineTransform<double, 3>;
+  auto                         affine = AffineType::New();
+  AffineType::OutputVectorType axis;
+  AffineType::OutputVectorType translation;
+  axis[0] = 0.3;
+  axis[1] = -0.2;
+  axis[2] = 1.0;
+  translation[0] = 1.5;
+  translation[1] = -2.25;
+  translation[2] = 0.125;
+  affine->Rotate3D(axis, 0.7);
+  affine->Scale(1.3);
+  affine->Shear(0, 2, 0.2);
+  affine->Translate(translation);
+
+  ExpectTransformPointsEqual(affine.GetPointer(), "Affine");
+
+  using AffineFloatType = itk::AffineTransform<float, 2>;
+  auto affineFloat = AffineFloatType::New();
+  affineFloat->Rotate2D(0.3);
+  affineFloat->Scale(0.9f);
+  ExpectTransformPointsEqual(affineFloat.GetPointer(), "Affine float");
+
+  using EulerType = itk::Euler3DTransform<double>;
+  auto euler = EulerType::New();
+  euler->SetRotation(0.1, -0.4, 0.25);
+  euler->SetTranslation(translation);
+  ExpectTransformPointsEqual(euler.GetPointer(), "Euler3D");
+}
+
+TEST(ITKTransformPoints, MatrixOffsetSubclassesOverridingTransformPoint)
+{
+  using ScaleType = itk::ScaleTransform<double, 3>;
+  auto                 scaleTransform = ScaleType::New();
+  ScaleType::ScaleType scale;
+  scale[0] = 1.1;
+  scale[1] = 0.7;
+  scale[2] = 1.9;
+  ScaleType::InputPointType center;
+  center.Fill(2.5);
+  scaleTransform->SetScale(scale);
+  scaleTransform->SetCenter(center);
+  ExpectTransformPointsEqual(scaleTransform.GetPointer(), "Scale");
+
+  using AzimuthElevationType = itk::AzimuthElevationToCartesianTransform<double, 3>;
+  auto azimuthElevation = AzimuthElevationType::New();
+  azimuthElevation->SetAzimuthElevationToCartesianParameters(0.5, 1.0, 30, 20);
+  ExpectTransformPointsEqual(azimuthElevation.GetPointer(), "AzimuthElevationToCartesian");
+}
+
+TEST(ITKTransformPoints, SubclassOverridingTransformPoint)
+{
+  // A subclass of the affine family that does not opt in to the batched
+  // matrix path still gets its own TransformPoint
+  auto shifted = ShiftedAffineTransform::New();
+  shifted->Rotate(0, 1, 0.4);
+  shifted->Scale(1.2);
+  ExpectTransformPointsEqual(shifted.GetPointer(), "Shifted affine");
+  ExpectJacobiansEqual(shifted.GetPointer(), "Shifted affine");
+}
+
+TEST(ITKTransformPoints, Jacobians)
+{
+  using AffineType = itk::AffineTransform<double, 3>;
+  auto                         affine = AffineType::New();
+  AffineType::OutputVectorType translation;
+  translation.Fill(0.5);
+  affine->Rotate(0, 2, -0.3);
+  affine->Translate(translation);
+  AffineType::InputPointType center;
+  center.Fill(1.25);
+  affine->SetCenter(center);
+  ExpectJacobiansEqual(affine.GetPointer(), "Affine");
+
+  using ScalableAffineType = itk::ScalableAffineTransform<double, 2>;
+  auto                               scalableAffine = ScalableAffineType::New();
+  ScalableAffineType::InputPointType scalableCenter;
+  scalableCenter.Fill(-0.5);
+  scalableAffine->SetCenter(scalableCenter);
+  scalableAffine->Rotate2D(0.2);
+  ExpectJacobiansEqual(scalableAffine.GetPointer(), "ScalableAffine");
+
+  using EulerType = itk::Euler3DTransform<double>;
+  auto euler = EulerType::New();
+  euler->SetRotation(0.1, -0.4, 0.25);
+  euler->SetCenter(center);
+  ExpectJacobiansEqual(euler.GetPointer(), "Euler3D");
+
+  ExpectJacobiansEqual(MakeBSplineTransform<2>().GetPointer(), "BSpline 2D");
+}
+
+TEST(ITKTransformPoints, BSpline)
+{
+  ExpectTransformPointsEqual(MakeBSplineTransform<2>().GetPointer(), "BSpline 2D");
+  ExpectTransformPointsEqual(MakeBSplineTransform<3>().GetPointer(), "BSpline 3D");
+}
+
+TEST(ITKTransformPoints, BSplineScanlines)
+{
+  // Points along image rows, as passed by ResampleImageFilter, for which
+  // the weights along the other dimensions are reused within a row
+  using BSplineType = itk::BSplineTransform<double, 3, 3>;
+  const BSplineType::Pointer bspline = MakeBSplineTransform<3>();
+
+  const unsigned int                        rowLength = 64;
+  std::vector<BSplineType::InputPointType>  rowPoints(rowLength);
+  std::vector<BSplineType::OutputPointType> rowOutput(rowLength);
+  for (double y : { -9.0, -2.5, 0.0, 3.75, 9.5 })
+  {
+    for (double z : { -4.0, 6.125 })
+    {
+      for (unsigned int i = 0; i < rowLength; ++i)
+      {
+        rowPoints[i][0] = -12.0 + 0.375 * i;
+        rowPoints[i][1] = y;
+        rowPoints[i][2] = z;
+      }
+      bspline->TransformPoints(rowPoints.data(), rowOutput.data(), rowLength);
+      for (unsigned int i = 0; i < rowLength; ++i)
+      {
+        EXPECT_EQ(rowOutput[i], bspline->TransformPoint(rowPoints[i])) << "row point " << rowPoints[i];
+      }
+    }
+  }
+}
+
+TEST(ITKTransformPoints, DefaultImplementation)
+{
+  using TranslationType = itk::TranslationTransform<double, 3>;
+  auto                              translation = TranslationType::New();
+  TranslationType::OutputVectorType offset;
+  offset.Fill(-3.5);
+  translation->SetOffset(offset);
+
+  ExpectTransformPointsEqual(translation.GetPointer(), "Translation");
+}
+
+TEST(ITKTransformPoints, Composite)
+{
+  using CompositeType = itk::CompositeTransform<double, 3>;
+  auto composite = CompositeType::New();
+
+  // An empty composite transform is the identity
+  const std::vector<CompositeType::InputPointType> inputPoints = MakeTestPoints<CompositeType::InputPointType>(10);
+  std::vector<CompositeType::OutputPointType>      outputPoints(inputPoints.size());
+  composite->TransformPoints(inputPoints.data(), outputPoints.data(), inputPoints.size());
+  for (size_t i = 0; i < inputPoints.size(); ++i)
+  {
+    EXPECT_EQ(outputPoints[i], inputPoints[i]) << "Empty composite point " << i;
+  }
+
+  auto affine = itk::AffineTransform<double, 3>::New();
+  affine->Rotate(0, 1, 0.4);
+  affine->Scale(0.8);
+  composite->AddTransform(affine);
+  ExpectTransformPointsEqual(composite.GetPointer(), "Composite with one transform");
+
+  using TranslationType = itk::TranslationTransform<double, 3>;
+  auto                              translation = TranslationType::New();
+  TranslationType::OutputVectorType offset;
+  offset.Fill(0.75);
+  translation->SetOffset(offset);
+  composite->AddTransform(MakeBSplineTransform<3>());
+  composite->AddTransform(translation);
+  ExpectTransformPointsEqual(composite.GetPointer(), "Composite with three transforms");
+}
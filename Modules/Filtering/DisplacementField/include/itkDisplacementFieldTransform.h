@@ -209,6 +209,17 @@ public:
   OutputPointType
   TransformPoint(const InputPointType & thisPoint) const override;
 
+  /** Transform a batch of points, e.g. a scanline of an image. With the
+   * default VectorLinearInterpolateImageFunction, the field is interpolated
+   * directly from its buffer, and the interpolation position along a
+   * dimension is only recomputed when it changes from one point to the next.
+   * Other interpolators are evaluated point by point. The result is
+   * identical to that of TransformPoint. */
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  SizeValueType          numberOfPoints) const override;
+
   /**  Method to transform a vector. */
   using Superclass::TransformVector;
   OutputVectorType
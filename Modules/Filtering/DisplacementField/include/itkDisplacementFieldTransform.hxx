@@ -97,6 +97,139 @@ DisplacementFieldTransform<TParametersValueType, NDimensions>::TransformPoint(co
   return outputPoint;
 }
 
+template <typename TParametersValueType, unsigned int NDimensions>
+void
+DisplacementFieldTransform<TParametersValueType, NDimensions>::TransformPoints(
+  const InputPointType * inputPoints,
+  OutputPointType *      outputPoints,
+  SizeValueType          numberOfPoints) const
+{
+  if (!this->m_DisplacementField)
+  {
+    itkExceptionMacro("No displacement field is specified.");
+  }
+
+  using LinearInterpolatorType = VectorLinearInterpolateImageFunction<DisplacementFieldType, ScalarType>;
+  const auto * const linearInterpolator =
+    dynamic_cast<const LinearInterpolatorType *>(this->m_Interpolator.GetPointer());
+  if (linearInterpolator == nullptr)
+  {
+    Superclass::TransformPoints(inputPoints, outputPoints, numberOfPoints);
+    return;
+  }
+
+  // Interpolate the field directly from its buffer, the same way as
+  // VectorLinearInterpolateImageFunction::EvaluateAtContinuousIndex does
+  using ContinuousIndexType = typename LinearInterpolatorType::ContinuousIndexType;
+  using InternalComputationType = typename LinearInterpolatorType::InternalComputationType;
+  using InterpolatorOutputType = typename LinearInterpolatorType::OutputType;
+  using ScalarRealType = typename NumericTraits<PixelType>::ScalarRealType;
+
+  const DisplacementFieldType * const field = linearInterpolator->GetInputImage();
+  const PixelType * const             buffer = field->GetBufferPointer();
+  const OffsetValueType * const       offsetTable = field->GetOffsetTable();
+  const IndexType &                   bufferStart = field->GetBufferedRegion().GetIndex();
+  const IndexType &                   startIndex = linearInterpolator->GetStartIndex();
+  const IndexType &                   endIndex = linearInterpolator->GetEndIndex();
+  const ContinuousIndexType &         startContinuousIndex = linearInterpolator->GetStartContinuousIndex();
+  const ContinuousIndexType &         endContinuousIndex = linearInterpolator->GetEndContinuousIndex();
+  const unsigned int                  numberOfNeighbors = 1u << NDimensions;
+
+  // Per dimension: the buffer offsets of the lower and upper neighbors, and the
+  // distance to the lower one, together with the continuous index they were computed for
+  OffsetValueType         lowerOffset[NDimensions];
+  OffsetValueType         upperOffset[NDimensions];
+  InternalComputationType distance[NDimensions];
+  ContinuousIndexType     cachedIndex;
+  bool                    cached[NDimensions];
+  std::fill_n(cached, NDimensions, false);
+
+  for (SizeValueType n = 0; n < numberOfPoints; ++n)
+  {
+    OutputPointType & outputPoint = outputPoints[n];
+    outputPoint.CastFrom(inputPoints[n]);
+
+    typename InterpolatorType::PointType point;
+    point.CastFrom(inputPoints[n]);
+
+    ContinuousIndexType cidx;
+    field->TransformPhysicalPointToContinuousIndex(point, cidx);
+
+    bool isInside = true;
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      if (!(cidx[dim] >= startContinuousIndex[dim] && cidx[dim] < endContinuousIndex[dim]))
+      {
+        isInside = false;
+        break;
+      }
+    }
+    if (!isInside)
+    {
+      continue;
+    }
+
+    for (unsigned int dim = 0; dim < NDimensions; ++dim)
+    {
+      if (cached[dim] && cidx[dim] == cachedIndex[dim])
+      {
+        continue;
+      }
+      const IndexValueType baseIndex = Math::Floor<IndexValueType>(cidx[dim]);
+      distance[dim] = cidx[dim] - static_cast<InternalComputationType>(baseIndex);
+      lowerOffset[dim] = (std::max(baseIndex, startIndex[dim]) - bufferStart[dim]) * offsetTable[dim];
+      upperOffset[dim] = (std::min(baseIndex + 1, endIndex[dim]) - bufferStart[dim]) * offsetTable[dim];
+      cachedIndex[dim] = cidx[dim];
+      cached[dim] = true;
+    }
+
+    InterpolatorOutputType displacement;
+    displacement.Fill(0.0);
+    ScalarRealType totalOverlap = NumericTraits<ScalarRealType>::ZeroValue();
+
+    for (unsigned int counter = 0; counter < numberOfNeighbors; ++counter)
+    {
+      InternalComputationType overlap = 1.0;
+      OffsetValueType         offset = 0;
+      unsigned int            upper = counter; // each bit indicates upper/lower neighbour
+      for (unsigned int dim = 0; dim < NDimensions; ++dim)
+      {
+        if (upper & 1)
+        {
+          offset += upperOffset[dim];
+          overlap *= distance[dim];
+        }
+        else
+        {
+          offset += lowerOffset[dim];
+          overlap *= 1.0 - distance[dim];
+        }
+        upper >>= 1;
+      }
+
+      if (overlap)
+      {
+        const PixelType & input = buffer[offset];
+        for (unsigned int k = 0; k < NDimensions; ++k)
+        {
+          displacement[k] += overlap * static_cast<InternalComputationType>(input[k]);
+        }
+        totalOverlap += overlap;
+      }
+
+      if (totalOverlap == 1.0)
+      {
+        break;
+      }
+    }
+
+    for (unsigned int ii = 0; ii < NDimensions; ++ii)
+    {
+      outputPoint[ii] += displacement[ii];
+    }
+  }
+}
+
 template <typename TParametersValueType, unsigned int NDimensions>
 bool
 DisplacementFieldTransform<TParametersValueType, NDimensions>::GetInverse(Self * inverse) const
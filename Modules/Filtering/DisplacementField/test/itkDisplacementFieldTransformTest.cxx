@@ -26,6 +26,8 @@
 #include "itkTestingMacros.h"
 #include "itkVectorLinearInterpolateImageFunction.h"
 
+#include <vector>
+
 
 template <typename TPoint>
 bool
@@ -410,6 +412,32 @@ itkDisplacementFieldTransformTest(int argc, char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Test batched point transformation against TransformPoint, along rows
+  // that start outside the field and run through and past it
+  {
+    constexpr unsigned int                                  rowLength = 50;
+    std::vector<DisplacementTransformType::InputPointType>  rowPoints(rowLength);
+    std::vector<DisplacementTransformType::OutputPointType> rowOutput(rowLength);
+    for (double y : { -0.5, 0.0, 7.25, 19.0 })
+    {
+      for (unsigned int i = 0; i < rowLength; ++i)
+      {
+        rowPoints[i][0] = -2.0 + 0.5 * i;
+        rowPoints[i][1] = y;
+      }
+      displacementTransform->TransformPoints(rowPoints.data(), rowOutput.data(), rowLength);
+      for (unsigned int i = 0; i < rowLength; ++i)
+      {
+        if (rowOutput[i] != displacementTransform->TransformPoint(rowPoints[i]))
+        {
+          std::cout << "Error transforming point: TransformPoints(...) at " << rowPoints[i] << std::endl;
+          std::cout << "Test failed!" << std::endl;
+          return EXIT_FAILURE;
+        }
+      }
+    }
+  }
+
   DisplacementTransformType::InputVectorType  testVector;
   DisplacementTransformType::OutputVectorType deformVector, deformVectorTruth;
   testVector[0] = 0.5;
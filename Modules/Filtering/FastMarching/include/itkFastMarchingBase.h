@@ -25,6 +25,7 @@
 
 #include <queue>
 #include <functional>
+#include <vector>
 
 namespace itk
 {
@@ -46,6 +47,16 @@ namespace itk
  * Fast Marching sweeps through N points in (N log N) steps to obtain
  * the arrival time value as the front propagates through the domain.
  *
+ * Alternatively, trial nodes can be kept in an untidy priority queue
+ * (UseUntidyQueueOn()): nodes are binned into buckets of width
+ * UntidyQueueBucketWidth and the buckets are processed in increasing order,
+ * first-in first-out within a bucket. This avoids the logarithmic cost of
+ * the heap and keeps the queue in contiguous, reused storage, at the price of
+ * an additional error bounded by the bucket width. See
+ *
+ * L. Yatziv, A. Bartesaghi, G. Sapiro. "O(N) implementation of the fast
+ * marching algorithm", Journal of Computational Physics, 212(2):393-399, 2006.
+ *
  * The initial front is specified by two containers:
  * \li one containing the known nodes (Alive Nodes: nodes that are already
  * part of the object),
@@ -209,6 +220,18 @@ public:
   itkGetConstReferenceMacro(CollectPoints, bool);
   itkBooleanMacro(CollectPoints);
 
+  /** Set/Get whether trial nodes are kept in an untidy (bucketed) priority
+   * queue instead of a binary heap. Off by default. */
+  itkSetMacro(UseUntidyQueue, bool);
+  itkGetConstReferenceMacro(UseUntidyQueue, bool);
+  itkBooleanMacro(UseUntidyQueue);
+
+  /** Set/Get the width of the buckets of the untidy queue, in output value
+   * units. When zero (default), the width returned by
+   * ComputeUntidyQueueBucketWidth() is used. */
+  itkSetMacro(UntidyQueueBucketWidth, double);
+  itkGetConstMacro(UntidyQueueBucketWidth, double);
+
 protected:
   /** \brief Constructor */
   FastMarchingBase();
@@ -241,6 +264,84 @@ protected:
 
   PriorityQueueType m_Heap;
 
+  /** \class UntidyQueue
+   * \brief Bucketed priority queue with contiguous storage.
+   *
+   * Nodes are binned by floor( value / width ) into a window of consecutive
+   * buckets; nodes beyond the window wait in an overflow list until the window
+   * has been processed. Buckets keep their capacity so that steady state
+   * propagation does not allocate.
+   * \ingroup ITKFastMarching */
+  class UntidyQueue
+  {
+  public:
+    void
+    Initialize(double width);
+    void
+    Push(const NodePairType & iNodePair);
+    bool
+    Pop(NodePairType & oNodePair);
+    bool
+    Empty() const
+    {
+      return m_Size == 0;
+    }
+    void
+    Clear();
+
+  private:
+    using BucketType = std::vector<NodePairType>;
+
+    static constexpr SizeValueType NumberOfBuckets = 1024;
+
+    int64_t
+    GetKey(const OutputPixelType & iValue) const;
+    void
+    Rebase();
+
+    std::vector<BucketType> m_Buckets;
+    BucketType              m_Overflow;
+    double                  m_InverseWidth{ 1. };
+    int64_t                 m_FirstKey{ 0 };
+    SizeValueType           m_CurrentBucket{ 0 };
+    SizeValueType           m_Head{ 0 };
+    SizeValueType           m_Size{ 0 };
+    SizeValueType           m_SizeInBuckets{ 0 };
+  };
+
+  bool        m_UseUntidyQueue;
+  double      m_UntidyQueueBucketWidth;
+  UntidyQueue m_UntidyQueue;
+
+  /** \brief Insert a node into the trial queue in use */
+  void
+  PushTrialNode(const NodePairType & iNodePair)
+  {
+    if (m_UseUntidyQueue)
+    {
+      m_UntidyQueue.Push(iNodePair);
+    }
+    else
+    {
+      m_Heap.push(iNodePair);
+    }
+  }
+
+  /** \brief Remove the next node from the trial queue in use
+    \return false if the queue is empty */
+  bool
+  PopTrialNode(NodePairType & oNodePair);
+
+  /** \brief Empty the trial queues and release their memory */
+  void
+  ClearTrialNodes();
+
+  /** \brief Bucket width of the untidy queue when UntidyQueueBucketWidth is
+   * zero. It should not exceed the smallest increment of value between
+   * neighboring nodes. The default implementation throws. */
+  virtual double
+  ComputeUntidyQueueBucketWidth() const;
+
   TopologyCheckType m_TopologyCheck;
 
   /** \brief Get the total number of nodes in the domain */
@@ -23,7 +23,9 @@
 
 #include "itkProgressReporter.h"
 #include "itkMath.h"
-#include "itkMath.h"
+
+#include <algorithm>
+#include <cmath>
 
 namespace itk
 {
@@ -47,6 +49,8 @@ FastMarchingBase<TInput, TOutput>::FastMarchingBase()
   m_LargeValue = NumericTraits<OutputPixelType>::max();
   m_TopologyValue = m_LargeValue;
   m_CollectPoints = false;
+  m_UseUntidyQueue = false;
+  m_UntidyQueueBucketWidth = 0.;
 }
 // -----------------------------------------------------------------------------
 
@@ -59,6 +63,8 @@ FastMarchingBase<TInput, TOutput>::PrintSelf(std::ostream & os, Indent indent) c
   os << indent << "Speed constant: " << m_SpeedConstant << std::endl;
   os << indent << "Topology check: " << m_TopologyCheck << std::endl;
   os << indent << "Normalization Factor: " << m_NormalizationFactor << std::endl;
+  os << indent << "Use untidy queue: " << m_UseUntidyQueue << std::endl;
+  os << indent << "Untidy queue bucket width: " << m_UntidyQueueBucketWidth << std::endl;
 }
 
 // -----------------------------------------------------------------------------
@@ -92,17 +98,19 @@ FastMarchingBase<TInput, TOutput>::Initialize(OutputDomainType * oDomain)
     }
   }
 
-  // make sure the heap is empty
-  while (!m_Heap.empty())
+  // make sure the trial queue is empty
+  this->ClearTrialNodes();
+
+  if (m_UseUntidyQueue)
   {
-    m_Heap.pop();
-  }
-  /*
-  while ( !m_Heap->Empty() )
+    const double width =
+      (m_UntidyQueueBucketWidth != 0.) ? m_UntidyQueueBucketWidth : this->ComputeUntidyQueueBucketWidth();
+    if (!(width > 0.) || !std::isfinite(width))
     {
-    m_Heap->Pop();
+      itkExceptionMacro(<< "Untidy queue bucket width is null, negative or not finite");
     }
-  */
+    m_UntidyQueue.Initialize(width);
+  }
 
   this->InitializeOutput(oDomain);
 
@@ -129,19 +137,10 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
 
   try
   {
-    // while( !m_Heap->Empty() )
-    while (!m_Heap.empty())
-    {
-      // PriorityQueueElementType element = m_Heap->Peek();
-      // m_Heap->Pop();
-      //
-      // NodeType current_node = element.m_Element;
-      // OutputPixelType current_value = element.m_Priority;
-
-
-      NodePairType current_node_pair = m_Heap.top();
-      m_Heap.pop();
+    NodePairType current_node_pair;
 
+    while (this->PopTrialNode(current_node_pair))
+    {
       NodeType current_node = current_node_pair.GetNode();
       current_value = this->GetOutputValue(output, current_node);
 
@@ -183,14 +182,7 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
     // it.
     //
     // RELEASE MEMORY!!!
-    while (!m_Heap.empty())
-    {
-      m_Heap.pop();
-    }
-    /*while( !m_Heap->Empty() )
-      {
-      m_Heap->Pop();
-      }*/
+    this->ClearTrialNodes();
 
     throw ProcessAborted(__FILE__, __LINE__);
   }
@@ -198,14 +190,193 @@ FastMarchingBase<TInput, TOutput>::GenerateData()
   m_TargetReachedValue = current_value;
 
   // let's release some useless memory...
-  while (!m_Heap.empty())
+  this->ClearTrialNodes();
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+bool
+FastMarchingBase<TInput, TOutput>::PopTrialNode(NodePairType & oNodePair)
+{
+  if (m_UseUntidyQueue)
+  {
+    return m_UntidyQueue.Pop(oNodePair);
+  }
+  if (m_Heap.empty())
+  {
+    return false;
+  }
+  oNodePair = m_Heap.top();
+  m_Heap.pop();
+  return true;
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::ClearTrialNodes()
+{
+  m_Heap = PriorityQueueType();
+  m_UntidyQueue = UntidyQueue();
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+double
+FastMarchingBase<TInput, TOutput>::ComputeUntidyQueueBucketWidth() const
+{
+  itkExceptionMacro(<< "UntidyQueueBucketWidth must be set to use the untidy queue");
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::UntidyQueue::Initialize(double width)
+{
+  m_InverseWidth = 1. / width;
+  m_Buckets.resize(SizeValueType{ NumberOfBuckets });
+  this->Clear();
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::UntidyQueue::Clear()
+{
+  for (auto & bucket : m_Buckets)
   {
-    m_Heap.pop();
+    bucket.clear();
   }
-  /*while( !m_Heap->Empty() )
+  m_Overflow.clear();
+  m_FirstKey = 0;
+  m_CurrentBucket = 0;
+  m_Head = 0;
+  m_Size = 0;
+  m_SizeInBuckets = 0;
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+int64_t
+FastMarchingBase<TInput, TOutput>::UntidyQueue::GetKey(const OutputPixelType & iValue) const
+{
+  // Clamp so that very large values (e.g. unreachable nodes) do not overflow
+  constexpr double maxKey = 4611686018427387904.; // 2^62
+  const double     key = std::floor(static_cast<double>(iValue) * m_InverseWidth);
+  if (key >= maxKey)
+  {
+    return static_cast<int64_t>(maxKey);
+  }
+  if (key <= -maxKey)
+  {
+    return -static_cast<int64_t>(maxKey);
+  }
+  return static_cast<int64_t>(key);
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::UntidyQueue::Push(const NodePairType & iNodePair)
+{
+  const int64_t key = this->GetKey(iNodePair.GetValue());
+
+  if (m_Size == 0)
+  {
+    // restart the window at the new node
+    m_Buckets[m_CurrentBucket].clear();
+    m_Head = 0;
+    m_FirstKey = key;
+    m_CurrentBucket = 0;
+  }
+
+  // a node whose bucket has already been processed goes to the current one
+  const auto bucket = static_cast<SizeValueType>(std::max(key - m_FirstKey, static_cast<int64_t>(m_CurrentBucket)));
+  if (bucket < NumberOfBuckets)
+  {
+    m_Buckets[bucket].push_back(iNodePair);
+    ++m_SizeInBuckets;
+  }
+  else
+  {
+    m_Overflow.push_back(iNodePair);
+  }
+  ++m_Size;
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+bool
+FastMarchingBase<TInput, TOutput>::UntidyQueue::Pop(NodePairType & oNodePair)
+{
+  if (m_Size == 0)
+  {
+    return false;
+  }
+
+  while (true)
+  {
+    BucketType & bucket = m_Buckets[m_CurrentBucket];
+    if (m_Head < bucket.size())
+    {
+      oNodePair = bucket[m_Head++];
+      --m_SizeInBuckets;
+      --m_Size;
+      return true;
+    }
+
+    // the current bucket is exhausted, keep its capacity and move on
+    bucket.clear();
+    m_Head = 0;
+    if (m_SizeInBuckets == 0)
+    {
+      this->Rebase();
+    }
+    else
+    {
+      ++m_CurrentBucket;
+    }
+  }
+}
+// -----------------------------------------------------------------------------
+
+// -----------------------------------------------------------------------------
+template <typename TInput, typename TOutput>
+void
+FastMarchingBase<TInput, TOutput>::UntidyQueue::Rebase()
+{
+  // The window has been processed: move it to the lowest overflowing node and
+  // bring in every overflowing node which now fits.
+  m_FirstKey = this->GetKey(m_Overflow.front().GetValue());
+  for (const auto & nodePair : m_Overflow)
+  {
+    m_FirstKey = std::min(m_FirstKey, this->GetKey(nodePair.GetValue()));
+  }
+  m_CurrentBucket = 0;
+
+  SizeValueType kept = 0;
+  for (const auto & nodePair : m_Overflow)
+  {
+    const auto bucket = static_cast<SizeValueType>(this->GetKey(nodePair.GetValue()) - m_FirstKey);
+    if (bucket < NumberOfBuckets)
+    {
+      m_Buckets[bucket].push_back(nodePair);
+      ++m_SizeInBuckets;
+    }
+    else
     {
-    m_Heap->Pop();
-    }*/
+      m_Overflow[kept++] = nodePair;
+    }
+  }
+  m_Overflow.resize(kept);
 }
 // -----------------------------------------------------------------------------
 
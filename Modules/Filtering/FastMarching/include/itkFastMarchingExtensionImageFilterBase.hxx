@@ -111,6 +111,11 @@ void
 FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>::InitializeOutput(
   OutputImageType * oImage)
 {
+  if (this->m_UseFastSweeping)
+  {
+    itkExceptionMacro(<< "Auxiliary values are not extended by the fast sweeping solver");
+  }
+
   this->Superclass::InitializeOutput(oImage);
 
   if (!m_AuxiliaryAliveValues)
@@ -230,7 +235,7 @@ FastMarchingExtensionImageFilterBase<TInput, TOutput, TAuxValue, VAuxDimension>:
     // node.SetValue( outputPixel );
     // node.SetIndex( index );
     // m_TrialHeap.push(node);
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->PushTrialNode(NodePairType(iNode, outputPixel));
 
     // update auxiliary values
     for (unsigned int k = 0; k < AuxDimension; k++)
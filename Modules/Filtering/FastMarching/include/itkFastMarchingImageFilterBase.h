@@ -61,6 +61,23 @@ namespace itk
  * "Level Set Methods and Fast Marching Methods", J.A. Sethian,
  * Cambridge Press, Second edition, 1999.
  *
+ * Besides the heap and untidy queues inherited from FastMarchingBase, the
+ * same upwind discretization can be solved with the Fast Sweeping Method
+ * (UseFastSweepingOn()): Gauss-Seidel sweeps in the 2^N axis-aligned
+ * orderings are repeated until no value decreases by more than
+ * SweepingTolerance. The sweep orderings are distributed over up to 2^N work
+ * units, each updating its own copy of the arrival times, and the copies are
+ * merged with a minimum after each round. This converges in a few rounds when
+ * the speed is smooth; the whole buffered region is solved, so the stopping
+ * criterion is not consulted, and neither topology checks nor CollectPoints
+ * are supported. See
+ *
+ * H. Zhao. "A fast sweeping method for Eikonal equations", Mathematics of
+ * Computation, 74(250):603-627, 2005.
+ *
+ * H. Zhao. "Parallel implementations of the fast sweeping method", Journal
+ * of Computational Mathematics, 25(4):421-429, 2007.
+ *
  * For an alternative implementation, see itk::FastMarchingImageFilter.
  *
  * \tparam TTraits traits
@@ -159,6 +176,22 @@ public:
   itkGetConstReferenceMacro(OverrideOutputInformation, bool);
   itkBooleanMacro(OverrideOutputInformation);
 
+  /** Set/Get whether the Fast Sweeping Method is used instead of a
+   * priority queue. Off by default. */
+  itkSetMacro(UseFastSweeping, bool);
+  itkGetConstReferenceMacro(UseFastSweeping, bool);
+  itkBooleanMacro(UseFastSweeping);
+
+  /** Set/Get the maximum number of sweeping rounds. Defaults to 100. */
+  itkSetMacro(MaximumNumberOfSweepIterations, unsigned int);
+  itkGetConstMacro(MaximumNumberOfSweepIterations, unsigned int);
+
+  /** Set/Get the largest decrease of a value during a sweeping round below
+   * which the sweeps are considered converged. Defaults to 0, i.e. sweep until
+   * no value changes. */
+  itkSetMacro(SweepingTolerance, double);
+  itkGetConstMacro(SweepingTolerance, double);
+
 protected:
   FastMarchingImageFilterBase();
 
@@ -177,10 +210,17 @@ protected:
   OutputDirectionType m_OutputDirection;
   bool                m_OverrideOutputInformation{ false };
 
+  bool         m_UseFastSweeping{ false };
+  unsigned int m_MaximumNumberOfSweepIterations{ 100 };
+  double       m_SweepingTolerance{ 0. };
+
   /** Generate the output image meta information. */
   void
   GenerateOutputInformation() override;
 
+  void
+  GenerateData() override;
+
   void
   EnlargeOutputRequestedRegion(DataObject * output) override;
 
@@ -219,6 +259,11 @@ protected:
   void
   InitializeOutput(OutputImageType * oImage) override;
 
+  /** A tenth of the smallest spacing over the largest speed, divided by
+   * sqrt(ImageDimension) */
+  double
+  ComputeUntidyQueueBucketWidth() const override;
+
   /** Find the nodes were the front will propagate given a node */
   void
   GetInternalNodesUsed(OutputImageType * oImage, const NodeType & iNode, InternalNodeStructureArray & ioNodesUsed);
@@ -270,6 +315,15 @@ protected:
   const InputImageType * m_InputCache;
 
 private:
+  /** Solve the whole buffered region with the Fast Sweeping Method */
+  void
+  GenerateDataFastSweeping(OutputImageType * oImage);
+
+  /** Run one Gauss-Seidel sweep over ioBuffer in the ordering given by the
+   * bits of iDirection (bit j set: decreasing indices along axis j).
+   * \return the largest decrease of a value */
+  double
+  Sweep(OutputPixelType * ioBuffer, unsigned int iDirection) const;
 };
 } // end namespace itk
 
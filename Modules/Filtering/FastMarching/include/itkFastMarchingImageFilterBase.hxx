@@ -24,6 +24,12 @@
 #include "itkImageRegionIterator.h"
 #include "itkConnectedComponentImageFilter.h"
 #include "itkRelabelComponentImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkProgressReporter.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
 
 namespace itk
 {
@@ -107,6 +113,307 @@ FastMarchingImageFilterBase<TInput, TOutput>::EnlargeOutputRequestedRegion(DataO
   }
 }
 
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::GenerateData()
+{
+  if (!m_UseFastSweeping)
+  {
+    Superclass::GenerateData();
+    return;
+  }
+
+  if (this->m_TopologyCheck != Superclass::Nothing)
+  {
+    itkExceptionMacro(<< "Topology checks are not supported by the fast sweeping solver");
+  }
+  if (this->m_CollectPoints)
+  {
+    itkExceptionMacro(<< "CollectPoints is not supported by the fast sweeping solver");
+  }
+
+  OutputImageType * output = this->GetOutput();
+
+  this->Initialize(output);
+
+  // Fixed nodes are known from the label image, the trial queue is not used
+  this->ClearTrialNodes();
+
+  this->GenerateDataFastSweeping(output);
+}
+
+template <typename TInput, typename TOutput>
+void
+FastMarchingImageFilterBase<TInput, TOutput>::GenerateDataFastSweeping(OutputImageType * oImage)
+{
+  const SizeValueType numberOfNodes = m_BufferedRegion.GetNumberOfPixels();
+  OutputPixelType *   outputBuffer = oImage->GetBufferPointer();
+  unsigned char *     labelBuffer = m_LabelImage->GetBufferPointer();
+
+  // Forbidden nodes must not be used as neighbors while sweeping
+  for (SizeValueType i = 0; i < numberOfNodes; ++i)
+  {
+    if (labelBuffer[i] == Traits::Forbidden)
+    {
+      outputBuffer[i] = this->m_LargeValue;
+    }
+  }
+
+  // Each work unit sweeps its own copy of the arrival times, the output
+  // buffer being the first one
+  constexpr unsigned int numberOfDirections = 1u << ImageDimension;
+  const unsigned int     numberOfCopies = std::max(1u, std::min(numberOfDirections, this->GetNumberOfWorkUnits()));
+
+  std::vector<std::vector<OutputPixelType>> copies(
+    numberOfCopies - 1, std::vector<OutputPixelType>(outputBuffer, outputBuffer + numberOfNodes));
+  std::vector<OutputPixelType *>            buffers(1, outputBuffer);
+  for (auto & copy : copies)
+  {
+    buffers.push_back(copy.data());
+  }
+  std::vector<double> changes(numberOfCopies);
+
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+
+  ProgressReporter progress(this, 0, m_MaximumNumberOfSweepIterations);
+
+  for (unsigned int iteration = 0; iteration < m_MaximumNumberOfSweepIterations; ++iteration)
+  {
+    multiThreader->SetNumberOfWorkUnits(numberOfCopies);
+    multiThreader->ParallelizeArray(0,
+                                    numberOfCopies,
+                                    [&](SizeValueType copy) {
+                                      double change = 0.;
+                                      for (unsigned int d = copy; d < numberOfDirections; d += numberOfCopies)
+                                      {
+                                        change = std::max(change, this->Sweep(buffers[copy], d));
+                                      }
+                                      changes[copy] = change;
+                                    },
+                                    nullptr);
+
+    if (numberOfCopies > 1)
+    {
+      // Merge the copies: every copy restarts from the smallest value
+      constexpr SizeValueType blockSize = 1 << 16;
+      multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+      multiThreader->ParallelizeArray(0,
+                                      (numberOfNodes + blockSize - 1) / blockSize,
+                                      [&](SizeValueType block) {
+                                        const SizeValueType first = block * blockSize;
+                                        const SizeValueType last = std::min(first + blockSize, numberOfNodes);
+                                        for (SizeValueType i = first; i < last; ++i)
+                                        {
+                                          OutputPixelType value = buffers[0][i];
+                                          for (unsigned int c = 1; c < numberOfCopies; ++c)
+                                          {
+                                            value = std::min(value, buffers[c][i]);
+                                          }
+                                          for (unsigned int c = 0; c < numberOfCopies; ++c)
+                                          {
+                                            buffers[c][i] = value;
+                                          }
+                                        }
+                                      },
+                                      nullptr);
+    }
+
+    progress.CompletedPixel();
+
+    if (*std::max_element(changes.begin(), changes.end()) <= m_SweepingTolerance)
+    {
+      break;
+    }
+  }
+
+  // Restore forbidden nodes, mark solved nodes as alive
+  OutputPixelType targetReachedValue = NumericTraits<OutputPixelType>::ZeroValue();
+  for (SizeValueType i = 0; i < numberOfNodes; ++i)
+  {
+    if (labelBuffer[i] == Traits::Forbidden)
+    {
+      outputBuffer[i] = NumericTraits<OutputPixelType>::ZeroValue();
+    }
+    else if (outputBuffer[i] < this->m_LargeValue)
+    {
+      labelBuffer[i] = Traits::Alive;
+      targetReachedValue = std::max(targetReachedValue, outputBuffer[i]);
+    }
+  }
+  this->m_TargetReachedValue = targetReachedValue;
+}
+
+template <typename TInput, typename TOutput>
+double
+FastMarchingImageFilterBase<TInput, TOutput>::Sweep(OutputPixelType * ioBuffer, unsigned int iDirection) const
+{
+  const OutputSizeType & size = m_BufferedRegion.GetSize();
+  const unsigned char *  labelBuffer = m_LabelImage->GetBufferPointer();
+  const double           largeValue = static_cast<double>(this->m_LargeValue);
+
+  OffsetValueType strides[ImageDimension];
+  double          spaceFactors[ImageDimension];
+  strides[0] = 1;
+  for (unsigned int j = 0; j < ImageDimension; ++j)
+  {
+    if (j > 0)
+    {
+      strides[j] = strides[j - 1] * static_cast<OffsetValueType>(size[j - 1]);
+    }
+    // spaceFactor = \frac{1}{spacing[axis]^2}
+    spaceFactors[j] = itk::Math::sqr(1.0 / m_OutputSpacing[j]);
+  }
+
+  const SizeValueType lineLength = size[0];
+  const SizeValueType numberOfLines = m_BufferedRegion.GetNumberOfPixels() / lineLength;
+  const bool          reverseLine = (iDirection & 1u) != 0;
+
+  double maxChange = 0.;
+
+  bool     hasPrevious[ImageDimension];
+  bool     hasNext[ImageDimension];
+  NodeType lineIndex = m_StartIndex;
+
+  // (smallest neighbor value, space factor) for each axis
+  std::pair<double, double> neighbors[ImageDimension];
+
+  for (SizeValueType line = 0; line < numberOfLines; ++line)
+  {
+    // Position of the line along the other axes, in the sweep ordering
+    SizeValueType   remainder = line;
+    OffsetValueType lineOffset = 0;
+    for (unsigned int j = 1; j < ImageDimension; ++j)
+    {
+      SizeValueType position = remainder % size[j];
+      remainder /= size[j];
+      if (iDirection & (1u << j))
+      {
+        position = size[j] - 1 - position;
+      }
+      lineOffset += static_cast<OffsetValueType>(position) * strides[j];
+      hasPrevious[j] = position > 0;
+      hasNext[j] = position + 1 < size[j];
+      lineIndex[j] = m_StartIndex[j] + static_cast<IndexValueType>(position);
+    }
+
+    const InputPixelType * speedLine = m_InputCache ? &m_InputCache->GetPixel(lineIndex) : nullptr;
+
+    for (SizeValueType k = 0; k < lineLength; ++k)
+    {
+      const SizeValueType   i = reverseLine ? lineLength - 1 - k : k;
+      const OffsetValueType offset = lineOffset + static_cast<OffsetValueType>(i);
+
+      if (labelBuffer[offset] != Traits::Far)
+      {
+        continue;
+      }
+
+      hasPrevious[0] = i > 0;
+      hasNext[0] = i + 1 < lineLength;
+
+      unsigned int numberOfNeighbors = 0;
+      for (unsigned int j = 0; j < ImageDimension; ++j)
+      {
+        double value = largeValue;
+        if (hasPrevious[j])
+        {
+          value = std::min(value, static_cast<double>(ioBuffer[offset - strides[j]]));
+        }
+        if (hasNext[j])
+        {
+          value = std::min(value, static_cast<double>(ioBuffer[offset + strides[j]]));
+        }
+        if (value < largeValue)
+        {
+          // insertion sort by increasing value
+          unsigned int n = numberOfNeighbors++;
+          for (; n > 0 && neighbors[n - 1].first > value; --n)
+          {
+            neighbors[n] = neighbors[n - 1];
+          }
+          neighbors[n] = std::make_pair(value, spaceFactors[j]);
+        }
+      }
+
+      if (numberOfNeighbors == 0)
+      {
+        continue;
+      }
+
+      // Same quadratic solver as Solve()
+      double cc(this->m_InverseSpeed);
+      if (speedLine)
+      {
+        cc = static_cast<double>(speedLine[i]) / this->m_NormalizationFactor;
+        if (itk::Math::FloatAlmostEqual<double>(cc, 0.0))
+        {
+          cc = -1.0 * itk::Math::sqr(1.0 / (cc + itk::Math::eps));
+        }
+        else
+        {
+          cc = -1.0 * itk::Math::sqr(1.0 / cc);
+        }
+      }
+
+      double aa(0.0);
+      double bb(0.0);
+      double solution = NumericTraits<double>::max();
+
+      for (unsigned int n = 0; n < numberOfNeighbors && solution >= neighbors[n].first; ++n)
+      {
+        const double value = neighbors[n].first;
+        const double spaceFactor = neighbors[n].second;
+
+        aa += spaceFactor;
+        bb += value * spaceFactor;
+        cc += itk::Math::sqr(value) * spaceFactor;
+
+        const double discrim = itk::Math::sqr(bb) - aa * cc;
+        if (discrim < 0.)
+        {
+          break;
+        }
+        solution = (std::sqrt(discrim) + bb) / aa;
+      }
+
+      const auto newValue = static_cast<OutputPixelType>(solution);
+      if (newValue < ioBuffer[offset])
+      {
+        maxChange = std::max(maxChange, static_cast<double>(ioBuffer[offset]) - static_cast<double>(newValue));
+        ioBuffer[offset] = newValue;
+      }
+    }
+  }
+
+  return maxChange;
+}
+
+template <typename TInput, typename TOutput>
+double
+FastMarchingImageFilterBase<TInput, TOutput>::ComputeUntidyQueueBucketWidth() const
+{
+  const OutputSpacingType & spacing = this->GetOutput()->GetSpacing();
+  const double minimumSpacing = *std::min_element(spacing.Begin(), spacing.End());
+
+  double maximumSpeed = 1.0 / std::sqrt(-this->m_InverseSpeed);
+
+  const InputImageType * input = this->GetInput();
+  if (input)
+  {
+    maximumSpeed = 0.0;
+    for (ImageRegionConstIterator<InputImageType> it(input, input->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+    {
+      maximumSpeed = std::max(maximumSpeed, static_cast<double>(it.Get()));
+    }
+    maximumSpeed /= this->m_NormalizationFactor;
+  }
+
+  // A tenth of the smallest increment between neighboring nodes, reached by a
+  // front moving diagonally at the largest speed: the ordering error then stays
+  // well below the discretization error
+  return 0.1 * minimumSpacing / (maximumSpeed * std::sqrt(static_cast<double>(ImageDimension)));
+}
+
 template <typename TInput, typename TOutput>
 IdentifierType
 FastMarchingImageFilterBase<TInput, TOutput>::GetTotalNumberOfNodes() const
@@ -199,7 +506,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::UpdateValue(OutputImageType * oIma
     this->SetLabelValueForGivenNode(iNode, Traits::Trial);
 
     // Insert point into trial heap
-    this->m_Heap.push(NodePairType(iNode, outputPixel));
+    this->PushTrialNode(NodePairType(iNode, outputPixel));
   }
 }
 
@@ -564,7 +871,7 @@ FastMarchingImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType *
         this->SetOutputValue(oImage, idx, outputPixel);
 
         // this->m_Heap->Push( PriorityQueueElementType( idx, pointsIter->second ) );
-        this->m_Heap.push(pointsIter->Value());
+        this->PushTrialNode(pointsIter->Value());
       }
       ++pointsIter;
     }
@@ -1025,6 +1332,9 @@ FastMarchingImageFilterBase<TInput, TOutput>::PrintSelf(std::ostream & os, Inden
   os << indent << "OutputDirection: " << m_OutputDirection << std::endl;
 
   os << indent << "OverrideOutputInformation: " << m_OverrideOutputInformation << std::endl;
+  os << indent << "UseFastSweeping: " << m_UseFastSweeping << std::endl;
+  os << indent << "MaximumNumberOfSweepIterations: " << m_MaximumNumberOfSweepIterations << std::endl;
+  os << indent << "SweepingTolerance: " << m_SweepingTolerance << std::endl;
 
   itkPrintSelfObjectMacro(LabelImage);
 
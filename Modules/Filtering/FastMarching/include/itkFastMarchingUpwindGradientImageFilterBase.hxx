@@ -60,6 +60,11 @@ template <typename TInput, typename TOutput>
 void
 FastMarchingUpwindGradientImageFilterBase<TInput, TOutput>::InitializeOutput(OutputImageType * output)
 {
+  if (this->m_UseFastSweeping)
+  {
+    itkExceptionMacro(<< "The upwind gradient is not computed by the fast sweeping solver");
+  }
+
   Superclass::InitializeOutput(output);
 
   // allocate memory for the GradientImage if requested
@@ -0,0 +1,195 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkFastMarchingImageFilterBase.h"
+#include "itkFastMarchingThresholdStoppingCriterion.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Compare the untidy queue and the fast sweeping solvers with the heap based
+ * fast marching on a 3D image with anisotropic spacing, a smoothly varying
+ * speed, trial nodes and forbidden nodes.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using PixelType = float;
+using ImageType = itk::Image<PixelType, Dimension>;
+using FastMarchingType = itk::FastMarchingImageFilterBase<ImageType, ImageType>;
+
+FastMarchingType::Pointer
+CreateFastMarching(const ImageType * speed)
+{
+  using CriterionType = itk::FastMarchingThresholdStoppingCriterion<ImageType, ImageType>;
+  CriterionType::Pointer criterion = CriterionType::New();
+  criterion->SetThreshold(1.e6);
+
+  using NodePairType = FastMarchingType::NodePairType;
+  using NodePairContainerType = FastMarchingType::NodePairContainerType;
+
+  ImageType::IndexType index;
+
+  NodePairContainerType::Pointer trial = NodePairContainerType::New();
+  index[0] = 30;
+  index[1] = 8;
+  index[2] = 25;
+  trial->push_back(NodePairType(index, 0.));
+  index[0] = 8;
+  index[1] = 20;
+  index[2] = 6;
+  trial->push_back(NodePairType(index, 0.5));
+
+  // A wall the front has to go around, and the image boundary: the heap based
+  // solver does not update the neighbors of boundary nodes along the normal
+  // axis, which makes it less accurate there.
+  NodePairContainerType::Pointer forbidden = NodePairContainerType::New();
+  const ImageType::RegionType &  region = speed->GetBufferedRegion();
+  for (itk::ImageRegionConstIteratorWithIndex<ImageType> it(speed, region); !it.IsAtEnd(); ++it)
+  {
+    index = it.GetIndex();
+    bool isForbidden = index[0] >= 18 && index[0] < 22 && index[1] >= 2 && index[2] < 28;
+    for (unsigned int j = 0; j < Dimension; ++j)
+    {
+      isForbidden = isForbidden || index[j] == region.GetIndex(j) || index[j] == region.GetUpperIndex()[j];
+    }
+    if (isForbidden)
+    {
+      forbidden->push_back(NodePairType(index, 0.));
+    }
+  }
+
+  FastMarchingType::Pointer fastMarching = FastMarchingType::New();
+  fastMarching->SetInput(speed);
+  fastMarching->SetStoppingCriterion(criterion);
+  fastMarching->SetTrialPoints(trial);
+  fastMarching->SetForbiddenPoints(forbidden);
+  return fastMarching;
+}
+
+double
+MaximumDifference(const ImageType * image1, const ImageType * image2)
+{
+  double                                            maximumDifference = 0.;
+  itk::ImageRegionConstIterator<ImageType>          it1(image1, image1->GetBufferedRegion());
+  itk::ImageRegionConstIteratorWithIndex<ImageType> it2(image2, image2->GetBufferedRegion());
+  for (; !it1.IsAtEnd(); ++it1, ++it2)
+  {
+    const double value1 = it1.Get();
+    const double value2 = it2.Get();
+    if ((value1 >= 1.e30) != (value2 >= 1.e30))
+    {
+      std::cerr << "Reached nodes differ at " << it2.GetIndex() << ": " << value1 << " vs " << value2 << std::endl;
+      return itk::NumericTraits<double>::max();
+    }
+    if (value1 < 1.e30)
+    {
+      maximumDifference = std::max(maximumDifference, std::abs(value1 - value2));
+    }
+  }
+  return maximumDifference;
+}
+} // namespace
+
+int
+itkFastMarchingImageFilterSolversTest(int, char *[])
+{
+  ImageType::SizeType size;
+  size[0] = 41;
+  size[1] = 37;
+  size[2] = 33;
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  start[2] = 0;
+  ImageType::SpacingType spacing;
+  spacing[0] = 1.;
+  spacing[1] = 1.25;
+  spacing[2] = 0.8;
+
+  ImageType::Pointer speed = ImageType::New();
+  speed->SetRegions(ImageType::RegionType(start, size));
+  speed->SetSpacing(spacing);
+  speed->Allocate();
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(speed, speed->GetBufferedRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & idx = it.GetIndex();
+    it.Set(static_cast<PixelType>(1. + 0.5 * std::sin(0.15 * idx[0]) * std::cos(0.1 * idx[1] + 0.05 * idx[2])));
+  }
+
+  // Reference: heap based fast marching
+  FastMarchingType::Pointer heap = CreateFastMarching(speed);
+  ITK_TRY_EXPECT_NO_EXCEPTION(heap->Update());
+  const double maximumValue = heap->GetTargetReachedValue();
+  std::cout << "Heap: largest arrival time " << maximumValue << std::endl;
+
+  // Untidy queue
+  FastMarchingType::Pointer untidy = CreateFastMarching(speed);
+  ITK_TEST_SET_GET_BOOLEAN(untidy, UseUntidyQueue, true);
+  ITK_TEST_SET_GET_VALUE(0., untidy->GetUntidyQueueBucketWidth());
+  ITK_TRY_EXPECT_NO_EXCEPTION(untidy->Update());
+  double difference = MaximumDifference(heap->GetOutput(), untidy->GetOutput());
+  std::cout << "Untidy queue: maximum difference " << difference << std::endl;
+  ITK_TEST_EXPECT_TRUE(difference < 1.e-3 * maximumValue);
+
+  // Narrow buckets process the nodes in nearly the same order as the heap
+  untidy->SetUntidyQueueBucketWidth(1.e-4);
+  ITK_TEST_SET_GET_VALUE(1.e-4, untidy->GetUntidyQueueBucketWidth());
+  ITK_TRY_EXPECT_NO_EXCEPTION(untidy->Update());
+  difference = MaximumDifference(heap->GetOutput(), untidy->GetOutput());
+  std::cout << "Untidy queue with width 1e-4: maximum difference " << difference << std::endl;
+  ITK_TEST_EXPECT_TRUE(difference < 1.e-3 * maximumValue);
+
+  // Coarse buckets degrade the solution but still reach every node
+  untidy->SetUntidyQueueBucketWidth(2.);
+  ITK_TRY_EXPECT_NO_EXCEPTION(untidy->Update());
+  difference = MaximumDifference(heap->GetOutput(), untidy->GetOutput());
+  std::cout << "Untidy queue with width 2: maximum difference " << difference << std::endl;
+  ITK_TEST_EXPECT_TRUE(difference < 0.25 * maximumValue);
+
+  untidy->SetUntidyQueueBucketWidth(-1.);
+  ITK_TRY_EXPECT_EXCEPTION(untidy->Update());
+
+  // Fast sweeping, for several numbers of sweeping copies
+  const unsigned int numbersOfWorkUnits[] = { 1, 2, 3, 8, 11 };
+  for (unsigned int numberOfWorkUnits : numbersOfWorkUnits)
+  {
+    FastMarchingType::Pointer sweeping = CreateFastMarching(speed);
+    ITK_TEST_SET_GET_BOOLEAN(sweeping, UseFastSweeping, true);
+    ITK_TEST_SET_GET_VALUE(100u, sweeping->GetMaximumNumberOfSweepIterations());
+    ITK_TEST_SET_GET_VALUE(0., sweeping->GetSweepingTolerance());
+    sweeping->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(sweeping->Update());
+    difference = MaximumDifference(heap->GetOutput(), sweeping->GetOutput());
+    std::cout << "Fast sweeping with " << numberOfWorkUnits << " work units: maximum difference " << difference
+              << std::endl;
+    ITK_TEST_EXPECT_TRUE(difference < 1.e-5 * maximumValue);
+    ITK_TEST_EXPECT_TRUE(std::abs(sweeping->GetTargetReachedValue() - maximumValue) < 1.e-5 * maximumValue);
+  }
+
+  // Unsupported options
+  FastMarchingType::Pointer sweeping = CreateFastMarching(speed);
+  sweeping->UseFastSweepingOn();
+  sweeping->SetTopologyCheck(FastMarchingType::Strict);
+  ITK_TRY_EXPECT_EXCEPTION(sweeping->Update());
+  sweeping->SetTopologyCheck(FastMarchingType::Nothing);
+  sweeping->CollectPointsOn();
+  ITK_TRY_EXPECT_EXCEPTION(sweeping->Update());
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,146 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkFunctorChain_h
+#define itkFunctorChain_h
+
+#include <type_traits>
+#include <utility>
+
+namespace itk
+{
+namespace Functor
+{
+/** \class Chain
+ * \brief Composes pixel-wise functors into one, applied one after the other.
+ *
+ * Chain<F1, F2, ..., Fn> calls F1 with the pixel values of the inputs,
+ * F2 with the result of F1, and so on; its result is the result of Fn.
+ * The composition happens at compile time, so the compiler can inline all
+ * the stages into a single expression per pixel.
+ *
+ * Passed to UnaryGeneratorImageFilter, BinaryGeneratorImageFilter or,
+ * when all stages are default constructible, TernaryFunctorImageFilter, a
+ * chain replaces a pipeline of pixel-wise filters with one filter, which
+ * runs a single pass over the images and allocates no intermediate image.
+ * For example, SubtractImageFilter, MultiplyImageFilter with a constant,
+ * ClampImageFilter and CastImageFilter become:
+ *
+   \code
+   Functor::Clamp<float, float> clamp;
+   clamp.SetBounds(0.0f, 255.0f);
+   auto filter = BinaryGeneratorImageFilter<FloatImageType, FloatImageType, UCharImageType>::New();
+   filter->SetInput1(image1);
+   filter->SetInput2(image2);
+   filter->SetFunctor(Functor::MakeChain(Functor::Sub2<float, float, float>(),
+                                         [](float v) { return 2.0f * v; },
+                                         clamp,
+                                         [](float v) { return static_cast<unsigned char>(v); }));
+   \endcode
+ *
+ * Intermediate values keep the result types of the stages, exactly as if
+ * the stages wrote them to images of these pixel types.
+ *
+ * \sa MakeChain
+ * \ingroup ITKImageFilterBase
+ */
+template <typename... TStages>
+class Chain;
+
+template <typename TStage>
+class Chain<TStage>
+{
+public:
+  Chain() = default;
+  explicit Chain(const TStage & stage)
+    : m_Stage(stage)
+  {}
+
+  template <typename... TArguments>
+  auto
+  operator()(const TArguments &... arguments) const -> decltype(std::declval<const TStage &>()(arguments...))
+  {
+    return m_Stage(arguments...);
+  }
+
+  bool
+  operator==(const Chain & other) const
+  {
+    return m_Stage == other.m_Stage;
+  }
+
+  bool
+  operator!=(const Chain & other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  TStage m_Stage;
+};
+
+template <typename TStage, typename... TNextStages>
+class Chain<TStage, TNextStages...>
+{
+public:
+  using NextChainType = Chain<TNextStages...>;
+
+  Chain() = default;
+  explicit Chain(const TStage & stage, const TNextStages &... nextStages)
+    : m_Stage(stage)
+    , m_NextStages(nextStages...)
+  {}
+
+  template <typename... TArguments>
+  auto
+  operator()(const TArguments &... arguments) const
+    -> decltype(std::declval<const NextChainType &>()(std::declval<const TStage &>()(arguments...)))
+  {
+    return m_NextStages(m_Stage(arguments...));
+  }
+
+  bool
+  operator==(const Chain & other) const
+  {
+    return m_Stage == other.m_Stage && m_NextStages == other.m_NextStages;
+  }
+
+  bool
+  operator!=(const Chain & other) const
+  {
+    return !(*this == other);
+  }
+
+private:
+  TStage        m_Stage;
+  NextChainType m_NextStages;
+};
+
+/** Creates a Chain from its stages, deducing their types, which allows
+ * lambdas and functions as stages.
+ * \sa Chain
+ * \ingroup ITKImageFilterBase */
+template <typename... TStages>
+Chain<typename std::decay<TStages>::type...>
+MakeChain(const TStages &... stages)
+{
+  return Chain<typename std::decay<TStages>::type...>(stages...);
+}
+} // end namespace Functor
+} // end namespace itk
+
+#endif
@@ -18,8 +18,15 @@
 
 #include "itkUnaryGeneratorImageFilter.h"
 #include "itkBinaryGeneratorImageFilter.h"
+#include "itkTernaryFunctorImageFilter.h"
+#include "itkFunctorChain.h"
+#include "itkArithmeticOpsFunctors.h"
+#include "itkCastImageFilter.h"
+#include "itkClampImageFilter.h"
 #include "itkImage.h"
 #include "itkImageRegionIterator.h"
+#include "itkMultiplyImageFilter.h"
+#include "itkSubtractImageFilter.h"
 
 #include "itkGTest.h"
 
@@ -263,3 +270,97 @@ TEST(BinaryGeneratorImageFilter, SetFunctor)
 
   EXPECT_NEAR(2.0, outputImage->GetPixel(idx), 1e-8);
 }
+
+
+TEST(FunctorChain, BinaryGeneratorMatchesFilterPipeline)
+{
+  using FloatImageType = itk::Image<float, 2>;
+  using UCharImageType = itk::Image<unsigned char, 2>;
+
+  FloatImageType::SizeType size = { { 17, 9 } };
+  auto                     image1 = FloatImageType::New();
+  image1->SetRegions(size);
+  image1->Allocate();
+  auto image2 = FloatImageType::New();
+  image2->SetRegions(size);
+  image2->Allocate();
+  itk::ImageRegionIterator<FloatImageType> it1(image1, image1->GetBufferedRegion());
+  itk::ImageRegionIterator<FloatImageType> it2(image2, image2->GetBufferedRegion());
+  float                                    value = -40.0f;
+  for (; !it1.IsAtEnd(); ++it1, ++it2, value += 0.75f)
+  {
+    it1.Set(value);
+    it2.Set(0.25f * value - 3.0f);
+  }
+
+  // the pipeline of pixel-wise filters
+  auto subtract = itk::SubtractImageFilter<FloatImageType>::New();
+  subtract->SetInput1(image1);
+  subtract->SetInput2(image2);
+  auto multiply = itk::MultiplyImageFilter<FloatImageType>::New();
+  multiply->SetInput(subtract->GetOutput());
+  multiply->SetConstant(2.0f);
+  auto clampFilter = itk::ClampImageFilter<FloatImageType, FloatImageType>::New();
+  clampFilter->SetInput(multiply->GetOutput());
+  clampFilter->SetBounds(0.0f, 100.0f);
+  auto cast = itk::CastImageFilter<FloatImageType, UCharImageType>::New();
+  cast->SetInput(clampFilter->GetOutput());
+  cast->Update();
+
+  // the same stages fused into one filter
+  itk::Functor::Clamp<float, float> clamp;
+  clamp.SetBounds(0.0f, 100.0f);
+  auto fused = itk::BinaryGeneratorImageFilter<FloatImageType, FloatImageType, UCharImageType>::New();
+  fused->SetInput1(image1);
+  fused->SetInput2(image2);
+  fused->SetFunctor(itk::Functor::MakeChain(itk::Functor::Sub2<float, float, float>(),
+                                            [](float v) { return 2.0f * v; },
+                                            clamp,
+                                            [](float v) { return static_cast<unsigned char>(v); }));
+  EXPECT_NO_THROW(fused->Update());
+
+  itk::ImageRegionConstIterator<UCharImageType> expectedIt(cast->GetOutput(), cast->GetOutput()->GetBufferedRegion());
+  itk::ImageRegionConstIterator<UCharImageType> fusedIt(fused->GetOutput(), cast->GetOutput()->GetBufferedRegion());
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++fusedIt)
+  {
+    EXPECT_EQ(expectedIt.Get(), fusedIt.Get()) << "at " << expectedIt.GetIndex();
+  }
+}
+
+
+TEST(FunctorChain, UnaryAndTernaryFilters)
+{
+  using Utils = Utilities<2, float>;
+  using ImageType = Utils::ImageType;
+
+  auto image = Utils::CreateImage();
+  image->FillBuffer(3.0f);
+
+  Utils::IndexType idx;
+  idx.Fill(0);
+
+  // a single stage, and a chain of stages with different types
+  auto unary = itk::UnaryGeneratorImageFilter<ImageType, ImageType>::New();
+  unary->SetInput(image);
+  unary->SetFunctor(itk::Functor::MakeChain(Utils::MyUnaryFunction));
+  EXPECT_NO_THROW(unary->Update());
+  EXPECT_NEAR(13.0, unary->GetOutput()->GetPixel(idx), 1e-8);
+
+  unary->SetFunctor(itk::Functor::MakeChain([](float v) { return static_cast<int>(v) * 7; },
+                                            [](int v) { return v % 4; },
+                                            [](int v) { return 0.5f * v; }));
+  EXPECT_NO_THROW(unary->Update());
+  EXPECT_NEAR(0.5, unary->GetOutput()->GetPixel(idx), 1e-8);
+
+  // default constructible stages are accepted by the functor filters
+  using ChainType =
+    itk::Functor::Chain<itk::Functor::Add3<float, float, float, float>, itk::Functor::Clamp<float, float>>;
+  EXPECT_TRUE(ChainType() == ChainType());
+
+  auto ternary = itk::TernaryFunctorImageFilter<ImageType, ImageType, ImageType, ImageType, ChainType>::New();
+  ternary->SetInput1(image);
+  ternary->SetInput2(image);
+  ternary->SetInput3(image);
+  EXPECT_NO_THROW(ternary->Update());
+  EXPECT_NEAR(9.0, ternary->GetOutput()->GetPixel(idx), 1e-8);
+}
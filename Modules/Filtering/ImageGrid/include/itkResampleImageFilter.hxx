@@ -353,9 +353,16 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
 
   // Create an iterator that will walk the output region for this thread.
-  using OutputIterator = ImageRegionIteratorWithIndex<TOutputImage>;
+  using OutputIterator = ImageScanlineIterator<TOutputImage>;
   OutputIterator outIt(outputPtr, outputRegionForThread);
 
+  // The output points of a scanline are transformed in one batch
+  using TransformInputPointType = typename TransformType::InputPointType;
+  using TransformOutputPointType = typename TransformType::OutputPointType;
+  const SizeValueType                   lineLength = outputRegionForThread.GetSize(0);
+  std::vector<TransformInputPointType>  outputPoints(lineLength);
+  std::vector<TransformOutputPointType> inputPoints(lineLength);
+
   // Define a few indices that will be used to translate from an input pixel
   // to an output pixel
   PointType outputPoint; // Coordinates of current output pixel
@@ -370,34 +377,45 @@ ResampleImageFilter<TInputImage, TOutputImage, TInterpolatorPrecisionType, TTran
 
   while (!outIt.IsAtEnd())
   {
-    // Determine the index of the current output pixel
-    outputPtr->TransformIndexToPhysicalPoint(outIt.GetIndex(), outputPoint);
-
-    // Compute corresponding input pixel position
-    inputPoint = transformPtr->TransformPoint(outputPoint);
-    const bool isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
-
-    OutputType value;
-    // Evaluate input at right position and copy to the output
-    if (m_Interpolator->IsInsideBuffer(inputIndex) && (!isSpecialCoordinatesImage || isInsideInput))
+    // Determine the coordinates of the output pixels of the scanline
+    IndexType index = outIt.GetIndex();
+    for (SizeValueType i = 0; i < lineLength; ++i, ++index[0])
     {
-      value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
-      outIt.Set(Self::CastPixelWithBoundsChecking(value));
+      outputPtr->TransformIndexToPhysicalPoint(index, outputPoint);
+      outputPoints[i].CastFrom(outputPoint);
     }
-    else
+
+    // Compute corresponding input pixel positions
+    transformPtr->TransformPoints(outputPoints.data(), inputPoints.data(), lineLength);
+
+    for (SizeValueType i = 0; i < lineLength; ++i)
     {
-      if (m_Extrapolator.IsNull())
+      inputPoint.CastFrom(inputPoints[i]);
+      const bool isInsideInput = inputPtr->TransformPhysicalPointToContinuousIndex(inputPoint, inputIndex);
+
+      OutputType value;
+      // Evaluate input at right position and copy to the output
+      if (m_Interpolator->IsInsideBuffer(inputIndex) && (!isSpecialCoordinatesImage || isInsideInput))
       {
-        outIt.Set(m_DefaultPixelValue); // default background value
+        value = m_Interpolator->EvaluateAtContinuousIndex(inputIndex);
+        outIt.Set(Self::CastPixelWithBoundsChecking(value));
       }
       else
       {
-        value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndex);
-        outIt.Set(Self::CastPixelWithBoundsChecking(value));
+        if (m_Extrapolator.IsNull())
+        {
+          outIt.Set(m_DefaultPixelValue); // default background value
+        }
+        else
+        {
+          value = m_Extrapolator->EvaluateAtContinuousIndex(inputIndex);
+          outIt.Set(Self::CastPixelWithBoundsChecking(value));
+        }
       }
-    }
 
-    ++outIt;
+      ++outIt;
+    }
+    outIt.NextLine();
   }
 }
 
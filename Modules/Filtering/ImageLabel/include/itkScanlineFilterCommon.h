@@ -24,6 +24,7 @@
 #include <deque>
 #include <functional>
 #include <mutex>
+#include <utility>
 #include <vector>
 
 namespace itk
@@ -134,7 +135,9 @@ protected:
 
   using LineMapType = std::vector<LineEncodingType>;
 
-  using UnionFindType = std::vector<InternalLabelType>;
+  // The parent of each label.  The links are made with compare-and-swap, so
+  // that the work units merge their equivalences concurrently without a lock.
+  using UnionFindType = std::vector<std::atomic<InternalLabelType>>;
   using ConsecutiveVectorType = std::vector<OutputPixelType>;
 
   SizeValueType
@@ -169,37 +172,61 @@ protected:
       for (cIt = LineIt->begin(); cIt != LineIt->end(); ++cIt)
       {
         cIt->label = label;
-        m_UnionFind[label] = label;
+        m_UnionFind[label].store(label, std::memory_order_relaxed);
         label++;
       }
     }
   }
 
+  // A label is always linked to a smaller one, so that the parents only
+  // decrease and the root of a set is its smallest label, whatever the order
+  // of the links.  The parents are the only data shared through the union
+  // find, hence the relaxed memory order.
   InternalLabelType
   LookupSet(const InternalLabelType label)
   {
     InternalLabelType l = label;
-    while (l != m_UnionFind[l])
+    while (true)
     {
-      l = m_UnionFind[l]; // transitively sets equivalence
+      InternalLabelType parent = m_UnionFind[l].load(std::memory_order_relaxed);
+      if (parent == l)
+      {
+        return l;
+      }
+      const InternalLabelType grandParent = m_UnionFind[parent].load(std::memory_order_relaxed);
+      if (grandParent == parent)
+      {
+        return parent;
+      }
+      // path halving: a failure means that another work unit shortened the path
+      m_UnionFind[l].compare_exchange_weak(parent, grandParent, std::memory_order_relaxed);
+      l = grandParent;
     }
-    return l;
   }
 
   void
   LinkLabels(const InternalLabelType label1, const InternalLabelType label2)
   {
-    std::lock_guard<std::mutex> mutexHolder(m_Mutex);
-    InternalLabelType           E1 = this->LookupSet(label1);
-    InternalLabelType           E2 = this->LookupSet(label2);
-
-    if (E1 < E2)
-    {
-      m_UnionFind[E2] = E1;
-    }
-    else
+    InternalLabelType E1 = label1;
+    InternalLabelType E2 = label2;
+    while (true)
     {
-      m_UnionFind[E1] = E2;
+      E1 = this->LookupSet(E1);
+      E2 = this->LookupSet(E2);
+      if (E1 == E2)
+      {
+        return;
+      }
+      if (E1 < E2)
+      {
+        std::swap(E1, E2);
+      }
+      // link the larger root to the smaller one, unless it is no longer a root
+      InternalLabelType expected = E1;
+      if (m_UnionFind[E1].compare_exchange_strong(expected, E2, std::memory_order_relaxed))
+      {
+        return;
+      }
     }
   }
 
@@ -216,7 +243,12 @@ protected:
 
     for (size_t i = 1; i < N; i++)
     {
-      const auto label = static_cast<size_t>(m_UnionFind[i]);
+      // The parent of a label is smaller than the label, and was already
+      // linked to its root: flatten the sets, so that LookupSet() takes a
+      // single step when the output is written.
+      const auto label = static_cast<size_t>(
+        m_UnionFind[m_UnionFind[i].load(std::memory_order_relaxed)].load(std::memory_order_relaxed));
+      m_UnionFind[i].store(label, std::memory_order_relaxed);
       if (label == i)
       {
         if (consecutiveLabel == backgroundValue)
@@ -460,20 +492,18 @@ protected:
     return WorkUnitData{ firstLine, lastLine };
   }
 
-  /* Process the map and make appropriate entries in an equivalence table */
+  /* Process the map and make appropriate entries in an equivalence table.
+   * The lines of a work unit are first linked to the neighbor lines of the
+   * same work unit (withinWorkUnit true), which only touches the labels of
+   * that work unit, and then to the neighbor lines of the other work units
+   * (withinWorkUnit false), once all the work units have merged their own
+   * runs. */
   void
-  ComputeEquivalence(const SizeValueType workUnitResultsIndex, bool strictlyLess)
+  ComputeEquivalence(const SizeValueType workUnitResultsIndex, bool withinWorkUnit)
   {
     const OffsetValueType linecount = m_LineMap.size();
     WorkUnitData          wud = m_WorkUnitResults[workUnitResultsIndex];
-    SizeValueType         lastLine = wud.lastLine;
-    if (!strictlyLess)
-    {
-      lastLine++;
-      // make sure we are not wrapping around
-      itkAssertInDebugAndIgnoreInReleaseMacro(lastLine >= wud.lastLine);
-    }
-    for (SizeValueType thisIdx = wud.firstLine; thisIdx < lastLine; ++thisIdx)
+    for (SizeValueType thisIdx = wud.firstLine; thisIdx <= wud.lastLine; ++thisIdx)
     {
       if (!m_LineMap[thisIdx].empty())
       {
@@ -481,8 +511,10 @@ protected:
         while (it != this->m_LineOffsets.end())
         {
           OffsetValueType neighIdx = thisIdx + (*it);
-          // check if the neighbor is in the map
-          if (neighIdx >= 0 && neighIdx < linecount && !m_LineMap[neighIdx].empty())
+          // check if the neighbor is in the map, and in the work units of this pass
+          if (neighIdx >= 0 && neighIdx < linecount && !m_LineMap[neighIdx].empty() &&
+              (static_cast<SizeValueType>(neighIdx) >= wud.firstLine &&
+               static_cast<SizeValueType>(neighIdx) <= wud.lastLine) == withinWorkUnit)
           {
             // Now check whether they are really neighbors
             bool areNeighbors = this->CheckNeighbors(m_LineMap[thisIdx][0].where, m_LineMap[neighIdx][0].where);
@@ -510,6 +542,8 @@ protected:
   OffsetVectorType      m_LineOffsets;
   UnionFindType         m_UnionFind;
   ConsecutiveVectorType m_Consecutive;
+  // Guards m_WorkUnitResults, which the work units append to.  The union
+  // find needs no lock.
   std::mutex            m_Mutex;
 
   std::atomic<SizeValueType> m_NumberOfLabels;
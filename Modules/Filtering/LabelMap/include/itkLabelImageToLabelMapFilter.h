@@ -21,6 +21,7 @@
 #include "itkImageToImageFilter.h"
 #include "itkLabelMap.h"
 #include "itkLabelObject.h"
+#include "itkRLEImage.h"
 
 namespace itk
 {
@@ -30,6 +31,9 @@ namespace itk
  * LabelImageToLabelMapFilter converts a label image to a label collection image.
  * The labels are the same in the input and the output image.
  *
+ * An RLEImage input is read run by run: its runs are the lines of the label
+ * objects.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -126,6 +130,17 @@ protected:
   AfterThreadedGenerateData() override;
 
 private:
+  /** Add the runs of the input lines in regionForThread to the temporary
+   * image of threadId. */
+  template <typename TImage>
+  void
+  ThreadedGenerateLines(const TImage * input, const OutputImageRegionType & regionForThread, ThreadIdType threadId);
+  template <typename TPixel, typename TRunLength>
+  void
+  ThreadedGenerateLines(const RLEImage<TPixel, InputImageDimension, TRunLength> * input,
+                        const OutputImageRegionType &                             regionForThread,
+                        ThreadIdType                                              threadId);
+
   OutputImagePixelType m_BackgroundValue;
 
   typename std::vector<OutputImagePointer> m_TemporaryImages;
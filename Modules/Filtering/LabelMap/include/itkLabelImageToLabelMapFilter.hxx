@@ -22,6 +22,9 @@
 #include "itkNumericTraits.h"
 #include "itkProgressReporter.h"
 #include "itkImageLinearConstIteratorWithIndex.h"
+#include "itkIndexRange.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -85,11 +88,22 @@ void
 LabelImageToLabelMapFilter<TInputImage, TOutputImage>::ThreadedGenerateData(
   const OutputImageRegionType & regionForThread,
   ThreadIdType                  threadId)
+{
+  this->ThreadedGenerateLines(this->GetInput(), regionForThread, threadId);
+}
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TImage>
+void
+LabelImageToLabelMapFilter<TInputImage, TOutputImage>::ThreadedGenerateLines(
+  const TImage *                input,
+  const OutputImageRegionType & regionForThread,
+  ThreadIdType                  threadId)
 {
   ProgressReporter progress(this, threadId, regionForThread.GetNumberOfPixels());
 
-  using InputLineIteratorType = ImageLinearConstIteratorWithIndex<InputImageType>;
-  InputLineIteratorType it(this->GetInput(), regionForThread);
+  using InputLineIteratorType = ImageLinearConstIteratorWithIndex<TImage>;
+  InputLineIteratorType it(input, regionForThread);
   it.SetDirection(0);
 
   for (it.GoToBegin(); !it.IsAtEnd(); it.NextLine())
@@ -124,6 +138,49 @@ LabelImageToLabelMapFilter<TInputImage, TOutputImage>::ThreadedGenerateData(
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+template <typename TPixel, typename TRunLength>
+void
+LabelImageToLabelMapFilter<TInputImage, TOutputImage>::ThreadedGenerateLines(
+  const RLEImage<TPixel, InputImageDimension, TRunLength> * input,
+  const OutputImageRegionType &                             regionForThread,
+  ThreadIdType                                              threadId)
+{
+  using RunType = typename RLEImage<TPixel, InputImageDimension, TRunLength>::RunType;
+
+  // One index per line of the region
+  OutputImageRegionType lineRegion = regionForThread;
+  lineRegion.SetSize(0, 1);
+
+  ProgressReporter progress(this, threadId, lineRegion.GetNumberOfPixels());
+
+  const IndexValueType regionBegin = regionForThread.GetIndex(0);
+  const IndexValueType regionEnd = regionBegin + static_cast<IndexValueType>(regionForThread.GetSize(0));
+  const auto           background = static_cast<InputImagePixelType>(m_BackgroundValue);
+
+  for (IndexType idx : Experimental::ImageRegionIndexRange<InputImageDimension>(lineRegion))
+  {
+    // Copy the runs which are not background, clipped to the region
+    IndexValueType runBegin = input->GetBufferedRegion().GetIndex(0);
+    for (const RunType & run : input->GetLine(input->ComputeLineNumber(idx)))
+    {
+      const IndexValueType runEnd = runBegin + static_cast<IndexValueType>(run.first);
+      if (run.second != background && runEnd > regionBegin)
+      {
+        idx[0] = std::max(runBegin, regionBegin);
+        const auto length = static_cast<LengthType>(std::min(runEnd, regionEnd) - idx[0]);
+        m_TemporaryImages[threadId]->SetLine(idx, length, run.second);
+      }
+      runBegin = runEnd;
+      if (runBegin >= regionEnd)
+      {
+        break;
+      }
+    }
+    progress.CompletedPixel();
+  }
+}
+
 template <typename TInputImage, typename TOutputImage>
 void
 LabelImageToLabelMapFilter<TInputImage, TOutputImage>::AfterThreadedGenerateData()
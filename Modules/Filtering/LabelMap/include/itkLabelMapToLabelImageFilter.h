@@ -19,6 +19,7 @@
 #define itkLabelMapToLabelImageFilter_h
 
 #include "itkLabelMapFilter.h"
+#include "itkRLEImage.h"
 
 namespace itk
 {
@@ -27,6 +28,9 @@ namespace itk
  *
  * LabelMapToBinaryImageFilter to a label image.
  *
+ * An RLEImage output is written line by line from the lines of the label
+ * objects, without going through the pixels.
+ *
  * \author Gaetan Lehmann. Biologie du Developpement et de la Reproduction, INRA de Jouy-en-Josas, France.
  *
  * This implementation was taken from the Insight Journal paper:
@@ -87,6 +91,9 @@ protected:
   LabelMapToLabelImageFilter();
   ~LabelMapToLabelImageFilter() override = default;
 
+  void
+  GenerateData() override;
+
   void
   BeforeThreadedGenerateData() override;
 
@@ -94,6 +101,15 @@ protected:
   ThreadedProcessLabelObject(LabelObjectType * labelObject) override;
 
 private:
+  /** Fill the output with the label objects, by the label map filter
+   * machinery or run by run for an RLEImage. */
+  template <typename TImage>
+  void
+  GenerateOutput(TImage * output);
+  template <typename TPixel, typename TRunLength>
+  void
+  GenerateOutput(RLEImage<TPixel, OutputImageDimension, TRunLength> * output);
+
   OutputImageType * m_OutputImage;
 }; // end of class
 } // end namespace itk
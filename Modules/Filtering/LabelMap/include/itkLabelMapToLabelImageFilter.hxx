@@ -23,6 +23,8 @@
 #include "itkProgressReporter.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 
+#include <algorithm>
+
 namespace itk
 {
 
@@ -33,6 +35,92 @@ LabelMapToLabelImageFilter<TInputImage, TOutputImage>::LabelMapToLabelImageFilte
 }
 
 
+template <typename TInputImage, typename TOutputImage>
+void
+LabelMapToLabelImageFilter<TInputImage, TOutputImage>::GenerateData()
+{
+  this->GenerateOutput(this->GetOutput());
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TImage>
+void
+LabelMapToLabelImageFilter<TInputImage, TOutputImage>::GenerateOutput(TImage *)
+{
+  Superclass::GenerateData();
+}
+
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TPixel, typename TRunLength>
+void
+LabelMapToLabelImageFilter<TInputImage, TOutputImage>::GenerateOutput(
+  RLEImage<TPixel, OutputImageDimension, TRunLength> * output)
+{
+  using RLEImageType = RLEImage<TPixel, OutputImageDimension, TRunLength>;
+  using RunType = typename RLEImageType::RunType;
+  using LineType = typename RLEImageType::LineType;
+  using PositionedRunType = std::pair<IndexValueType, RunType>;
+
+  this->AllocateOutputs();
+
+  const InputImageType * input = this->GetInput();
+  const auto             background = static_cast<OutputImagePixelType>(input->GetBackgroundValue());
+  const IndexValueType   lineBegin = output->GetBufferedRegion().GetIndex(0);
+  const SizeValueType    lineLength = output->GetBufferedRegion().GetSize(0);
+
+  // Sort the lines of the label objects by output line
+  std::vector<std::vector<PositionedRunType>> runs(output->GetNumberOfLines());
+  for (typename InputImageType::ConstIterator it(input); !it.IsAtEnd(); ++it)
+  {
+    const LabelObjectType * labelObject = it.GetLabelObject();
+    const auto              label = static_cast<OutputImagePixelType>(labelObject->GetLabel());
+    for (typename LabelObjectType::ConstLineIterator lit(labelObject); !lit.IsAtEnd(); ++lit)
+    {
+      const IndexType & idx = lit.GetLine().GetIndex();
+      runs[output->ComputeLineNumber(idx)].push_back(
+        PositionedRunType(idx[0] - lineBegin, RunType(static_cast<TRunLength>(lit.GetLine().GetLength()), label)));
+    }
+  }
+
+  // Build each line of the output from its runs, filling the gaps with the
+  // background
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  multiThreader->ParallelizeArray(
+    0,
+    runs.size(),
+    [&](SizeValueType lineNumber) {
+      std::vector<PositionedRunType> & lineRuns = runs[lineNumber];
+      std::sort(lineRuns.begin(), lineRuns.end(), [](const PositionedRunType & a, const PositionedRunType & b) {
+        return a.first < b.first;
+      });
+
+      LineType       line;
+      IndexValueType x = 0;
+      for (const PositionedRunType & run : lineRuns)
+      {
+        if (run.first > x)
+        {
+          line.push_back(RunType(static_cast<TRunLength>(run.first - x), background));
+        }
+        line.push_back(run.second);
+        x = run.first + static_cast<IndexValueType>(run.second.first);
+      }
+      if (x < static_cast<IndexValueType>(lineLength))
+      {
+        line.push_back(RunType(static_cast<TRunLength>(lineLength - x), background));
+      }
+      RLEImageType::CleanUpLine(line);
+
+      output->GetLine(lineNumber).swap(line);
+      std::vector<PositionedRunType>().swap(lineRuns);
+    },
+    this);
+}
+
+
 template <typename TInputImage, typename TOutputImage>
 void
 LabelMapToLabelImageFilter<TInputImage, TOutputImage>::BeforeThreadedGenerateData()
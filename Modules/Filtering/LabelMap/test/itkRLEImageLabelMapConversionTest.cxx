@@ -0,0 +1,145 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkLabelImageToLabelMapFilter.h"
+#include "itkLabelMapToLabelImageFilter.h"
+#include "itkRLEImage.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Convert a label image to a label map and back, through both an itk::Image
+// and an RLEImage.
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using PixelType = unsigned char;
+using ImageType = itk::Image<PixelType, Dimension>;
+using RLEImageType = itk::RLEImage<PixelType, Dimension>;
+using LabelMapType = itk::LabelMap<itk::LabelObject<PixelType, Dimension>>;
+
+template <typename TImage>
+bool
+SameImages(const ImageType * expected, const TImage * output, const char * what)
+{
+  const ImageType::RegionType & region = expected->GetBufferedRegion();
+  if (output->GetBufferedRegion() != region)
+  {
+    std::cerr << "Test failed for " << what << ": buffered region " << output->GetBufferedRegion() << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIterator<ImageType> it(expected, region);
+  itk::ImageRegionConstIterator<TImage>    oit(output, region);
+  for (; !it.IsAtEnd(); ++it, ++oit)
+  {
+    if (oit.Get() != it.Get())
+    {
+      std::cerr << "Test failed for " << what << " at index " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkRLEImageLabelMapConversionTest(int, char *[])
+{
+  ImageType::RegionType region;
+  region.SetIndex({ { 3, -4, 1 } });
+  region.SetSize({ { 50, 21, 13 } });
+
+  // Random runs of 3 labels over the background
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(7);
+  PixelType label = 0;
+  for (itk::ImageRegionIterator<ImageType> it(image, region); !it.IsAtEnd(); ++it)
+  {
+    if (generator->GetUniformVariate(0.0, 1.0) < 0.1)
+    {
+      label = static_cast<PixelType>(generator->GetIntegerVariate(3));
+    }
+    it.Set(label);
+  }
+
+  bool testPassed = true;
+
+  using ImageToLabelMapType = itk::LabelImageToLabelMapFilter<ImageType, LabelMapType>;
+  ImageToLabelMapType::Pointer imageToLabelMap = ImageToLabelMapType::New();
+  imageToLabelMap->SetInput(image);
+  ITK_TRY_EXPECT_NO_EXCEPTION(imageToLabelMap->Update());
+
+  // Label map to RLEImage
+  using LabelMapToRLEImageType = itk::LabelMapToLabelImageFilter<LabelMapType, RLEImageType>;
+  LabelMapToRLEImageType::Pointer labelMapToRLEImage = LabelMapToRLEImageType::New();
+  labelMapToRLEImage->SetInput(imageToLabelMap->GetOutput());
+  ITK_TRY_EXPECT_NO_EXCEPTION(labelMapToRLEImage->Update());
+  const RLEImageType * rleImage = labelMapToRLEImage->GetOutput();
+  testPassed &= SameImages(image, rleImage, "label map to RLEImage");
+  std::cout << "Runs: " << rleImage->GetNumberOfRuns() << " for " << region.GetNumberOfPixels() << " pixels"
+            << std::endl;
+
+  // RLEImage to label map and back to an image
+  using RLEImageToLabelMapType = itk::LabelImageToLabelMapFilter<RLEImageType, LabelMapType>;
+  RLEImageToLabelMapType::Pointer rleImageToLabelMap = RLEImageToLabelMapType::New();
+  rleImageToLabelMap->SetInput(rleImage);
+
+  using LabelMapToImageType = itk::LabelMapToLabelImageFilter<LabelMapType, ImageType>;
+  LabelMapToImageType::Pointer labelMapToImage = LabelMapToImageType::New();
+  labelMapToImage->SetInput(rleImageToLabelMap->GetOutput());
+
+  for (itk::ThreadIdType numberOfWorkUnits : { 1, 3 })
+  {
+    rleImageToLabelMap->SetNumberOfWorkUnits(numberOfWorkUnits);
+    labelMapToRLEImage->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(labelMapToImage->Update());
+    ITK_TRY_EXPECT_NO_EXCEPTION(labelMapToRLEImage->Update());
+
+    const LabelMapType * expectedMap = imageToLabelMap->GetOutput();
+    const LabelMapType * labelMap = rleImageToLabelMap->GetOutput();
+    ITK_TEST_EXPECT_EQUAL(labelMap->GetNumberOfLabelObjects(), expectedMap->GetNumberOfLabelObjects());
+    for (LabelMapType::ConstIterator it(expectedMap); !it.IsAtEnd(); ++it)
+    {
+      ITK_TEST_EXPECT_TRUE(labelMap->HasLabel(it.GetLabel()));
+      ITK_TEST_EXPECT_EQUAL(labelMap->GetLabelObject(it.GetLabel())->Size(), it.GetLabelObject()->Size());
+    }
+    testPassed &= SameImages(image, labelMapToImage->GetOutput(), "RLEImage to label map");
+    testPassed &= SameImages(image, labelMapToRLEImage->GetOutput(), "label map to RLEImage");
+  }
+
+  // Runs of the background value are not label objects
+  rleImageToLabelMap->SetBackgroundValue(2);
+  ITK_TRY_EXPECT_NO_EXCEPTION(labelMapToImage->Update());
+  ITK_TEST_EXPECT_EQUAL(rleImageToLabelMap->GetOutput()->GetNumberOfLabelObjects(), 3);
+  ITK_TEST_EXPECT_TRUE(rleImageToLabelMap->GetOutput()->HasLabel(0));
+  testPassed &= SameImages(image, labelMapToImage->GetOutput(), "RLEImage to label map with background");
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -21,6 +21,9 @@
 #include "itkImageToImageFilter.h"
 #include "itkImage.h"
 #include "itkZeroFluxNeumannBoundaryCondition.h"
+#include "itkGaussianOperator.h"
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -44,6 +47,16 @@ namespace itk
  * When the Gaussian kernel is small, this filter tends to run faster than
  * itk::RecursiveGaussianImageFilter.
  *
+ * For itk::Image inputs and outputs of scalar pixels with the default
+ * boundary conditions, the passes convolve the pixel buffers directly:
+ * blocks of neighboring lines are copied into reused line buffers and
+ * convolved there with a loop the compiler vectorizes. Other images and
+ * boundary conditions are processed by a pipeline of
+ * NeighborhoodOperatorImageFilters. Both cast the result of each pass to
+ * the output pixel type and accumulate in double, so they produce the same
+ * output, except for float outputs: their line buffers are float, which
+ * changes the result within the float precision.
+ *
  * \sa GaussianOperator
  * \sa Image
  * \sa Neighborhood
@@ -108,6 +121,9 @@ public:
   using RealBoundaryConditionPointerType = ImageBoundaryCondition<RealOutputImageType> *;
   using RealDefaultBoundaryConditionType = ZeroFluxNeumannBoundaryCondition<RealOutputImageType>;
 
+  /** Type of the Gaussian operators built for each direction. */
+  using OperatorType = GaussianOperator<RealOutputPixelValueType, ImageDimension>;
+
   /** Typedef of double containers */
   using ArrayType = FixedArray<double, Self::ImageDimension>;
   using SigmaArrayType = ArrayType;
@@ -327,6 +343,42 @@ protected:
   GenerateData() override;
 
 private:
+  /** Scalar type of the line buffers of the direct convolution, double
+   * like the accumulator of NeighborhoodInnerProduct, except for float
+   * outputs. */
+  using LineRealType = typename std::conditional<std::is_same<OutputPixelType, float>::value, float, double>::type;
+
+  /** Whether the pixel buffers of the input and output can be convolved
+   * directly, see GenerateDataUsingLineBuffers. */
+  using CanUseLineBuffers =
+    std::integral_constant<bool,
+                           std::is_arithmetic<InputPixelType>::value && std::is_arithmetic<OutputPixelType>::value &&
+                             std::is_same<TInputImage, Image<InputPixelType, ImageDimension>>::value &&
+                             std::is_same<TOutputImage, Image<OutputPixelType, ImageDimension>>::value>;
+
+  /** Convolves the input with the operators, one direction after the
+   * other, directly in the pixel buffers. Returns false when the image
+   * types do not allow it. */
+  bool
+  GenerateDataUsingLineBuffers(const InputImageType * input, const std::vector<OperatorType> & oper, std::true_type);
+  bool
+  GenerateDataUsingLineBuffers(const InputImageType *, const std::vector<OperatorType> &, std::false_type)
+  {
+    return false;
+  }
+
+  /** Convolves the lines of the source along direction with the kernel
+   * into the buffered region of the destination, summing the products in
+   * the order of NeighborhoodInnerProduct. Source
+   * pixels outside the input's largest possible region are replaced by
+   * the nearest ones inside, like ZeroFluxNeumannBoundaryCondition. */
+  template <typename TSourceImage, typename TDestinationImage>
+  void
+  ConvolveLines(const TSourceImage *              source,
+                TDestinationImage *               destination,
+                const std::vector<LineRealType> & kernel,
+                unsigned int                      direction);
+
   /** The variance of the gaussian blurring kernel in each dimensional
     direction. */
   ArrayType m_Variance;
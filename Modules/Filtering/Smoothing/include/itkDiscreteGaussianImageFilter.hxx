@@ -24,6 +24,9 @@
 #include "itkImageRegionIterator.h"
 #include "itkProgressAccumulator.h"
 #include "itkImageAlgorithm.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -161,8 +164,6 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   using SingleFilterPointer = typename SingleFilterType::Pointer;
 
   // Create a series of operators
-  using OperatorType = GaussianOperator<RealOutputPixelValueType, ImageDimension>;
-
   std::vector<OperatorType> oper;
   oper.resize(filterDimensionality);
 
@@ -204,6 +205,15 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
     oper[reverse_i].CreateDirectional();
   }
 
+  // Convolve the pixel buffers directly when the image types and the
+  // boundary conditions allow it
+  if (m_InputBoundaryCondition == &m_InputDefaultBoundaryCondition &&
+      m_RealBoundaryCondition == &m_RealDefaultBoundaryCondition &&
+      this->GenerateDataUsingLineBuffers(localInput, oper, CanUseLineBuffers()))
+  {
+    return;
+  }
+
   // Create a chain of filters
   //
   //
@@ -300,6 +310,194 @@ DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateData()
   }
 }
 
+template <typename TInputImage, typename TOutputImage>
+bool
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::GenerateDataUsingLineBuffers(
+  const InputImageType *            input,
+  const std::vector<OperatorType> & oper,
+  std::true_type)
+{
+  using RegionType = typename TOutputImage::RegionType;
+
+  TOutputImage * output = this->GetOutput();
+
+  // oper[stage] convolves along direction numberOfStages - 1 - stage
+  const auto          numberOfStages = static_cast<unsigned int>(oper.size());
+  const RegionType &  largestRegion = input->GetLargestPossibleRegion();
+  std::vector<RegionType>                  regions(numberOfStages + 1);
+  std::vector<std::vector<LineRealType>> kernels(numberOfStages);
+  regions[numberOfStages] = output->GetRequestedRegion();
+  for (unsigned int stage = numberOfStages; stage-- > 0;)
+  {
+    const unsigned int direction = numberOfStages - 1 - stage;
+    const auto         radius = static_cast<IndexValueType>(oper[stage].GetRadius(direction));
+
+    // the region read by a stage is the region it writes, padded by the
+    // radius along its direction
+    RegionType region = regions[stage + 1];
+    region.SetIndex(direction, region.GetIndex(direction) - radius);
+    region.SetSize(direction, region.GetSize(direction) + 2 * radius);
+    region.Crop(largestRegion);
+    regions[stage] = region;
+
+    kernels[stage].assign(oper[stage].Begin(), oper[stage].End());
+  }
+
+  if (numberOfStages == 1)
+  {
+    this->ConvolveLines(input, output, kernels[0], 0);
+    this->UpdateProgress(1.0f);
+    return true;
+  }
+
+  // the intermediate images take turns, their regions shrink from stage
+  // to stage so they are allocated only once
+  // like the pipeline, each pass is cast to the output pixel type
+  typename RealOutputImageType::Pointer intermediate[2] = { RealOutputImageType::New(), RealOutputImageType::New() };
+  for (unsigned int stage = 0; stage < numberOfStages; ++stage)
+  {
+    const unsigned int direction = numberOfStages - 1 - stage;
+    if (stage == 0)
+    {
+      intermediate[0]->SetRegions(regions[1]);
+      intermediate[0]->Allocate();
+      this->ConvolveLines(input, intermediate[0].GetPointer(), kernels[0], direction);
+    }
+    else if (stage + 1 < numberOfStages)
+    {
+      RealOutputImageType * destination = intermediate[stage % 2];
+      destination->SetRegions(regions[stage + 1]);
+      destination->Allocate();
+      this->ConvolveLines(intermediate[(stage - 1) % 2].GetPointer(), destination, kernels[stage], direction);
+    }
+    else
+    {
+      this->ConvolveLines(intermediate[(stage - 1) % 2].GetPointer(), output, kernels[stage], direction);
+    }
+    this->UpdateProgress(static_cast<float>(stage + 1) / numberOfStages);
+  }
+  return true;
+}
+
+template <typename TInputImage, typename TOutputImage>
+template <typename TSourceImage, typename TDestinationImage>
+void
+DiscreteGaussianImageFilter<TInputImage, TOutputImage>::ConvolveLines(const TSourceImage *              source,
+                                                                      TDestinationImage *               destination,
+                                                                      const std::vector<LineRealType> & kernel,
+                                                                      unsigned int                      direction)
+{
+  using RegionType = typename TOutputImage::RegionType;
+  using IndexType = typename TOutputImage::IndexType;
+  using DestinationPixelType = typename TDestinationImage::PixelType;
+
+  // number of neighboring lines convolved at once, when they are
+  // contiguous in memory
+  constexpr SizeValueType blockWidth = 16;
+
+  const SizeValueType    radius = (kernel.size() - 1) / 2;
+  const RegionType &     largestRegion = this->GetInput()->GetLargestPossibleRegion();
+  const IndexValueType   lowerBound = largestRegion.GetIndex(direction);
+  const IndexValueType   upperBound = lowerBound + static_cast<IndexValueType>(largestRegion.GetSize(direction)) - 1;
+  const RegionType &     destinationRegion = destination->GetBufferedRegion();
+  const IndexValueType   lineStart = destinationRegion.GetIndex(direction);
+  const SizeValueType    lineLength = destinationRegion.GetSize(direction);
+  const OffsetValueType  sourceStride = source->GetOffsetTable()[direction];
+  const OffsetValueType  destinationStride = destination->GetOffsetTable()[direction];
+  const auto * const     sourceBuffer = source->GetBufferPointer();
+  DestinationPixelType * destinationBuffer = destination->GetBufferPointer();
+
+  // a line is identified by its first pixel
+  RegionType lineRegion = destinationRegion;
+  lineRegion.SetSize(direction, 1);
+  if (lineRegion.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    lineRegion,
+    [&](const RegionType & lines) {
+      // along the first direction the lines are contiguous, along the
+      // others blocks of lines which are neighbors along the first
+      // direction are interleaved, so the convolution runs over contiguous
+      // memory either way
+      const SizeValueType       maximumWidth = (direction == 0) ? 1 : blockWidth;
+      std::vector<LineRealType> buffer((lineLength + 2 * radius) * maximumWidth);
+      std::vector<LineRealType> result(lineLength * maximumWidth);
+
+      const SizeValueType rowLength = lines.GetSize(0);
+      const SizeValueType numberOfRows = lines.GetNumberOfPixels() / rowLength;
+      IndexType           rowIndex = lines.GetIndex();
+      for (SizeValueType row = 0; row < numberOfRows; ++row)
+      {
+        for (SizeValueType x = 0; x < rowLength; x += maximumWidth)
+        {
+          const SizeValueType width = std::min(maximumWidth, rowLength - x);
+          IndexType           index = rowIndex;
+          index[0] += static_cast<IndexValueType>(x);
+          index[direction] = 0;
+          const OffsetValueType sourceOffset = source->ComputeOffset(index);
+
+          // gather, clamping at the boundaries of the largest possible region
+          LineRealType * bufferIt = buffer.data();
+          for (SizeValueType t = 0; t < lineLength + 2 * radius; ++t)
+          {
+            const IndexValueType position = std::min(
+              std::max(lineStart - static_cast<IndexValueType>(radius) + static_cast<IndexValueType>(t), lowerBound),
+              upperBound);
+            const auto * sourceIt = sourceBuffer + (sourceOffset + position * sourceStride);
+            for (SizeValueType b = 0; b < width; ++b)
+            {
+              *bufferIt++ = static_cast<LineRealType>(sourceIt[b]);
+            }
+          }
+
+          // convolve
+          const SizeValueType  count = lineLength * width;
+          const LineRealType * first = buffer.data();
+          LineRealType *       resultIt = result.data();
+          const LineRealType   firstWeight = kernel[0];
+          for (SizeValueType j = 0; j < count; ++j)
+          {
+            resultIt[j] = firstWeight * first[j];
+          }
+          for (SizeValueType k = 1; k < kernel.size(); ++k)
+          {
+            const LineRealType   weight = kernel[k];
+            const LineRealType * shifted = first + k * width;
+            for (SizeValueType j = 0; j < count; ++j)
+            {
+              resultIt[j] += weight * shifted[j];
+            }
+          }
+
+          // scatter
+          index[direction] = lineStart;
+          DestinationPixelType * destinationIt = destinationBuffer + destination->ComputeOffset(index);
+          for (SizeValueType t = 0; t < lineLength; ++t, destinationIt += destinationStride)
+          {
+            for (SizeValueType b = 0; b < width; ++b)
+            {
+              destinationIt[b] = static_cast<DestinationPixelType>(*resultIt++);
+            }
+          }
+        }
+
+        // next row of lines
+        for (unsigned int dim = 1; dim < ImageDimension; ++dim)
+        {
+          if (++rowIndex[dim] < lines.GetIndex(dim) + static_cast<IndexValueType>(lines.GetSize(dim)))
+          {
+            break;
+          }
+          rowIndex[dim] = lines.GetIndex(dim);
+        }
+      }
+    },
+    nullptr);
+}
+
 #if !defined(ITK_LEGACY_REMOVE)
 template <typename TInputImage, typename TOutputImage>
 unsigned int
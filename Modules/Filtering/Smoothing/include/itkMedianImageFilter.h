@@ -20,6 +20,7 @@
 
 #include "itkBoxImageFilter.h"
 #include "itkImage.h"
+#include <type_traits>
 
 namespace itk
 {
@@ -35,6 +36,14 @@ namespace itk
  * This filter requires that the input pixel type provides an operator<()
  * (LessThan Comparable).
  *
+ * For itk::Image of integer pixels of at most 16 bits and large enough
+ * neighborhoods, the median is maintained in a histogram of the
+ * neighborhood, which slides along the rows: only the pixels entering and
+ * leaving the neighborhood are counted, and the median moves from the one
+ * of the previous pixel. This costs O(r^(D-1)) instead of O(r^D) per pixel.
+ * Other pixel types and small neighborhoods select the median of the
+ * gathered neighborhood with std::nth_element. Both give the same result.
+ *
  * \sa Image
  * \sa Neighborhood
  * \sa NeighborhoodOperator
@@ -107,6 +116,27 @@ protected:
    *     ImageToImageFilter::GenerateData() */
   void
   DynamicThreadedGenerateData(const OutputImageRegionType & outputRegionForThread) override;
+
+private:
+  /** Whether the pixel types allow the sliding histogram: the input pixel
+   * values index a dense histogram, and both images have pixel buffers. */
+  using CanUseHistogram =
+    std::integral_constant<bool,
+                           std::is_integral<InputPixelType>::value && !std::is_same<InputPixelType, bool>::value &&
+                             (sizeof(InputPixelType) <= 2) &&
+                             std::is_same<TInputImage, Image<InputPixelType, InputImageDimension>>::value &&
+                             std::is_same<TOutputImage, Image<OutputPixelType, OutputImageDimension>>::value>;
+
+  /** Computes the medians of the region with a histogram sliding along
+   * the rows. Returns false when the pixel types or the size of the
+   * neighborhood favor std::nth_element. */
+  bool
+  GenerateDataUsingHistogram(const OutputImageRegionType & outputRegionForThread, std::true_type);
+  bool
+  GenerateDataUsingHistogram(const OutputImageRegionType &, std::false_type)
+  {
+    return false;
+  }
 };
 } // end namespace itk
 
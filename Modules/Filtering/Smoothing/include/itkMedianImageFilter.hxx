@@ -43,6 +43,11 @@ void
 MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
   const OutputImageRegionType & outputRegionForThread)
 {
+  if (this->GenerateDataUsingHistogram(outputRegionForThread, CanUseHistogram()))
+  {
+    return;
+  }
+
   // Allocate output
   typename OutputImageType::Pointer     output = this->GetOutput();
   typename InputImageType::ConstPointer input = this->GetInput();
@@ -100,6 +105,180 @@ MedianImageFilter<TInputImage, TOutputImage>::DynamicThreadedGenerateData(
     }
   }
 }
+
+template <typename TInputImage, typename TOutputImage>
+bool
+MedianImageFilter<TInputImage, TOutputImage>::GenerateDataUsingHistogram(
+  const OutputImageRegionType & outputRegionForThread,
+  std::true_type)
+{
+  using CountType = uint32_t;
+
+  const InputImageType * input = this->GetInput();
+  OutputImageType *      output = this->GetOutput();
+  const auto             radius = this->GetRadius();
+
+  // Each pixel of a row slides the histogram by one slice of the
+  // neighborhood. Measured on 2D and 3D images, that beats sorting from
+  // 9 pixels for 8 bit pixels, from 25 pixels for 16 bit ones.
+  SizeValueType sliceSize = 1;
+  for (unsigned int dim = 1; dim < InputImageDimension; ++dim)
+  {
+    sliceSize *= 2 * radius[dim] + 1;
+  }
+  const SizeValueType neighborhoodSize = sliceSize * (2 * radius[0] + 1);
+  const SizeValueType minimumNeighborhoodSize = (sizeof(InputPixelType) == 1) ? 9 : 25;
+  if (neighborhoodSize < minimumNeighborhoodSize || outputRegionForThread.GetNumberOfPixels() == 0)
+  {
+    return false;
+  }
+
+  // The bins are split into blocks of 256, whose counts let the median
+  // skip empty blocks of the 16 bit histograms
+  constexpr SizeValueType blockSize = 256;
+  const auto              minimumValue = static_cast<OffsetValueType>(NumericTraits<InputPixelType>::NonpositiveMin());
+  const SizeValueType     numberOfBins =
+    static_cast<SizeValueType>(static_cast<OffsetValueType>(NumericTraits<InputPixelType>::max()) - minimumValue + 1);
+  std::vector<CountType> histogram(numberOfBins, 0);
+  std::vector<CountType> blockHistogram(numberOfBins / blockSize + 1, 0);
+
+  // the median is the smallest bin with more than medianRank pixels at or
+  // below it; below counts the pixels below medianBin
+  const SizeValueType medianRank = neighborhoodSize / 2;
+  SizeValueType       medianBin = 0;
+  SizeValueType       below = 0;
+
+  // Pixels outside the buffered region are replaced by the nearest ones
+  // inside, as the ZeroFluxNeumann access of the neighborhood ranges does
+  const InputImageRegionType & bufferedRegion = input->GetBufferedRegion();
+  const InputPixelType * const inputBuffer = input->GetBufferPointer();
+  const OffsetValueType *      inputOffsetTable = input->GetOffsetTable();
+  const auto                   clamp = [&bufferedRegion](unsigned int dim, IndexValueType index) {
+    const IndexValueType lower = bufferedRegion.GetIndex(dim);
+    const IndexValueType upper = lower + static_cast<IndexValueType>(bufferedRegion.GetSize(dim)) - 1;
+    return std::min(std::max(index, lower), upper) - lower;
+  };
+
+  std::vector<OffsetValueType> sliceOffsets(sliceSize);
+
+  // adds or removes the slice of the neighborhood at column x
+  const auto updateSlice = [&](IndexValueType x, bool add) {
+    const InputPixelType * column = inputBuffer + clamp(0, x);
+    for (const OffsetValueType offset : sliceOffsets)
+    {
+      const auto bin = static_cast<SizeValueType>(static_cast<OffsetValueType>(column[offset]) - minimumValue);
+      if (add)
+      {
+        ++histogram[bin];
+        ++blockHistogram[bin / blockSize];
+        below += (bin < medianBin);
+      }
+      else
+      {
+        --histogram[bin];
+        --blockHistogram[bin / blockSize];
+        below -= (bin < medianBin);
+      }
+    }
+  };
+
+  // the slice of the neighborhood, relative to its first pixel
+  InputSizeType sliceRegionSize;
+  for (unsigned int dim = 0; dim < InputImageDimension; ++dim)
+  {
+    sliceRegionSize[dim] = 2 * radius[dim] + 1;
+  }
+  sliceRegionSize[0] = 1;
+  const InputImageRegionType sliceRegion(sliceRegionSize);
+
+  const SizeValueType rowLength = outputRegionForThread.GetSize(0);
+  const SizeValueType numberOfRows = outputRegionForThread.GetNumberOfPixels() / rowLength;
+  const auto          radius0 = static_cast<IndexValueType>(radius[0]);
+  auto                rowIndex = outputRegionForThread.GetIndex();
+  for (SizeValueType row = 0; row < numberOfRows; ++row)
+  {
+    // the offsets of the slice are the same along the row
+    auto sliceIt = sliceOffsets.begin();
+    for (const auto & offset : Experimental::ImageRegionIndexRange<InputImageDimension>(sliceRegion))
+    {
+      OffsetValueType sliceOffset = 0;
+      for (unsigned int dim = 1; dim < InputImageDimension; ++dim)
+      {
+        sliceOffset += clamp(dim, rowIndex[dim] + offset[dim] - static_cast<IndexValueType>(radius[dim])) *
+                       inputOffsetTable[dim];
+      }
+      *sliceIt++ = sliceOffset;
+    }
+
+    const IndexValueType firstX = rowIndex[0];
+    for (IndexValueType x = firstX - radius0; x <= firstX + radius0; ++x)
+    {
+      updateSlice(x, true);
+    }
+
+    OutputPixelType * outputIt = output->GetBufferPointer() + output->ComputeOffset(rowIndex);
+    for (SizeValueType i = 0; i < rowLength; ++i)
+    {
+      const IndexValueType x = firstX + static_cast<IndexValueType>(i);
+      if (i > 0)
+      {
+        updateSlice(x - radius0 - 1, false);
+        updateSlice(x + radius0, true);
+      }
+
+      // move the median down, skipping empty blocks
+      while (below > medianRank)
+      {
+        if (medianBin % blockSize == 0)
+        {
+          SizeValueType block = medianBin / blockSize - 1;
+          while (blockHistogram[block] == 0)
+          {
+            --block;
+          }
+          medianBin = (block + 1) * blockSize;
+        }
+        --medianBin;
+        below -= histogram[medianBin];
+      }
+      // or up
+      while (below + histogram[medianBin] <= medianRank)
+      {
+        below += histogram[medianBin];
+        ++medianBin;
+        if (medianBin % blockSize == 0)
+        {
+          SizeValueType block = medianBin / blockSize;
+          while (blockHistogram[block] == 0)
+          {
+            ++block;
+          }
+          medianBin = block * blockSize;
+        }
+      }
+      const auto median = static_cast<InputPixelType>(static_cast<OffsetValueType>(medianBin) + minimumValue);
+      *outputIt++ = static_cast<OutputPixelType>(median);
+    }
+
+    // empty the histogram for the next row
+    const IndexValueType lastX = firstX + static_cast<IndexValueType>(rowLength) - 1;
+    for (IndexValueType x = lastX - radius0; x <= lastX + radius0; ++x)
+    {
+      updateSlice(x, false);
+    }
+
+    for (unsigned int dim = 1; dim < InputImageDimension; ++dim)
+    {
+      if (++rowIndex[dim] <
+          outputRegionForThread.GetIndex(dim) + static_cast<IndexValueType>(outputRegionForThread.GetSize(dim)))
+      {
+        break;
+      }
+      rowIndex[dim] = outputRegionForThread.GetIndex(dim);
+    }
+  }
+  return true;
+}
 } // end namespace itk
 
 #endif
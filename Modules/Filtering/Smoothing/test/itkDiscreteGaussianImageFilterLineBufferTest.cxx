@@ -0,0 +1,168 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkStreamingImageFilter.h"
+#include "itkTestingMacros.h"
+#include "itkZeroFluxNeumannBoundaryCondition.h"
+
+#include <cmath>
+#include <iostream>
+
+// Compares the direct convolution of the pixel buffers, used with the
+// default boundary conditions, with the pipeline of
+// NeighborhoodOperatorImageFilters, used when the boundary conditions are
+// set to other ZeroFluxNeumannBoundaryCondition objects. They agree
+// exactly, except for float outputs.
+namespace
+{
+template <typename TImage>
+typename TImage::Pointer
+MakeImage(const typename TImage::SizeType & size)
+{
+  auto image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  typename TImage::SpacingType spacing;
+  for (unsigned int d = 0; d < TImage::ImageDimension; ++d)
+  {
+    spacing[d] = 0.5 + 0.25 * d;
+  }
+  image->SetSpacing(spacing);
+
+  unsigned int                        value = 7;
+  itk::ImageRegionIterator<TImage> it(image, image->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    value = (value * 1103515245u + 12345u) % 2147483648u;
+    it.Set(static_cast<typename TImage::PixelType>((value >> 16) % 200));
+  }
+  return image;
+}
+
+template <typename TInputImage, typename TOutputImage>
+bool
+CompareWithPipeline(const TInputImage *                                                 input,
+                    const typename itk::DiscreteGaussianImageFilter<TInputImage, TOutputImage>::ArrayType & variance,
+                    unsigned int filterDimensionality,
+                    unsigned int numberOfStreamDivisions,
+                    double       tolerance)
+{
+  using FilterType = itk::DiscreteGaussianImageFilter<TInputImage, TOutputImage>;
+  using RealImageType = typename FilterType::RealOutputImageType;
+
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetVariance(variance);
+  filter->SetFilterDimensionality(filterDimensionality);
+
+  auto streamer = itk::StreamingImageFilter<TOutputImage, TOutputImage>::New();
+  streamer->SetInput(filter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+
+  itk::ZeroFluxNeumannBoundaryCondition<TInputImage>   inputBoundaryCondition;
+  itk::ZeroFluxNeumannBoundaryCondition<RealImageType> realBoundaryCondition;
+  auto                                                 reference = FilterType::New();
+  reference->SetInput(input);
+  reference->SetVariance(variance);
+  reference->SetFilterDimensionality(filterDimensionality);
+  reference->SetInputBoundaryCondition(&inputBoundaryCondition);
+  reference->SetRealBoundaryCondition(&realBoundaryCondition);
+  reference->Update();
+
+  itk::ImageRegionConstIterator<TOutputImage> it(streamer->GetOutput(), input->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<TOutputImage> rit(reference->GetOutput(), input->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it, ++rit)
+  {
+    if (std::abs(static_cast<double>(it.Get()) - static_cast<double>(rit.Get())) > tolerance)
+    {
+      std::cerr << "Pixel " << it.GetIndex() << " is " << it.Get() << " instead of " << rit.Get()
+                << " (variance " << variance << ", filter dimensionality " << filterDimensionality << ", "
+                << numberOfStreamDivisions << " stream divisions)" << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkDiscreteGaussianImageFilterLineBufferTest(int, char *[])
+{
+  using FloatImageType = itk::Image<float, 3>;
+  using CharImageType = itk::Image<unsigned char, 2>;
+  using FloatImage2DType = itk::Image<float, 2>;
+  using ShortImageType = itk::Image<short, 3>;
+  using DoubleImageType = itk::Image<double, 3>;
+
+  FloatImageType::SizeType size3D = { { 37, 29, 23 } };
+  FloatImageType::Pointer  floatImage = MakeImage<FloatImageType>(size3D);
+
+  CharImageType::SizeType size2D = { { 53, 41 } };
+  CharImageType::Pointer  charImage = MakeImage<CharImageType>(size2D);
+
+  ShortImageType::Pointer  shortImage = MakeImage<ShortImageType>(size3D);
+  DoubleImageType::Pointer doubleImage = MakeImage<DoubleImageType>(size3D);
+
+  bool passed = true;
+
+  using FloatFilterType = itk::DiscreteGaussianImageFilter<FloatImageType, FloatImageType>;
+  FloatFilterType::ArrayType variance3D;
+  variance3D[0] = 1.0;
+  variance3D[1] = 4.0;
+  variance3D[2] = 0.5;
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 3, 1, 1e-3);
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 2, 1, 1e-3);
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 1, 1, 1e-3);
+  // requested regions smaller than the image
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 3, 5, 1e-3);
+  // a large kernel, wider than the streamed pieces
+  variance3D.Fill(9.0);
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 3, 7, 1e-3);
+  // no smoothing along one direction
+  variance3D[1] = 0.0;
+  passed &= CompareWithPipeline<FloatImageType, FloatImageType>(floatImage, variance3D, 3, 1, 1e-3);
+
+  using CharFilterType = itk::DiscreteGaussianImageFilter<CharImageType, FloatImage2DType>;
+  CharFilterType::ArrayType variance2D;
+  variance2D[0] = 2.0;
+  variance2D[1] = 3.0;
+  passed &= CompareWithPipeline<CharImageType, FloatImage2DType>(charImage, variance2D, 2, 1, 1e-3);
+  passed &= CompareWithPipeline<CharImageType, FloatImage2DType>(charImage, variance2D, 2, 3, 1e-3);
+
+  // integer and double outputs are exactly those of the pipeline
+  passed &= CompareWithPipeline<CharImageType, CharImageType>(charImage, variance2D, 2, 1, 0.0);
+  passed &= CompareWithPipeline<CharImageType, CharImageType>(charImage, variance2D, 2, 3, 0.0);
+  variance3D[0] = 1.0;
+  variance3D[1] = 4.0;
+  variance3D[2] = 0.5;
+  passed &= CompareWithPipeline<ShortImageType, ShortImageType>(shortImage, variance3D, 3, 1, 0.0);
+  passed &= CompareWithPipeline<ShortImageType, ShortImageType>(shortImage, variance3D, 3, 5, 0.0);
+  passed &= CompareWithPipeline<DoubleImageType, DoubleImageType>(doubleImage, variance3D, 3, 1, 0.0);
+  passed &= CompareWithPipeline<DoubleImageType, DoubleImageType>(doubleImage, variance3D, 2, 5, 0.0);
+  passed &= CompareWithPipeline<ShortImageType, DoubleImageType>(shortImage, variance3D, 3, 1, 0.0);
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
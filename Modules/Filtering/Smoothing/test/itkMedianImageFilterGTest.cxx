@@ -21,6 +21,7 @@
 
 #include "itkImage.h"
 #include "itkImageBufferRange.h"
+#include "itkStreamingImageFilter.h"
 
 #include <numeric> // For iota.
 #include <vector>
@@ -92,6 +93,58 @@ Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numb
   EXPECT_EQ(outputPixelValues, expectedPixelValues);
 }
 
+
+// Expects the sliding histogram, used for small integer pixel types and large neighborhoods, to give the same
+// output as std::nth_element, used for float pixels, also at the image boundaries and for streamed requests.
+template <typename TPixel, unsigned int VDimension>
+void
+Expect_same_output_for_integer_and_float_pixels(const itk::Size<VDimension> & imageSize,
+                                                const itk::Size<VDimension> & radius,
+                                                const unsigned int            numberOfStreamDivisions)
+{
+  using IntegerImageType = itk::Image<TPixel, VDimension>;
+  using FloatImageType = itk::Image<float, VDimension>;
+
+  const auto integerImage = IntegerImageType::New();
+  integerImage->SetRegions(imageSize);
+  integerImage->Allocate();
+  const auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(imageSize);
+  floatImage->Allocate();
+
+  // pseudo random values, spread over the range of the pixel type
+  const auto   integerRange = itk::Experimental::MakeImageBufferRange(integerImage.GetPointer());
+  auto         floatIt = itk::Experimental::MakeImageBufferRange(floatImage.GetPointer()).begin();
+  unsigned int value = 1;
+  for (auto && pixel : integerRange)
+  {
+    value = value * 1664525u + 1013904223u;
+    pixel = static_cast<TPixel>(value >> 16);
+    *floatIt = static_cast<float>(static_cast<TPixel>(pixel));
+    ++floatIt;
+  }
+
+  const auto integerFilter = itk::MedianImageFilter<IntegerImageType, IntegerImageType>::New();
+  integerFilter->SetInput(integerImage);
+  integerFilter->SetRadius(radius);
+  const auto streamer = itk::StreamingImageFilter<IntegerImageType, IntegerImageType>::New();
+  streamer->SetInput(integerFilter->GetOutput());
+  streamer->SetNumberOfStreamDivisions(numberOfStreamDivisions);
+  streamer->Update();
+
+  const auto floatFilter = itk::MedianImageFilter<FloatImageType, FloatImageType>::New();
+  floatFilter->SetInput(floatImage);
+  floatFilter->SetRadius(radius);
+  floatFilter->Update();
+
+  const auto integerOutput = itk::Experimental::MakeImageBufferRange(streamer->GetOutput());
+  const auto floatOutput = itk::Experimental::MakeImageBufferRange(floatFilter->GetOutput());
+  ASSERT_EQ(integerOutput.size(), floatOutput.size());
+  EXPECT_TRUE(std::equal(integerOutput.cbegin(), integerOutput.cend(), floatOutput.cbegin(), [](TPixel i, float f) {
+    return static_cast<float>(i) == f;
+  }));
+}
+
 } // namespace
 
 
@@ -122,3 +175,19 @@ TEST(MedianImageFilter, ExpectedOutputPixelValuesForSequenceOfNaturalNumbers)
   Expect_output_has_specified_pixel_values_when_input_has_sequence_of_natural_numbers<itk::Image<int, 3>>(
     itk::Size<3>{ { 2, 2, 2 } }, { 3, 3, 3, 4, 5, 6, 6, 6 });
 }
+
+
+// Tests that the sliding histogram gives the same output as sorting the neighborhood.
+TEST(MedianImageFilter, SameOutputForSlidingHistogramAndSorting)
+{
+  Expect_same_output_for_integer_and_float_pixels<unsigned char, 2>(
+    itk::Size<2>{ { 37, 23 } }, itk::Size<2>{ { 3, 2 } }, 1);
+  Expect_same_output_for_integer_and_float_pixels<signed char, 2>(
+    itk::Size<2>{ { 37, 23 } }, itk::Size<2>{ { 6, 6 } }, 3);
+  Expect_same_output_for_integer_and_float_pixels<unsigned char, 3>(
+    itk::Size<3>{ { 19, 17, 11 } }, itk::Size<3>{ { 2, 2, 2 } }, 4);
+  Expect_same_output_for_integer_and_float_pixels<short, 3>(
+    itk::Size<3>{ { 19, 17, 11 } }, itk::Size<3>{ { 2, 3, 2 } }, 1);
+  Expect_same_output_for_integer_and_float_pixels<unsigned short, 3>(
+    itk::Size<3>{ { 15, 13, 11 } }, itk::Size<3>{ { 5, 5, 5 } }, 2);
+}
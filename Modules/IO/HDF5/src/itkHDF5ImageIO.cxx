@@ -1013,6 +1013,21 @@ HDF5ImageIO ::WriteImageInformation()
     this->CloseH5File();
     this->CloseDataSet();
 
+    if (this->RequestedToStream() && itksys::SystemTools::FileExists(this->GetFileName()))
+    {
+      // Pasting into an existing file, which GetActualNumberOfSplitsForWriting
+      // has checked to match, so write into its voxel data instead of
+      // truncating it.
+      this->m_H5File = new H5::H5File(this->GetFileName(), H5F_ACC_RDWR);
+      this->m_VoxelDataSet = new H5::DataSet();
+      std::string VoxelDataName(ImageGroup);
+      VoxelDataName += "/0";
+      VoxelDataName += VoxelData;
+      *(this->m_VoxelDataSet) = this->m_H5File->openDataSet(VoxelDataName);
+      this->m_ImageInformationWritten = true;
+      return;
+    }
+
     H5::FileAccPropList fapl;
 #if (H5_VERS_MAJOR > 1) || (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR > 10) ||                                             \
   (H5_VERS_MAJOR == 1) && (H5_VERS_MINOR == 10) && (H5_VERS_RELEASE >= 2)
@@ -227,6 +227,94 @@ HDF5ReadWriteTest2(const char * fileName)
   return EXIT_SUCCESS;
 }
 
+int
+HDF5PasteTest(const char * fileName)
+{
+  using ImageType = itk::Image<float, 3>;
+  using WriterType = itk::ImageFileWriter<ImageType>;
+
+  // Write a constant image.
+  ImageType::SizeType size;
+  size.Fill(5);
+  ImageType::Pointer background = ImageType::New();
+  background->SetRegions(size);
+  background->Allocate();
+  background->FillBuffer(-1);
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(background);
+  try
+  {
+    writer->Update();
+  }
+  catch (itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ImageIOTest" << std::endl << "Exception Object caught: " << std::endl << err << std::endl;
+    return EXIT_FAILURE;
+  }
+  writer = WriterType::Pointer();
+
+  // Paste a region of the generated image into it.
+  itk::DemoImageSource<ImageType>::Pointer imageSource = itk::DemoImageSource<ImageType>::New();
+  imageSource->SetSize(size);
+  ImageType::RegionType pasteRegion;
+  pasteRegion.SetIndex(0, 1);
+  pasteRegion.SetIndex(1, 2);
+  pasteRegion.SetIndex(2, 3);
+  pasteRegion.SetSize(0, 3);
+  pasteRegion.SetSize(1, 2);
+  pasteRegion.SetSize(2, 2);
+  itk::ImageIORegion ioRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ioRegion.SetIndex(i, pasteRegion.GetIndex(i));
+    ioRegion.SetSize(i, pasteRegion.GetSize(i));
+  }
+  writer = WriterType::New();
+  writer->SetFileName(fileName);
+  writer->SetInput(imageSource->GetOutput());
+  writer->SetIORegion(ioRegion);
+  try
+  {
+    writer->Update();
+  }
+  catch (itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ImageIOTest" << std::endl << "Exception Object caught: " << std::endl << err << std::endl;
+    return EXIT_FAILURE;
+  }
+  // Force writer close.
+  writer = WriterType::Pointer();
+
+  // Read back, the region is pasted and the rest is unchanged.
+  ImageType::Pointer image;
+  try
+  {
+    image = itk::IOTestHelper::ReadImage<ImageType>(std::string(fileName));
+  }
+  catch (itk::ExceptionObject & err)
+  {
+    std::cout << "itkHDF5ImageIOTest" << std::endl << "Exception Object caught: " << std::endl << err << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType idx = it.GetIndex();
+    const float expected = pasteRegion.IsInside(idx) ? idx[2] * 100 + idx[1] * 10 + idx[0] : -1;
+    if (itk::Math::NotExactlyEquals(it.Get(), expected))
+    {
+      std::cout << "Pasted image value " << it.Get() << " at " << idx << " doesn't match expected " << expected
+                << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Clean working directory.
+  itk::IOTestHelper::Remove(fileName);
+
+  return EXIT_SUCCESS;
+}
+
 int
 itkHDF5ImageIOStreamingReadWriteTest(int ac, char * av[])
 {
@@ -243,5 +331,6 @@ itkHDF5ImageIOStreamingReadWriteTest(int ac, char * av[])
   result += HDF5ReadWriteTest2<unsigned char>("StreamingUCharImage.hdf5");
   result += HDF5ReadWriteTest2<float>("StreamingFloatImage.hdf5");
   result += HDF5ReadWriteTest2<itk::RGBPixel<unsigned char>>("StreamingRGBImage.hdf5");
+  result += HDF5PasteTest("PastingFloatImage.hdf5");
   return result != 0;
 }
@@ -118,6 +118,21 @@ public:
   itkGetConstReferenceMacro(UseStreaming, bool);
   itkBooleanMacro(UseStreaming);
 
+  /** Set/Get whether the output may be backed by a memory mapping of the
+   * file instead of a copy of its pixels. The operating system then reads
+   * the pixels lazily when they are first accessed, and shares them with
+   * other processes mapping the same file. The mapping is copy-on-write, so
+   * the output can be modified without changing the file. The file must not
+   * be modified or truncated while the output is in use.
+   *
+   * This only applies when the ImageIO supports it (see
+   * ImageIOBase::CanMemoryMapRead) and no pixel type conversion is needed;
+   * otherwise the pixels are read into a buffer as usual. Default is off.
+   * \sa MemoryMappedImportImageContainer */
+  itkSetMacro(UseMemoryMapping, bool);
+  itkGetConstReferenceMacro(UseMemoryMapping, bool);
+  itkBooleanMacro(UseMemoryMapping);
+
 protected:
   ImageFileReader();
   ~ImageFileReader() override = default;
@@ -153,6 +168,11 @@ protected:
   void
   GenerateData() override;
 
+  /** Back the output with a memory mapping of the file, if possible.
+   * Returns false if the pixels have to be read into a buffer instead. */
+  bool
+  MemoryMapOutput();
+
   ImageIOBase::Pointer m_ImageIO;
 
   bool m_UserSpecifiedImageIO; // keep track whether the
@@ -160,6 +180,8 @@ protected:
 
   bool m_UseStreaming;
 
+  bool m_UseMemoryMapping{ false };
+
 private:
   std::string m_ExceptionMessage;
 
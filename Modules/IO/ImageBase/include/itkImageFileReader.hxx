@@ -25,8 +25,10 @@
 #include "itkPixelTraits.h"
 #include "itkVectorImage.h"
 #include "itkMetaDataObject.h"
+#include "itkMemoryMappedImportImageContainer.h"
 
 #include "itksys/SystemTools.hxx"
+#include <cstdint>
 #include <memory> // For unique_ptr
 #include <fstream>
 
@@ -51,6 +53,7 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::PrintSelf(std::ostream & os,
 
   os << indent << "UserSpecifiedImageIO flag: " << m_UserSpecifiedImageIO << "\n";
   os << indent << "m_UseStreaming: " << m_UseStreaming << "\n";
+  os << indent << "UseMemoryMapping: " << m_UseMemoryMapping << "\n";
 }
 
 template <typename TOutputImage, typename ConvertPixelTraits>
@@ -356,6 +359,20 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
 
   typename TOutputImage::Pointer output = this->GetOutput();
 
+  if (m_UseMemoryMapping && this->MemoryMapOutput())
+  {
+    this->UpdateProgress(1.0f);
+    return;
+  }
+
+  // Do not read into a mapping left over from a previous update
+  using MemoryMappedContainerType =
+    MemoryMappedImportImageContainer<typename TOutputImage::PixelContainer::ElementIdentifier, OutputImagePixelType>;
+  if (dynamic_cast<MemoryMappedContainerType *>(output->GetPixelContainer()) != nullptr)
+  {
+    output->SetPixelContainer(TOutputImage::PixelContainer::New());
+  }
+
   itkDebugMacro(<< "ImageFileReader::GenerateData() \n"
                 << "Allocating the buffer with the EnlargedRequestedRegion \n"
                 << output->GetRequestedRegion() << "\n");
@@ -441,6 +458,76 @@ ImageFileReader<TOutputImage, ConvertPixelTraits>::GenerateData()
   this->UpdateProgress(1.0f);
 }
 
+template <typename TOutputImage, typename ConvertPixelTraits>
+bool
+ImageFileReader<TOutputImage, ConvertPixelTraits>::MemoryMapOutput()
+{
+  if (!MemoryMappedFile::IsSupported())
+  {
+    return false;
+  }
+
+  typename TOutputImage::Pointer output = this->GetOutput();
+
+  // Unlike GenerateData, compare with the number of components of the
+  // output rather than ConvertPixelTraits, so that VectorImages qualify
+  ImageIOBase::IOComponentType ioType = ImageIOBase ::MapPixelType<typename ConvertPixelTraits::ComponentType>::CType;
+  if (m_ImageIO->GetComponentType() != ioType ||
+      m_ImageIO->GetNumberOfComponents() != output->GetNumberOfComponentsPerPixel())
+  {
+    itkDebugMacro(<< "Not memory mapping: buffer conversion required.");
+    return false;
+  }
+
+  const SizeValueType numberOfPixels = output->GetRequestedRegion().GetNumberOfPixels();
+  const SizeValueType numberOfBytes =
+    m_ActualIORegion.GetNumberOfPixels() * m_ImageIO->GetComponentSize() * m_ImageIO->GetNumberOfComponents();
+  if (m_ActualIORegion.GetNumberOfPixels() != numberOfPixels || numberOfPixels == 0 ||
+      numberOfBytes % sizeof(OutputImagePixelType) != 0)
+  {
+    itkDebugMacro(<< "Not memory mapping: the read region differs from the requested region.");
+    return false;
+  }
+
+  m_ImageIO->SetFileName(this->GetFileName().c_str());
+  m_ImageIO->SetIORegion(m_ActualIORegion);
+
+  std::string           fileName;
+  ImageIOBase::SizeType offset = 0;
+  if (!m_ImageIO->CanMemoryMapRead(fileName, offset))
+  {
+    itkDebugMacro(<< "Not memory mapping: not supported by " << m_ImageIO->GetNameOfClass() << " for this file.");
+    return false;
+  }
+
+  MemoryMappedFile::Pointer mappedFile = MemoryMappedFile::New();
+  try
+  {
+    mappedFile->Map(fileName, static_cast<SizeValueType>(offset), numberOfBytes);
+  }
+  catch (const ExceptionObject & err)
+  {
+    itkDebugMacro(<< "Not memory mapping: " << err.GetDescription());
+    return false;
+  }
+  if (reinterpret_cast<std::uintptr_t>(mappedFile->GetPointer()) % alignof(OutputImagePixelType) != 0)
+  {
+    itkDebugMacro(<< "Not memory mapping: pixel data in " << fileName << " is misaligned.");
+    return false;
+  }
+
+  itkDebugMacro(<< "Memory mapping " << numberOfBytes << " bytes at offset " << offset << " of " << fileName);
+
+  using MemoryMappedContainerType =
+    MemoryMappedImportImageContainer<typename TOutputImage::PixelContainer::ElementIdentifier, OutputImagePixelType>;
+  typename MemoryMappedContainerType::Pointer container = MemoryMappedContainerType::New();
+  container->SetMemoryMappedFile(mappedFile, numberOfBytes / sizeof(OutputImagePixelType));
+
+  output->SetBufferedRegion(output->GetRequestedRegion());
+  output->SetPixelContainer(container.GetPointer());
+  return true;
+}
+
 template <typename TOutputImage, typename ConvertPixelTraits>
 void
 ImageFileReader<TOutputImage, ConvertPixelTraits>::DoConvertBuffer(void * inputData, size_t numberOfPixels)
@@ -446,6 +446,17 @@ public:
   virtual void
   Read(void * buffer) = 0;
 
+  /** Determine whether the pixels of the current IORegion can be memory
+   * mapped instead of being copied into a buffer by Read. This is the case
+   * when they are stored uncompressed and contiguously in a single file, in
+   * the byte order of this machine. If so, fileName and offset are set to
+   * that file and to the byte position of the first pixel of the IORegion
+   * in it. Must be called after ReadImageInformation and SetIORegion.
+   * Default is false.
+   * \sa ImageFileReader::SetUseMemoryMapping */
+  virtual bool
+  CanMemoryMapRead(std::string & fileName, SizeType & offset);
+
   /*-------- This part of the interfaces deals with writing data ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -846,6 +857,14 @@ protected:
   bool
   ReadBufferAsBinary(std::istream & os, void * buffer, SizeType numberOfBytesToBeRead);
 
+  /** Helper for CanMemoryMapRead, for formats storing the pixels of the
+   * whole image as a binary array starting at byte dataPosition of a file.
+   * Returns false if the file is not binary, is not in the byte order of
+   * this machine, or if the pixels of the IORegion are not contiguous.
+   * Otherwise offset is set to the position of the first of them. */
+  bool
+  ComputeMemoryMapReadOffset(SizeType dataPosition, SizeType & offset) const;
+
   /** Insert an extension to the list of supported extensions for reading. */
   void
   AddSupportedReadExtension(const char * extension);
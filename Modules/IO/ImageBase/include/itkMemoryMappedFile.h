@@ -0,0 +1,107 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedFile_h
+#define itkMemoryMappedFile_h
+
+#include "ITKIOImageBaseExport.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <string>
+
+namespace itk
+{
+/** \class MemoryMappedFile
+ * \brief Maps a range of a file into memory.
+ *
+ * The mapping is private and copy-on-write: the pages are read from the
+ * file lazily when first accessed, and are shared with other processes
+ * mapping the same file until they are written to. Writes go to private
+ * copies of the pages and never reach the file.
+ *
+ * The range is unmapped when the object is destroyed, so the pointer
+ * returned by GetPointer must not be used after that.
+ *
+ * Supported on POSIX systems and on Windows. IsSupported returns false
+ * on other platforms, and Map throws.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT MemoryMappedFile : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(MemoryMappedFile);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedFile;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedFile, Object);
+
+  /** Map length bytes of the file fileName, starting at byte offset.
+   * Any previous mapping is released first. Throws an ExceptionObject if
+   * the file cannot be opened, is shorter than offset + length, or cannot
+   * be mapped. */
+  void
+  Map(const std::string & fileName, SizeValueType offset, SizeValueType length);
+
+  /** Release the mapping, if any. */
+  void
+  Unmap();
+
+  /** The address of the byte at offset in the file, or nullptr if nothing
+   * is mapped. */
+  void *
+  GetPointer() const
+  {
+    return m_Pointer;
+  }
+
+  /** The number of mapped bytes, as passed to Map. */
+  itkGetConstMacro(Length, SizeValueType);
+
+  /** Whether memory mapping is available on this platform. */
+  static bool
+  IsSupported();
+
+protected:
+  MemoryMappedFile() = default;
+  ~MemoryMappedFile() override;
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  /** The mapping starts at a multiple of the allocation granularity,
+   * m_Pointer points to the requested offset within it. */
+  void *        m_Pointer{ nullptr };
+  char *        m_MappingStart{ nullptr };
+  SizeValueType m_MappingLength{ 0 };
+  SizeValueType m_Length{ 0 };
+  std::string   m_FileName;
+};
+} // end namespace itk
+
+#endif
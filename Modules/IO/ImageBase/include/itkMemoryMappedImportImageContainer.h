@@ -0,0 +1,98 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkMemoryMappedImportImageContainer_h
+#define itkMemoryMappedImportImageContainer_h
+
+#include "itkImportImageContainer.h"
+#include "itkMemoryMappedFile.h"
+
+namespace itk
+{
+/** \class MemoryMappedImportImageContainer
+ * \brief An ImportImageContainer whose elements live in a MemoryMappedFile.
+ *
+ * The container keeps the mapping alive for as long as it refers to it.
+ * ImageFileReader uses it to back an image directly with the pixels of an
+ * uncompressed file, see ImageFileReader::SetUseMemoryMapping.
+ *
+ * Since the mapping is copy-on-write, the pixels may be modified without
+ * affecting the file. Reserve and Squeeze copy the pixels into a buffer
+ * allocated as usual and release the mapping.
+ *
+ * \ingroup ImageObjects
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+template <typename TElementIdentifier, typename TElement>
+class ITK_TEMPLATE_EXPORT MemoryMappedImportImageContainer : public ImportImageContainer<TElementIdentifier, TElement>
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(MemoryMappedImportImageContainer);
+
+  /** Standard class type aliases. */
+  using Self = MemoryMappedImportImageContainer;
+  using Superclass = ImportImageContainer<TElementIdentifier, TElement>;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  using ElementIdentifier = typename Superclass::ElementIdentifier;
+  using Element = typename Superclass::Element;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(MemoryMappedImportImageContainer, ImportImageContainer);
+
+  /** Use the elements stored in the mapped range of the file. The
+   * mapping must hold exactly numberOfElements elements, and its
+   * address must be suitably aligned for TElement. */
+  void
+  SetMemoryMappedFile(MemoryMappedFile * file, ElementIdentifier numberOfElements)
+  {
+    this->SetImportPointer(static_cast<TElement *>(file->GetPointer()), numberOfElements, false);
+    m_MemoryMappedFile = file;
+  }
+
+  /** Get the mapping currently used, or nullptr. */
+  itkGetModifiableObjectMacro(MemoryMappedFile, MemoryMappedFile);
+
+protected:
+  MemoryMappedImportImageContainer() = default;
+  ~MemoryMappedImportImageContainer() override = default;
+
+  void
+  DeallocateManagedMemory() override
+  {
+    Superclass::DeallocateManagedMemory();
+    m_MemoryMappedFile = nullptr;
+  }
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override
+  {
+    Superclass::PrintSelf(os, indent);
+    itkPrintSelfObjectMacro(MemoryMappedFile);
+  }
+
+private:
+  MemoryMappedFile::Pointer m_MemoryMappedFile;
+};
+} // end namespace itk
+
+#endif
@@ -0,0 +1,104 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelDeflateCompressor_h
+#define itkParallelDeflateCompressor_h
+
+#include "ITKIOImageBaseExport.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkIntTypes.h"
+
+#include <memory>
+
+namespace itk
+{
+/** \class ParallelDeflateCompressor
+ * \brief Compresses a buffer with deflate, in blocks compressed in parallel.
+ *
+ * The buffer is split into blocks of BlockSize bytes, which are compressed
+ * independently by the threads of a MultiThreaderBase. Every block is
+ * primed with the last 32 KiB of the block before it, and all but the
+ * last one end on a byte boundary, so the blocks are simply concatenated.
+ * The checksums of the blocks are combined.
+ *
+ * The result is a single, standard zlib (RFC 1950) or gzip (RFC 1952)
+ * stream, which any inflate implementation decompresses. Only the
+ * compression ratio differs slightly from compressing the buffer at once.
+ *
+ * \ingroup IOFilters
+ * \ingroup ITKIOImageBase
+ */
+class ITKIOImageBase_EXPORT ParallelDeflateCompressor : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ParallelDeflateCompressor);
+
+  /** Standard class type aliases. */
+  using Self = ParallelDeflateCompressor;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ParallelDeflateCompressor, Object);
+
+  /** The header and trailer around the deflate data. */
+  enum class StreamFormat : uint8_t
+  {
+    Zlib,
+    Gzip
+  };
+
+  /** Set/Get the format of the stream. Defaults to Zlib. */
+  itkSetEnumMacro(Format, StreamFormat);
+  itkGetEnumMacro(Format, StreamFormat);
+
+  /** Set/Get the zlib compression level, from 0 to 9, or -1 for the zlib
+   * default. Defaults to -1. */
+  itkSetClampMacro(CompressionLevel, int, -1, 9);
+  itkGetConstMacro(CompressionLevel, int);
+
+  /** Set/Get the number of bytes compressed by a thread at once, at most
+   * 1 GiB. Smaller blocks compress slightly worse. Defaults to 1 MiB. */
+  itkSetClampMacro(BlockSize, SizeValueType, 1, SizeValueType{ 1 } << 30);
+  itkGetConstMacro(BlockSize, SizeValueType);
+
+  /** Compress size bytes of data. Returns a buffer allocated with new[],
+   * and sets compressedSize to its length. Throws an ExceptionObject if
+   * zlib fails. */
+  std::unique_ptr<unsigned char[]>
+  Compress(const void * data, SizeValueType size, SizeValueType & compressedSize) const;
+
+protected:
+  ParallelDeflateCompressor() = default;
+  ~ParallelDeflateCompressor() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+private:
+  StreamFormat  m_Format{ StreamFormat::Zlib };
+  int           m_CompressionLevel{ -1 };
+  SizeValueType m_BlockSize{ 1024 * 1024 };
+};
+} // end namespace itk
+
+#endif
@@ -18,6 +18,8 @@
 
 #include "itkImageIOBase.h"
 #include "itkImageRegionSplitterSlowDimension.h"
+#include "itkByteSwapper.h"
+#include <algorithm>
 #include <mutex>
 #include "itksys/SystemTools.hxx"
 #include "itkPrintHelper.h"
@@ -323,6 +325,53 @@ ImageIOBase ::ReadBufferAsBinary(std::istream & is, void * buffer, ImageIOBase::
   return true;
 }
 
+bool
+ImageIOBase::CanMemoryMapRead(std::string & itkNotUsed(fileName), SizeType & itkNotUsed(offset))
+{
+  return false;
+}
+
+bool
+ImageIOBase::ComputeMemoryMapReadOffset(SizeType dataPosition, SizeType & offset) const
+{
+  if (m_FileType != Binary)
+  {
+    return false;
+  }
+  if (this->GetComponentSize() > 1)
+  {
+    const bool systemIsBigEndian = ByteSwapper<int>::SystemIsBigEndian();
+    if ((m_ByteOrder == BigEndian && !systemIsBigEndian) || (m_ByteOrder == LittleEndian && systemIsBigEndian))
+    {
+      return false;
+    }
+  }
+
+  // The pixels are contiguous if the region spans the whole image in all
+  // dimensions but the slowest one it extends in
+  const unsigned int regionDimension = m_IORegion.GetImageDimension();
+  const unsigned int dimension = std::max(regionDimension, m_NumberOfDimensions);
+  SizeType           pixelOffset = 0;
+  SizeType           stride = 1;
+  bool               isPartial = false;
+  for (unsigned int d = 0; d < dimension; ++d)
+  {
+    const SizeType index = d < regionDimension ? m_IORegion.GetIndex(d) : 0;
+    const SizeType size = d < regionDimension ? static_cast<SizeType>(m_IORegion.GetSize(d)) : 1;
+    const SizeType imageSize = d < m_NumberOfDimensions ? static_cast<SizeType>(m_Dimensions[d]) : 1;
+    if (index < 0 || index + size > imageSize || (isPartial && size != 1))
+    {
+      return false;
+    }
+    isPartial = isPartial || size != imageSize;
+    pixelOffset += index * stride;
+    stride *= imageSize;
+  }
+
+  offset = dataPosition + pixelOffset * static_cast<SizeType>(this->GetPixelSize());
+  return true;
+}
+
 unsigned int
 ImageIOBase::GetPixelSize() const
 {
@@ -0,0 +1,169 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkMemoryMappedFile.h"
+#include "itkInternationalizationIOHelpers.h"
+
+#include <algorithm>
+
+#if defined(_WIN32)
+#  define ITK_MEMORY_MAPPED_FILE_WIN32 1
+#  include <windows.h>
+#  include <io.h>
+#elif defined(ITK_HAVE_UNISTD_H)
+#  define ITK_MEMORY_MAPPED_FILE_POSIX 1
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+namespace itk
+{
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+  this->Unmap();
+}
+
+bool
+MemoryMappedFile::IsSupported()
+{
+#if defined(ITK_MEMORY_MAPPED_FILE_WIN32) || defined(ITK_MEMORY_MAPPED_FILE_POSIX)
+  return true;
+#else
+  return false;
+#endif
+}
+
+void
+MemoryMappedFile::Map(const std::string & fileName, SizeValueType offset, SizeValueType length)
+{
+  this->Unmap();
+
+  const int fd = i18n::I18nOpenForReading(fileName);
+  if (fd < 0)
+  {
+    itkExceptionMacro("Cannot open " << fileName << " for mapping.");
+  }
+
+  SizeValueType mappingOffset = 0;
+  void *        mapping = nullptr;
+
+#if defined(ITK_MEMORY_MAPPED_FILE_POSIX)
+  // Accessing a page beyond the end of the file raises SIGBUS, so make
+  // sure the whole range exists
+  struct stat fileStatus;
+  if (fstat(fd, &fileStatus) != 0 || static_cast<SizeValueType>(fileStatus.st_size) < offset + length)
+  {
+    close(fd);
+    itkExceptionMacro("File " << fileName << " is too short to map " << length << " bytes at offset " << offset
+                              << '.');
+  }
+
+  const auto          granularity = static_cast<SizeValueType>(sysconf(_SC_PAGESIZE));
+  mappingOffset = offset - offset % granularity;
+  const SizeValueType mappingLength = length + (offset - mappingOffset);
+
+  // A zero length mapping is invalid, map at least one byte
+  mapping = mmap(nullptr,
+                 std::max<SizeValueType>(mappingLength, 1),
+                 PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE,
+                 fd,
+                 static_cast<off_t>(mappingOffset));
+  close(fd); // the mapping keeps its own reference to the file
+  if (mapping == MAP_FAILED)
+  {
+    itkExceptionMacro("Cannot map " << fileName << '.');
+  }
+  m_MappingLength = std::max<SizeValueType>(mappingLength, 1);
+#elif defined(ITK_MEMORY_MAPPED_FILE_WIN32)
+  const auto    file = reinterpret_cast<HANDLE>(_get_osfhandle(fd));
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || static_cast<SizeValueType>(fileSize.QuadPart) < offset + length)
+  {
+    _close(fd);
+    itkExceptionMacro("File " << fileName << " is too short to map " << length << " bytes at offset " << offset
+                              << '.');
+  }
+
+  SYSTEM_INFO systemInfo;
+  GetSystemInfo(&systemInfo);
+  const auto          granularity = static_cast<SizeValueType>(systemInfo.dwAllocationGranularity);
+  mappingOffset = offset - offset % granularity;
+  const SizeValueType mappingLength = length + (offset - mappingOffset);
+
+  HANDLE fileMapping = CreateFileMapping(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+  _close(fd);
+  if (fileMapping != nullptr)
+  {
+    const auto mappingOffset64 = static_cast<unsigned long long>(mappingOffset);
+    mapping = MapViewOfFile(fileMapping,
+                            FILE_MAP_COPY,
+                            static_cast<DWORD>(mappingOffset64 >> 32),
+                            static_cast<DWORD>(mappingOffset64 & 0xffffffffULL),
+                            static_cast<SIZE_T>(mappingLength));
+    // the view keeps the mapping object alive
+    CloseHandle(fileMapping);
+  }
+  if (mapping == nullptr)
+  {
+    itkExceptionMacro("Cannot map " << fileName << '.');
+  }
+  m_MappingLength = mappingLength;
+#else
+  close(fd);
+  itkExceptionMacro("Memory mapping is not supported on this platform.");
+#endif
+
+  m_MappingStart = static_cast<char *>(mapping);
+  m_Pointer = m_MappingStart + (offset - mappingOffset);
+  m_Length = length;
+  m_FileName = fileName;
+  this->Modified();
+}
+
+void
+MemoryMappedFile::Unmap()
+{
+  if (m_MappingStart == nullptr)
+  {
+    return;
+  }
+#if defined(ITK_MEMORY_MAPPED_FILE_POSIX)
+  munmap(m_MappingStart, m_MappingLength);
+#elif defined(ITK_MEMORY_MAPPED_FILE_WIN32)
+  UnmapViewOfFile(m_MappingStart);
+#endif
+  m_MappingStart = nullptr;
+  m_MappingLength = 0;
+  m_Pointer = nullptr;
+  m_Length = 0;
+  m_FileName.clear();
+}
+
+void
+MemoryMappedFile::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "FileName: " << m_FileName << std::endl;
+  os << indent << "Pointer: " << m_Pointer << std::endl;
+  os << indent << "Length: " << m_Length << std::endl;
+}
+
+} // end namespace itk
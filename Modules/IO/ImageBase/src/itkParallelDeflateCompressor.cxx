@@ -0,0 +1,185 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkParallelDeflateCompressor.h"
+#include "itkMultiThreaderBase.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace itk
+{
+namespace
+{
+struct CompressedBlock
+{
+  std::vector<unsigned char> m_Data;
+  uLong                      m_Checksum{ 0 };
+  SizeValueType              m_Length{ 0 };
+};
+
+void
+AppendBigEndian32(unsigned char *& out, uLong value)
+{
+  for (int shift = 24; shift >= 0; shift -= 8)
+  {
+    *out++ = static_cast<unsigned char>((value >> shift) & 0xff);
+  }
+}
+
+void
+AppendLittleEndian32(unsigned char *& out, uLong value)
+{
+  for (int shift = 0; shift <= 24; shift += 8)
+  {
+    *out++ = static_cast<unsigned char>((value >> shift) & 0xff);
+  }
+}
+} // namespace
+
+std::unique_ptr<unsigned char[]>
+ParallelDeflateCompressor::Compress(const void * data, SizeValueType size, SizeValueType & compressedSize) const
+{
+  const auto * const input = static_cast<const unsigned char *>(data);
+  const bool         gzip = (m_Format == StreamFormat::Gzip);
+  const int          level = m_CompressionLevel;
+  const SizeValueType blockSize = m_BlockSize;
+  const SizeValueType numberOfBlocks = std::max<SizeValueType>(1, (size + blockSize - 1) / blockSize);
+
+  std::vector<CompressedBlock> blocks(numberOfBlocks);
+
+  MultiThreaderBase::Pointer multiThreader = MultiThreaderBase::New();
+  multiThreader->ParallelizeArray(
+    0,
+    numberOfBlocks,
+    [&](SizeValueType b) {
+      const SizeValueType start = b * blockSize;
+      const SizeValueType length = std::min(blockSize, size - start);
+      const bool          last = (b + 1 == numberOfBlocks);
+      CompressedBlock &   block = blocks[b];
+      block.m_Length = length;
+
+      z_stream stream;
+      std::memset(&stream, 0, sizeof(stream));
+      // raw deflate, the header and trailer are written around all blocks
+      if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+      {
+        itkExceptionMacro("deflateInit2 failed");
+      }
+      if (start > 0)
+      {
+        // back references may reach into the data of the previous block
+        const SizeValueType dictionaryLength = std::min<SizeValueType>(start, 32768);
+        deflateSetDictionary(&stream, input + start - dictionaryLength, static_cast<uInt>(dictionaryLength));
+      }
+
+      // a sync flush ends all but the last block on a byte boundary,
+      // without marking it as the final one
+      const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+      block.m_Data.resize(deflateBound(&stream, static_cast<uLong>(length)) + 16);
+      stream.next_in = const_cast<Bytef *>(input + start);
+      stream.avail_in = static_cast<uInt>(length);
+      SizeValueType produced = 0;
+      while (true)
+      {
+        stream.next_out = block.m_Data.data() + produced;
+        stream.avail_out = static_cast<uInt>(block.m_Data.size() - produced);
+        const int result = deflate(&stream, flush);
+        produced = block.m_Data.size() - stream.avail_out;
+        if (result == Z_STREAM_ERROR)
+        {
+          deflateEnd(&stream);
+          itkExceptionMacro("deflate failed");
+        }
+        if (last ? result == Z_STREAM_END : (stream.avail_in == 0 && stream.avail_out != 0))
+        {
+          break;
+        }
+        block.m_Data.resize(2 * block.m_Data.size());
+      }
+      deflateEnd(&stream);
+      block.m_Data.resize(produced);
+
+      block.m_Checksum = gzip ? crc32(crc32(0, nullptr, 0), input + start, static_cast<uInt>(length))
+                              : adler32(adler32(0, nullptr, 0), input + start, static_cast<uInt>(length));
+    },
+    nullptr);
+
+  uLong         checksum = blocks[0].m_Checksum;
+  SizeValueType deflateSize = blocks[0].m_Data.size();
+  for (SizeValueType b = 1; b < numberOfBlocks; ++b)
+  {
+    const auto length = static_cast<z_off_t>(blocks[b].m_Length);
+    checksum = gzip ? crc32_combine(checksum, blocks[b].m_Checksum, length)
+                    : adler32_combine(checksum, blocks[b].m_Checksum, length);
+    deflateSize += blocks[b].m_Data.size();
+  }
+
+  const SizeValueType headerSize = gzip ? 10 : 2;
+  const SizeValueType trailerSize = gzip ? 8 : 4;
+  compressedSize = headerSize + deflateSize + trailerSize;
+  std::unique_ptr<unsigned char[]> compressed(new unsigned char[compressedSize]);
+  unsigned char *                  out = compressed.get();
+
+  const int effectiveLevel = (level == Z_DEFAULT_COMPRESSION) ? 6 : level;
+  if (gzip)
+  {
+    // no file name, no modification time, unknown operating system
+    const unsigned char extraFlags = effectiveLevel == 9 ? 2 : (effectiveLevel == 1 ? 4 : 0);
+    const unsigned char header[10] = { 0x1f, 0x8b, Z_DEFLATED, 0, 0, 0, 0, 0, extraFlags, 255 };
+    std::memcpy(out, header, sizeof(header));
+    out += sizeof(header);
+  }
+  else
+  {
+    // the same compression level flags as zlib writes
+    const unsigned int levelFlags = effectiveLevel < 2 ? 0 : (effectiveLevel < 6 ? 1 : (effectiveLevel == 6 ? 2 : 3));
+    unsigned int       header = ((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8) | (levelFlags << 6);
+    header += 31 - (header % 31);
+    *out++ = static_cast<unsigned char>(header >> 8);
+    *out++ = static_cast<unsigned char>(header & 0xff);
+  }
+
+  for (const auto & block : blocks)
+  {
+    std::memcpy(out, block.m_Data.data(), block.m_Data.size());
+    out += block.m_Data.size();
+  }
+
+  if (gzip)
+  {
+    AppendLittleEndian32(out, checksum);
+    AppendLittleEndian32(out, static_cast<uLong>(size & 0xffffffff));
+  }
+  else
+  {
+    AppendBigEndian32(out, checksum);
+  }
+  return compressed;
+}
+
+void
+ParallelDeflateCompressor::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+  os << indent << "Format: " << (m_Format == StreamFormat::Gzip ? "Gzip" : "Zlib") << std::endl;
+  os << indent << "CompressionLevel: " << m_CompressionLevel << std::endl;
+  os << indent << "BlockSize: " << m_BlockSize << std::endl;
+}
+} // end namespace itk
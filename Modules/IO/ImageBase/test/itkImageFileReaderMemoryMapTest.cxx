@@ -0,0 +1,192 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkVectorImage.h"
+#include "itkTestingMacros.h"
+
+#include <iostream>
+
+namespace
+{
+template <typename TImage>
+bool
+IsMemoryMapped(const TImage * image)
+{
+  using ContainerType = itk::MemoryMappedImportImageContainer<typename TImage::PixelContainer::ElementIdentifier,
+                                                              typename TImage::InternalPixelType>;
+  return dynamic_cast<const ContainerType *>(image->GetPixelContainer()) != nullptr;
+}
+
+template <typename TImage1, typename TImage2>
+bool
+SameValues(const TImage1 * image1, const TImage2 * image2)
+{
+  itk::ImageRegionConstIterator<TImage1> it1(image1, image2->GetBufferedRegion());
+  itk::ImageRegionConstIterator<TImage2> it2(image2, image2->GetBufferedRegion());
+  for (; !it2.IsAtEnd(); ++it1, ++it2)
+  {
+    if (static_cast<double>(it1.Get()) != static_cast<double>(it2.Get()))
+    {
+      std::cerr << "Pixel " << it2.GetIndex() << " differs: " << it1.Get() << " != " << it2.Get() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkImageFileReaderMemoryMapTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  constexpr unsigned int Dimension = 3;
+  using ImageType = itk::Image<float, Dimension>;
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  using WriterType = itk::ImageFileWriter<ImageType>;
+
+  ImageType::SizeType size = { { 13, 7, 5 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  float value = 0.0f;
+  for (float * p = image->GetBufferPointer(); p != image->GetBufferPointer() + image->GetPixelContainer()->Size(); ++p)
+  {
+    *p = value;
+    value += 0.5f;
+  }
+
+  const std::string fileName = directory + "/itkImageFileReaderMemoryMapTest.mhd";
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  ReaderType::Pointer reader = ReaderType::New();
+  ITK_TEST_SET_GET_BOOLEAN(reader, UseMemoryMapping, false);
+  reader->UseMemoryMappingOn();
+  reader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(IsMemoryMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), reader->GetOutput()));
+
+  // The mapping is copy-on-write: modifying the output leaves the file alone
+  reader->GetOutput()->GetBufferPointer()[0] = -1.0f;
+  ReaderType::Pointer copyReader = ReaderType::New();
+  copyReader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(copyReader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMemoryMapped(copyReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), copyReader->GetOutput()));
+
+  // The output stays valid after the reader is gone
+  ImageType::Pointer mapped = reader->GetOutput();
+  reader = nullptr;
+  ITK_TEST_EXPECT_EQUAL(mapped->GetPixel({ { 12, 6, 4 } }), image->GetPixel({ { 12, 6, 4 } }));
+  mapped = nullptr;
+
+  // Streaming a slab maps only the pixels of the slab
+  reader = ReaderType::New();
+  reader->UseMemoryMappingOn();
+  reader->SetFileName(fileName);
+  reader->UpdateOutputInformation();
+  ImageType::RegionType slab = reader->GetOutput()->GetLargestPossibleRegion();
+  slab.SetIndex(2, 2);
+  slab.SetSize(2, 2);
+  reader->GetOutput()->SetRequestedRegion(slab);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->GetOutput()->Update());
+  ITK_TEST_EXPECT_EQUAL(reader->GetOutput()->GetBufferedRegion(), slab);
+  ITK_TEST_EXPECT_TRUE(IsMemoryMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), reader->GetOutput()));
+
+  // A pixel type conversion is read into a buffer
+  using DoubleImageType = itk::Image<double, Dimension>;
+  auto doubleReader = itk::ImageFileReader<DoubleImageType>::New();
+  doubleReader->UseMemoryMappingOn();
+  doubleReader->SetFileName(fileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(doubleReader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMemoryMapped(doubleReader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), doubleReader->GetOutput()));
+
+  // So is compressed data
+  const std::string compressedFileName = directory + "/itkImageFileReaderMemoryMapTestCompressed.mha";
+  writer->SetFileName(compressedFileName);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  reader = ReaderType::New();
+  reader->UseMemoryMappingOn();
+  reader->SetFileName(compressedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMemoryMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), reader->GetOutput()));
+
+  // Data stored after the header in the same file
+  const std::string localFileName = directory + "/itkImageFileReaderMemoryMapTest.mha";
+  writer->SetFileName(localFileName);
+  writer->UseCompressionOff();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  reader = ReaderType::New();
+  reader->UseMemoryMappingOn();
+  reader->SetFileName(localFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  std::cout << "Local data memory mapped: " << IsMemoryMapped(reader->GetOutput()) << std::endl;
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), reader->GetOutput()));
+
+  // Updating again without memory mapping does not write into the mapping
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOff();
+  ITK_TRY_EXPECT_NO_EXCEPTION(reader->Update());
+  ITK_TEST_EXPECT_TRUE(!IsMemoryMapped(reader->GetOutput()));
+  ITK_TEST_EXPECT_TRUE(SameValues(image.GetPointer(), reader->GetOutput()));
+
+  // Multi-component pixels into a VectorImage
+  using VectorImageType = itk::VectorImage<float, Dimension>;
+  using VectorType = itk::Vector<float, 2>;
+  using VectorPixelImageType = itk::Image<VectorType, Dimension>;
+  VectorPixelImageType::Pointer vectorImage = VectorPixelImageType::New();
+  vectorImage->SetRegions(size);
+  vectorImage->Allocate();
+  vectorImage->FillBuffer(VectorType(3.0f));
+  vectorImage->SetPixel({ { 1, 2, 3 } }, VectorType(5.0f));
+  const std::string vectorFileName = directory + "/itkImageFileReaderMemoryMapTestVector.mhd";
+  auto vectorWriter = itk::ImageFileWriter<VectorPixelImageType>::New();
+  vectorWriter->SetInput(vectorImage);
+  vectorWriter->SetFileName(vectorFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorWriter->Update());
+
+  auto vectorReader = itk::ImageFileReader<VectorImageType>::New();
+  vectorReader->UseMemoryMappingOn();
+  vectorReader->SetFileName(vectorFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(vectorReader->Update());
+  ITK_TEST_EXPECT_TRUE(IsMemoryMapped(vectorReader->GetOutput()));
+  ITK_TEST_EXPECT_EQUAL(vectorReader->GetOutput()->GetNumberOfComponentsPerPixel(), 2);
+  ITK_TEST_EXPECT_EQUAL(vectorReader->GetOutput()->GetPixel({ { 1, 2, 3 } })[1], 5.0f);
+  ITK_TEST_EXPECT_EQUAL(vectorReader->GetOutput()->GetPixel({ { 1, 2, 2 } })[0], 3.0f);
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
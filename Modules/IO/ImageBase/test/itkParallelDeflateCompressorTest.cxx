@@ -0,0 +1,137 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkParallelDeflateCompressor.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+// Inflates a whole zlib or gzip stream with zlib itself, and compares the
+// result with the original data.
+bool
+InflatesTo(const unsigned char *              compressed,
+           itk::SizeValueType                 compressedSize,
+           const std::vector<unsigned char> & expected,
+           bool                               gzip)
+{
+  z_stream stream;
+  std::memset(&stream, 0, sizeof(stream));
+  if (inflateInit2(&stream, gzip ? MAX_WBITS + 16 : MAX_WBITS) != Z_OK)
+  {
+    std::cerr << "inflateInit2 failed" << std::endl;
+    return false;
+  }
+  std::vector<unsigned char> inflated(expected.size() + 1);
+  stream.next_in = const_cast<Bytef *>(compressed);
+  stream.avail_in = static_cast<uInt>(compressedSize);
+  stream.next_out = inflated.data();
+  stream.avail_out = static_cast<uInt>(inflated.size());
+  const int result = inflate(&stream, Z_FINISH);
+  const uLong total = stream.total_out;
+  const uInt  remainingInput = stream.avail_in;
+  inflateEnd(&stream);
+
+  if (result != Z_STREAM_END)
+  {
+    std::cerr << "inflate returned " << result << " instead of Z_STREAM_END" << std::endl;
+    return false;
+  }
+  if (remainingInput != 0)
+  {
+    std::cerr << remainingInput << " bytes follow the end of the stream" << std::endl;
+    return false;
+  }
+  if (total != expected.size() || !std::equal(expected.begin(), expected.end(), inflated.begin()))
+  {
+    std::cerr << "Inflated " << total << " bytes which differ from the " << expected.size() << " input bytes"
+              << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkParallelDeflateCompressorTest(int, char *[])
+{
+  using CompressorType = itk::ParallelDeflateCompressor;
+  CompressorType::Pointer compressor = CompressorType::New();
+
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(compressor, ParallelDeflateCompressor, Object);
+
+  ITK_TEST_EXPECT_EQUAL(compressor->GetCompressionLevel(), -1);
+  compressor->SetCompressionLevel(12);
+  ITK_TEST_EXPECT_EQUAL(compressor->GetCompressionLevel(), 9);
+  compressor->SetBlockSize(0);
+  ITK_TEST_EXPECT_EQUAL(compressor->GetBlockSize(), 1);
+
+  // compressible data with a pattern longer than the small blocks below, so
+  // matches reach into the previous block
+  std::vector<unsigned char> data(300000);
+  for (size_t i = 0; i < data.size(); ++i)
+  {
+    data[i] = static_cast<unsigned char>((i * 7 + (i / 1000) * 13) % 251);
+  }
+  const std::vector<unsigned char> empty;
+
+  bool passed = true;
+  for (const auto format : { CompressorType::StreamFormat::Zlib, CompressorType::StreamFormat::Gzip })
+  {
+    const bool gzip = (format == CompressorType::StreamFormat::Gzip);
+    compressor->SetFormat(format);
+    ITK_TEST_EXPECT_TRUE(compressor->GetFormat() == format);
+
+    for (const int level : { 0, 1, -1, 9 })
+    {
+      compressor->SetCompressionLevel(level);
+      for (const itk::SizeValueType blockSize : { 1000, 65536, 1048576 })
+      {
+        compressor->SetBlockSize(blockSize);
+
+        itk::SizeValueType                     compressedSize = 0;
+        const std::unique_ptr<unsigned char[]> compressed =
+          compressor->Compress(data.data(), data.size(), compressedSize);
+        if (!InflatesTo(compressed.get(), compressedSize, data, gzip))
+        {
+          std::cerr << "Failed with gzip " << gzip << ", level " << level << ", block size " << blockSize << std::endl;
+          passed = false;
+        }
+      }
+
+      itk::SizeValueType                     compressedSize = 0;
+      const std::unique_ptr<unsigned char[]> compressed = compressor->Compress(nullptr, 0, compressedSize);
+      if (!InflatesTo(compressed.get(), compressedSize, empty, gzip))
+      {
+        std::cerr << "Failed on empty input with gzip " << gzip << ", level " << level << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  if (!passed)
+  {
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -21,6 +21,7 @@
 
 
 #include <fstream>
+#include <memory>
 #include "itkImageIOBase.h"
 #include "itkSingletonMacro.h"
 #include "metaObject.h"
@@ -80,6 +81,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Uncompressed binary data in a single data file (local or not) can be
+   * memory mapped, unless SubSamplingFactor is used. */
+  bool
+  CanMemoryMapRead(std::string & fileName, SizeType & offset) override;
+
   MetaImage *
   GetMetaImagePointer();
 
@@ -190,7 +196,29 @@ private:
   /** Only used to synchronize the global variable across static libraries.*/
   itkGetGlobalDeclarationMacro(unsigned int, DefaultDoublePrecision);
 
-  MetaImage m_MetaImage;
+  /** MetaImage which can write its element data compressed by
+   * ParallelDeflateCompressor, as one zlib stream deflated in parallel
+   * blocks, instead of by MetaIO on a single thread. */
+  class ParallelCompressionMetaImage : public MetaImage
+  {
+  public:
+    /** Write the header and the compressed element data. Only for binary
+     * data stored in a single file, as MetaImage::Write otherwise does not
+     * compress the data at once. */
+    bool
+    WriteParallelCompressed(const char * headerName);
+
+  protected:
+    void
+    M_SetupWriteFields() override;
+    bool
+    M_Write() override;
+
+  private:
+    std::unique_ptr<unsigned char[]> m_ParallelCompressedData;
+  };
+
+  ParallelCompressionMetaImage m_MetaImage;
 
   unsigned int m_SubSamplingFactor;
 
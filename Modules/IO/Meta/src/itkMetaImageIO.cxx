@@ -23,6 +23,7 @@
 #include "itksys/SystemTools.hxx"
 #include "itkMath.h"
 #include "itkSingleton.h"
+#include "itkParallelDeflateCompressor.h"
 
 namespace itk
 {
@@ -32,6 +33,74 @@ itkGetGlobalValueMacro(MetaImageIO, unsigned int, DefaultDoublePrecision, 17);
 
 unsigned int * MetaImageIO::m_DefaultDoublePrecision;
 
+bool
+MetaImageIO::ParallelCompressionMetaImage::WriteParallelCompressed(const char * headerName)
+{
+  this->FileName(headerName);
+
+  // Name the data file as MetaImage::Write does for compressed data
+  std::string defaultDataFileName;
+  if (m_ElementDataFileName.empty())
+  {
+    int suffixPosition = 0;
+    MET_GetFileSuffixPtr(m_FileName, &suffixPosition);
+    if (m_FileName.compare(suffixPosition, std::string::npos, "mha") == 0)
+    {
+      defaultDataFileName = "LOCAL";
+    }
+    else
+    {
+      MET_SetFileSuffix(m_FileName, "mhd");
+      defaultDataFileName = m_FileName;
+      MET_SetFileSuffix(defaultDataFileName, "zraw");
+    }
+  }
+
+  int elementSize = 0;
+  MET_SizeOfType(m_ElementType, &elementSize);
+  ParallelDeflateCompressor::Pointer compressor = ParallelDeflateCompressor::New();
+  compressor->SetCompressionLevel(m_CompressionLevel);
+  SizeValueType compressedSize = 0;
+  m_ParallelCompressedData = compressor->Compress(
+    m_ElementData, static_cast<SizeValueType>(m_Quantity * elementSize * m_ElementNumberOfChannels), compressedSize);
+  m_CompressedDataSize = static_cast<std::streamoff>(compressedSize);
+
+  // WriteStream deflates the data itself when CompressedData is on, so it
+  // is only turned on for the header, by M_SetupWriteFields. M_Write then
+  // appends the data compressed above.
+  m_CompressedData = false;
+  const bool written =
+    this->Write(nullptr, defaultDataFileName.empty() ? nullptr : defaultDataFileName.c_str(), false);
+  m_CompressedData = true;
+  m_CompressedDataSize = 0;
+  m_ParallelCompressedData.reset();
+  return written;
+}
+
+void
+MetaImageIO::ParallelCompressionMetaImage::M_SetupWriteFields()
+{
+  if (m_ParallelCompressedData)
+  {
+    m_CompressedData = true;
+  }
+  MetaImage::M_SetupWriteFields();
+}
+
+bool
+MetaImageIO::ParallelCompressionMetaImage::M_Write()
+{
+  if (!MetaImage::M_Write())
+  {
+    return false;
+  }
+  if (m_ParallelCompressedData)
+  {
+    return this->M_WriteElements(m_WriteStream, m_ParallelCompressedData.get(), m_CompressedDataSize);
+  }
+  return true;
+}
+
 MetaImageIO::MetaImageIO()
 {
   itkInitGlobalsMacro(DefaultDoublePrecision);
@@ -494,6 +563,57 @@ MetaImageIO::Read(void * buffer)
   }
 }
 
+bool
+MetaImageIO::CanMemoryMapRead(std::string & fileName, SizeType & offset)
+{
+  if (m_MetaImage.CompressedData() || m_SubSamplingFactor != 1 ||
+      (this->GetComponentSize() > 1 && m_MetaImage.BinaryDataByteOrderMSB() != MET_SystemByteOrderMSB()))
+  {
+    return false;
+  }
+
+  const std::string elementDataFileName = m_MetaImage.ElementDataFileName();
+  if (elementDataFileName.compare(0, 4, "LIST") == 0 || elementDataFileName.find('%') != std::string::npos)
+  {
+    return false; // one file per slice
+  }
+  if (itksys::SystemTools::UpperCase(elementDataFileName) == "LOCAL")
+  {
+    fileName = m_FileName;
+  }
+  else if (itksys::SystemTools::FileIsFullPath(elementDataFileName))
+  {
+    fileName = elementDataFileName;
+  }
+  else
+  {
+    const std::string path = itksys::SystemTools::GetFilenamePath(m_FileName);
+    fileName = path.empty() ? elementDataFileName : path + '/' + elementDataFileName;
+  }
+
+  // Same logic as MetaImage::M_ReadElements: local data fills the end of
+  // the header file, unless a header size is given
+  SizeType dataPosition = 0;
+  if (m_MetaImage.HeaderSize() > 0)
+  {
+    dataPosition = m_MetaImage.HeaderSize();
+  }
+  else if (m_MetaImage.HeaderSize() == -1 || fileName == m_FileName)
+  {
+    if (!itksys::SystemTools::FileExists(fileName, true))
+    {
+      return false;
+    }
+    dataPosition = static_cast<SizeType>(itksys::SystemTools::FileLength(fileName)) - this->GetImageSizeInBytes();
+    if (dataPosition < 0)
+    {
+      return false;
+    }
+  }
+
+  return this->ComputeMemoryMapReadOffset(dataPosition, offset);
+}
+
 MetaImage *
 MetaImageIO::GetMetaImagePointer()
 {
@@ -1145,7 +1265,11 @@ MetaImageIO ::Write(const void * buffer)
   }
   else
   {
-    if (!m_MetaImage.Write(m_FileName.c_str()))
+    // Data split in several files is compressed file by file by MetaIO
+    const bool parallelCompression = m_UseCompression && m_MetaImage.BinaryData() &&
+                                     std::string(m_MetaImage.ElementDataFileName()).find('%') == std::string::npos;
+    if (!(parallelCompression ? m_MetaImage.WriteParallelCompressed(m_FileName.c_str())
+                              : m_MetaImage.Write(m_FileName.c_str())))
     {
       delete[] dSize;
       delete[] eSpacing;
@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionIterator.h"
+#include "itkMetaImageIO.h"
+#include "itkTestingMacros.h"
+#include "itk_zlib.h"
+#include "itksys/SystemTools.hxx"
+
+// Write compressed MetaImages, which MetaImageIO deflates in parallel
+// blocks, and read them back, both with the header and data in one file
+// and in two.
+
+namespace
+{
+using PixelType = short;
+using ImageType = itk::Image<PixelType, 3>;
+
+bool
+WriteAndRead(const ImageType * image, const std::string & fileName)
+{
+  using WriterType = itk::ImageFileWriter<ImageType>;
+  WriterType::Pointer writer = WriterType::New();
+  writer->SetInput(image);
+  writer->SetFileName(fileName);
+  writer->SetImageIO(itk::MetaImageIO::New());
+  writer->UseCompressionOn();
+  writer->Update();
+
+  using ReaderType = itk::ImageFileReader<ImageType>;
+  ReaderType::Pointer reader = ReaderType::New();
+  reader->SetFileName(fileName);
+  reader->SetImageIO(itk::MetaImageIO::New());
+  reader->Update();
+
+  const ImageType * readImage = reader->GetOutput();
+  if (readImage->GetLargestPossibleRegion() != image->GetLargestPossibleRegion())
+  {
+    std::cerr << "Test failed for " << fileName << ": region " << readImage->GetLargestPossibleRegion() << std::endl;
+    return false;
+  }
+  itk::ImageRegionConstIterator<ImageType> it(image, image->GetLargestPossibleRegion());
+  itk::ImageRegionConstIterator<ImageType> rit(readImage, image->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it, ++rit)
+  {
+    if (rit.Get() != it.Get())
+    {
+      std::cerr << "Test failed for " << fileName << " at index " << it.GetIndex() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMetaImageIOParallelCompressionTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string outputDirectory = argv[1];
+
+  // Larger than the 1 MiB blocks of the compressor
+  ImageType::SizeType size = { { 128, 96, 64 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::ImageRegionIterator<ImageType> it(image, image->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const ImageType::IndexType & index = it.GetIndex();
+    it.Set(static_cast<PixelType>((index[0] * index[1] + 7 * index[2]) % 1000 - 500));
+  }
+
+  bool testPassed = true;
+
+  const std::string localFileName = outputDirectory + "/itkMetaImageIOParallelCompressionTest.mha";
+  ITK_TRY_EXPECT_NO_EXCEPTION(testPassed &= WriteAndRead(image, localFileName));
+
+  const std::string headerFileName = outputDirectory + "/itkMetaImageIOParallelCompressionTest.mhd";
+  ITK_TRY_EXPECT_NO_EXCEPTION(testPassed &= WriteAndRead(image, headerFileName));
+
+  // The data file is a single zlib stream of the size given in the header
+  const std::string dataFileName = outputDirectory + "/itkMetaImageIOParallelCompressionTest.zraw";
+  ITK_TEST_EXPECT_TRUE(itksys::SystemTools::FileExists(dataFileName));
+
+  std::ifstream     dataFile(dataFileName.c_str(), std::ios::binary);
+  std::vector<char> compressed((std::istreambuf_iterator<char>(dataFile)), std::istreambuf_iterator<char>());
+
+  std::ifstream     headerFile(headerFileName.c_str());
+  std::string       line;
+  const std::string compressedDataSizeField = "CompressedDataSize = ";
+  std::string       compressedDataSize;
+  while (std::getline(headerFile, line))
+  {
+    if (line.compare(0, compressedDataSizeField.size(), compressedDataSizeField) == 0)
+    {
+      compressedDataSize = line.substr(compressedDataSizeField.size());
+    }
+  }
+  ITK_TEST_EXPECT_EQUAL(compressedDataSize, std::to_string(compressed.size()));
+
+  std::vector<PixelType> uncompressed(image->GetLargestPossibleRegion().GetNumberOfPixels() + 1);
+  uLongf                 uncompressedSize = static_cast<uLongf>(uncompressed.size() * sizeof(PixelType));
+  ITK_TEST_EXPECT_EQUAL(uncompress(reinterpret_cast<Bytef *>(uncompressed.data()),
+                                   &uncompressedSize,
+                                   reinterpret_cast<const Bytef *>(compressed.data()),
+                                   static_cast<uLong>(compressed.size())),
+                        Z_OK);
+  ITK_TEST_EXPECT_EQUAL(uncompressedSize, image->GetLargestPossibleRegion().GetNumberOfPixels() * sizeof(PixelType));
+  ITK_TEST_EXPECT_EQUAL(uncompressed[0], image->GetBufferPointer()[0]);
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -23,7 +23,7 @@
 
 #include <fstream>
 #include <memory>
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 
 namespace itk
 {
@@ -63,14 +63,14 @@ extern ITKIONIFTI_EXPORT std::ostream &
  * \ingroup IOFilters
  * \ingroup ITKIONIFTI
  */
-class ITKIONIFTI_EXPORT NiftiImageIO : public ImageIOBase
+class ITKIONIFTI_EXPORT NiftiImageIO : public StreamingImageIOBase
 {
 public:
   ITK_DISALLOW_COPY_AND_ASSIGN(NiftiImageIO);
 
   /** Standard class type aliases. */
   using Self = NiftiImageIO;
-  using Superclass = ImageIOBase;
+  using Superclass = StreamingImageIOBase;
   using Pointer = SmartPointer<Self>;
 
   /** Method for creation through the object factory. */
@@ -145,11 +145,35 @@ public:
   void
   Write(const void * buffer) override;
 
+  /** NIfTI files are read with seeks, so any region can be read on its
+   * own. Compressed files are decompressed up to the end of the region. */
+  bool
+  CanStreamRead() override
+  {
+    return true;
+  }
+
   /** Calculate the region of the image that can be efficiently read
-   *  in response to a given requested region. */
+   *  in response to a given requested region. This is the requested
+   *  region, unless UseStreamedReading is off. */
   ImageIORegion
   GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const override;
 
+  /** Uncompressed .nii and .hdr/.img files of scalar, complex, RGB and
+   * RGBA images can be written region by region, and pasted into. The
+   * components of other multi-component images are stored in separate
+   * volumes, so they are always written at once. */
+  bool
+  CanStreamWrite() override;
+
+  /** Reimplemented because the geometry of the file is stored in single
+   * precision, so when pasting into an existing file it is compared with
+   * a tolerance. */
+  unsigned int
+  GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                    const ImageIORegion & pasteRegion,
+                                    const ImageIORegion & largestPossibleRegion) override;
+
   /** Set the slope and intercept for voxel value rescaling. */
   itkSetMacro(RescaleSlope, double);
   itkSetMacro(RescaleIntercept, double);
@@ -173,6 +197,14 @@ protected:
     return false;
   }
 
+  /** The position of the data in the image file, valid while writing
+   * a stream. */
+  SizeType
+  GetHeaderSize() const override
+  {
+    return m_DataPosition;
+  }
+
 private:
   // Try to use the Q and S form codes from MetaDataDictionary if they are specified
   // there, otherwise default to the backwards compatible values from earlier
@@ -198,6 +230,11 @@ private:
   void
   SetImageIOMetadataFromNIfTI();
 
+  /** Write the IORegion into the image file with seeks, writing the
+   * header first if the file does not exist yet. */
+  void
+  StreamWrite(const void * buffer);
+
   // This proxy class provides a nifti_image pointer interface to the internal implementation
   // of itk::NiftiImageIO, while hiding the niftilib interface from the external ITK interface.
   class NiftiImageProxy;
@@ -214,6 +251,10 @@ private:
   IOComponentType m_OnDiskComponentType{ UNKNOWNCOMPONENTTYPE };
 
   Analyze75Flavor m_LegacyAnalyze75Mode;
+
+  /** Where the data of the file being streamed is written. */
+  std::string m_DataFileName;
+  SizeType    m_DataPosition{ 0 };
 };
 
 
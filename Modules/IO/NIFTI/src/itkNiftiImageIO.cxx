@@ -19,7 +19,11 @@
 #include "itkIOCommon.h"
 #include "itkMetaDataObject.h"
 #include "itkSpatialOrientationAdapter.h"
+#include "itkByteSwapper.h"
+#include "itksys/SystemTools.hxx"
 #include <nifti1_io.h>
+#include <algorithm>
+#include <cmath>
 
 #include "itkNiftiImageIOConfigurePrivate.h"
 
@@ -323,6 +327,27 @@ str_xform(unsigned int xform)
   }
   return str_xform(NIFTI_XFORM_UNKNOWN);
 }
+
+template <typename T>
+void
+SwapRangeToFileByteOrder(T * buffer, SizeValueType numberOfComponents, bool bigEndian)
+{
+  if (bigEndian)
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
+  }
+  else
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(buffer, numberOfComponents);
+  }
+}
+
+// NIfTI stores the geometry in single precision
+bool
+GeometryAlmostEqual(double a, double b)
+{
+  return std::abs(a - b) <= 1e-4 * std::max(1.0, std::max(std::abs(a), std::abs(b)));
+}
 } // namespace
 
 // returns an ordering array for converting upper triangular symmetric matrix
@@ -424,6 +449,10 @@ SymMatDim(int count)
 ImageIORegion
 NiftiImageIO ::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requestedRegion) const
 {
+  if (!m_UseStreamedReading)
+  {
+    return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requestedRegion);
+  }
   return requestedRegion;
 }
 
@@ -553,6 +582,9 @@ NiftiImageIO::Read(void * buffer)
     _size[5] = _size[4];
     // sizes = x y z t vecsize
     _size[4] = numComponents;
+    _origin[6] = _origin[5];
+    _origin[5] = _origin[4];
+    _origin[4] = 0;
   }
   // Free memory if any was occupied already (incase of re-using the IO filter).
   nifti_image_free(this->m_NiftiImage);
@@ -676,10 +708,12 @@ NiftiImageIO::Read(void * buffer)
     // vec x y z t l m o
     const auto * niftibuf = (const char *)data;
     auto *       itkbuf = (char *)buffer;
-    const size_t rowdist = this->m_NiftiImage->dim[1];
-    const size_t slicedist = rowdist * this->m_NiftiImage->dim[2];
-    const size_t volumedist = slicedist * this->m_NiftiImage->dim[3];
-    const size_t seriesdist = volumedist * this->m_NiftiImage->dim[4];
+    // the data holds the region that was read, which may be a
+    // subregion of the image in the file
+    const size_t rowdist = _size[0];
+    const size_t slicedist = rowdist * _size[1];
+    const size_t volumedist = slicedist * _size[2];
+    const size_t seriesdist = volumedist * _size[3];
     //
     // as per ITK bug 0007485
     // NIfTI is lower triangular, ITK is upper triangular.
@@ -698,13 +732,13 @@ NiftiImageIO::Read(void * buffer)
         vecOrder[i] = i;
       }
     }
-    for (int t = 0; t < this->m_NiftiImage->dim[4]; t++)
+    for (int t = 0; t < _size[3]; t++)
     {
-      for (int z = 0; z < this->m_NiftiImage->dim[3]; z++)
+      for (int z = 0; z < _size[2]; z++)
       {
-        for (int y = 0; y < this->m_NiftiImage->dim[2]; y++)
+        for (int y = 0; y < _size[1]; y++)
         {
-          for (int x = 0; x < this->m_NiftiImage->dim[1]; x++)
+          for (int x = 0; x < _size[0]; x++)
           {
             for (unsigned int c = 0; c < numComponents; c++)
             {
@@ -1996,9 +2030,151 @@ NiftiImageIO::SetNIfTIOrientationFromImageIO(unsigned short int origdims, unsign
   //  this->m_NiftiImage->sform_code = 0;
 }
 
+bool
+NiftiImageIO::CanStreamWrite()
+{
+  const char * extension = nifti_find_file_extension(this->GetFileName());
+  if (extension == nullptr)
+  {
+    return false;
+  }
+  const std::string extensionName(extension);
+  if (extensionName != ".nii" && extensionName != ".hdr" && extensionName != ".img")
+  {
+    return false;
+  }
+  const unsigned int numComponents = this->GetNumberOfComponents();
+  return numComponents == 1 || (numComponents == 2 && this->GetPixelType() == COMPLEX) ||
+         (numComponents == 3 && this->GetPixelType() == RGB) || (numComponents == 4 && this->GetPixelType() == RGBA);
+}
+
+unsigned int
+NiftiImageIO::GetActualNumberOfSplitsForWriting(unsigned int          numberOfRequestedSplits,
+                                                const ImageIORegion & pasteRegion,
+                                                const ImageIORegion & largestPossibleRegion)
+{
+  if (!this->CanStreamWrite() || pasteRegion == largestPossibleRegion ||
+      !itksys::SystemTools::FileExists(m_FileName.c_str()))
+  {
+    return Superclass::GetActualNumberOfSplitsForWriting(numberOfRequestedSplits, pasteRegion, largestPossibleRegion);
+  }
+
+  // we are going to be pasting, check that the file is compatible
+  NiftiImageIO::Pointer headerIO = NiftiImageIO::New();
+  headerIO->SetLegacyAnalyze75Mode(this->GetLegacyAnalyze75Mode());
+  try
+  {
+    headerIO->SetFileName(m_FileName);
+    headerIO->ReadImageInformation();
+  }
+  catch (...)
+  {
+    itkExceptionMacro("Unable to paste because information could not be read from file: " << m_FileName);
+  }
+
+  bool compatible = headerIO->GetNumberOfComponents() == this->GetNumberOfComponents() &&
+                    headerIO->GetComponentType() == this->GetComponentType() &&
+                    headerIO->GetNumberOfDimensions() == this->GetNumberOfDimensions();
+  for (unsigned int i = 0; compatible && i < this->GetNumberOfDimensions(); ++i)
+  {
+    compatible = headerIO->GetDimensions(i) == this->GetDimensions(i) &&
+                 GeometryAlmostEqual(headerIO->GetSpacing(i), this->GetSpacing(i)) &&
+                 GeometryAlmostEqual(headerIO->GetOrigin(i), this->GetOrigin(i));
+    for (unsigned int j = 0; compatible && j < this->GetNumberOfDimensions(); ++j)
+    {
+      compatible = GeometryAlmostEqual(headerIO->GetDirection(i)[j], this->GetDirection(i)[j]);
+    }
+  }
+  if (!compatible)
+  {
+    itkExceptionMacro("Unable to paste because pasting file exists and is different: " << m_FileName);
+  }
+
+  return this->GetActualNumberOfSplitsForWritingCanStreamWrite(numberOfRequestedSplits, pasteRegion);
+}
+
+void
+NiftiImageIO::StreamWrite(const void * buffer)
+{
+  bool bigEndian = ByteSwapper<uint16_t>::SystemIsBigEndian();
+
+  // we assume that GetActualNumberOfSplitsForWriting is called before
+  // this method, and that it removed the file if a new header is needed
+  if (!itksys::SystemTools::FileExists(this->GetFileName()))
+  {
+    // write only the header, describing the whole image
+    this->WriteImageInformation();
+    nifti_image_write_hdr_img(this->m_NiftiImage, 0, "wb");
+    m_DataFileName = this->m_NiftiImage->iname;
+    m_DataPosition = this->m_NiftiImage->iname_offset;
+
+    // write one byte at the end of the data to allocate the file, which is
+    // sparse if the file system supports it
+    std::ofstream file;
+    this->OpenFileForWriting(file, m_DataFileName, false);
+    file.seekp(static_cast<std::streamoff>(m_DataPosition + this->GetImageSizeInBytes() - 1), std::ios::beg);
+    file.write("\0", 1);
+  }
+  else
+  {
+    nifti_image * header = nifti_image_read(this->GetFileName(), false);
+    if (header == nullptr)
+    {
+      itkExceptionMacro(<< "nifti_image_read (just header) failed for file: " << this->GetFileName());
+    }
+    const bool compressed = nifti_is_gzfile(header->iname);
+    m_DataFileName = header->iname;
+    m_DataPosition = header->iname_offset;
+    if (header->byteorder != nifti_short_order())
+    {
+      bigEndian = !bigEndian;
+    }
+    nifti_image_free(header);
+    if (compressed)
+    {
+      itkExceptionMacro(<< "Cannot paste into compressed file: " << this->GetFileName());
+    }
+  }
+
+  std::ofstream file;
+  this->OpenFileForWriting(file, m_DataFileName, false);
+  if (bigEndian == ByteSwapper<uint16_t>::SystemIsBigEndian() || this->GetComponentSize() == 1)
+  {
+    this->StreamWriteBufferAsBinary(file, buffer);
+    return;
+  }
+
+  // the file was written on a machine of the other byte order, swap a copy
+  const SizeValueType           numberOfComponents = m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+  const SizeValueType           numberOfBytes = numberOfComponents * this->GetComponentSize();
+  const std::unique_ptr<char[]> swapped(new char[numberOfBytes]);
+  memcpy(swapped.get(), buffer, numberOfBytes);
+  switch (this->GetComponentSize())
+  {
+    case 2:
+      SwapRangeToFileByteOrder(reinterpret_cast<uint16_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    case 4:
+      SwapRangeToFileByteOrder(reinterpret_cast<uint32_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    case 8:
+      SwapRangeToFileByteOrder(reinterpret_cast<uint64_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    default:
+      itkExceptionMacro(<< "Unknown component size" << this->GetComponentSize());
+  }
+  this->StreamWriteBufferAsBinary(file, swapped.get());
+}
+
 void
 NiftiImageIO ::Write(const void * buffer)
 {
+  if (this->RequestedToStream())
+  {
+    this->StreamWrite(buffer);
+    return;
+  }
+
   // Write the image Information before writing data
   this->WriteImageInformation();
   const unsigned int numComponents = this->GetNumberOfComponents();
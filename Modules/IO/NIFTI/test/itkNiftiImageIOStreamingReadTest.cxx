@@ -0,0 +1,127 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkNiftiImageIO.h"
+#include "itkVector.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Read a region of the file, and check the buffered region and the pixels of the output
+template <typename TImage>
+bool
+ReadRegion(const std::string & fileName, const TImage * image, const typename TImage::RegionType & region)
+{
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->SetFileName(fileName);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  const TImage * output = reader->GetOutput();
+
+  if (output->GetBufferedRegion() != region)
+  {
+    std::cerr << "Read " << output->GetBufferedRegion() << " instead of " << region << " from " << fileName
+              << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIterator<TImage> it(output, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != image->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Wrong value at " << it.GetIndex() << " in " << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+bool
+WriteAndReadRegions(const std::string & fileNameBase)
+{
+  using PixelType = typename TImage::PixelType;
+  using ValueType = typename itk::NumericTraits<PixelType>::ValueType;
+
+  typename TImage::SizeType size = { { 19, 13, 7 } };
+  auto                      image = TImage::New();
+  image->SetRegions(size);
+  image->Allocate();
+  const unsigned int numberOfComponents = image->GetNumberOfComponentsPerPixel();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    PixelType pixel;
+    itk::NumericTraits<PixelType>::SetLength(pixel, numberOfComponents);
+    for (unsigned int c = 0; c < numberOfComponents; ++c)
+    {
+      itk::DefaultConvertPixelTraits<PixelType>::SetNthComponent(c, pixel, static_cast<ValueType>(0.5 * i + 100 * c));
+    }
+    image->GetBufferPointer()[i] = pixel;
+  }
+
+  // a block, a set of complete rows, and a single slice
+  typename TImage::RegionType regions[3];
+  regions[0].SetIndex({ { 2, 3, 1 } });
+  regions[0].SetSize({ { 11, 4, 5 } });
+  regions[1].SetIndex({ { 0, 5, 2 } });
+  regions[1].SetSize({ { 19, 8, 3 } });
+  regions[2].SetIndex({ { 0, 0, 6 } });
+  regions[2].SetSize({ { 19, 13, 1 } });
+
+  for (const char * extension : { ".nii", ".nii.gz" })
+  {
+    const std::string fileName = fileNameBase + extension;
+    auto              writer = itk::ImageFileWriter<TImage>::New();
+    writer->SetInput(image);
+    writer->SetImageIO(itk::NiftiImageIO::New());
+    writer->SetFileName(fileName);
+    writer->Update();
+
+    for (const auto & region : regions)
+    {
+      if (!ReadRegion(fileName, image.GetPointer(), region))
+      {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNiftiImageIOStreamingReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  using ScalarImageType = itk::Image<float, 3>;
+  using VectorImageType = itk::Image<itk::Vector<float, 3>, 3>;
+  ITK_TEST_EXPECT_TRUE(WriteAndReadRegions<ScalarImageType>(directory + "/itkNiftiImageIOStreamingReadTest"));
+  ITK_TEST_EXPECT_TRUE(WriteAndReadRegions<VectorImageType>(directory + "/itkNiftiImageIOStreamingReadTestVector"));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
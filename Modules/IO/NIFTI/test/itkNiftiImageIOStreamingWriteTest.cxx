@@ -0,0 +1,188 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkNiftiImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+
+// Read the whole file and compare it with the image inside the region, and
+// with zero outside of it
+bool
+CheckFile(const std::string & fileName, const ImageType * image, const ImageType::RegionType & region)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+  const ImageType * output = reader->GetOutput();
+
+  for (itk::ImageRegionConstIterator<ImageType> it(output, output->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const float expected = region.IsInside(it.GetIndex()) ? image->GetPixel(it.GetIndex()) : 0.0f;
+    if (it.Get() != expected)
+    {
+      std::cerr << "Wrong value " << it.Get() << " instead of " << expected << " at " << it.GetIndex() << " in "
+                << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Stream the source file into the output file with a streaming reader, and
+// return whether the writer really got the pieces one by one
+bool
+StreamFile(const std::string & sourceFileName, const std::string & fileName)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->SetFileName(sourceFileName);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NiftiImageIO::New());
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetNumberOfStreamDivisions(4);
+  writer->Update();
+
+  // the last piece is left in the output of the reader
+  return reader->GetOutput()->GetBufferedRegion() != reader->GetOutput()->GetLargestPossibleRegion();
+}
+
+// Paste a region of the source file into the output file
+void
+PasteFile(const std::string & sourceFileName, const std::string & fileName, const ImageType::RegionType & region)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NiftiImageIO::New());
+  reader->SetFileName(sourceFileName);
+
+  itk::ImageIORegion ioRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ioRegion.SetIndex(i, region.GetIndex(i));
+    ioRegion.SetSize(i, region.GetSize(i));
+  }
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NiftiImageIO::New());
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetIORegion(ioRegion);
+  writer->Update();
+}
+} // namespace
+
+int
+itkNiftiImageIOStreamingWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  // the geometry is not exactly representable in single precision, so it
+  // does not exactly match when pasting into a file
+  ImageType::SizeType      size = { { 13, 7, 5 } };
+  ImageType::SpacingType   spacing;
+  ImageType::PointType     origin;
+  ImageType::DirectionType direction;
+  direction.Fill(0.0);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    spacing[i] = 0.3 + 0.1 * i;
+    origin[i] = -1.1 * i;
+  }
+  direction[0][1] = 1.0;
+  direction[1][0] = 1.0;
+  direction[2][2] = -1.0;
+
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->SetOrigin(origin);
+  image->SetDirection(direction);
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = 0.5f * i - 100.0f;
+  }
+  ImageType::Pointer zeros = ImageType::New();
+  zeros->CopyInformation(image);
+  zeros->SetRegions(size);
+  zeros->Allocate(true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NiftiImageIO::New());
+
+  const std::string sourceFileName = directory + "/itkNiftiImageIOStreamingWriteTestSource.nii";
+  writer->SetInput(image);
+  writer->SetFileName(sourceFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Stream the whole image into single and two file images; compressed
+  // images are written at once
+  const ImageType::RegionType largestRegion = image->GetLargestPossibleRegion();
+  const std::string           singleFileName = directory + "/itkNiftiImageIOStreamingWriteTest.nii";
+  const std::string           twoFileName = directory + "/itkNiftiImageIOStreamingWriteTest.hdr";
+  const std::string           compressedFileName = directory + "/itkNiftiImageIOStreamingWriteTest.nii.gz";
+  ITK_TEST_EXPECT_TRUE(StreamFile(sourceFileName, singleFileName));
+  ITK_TEST_EXPECT_TRUE(CheckFile(singleFileName, image, largestRegion));
+  ITK_TEST_EXPECT_TRUE(StreamFile(sourceFileName, twoFileName));
+  ITK_TEST_EXPECT_TRUE(CheckFile(twoFileName, image, largestRegion));
+  ITK_TEST_EXPECT_TRUE(!StreamFile(sourceFileName, compressedFileName));
+  ITK_TEST_EXPECT_TRUE(CheckFile(compressedFileName, image, largestRegion));
+
+  // Paste a block into existing files of zeros
+  ImageType::RegionType block;
+  block.SetIndex({ { 2, 1, 1 } });
+  block.SetSize({ { 5, 4, 3 } });
+  writer->SetInput(zeros);
+  writer->SetFileName(singleFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(PasteFile(sourceFileName, singleFileName, block));
+  ITK_TEST_EXPECT_TRUE(CheckFile(singleFileName, image, block));
+
+  writer->SetFileName(twoFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(PasteFile(sourceFileName, twoFileName, block));
+  ITK_TEST_EXPECT_TRUE(CheckFile(twoFileName, image, block));
+
+  // Pasting into a file of a different size fails
+  ImageType::Pointer smaller = ImageType::New();
+  smaller->CopyInformation(image);
+  ImageType::SizeType smallerSize = { { 13, 7, 4 } };
+  smaller->SetRegions(smallerSize);
+  smaller->Allocate(true);
+  writer->SetInput(smaller);
+  writer->SetFileName(singleFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_EXCEPTION(PasteFile(sourceFileName, singleFileName, block));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
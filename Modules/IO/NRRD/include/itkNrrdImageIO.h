@@ -20,7 +20,7 @@
 #include "ITKIONRRDExport.h"
 
 
-#include "itkImageIOBase.h"
+#include "itkStreamingImageIOBase.h"
 #include <fstream>
 
 struct NrrdEncoding_t;
@@ -37,24 +37,27 @@ namespace itk
  * "bzip2".  Only the "gzip" compressor support the compression level
  * in the range 0-9.
  *
+ * Raw encoded data in a single, attached or detached, data file can be
+ * read in pieces (streamed).
+ *
  *  \ingroup IOFilters
  * \ingroup ITKIONRRD
  */
-class ITKIONRRD_EXPORT NrrdImageIO : public ImageIOBase
+class ITKIONRRD_EXPORT NrrdImageIO : public StreamingImageIOBase
 {
 public:
   ITK_DISALLOW_COPY_AND_ASSIGN(NrrdImageIO);
 
   /** Standard class type aliases. */
   using Self = NrrdImageIO;
-  using Superclass = ImageIOBase;
+  using Superclass = StreamingImageIOBase;
   using Pointer = SmartPointer<Self>;
 
   /** Method for creation through the object factory. */
   itkNewMacro(Self);
 
   /** Run-time type information (and related methods). */
-  itkTypeMacro(NrrdImageIO, ImageIOBase);
+  itkTypeMacro(NrrdImageIO, StreamingImageIOBase);
 
   /** The different types of ImageIO's can support data of varying
    * dimensionality. For example, some file formats are strictly 2D
@@ -77,6 +80,24 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Raw encoded data in a single, attached or detached, data file can be
+   * memory mapped. */
+  bool
+  CanMemoryMapRead(std::string & fileName, SizeType & offset) override;
+
+  /** Raw encoded data in a single, attached or detached, data file can be
+   * streamed. Only valid after ReadImageInformation. */
+  bool
+  CanStreamRead() override
+  {
+    return !m_RawDataFileName.empty();
+  }
+
+  /** Raw encoded data can be streamed and pasted, compressed and ASCII
+   * encoded data cannot. */
+  bool
+  CanStreamWrite() override;
+
   /** Determine the file type. Returns true if this ImageIO can write the
    * file specified. */
   bool
@@ -100,6 +121,16 @@ protected:
   void
   InternalSetCompressor(const std::string & _compressor) override;
 
+  /** Read the IORegion from the raw data file, with seeks, and swap the
+   * bytes to the system byte order. */
+  void
+  StreamReadRawData(void * buffer);
+
+  /** Write the IORegion into the raw data file, with seeks, in the given
+   * byte order. */
+  void
+  StreamWriteRawData(const void * buffer, bool bigEndian);
+
   /** Utility functions for converting between enumerated data type
       representations */
   int
@@ -108,7 +139,19 @@ protected:
   ImageIOBase::IOComponentType
   NrrdToITKComponentType(const int) const;
 
+  /** The position of the raw data in m_RawDataFileName. */
+  SizeType
+  GetHeaderSize() const override
+  {
+    return m_RawDataPosition;
+  }
+
   const NrrdEncoding_t * m_NrrdCompressionEncoding{ nullptr };
+
+  /** Where the raw data of the file was found by ReadImageInformation,
+   * the file name is empty if it cannot be streamed or memory mapped. */
+  std::string m_RawDataFileName;
+  SizeType    m_RawDataPosition{ 0 };
 };
 } // end namespace itk
 
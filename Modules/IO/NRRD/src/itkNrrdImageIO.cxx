@@ -22,11 +22,35 @@
 #include "itkMetaDataObject.h"
 #include "itkIOCommon.h"
 #include "itkFloatingPointExceptions.h"
+#include "itkByteSwapper.h"
+#include "itkParallelDeflateCompressor.h"
+#include "itksys/SystemTools.hxx"
+
+#include <memory>
 
 namespace itk
 {
 #define KEY_PREFIX "NRRD_"
 
+namespace
+{
+// Byte swapping is its own inverse, so this converts both from and to the
+// byte order of the file.
+template <typename T>
+void
+SwapRangeForFileByteOrder(T * buffer, SizeValueType numberOfComponents, bool bigEndian)
+{
+  if (bigEndian)
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToBigEndian(buffer, numberOfComponents);
+  }
+  else
+  {
+    ByteSwapper<T>::SwapRangeFromSystemToLittleEndian(buffer, numberOfComponents);
+  }
+}
+} // namespace
+
 NrrdImageIO::NrrdImageIO()
 {
   this->SetNumberOfDimensions(3);
@@ -276,6 +300,9 @@ NrrdImageIO::ReadImageInformation()
     // this is the mechanism by which we tell nrrdLoad to read
     // just the header, and none of the data
     nrrdIoStateSet(nio, nrrdIoStateSkipData, 1);
+    // and to leave the data file open at the start of the data, so
+    // that we know where it is for streaming and memory mapping
+    nrrdIoStateSet(nio, nrrdIoStateKeepNrrdDataFileOpen, 1);
     if (nrrdLoad(nrrd, this->GetFileName(), nio) != 0)
     {
       char * err = biffGetDone(NRRD);
@@ -297,6 +324,31 @@ NrrdImageIO::ReadImageInformation()
     }
 
 
+    m_RawDataFileName.clear();
+    m_RawDataPosition = 0;
+    if (nio->dataFile)
+    {
+      const long position = ftell(nio->dataFile);
+      if (nrrdEncodingRaw == nio->encoding && !nio->dataFNFormat && nio->dataFNArr->len <= 1 && position >= 0)
+      {
+        if (0 == nio->dataFNArr->len)
+        {
+          m_RawDataFileName = this->GetFileName(); // attached data
+        }
+        else if (itksys::SystemTools::FileIsFullPath(nio->dataFN[0]) || !airStrlen(nio->path))
+        {
+          m_RawDataFileName = nio->dataFN[0];
+        }
+        else
+        {
+          // header-relative data file, see nrrdIoStateDataFileIterNext
+          m_RawDataFileName = std::string(nio->path) + '/' + nio->dataFN[0];
+        }
+        m_RawDataPosition = position;
+      }
+      nio->dataFile = airFclose(nio->dataFile);
+    }
+
     if (nrrdTypeBlock == nrrd->type)
     {
       itkExceptionMacro("ReadImageInformation: Cannot currently "
@@ -359,6 +411,12 @@ NrrdImageIO::ReadImageInformation()
       this->SetNumberOfDimensions(nrrd->dim - 1);
       int    kind = nrrd->axis[rangeAxisIdx[0]].kind;
       size_t size = nrrd->axis[rangeAxisIdx[0]].size;
+      if (0 != rangeAxisIdx[0] || nrrdKind3DMaskedSymMatrix == kind)
+      {
+        // Read permutes or crops the pixels, so they cannot be streamed
+        // or mapped
+        m_RawDataFileName.clear();
+      }
       // NOTE: it is the NRRD readers responsibility to make sure that
       // the size (#of components) associated with a specific kind is
       // matches the actual size of the axis.
@@ -707,9 +765,26 @@ NrrdImageIO::ReadImageInformation()
   }
 }
 
+bool
+NrrdImageIO::CanMemoryMapRead(std::string & fileName, SizeType & offset)
+{
+  if (m_RawDataFileName.empty())
+  {
+    return false;
+  }
+  fileName = m_RawDataFileName;
+  return this->ComputeMemoryMapReadOffset(m_RawDataPosition, offset);
+}
+
 void
 NrrdImageIO::Read(void * buffer)
 {
+  if (!m_RawDataFileName.empty() && this->RequestedToStream())
+  {
+    this->StreamReadRawData(buffer);
+    return;
+  }
+
   Nrrd * nrrd = nrrdNew();
   bool   nrrdAllocated;
 
@@ -844,6 +919,75 @@ NrrdImageIO::Read(void * buffer)
   }
 }
 
+void
+NrrdImageIO::StreamReadRawData(void * buffer)
+{
+  std::ifstream file;
+  this->OpenFileForReading(file, m_RawDataFileName);
+  this->StreamReadBufferAsBinary(file, buffer);
+  file.close();
+
+  const SizeValueType numberOfComponents = m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+  const bool          bigEndian = (this->GetByteOrder() == ImageIOBase::BigEndian);
+  switch (this->GetComponentSize())
+  {
+    case 2:
+      SwapRangeForFileByteOrder(static_cast<uint16_t *>(buffer), numberOfComponents, bigEndian);
+      break;
+    case 4:
+      SwapRangeForFileByteOrder(static_cast<uint32_t *>(buffer), numberOfComponents, bigEndian);
+      break;
+    case 8:
+      SwapRangeForFileByteOrder(static_cast<uint64_t *>(buffer), numberOfComponents, bigEndian);
+      break;
+    default:
+      break;
+  }
+}
+
+void
+NrrdImageIO::StreamWriteRawData(const void * buffer, bool bigEndian)
+{
+  std::ofstream file;
+  this->OpenFileForWriting(file, m_RawDataFileName, false);
+
+  const bool needSwap = (bigEndian != ByteSwapper<uint16_t>::SystemIsBigEndian()) && this->GetComponentSize() > 1;
+  if (!needSwap)
+  {
+    this->StreamWriteBufferAsBinary(file, buffer);
+    return;
+  }
+
+  // swap a copy, the buffer belongs to the caller
+  const SizeValueType numberOfComponents = m_IORegion.GetNumberOfPixels() * this->GetNumberOfComponents();
+  const SizeValueType numberOfBytes = numberOfComponents * this->GetComponentSize();
+  const std::unique_ptr<char[]> swapped(new char[numberOfBytes]);
+  memcpy(swapped.get(), buffer, numberOfBytes);
+  switch (this->GetComponentSize())
+  {
+    case 2:
+      SwapRangeForFileByteOrder(reinterpret_cast<uint16_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    case 4:
+      SwapRangeForFileByteOrder(reinterpret_cast<uint32_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    case 8:
+      SwapRangeForFileByteOrder(reinterpret_cast<uint64_t *>(swapped.get()), numberOfComponents, bigEndian);
+      break;
+    default:
+      itkExceptionMacro(<< "Unknown component size" << this->GetComponentSize());
+  }
+  this->StreamWriteBufferAsBinary(file, swapped.get());
+}
+
+bool
+NrrdImageIO::CanStreamWrite()
+{
+  const bool compressed = this->GetUseCompression() && m_NrrdCompressionEncoding != nullptr &&
+                          m_NrrdCompressionEncoding->available();
+  return !compressed && this->GetFileType() != ASCII;
+}
+
 bool
 NrrdImageIO::CanWriteFile(const char * name)
 {
@@ -866,6 +1010,26 @@ NrrdImageIO::WriteImageInformation()
 void
 NrrdImageIO::Write(const void * buffer)
 {
+  const bool streaming = this->RequestedToStream();
+  if (streaming && itksys::SystemTools::FileExists(this->GetFileName()))
+  {
+    // we assume that GetActualNumberOfSplitsForWriting is called before
+    // this method, and that it removed the file if a new header is needed,
+    // so paste into the data of the existing file
+    NrrdImageIO::Pointer headerIO = NrrdImageIO::New();
+    headerIO->SetFileName(this->GetFileName());
+    headerIO->ReadImageInformation();
+    if (headerIO->m_RawDataFileName.empty())
+    {
+      itkExceptionMacro("Write: Cannot paste into " << this->GetFileName()
+                                                    << ", its data is not raw encoded in a single file");
+    }
+    m_RawDataFileName = headerIO->m_RawDataFileName;
+    m_RawDataPosition = headerIO->m_RawDataPosition;
+    this->StreamWriteRawData(buffer, headerIO->GetByteOrder() == ImageIOBase::BigEndian);
+    return;
+  }
+
   Nrrd *        nrrd = nrrdNew();
   NrrdIoState * nio = nrrdIoStateNew();
   int           kind[NRRD_DIM_MAX];
@@ -1106,6 +1270,16 @@ NrrdImageIO::Write(const void * buffer)
       break;
   }
 
+  // When streaming, only the header is written here, describing the whole
+  // image. The data is written below, region by region.
+  // Gzip data is compressed in parallel below and appended to the data
+  // file, NrrdIO only writes the header.
+  const bool parallelGzip = !streaming && nio->encoding == nrrdEncodingGzip;
+  if (streaming || parallelGzip)
+  {
+    nio->skipData = AIR_TRUE;
+  }
+
   // Write the nrrd to file.
   if (nrrdSave(this->GetFileName(), nrrd, nio))
   {
@@ -1113,6 +1287,62 @@ NrrdImageIO::Write(const void * buffer)
     itkExceptionMacro("Write: Error writing " << this->GetFileName() << ":\n" << err);
   }
 
+  if (parallelGzip)
+  {
+    const bool        detached = nio->detachedHeader;
+    const std::string dataFileName =
+      !detached ? this->GetFileName()
+                : (airStrlen(nio->path) ? std::string(nio->path) + '/' + nio->dataFN[0] : nio->dataFN[0]);
+    nrrdNix(nrrd);
+    nrrdIoStateNix(nio);
+
+    ParallelDeflateCompressor::Pointer compressor = ParallelDeflateCompressor::New();
+    compressor->SetFormat(ParallelDeflateCompressor::StreamFormat::Gzip);
+    compressor->SetCompressionLevel(this->GetCompressionLevel());
+    SizeValueType compressedSize = 0;
+    const std::unique_ptr<unsigned char[]> compressed =
+      compressor->Compress(buffer, static_cast<SizeValueType>(this->GetImageSizeInBytes()), compressedSize);
+
+    std::ofstream file;
+    this->OpenFileForWriting(file, dataFileName, detached);
+    file.seekp(0, std::ios::end);
+    file.write(reinterpret_cast<const char *>(compressed.get()), static_cast<std::streamsize>(compressedSize));
+    if (file.fail())
+    {
+      itkExceptionMacro("Write: Error writing the compressed data to " << dataFileName);
+    }
+    return;
+  }
+
+  if (streaming)
+  {
+    if (nio->detachedHeader)
+    {
+      // nrrdSave contrived a header-relative data file name
+      m_RawDataFileName = airStrlen(nio->path) ? std::string(nio->path) + '/' + nio->dataFN[0] : nio->dataFN[0];
+      m_RawDataPosition = 0;
+    }
+    else
+    {
+      m_RawDataFileName = this->GetFileName();
+      m_RawDataPosition = itksys::SystemTools::FileLength(this->GetFileName());
+    }
+    const bool bigEndian = (airEndianUnknown == nio->endian ? airMyEndian() : nio->endian) == airEndianBig;
+    nrrdNix(nrrd);
+    nrrdIoStateNix(nio);
+
+    std::ofstream file;
+    this->OpenFileForWriting(file, m_RawDataFileName, false);
+    // write one byte at the end of the data to allocate the file, which is
+    // sparse if the file system supports it
+    file.seekp(static_cast<std::streamoff>(m_RawDataPosition + this->GetImageSizeInBytes() - 1), std::ios::beg);
+    file.write("\0", 1);
+    file.close();
+
+    this->StreamWriteRawData(buffer, bigEndian);
+    return;
+  }
+
   // Free the nrrd struct but don't touch nrrd->data
   nrrdNix(nrrd);
   nrrdIoStateNix(nio);
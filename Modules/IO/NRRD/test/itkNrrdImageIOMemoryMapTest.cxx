@@ -0,0 +1,110 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkMemoryMappedImportImageContainer.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+
+#include <algorithm>
+
+namespace
+{
+using ImageType = itk::Image<float, 3>;
+using ContainerType = itk::MemoryMappedImportImageContainer<ImageType::PixelContainer::ElementIdentifier, float>;
+
+ImageType::Pointer
+ReadMemoryMapped(const std::string & fileName)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->SetFileName(fileName);
+  reader->UseMemoryMappingOn();
+  reader->Update();
+  return reader->GetOutput();
+}
+
+bool
+SameValues(const ImageType * image1, const ImageType * image2)
+{
+  const itk::SizeValueType numberOfPixels = image1->GetBufferedRegion().GetNumberOfPixels();
+  if (image2->GetBufferedRegion() != image1->GetBufferedRegion() ||
+      !std::equal(image1->GetBufferPointer(), image1->GetBufferPointer() + numberOfPixels, image2->GetBufferPointer()))
+  {
+    std::cerr << "Images differ" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNrrdImageIOMemoryMapTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  ImageType::SizeType size = { { 11, 6, 4 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = 0.25f * i;
+  }
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(itk::NrrdImageIO::New());
+
+  // Detached header: the data file starts with the pixels
+  const std::string detachedFileName = directory + "/itkNrrdImageIOMemoryMapTest.nhdr";
+  writer->SetFileName(detachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ImageType::Pointer mapped;
+  ITK_TRY_EXPECT_NO_EXCEPTION(mapped = ReadMemoryMapped(detachedFileName));
+  ITK_TEST_EXPECT_TRUE(dynamic_cast<ContainerType *>(mapped->GetPixelContainer()) != nullptr);
+  ITK_TEST_EXPECT_TRUE(SameValues(image, mapped));
+
+  // Attached header: the pixels follow the header
+  const std::string attachedFileName = directory + "/itkNrrdImageIOMemoryMapTest.nrrd";
+  writer->SetFileName(attachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(mapped = ReadMemoryMapped(attachedFileName));
+  std::cout << "Attached data memory mapped: " << (dynamic_cast<ContainerType *>(mapped->GetPixelContainer()) != nullptr)
+            << std::endl;
+  ITK_TEST_EXPECT_TRUE(SameValues(image, mapped));
+
+  // Compressed data cannot be mapped
+  const std::string compressedFileName = directory + "/itkNrrdImageIOMemoryMapTestCompressed.nrrd";
+  writer->SetFileName(compressedFileName);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(mapped = ReadMemoryMapped(compressedFileName));
+  ITK_TEST_EXPECT_TRUE(dynamic_cast<ContainerType *>(mapped->GetPixelContainer()) == nullptr);
+  ITK_TEST_EXPECT_TRUE(SameValues(image, mapped));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkByteSwapper.h"
+
+#include <fstream>
+#include <vector>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+// Read a region of the file, and check the buffered region and the pixels of the output
+bool
+ReadRegion(const std::string & fileName, const ImageType * image, const ImageType::RegionType & region, bool streamed)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->SetFileName(fileName);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  const ImageType * output = reader->GetOutput();
+
+  const ImageType::RegionType expectedRegion = streamed ? region : image->GetLargestPossibleRegion();
+  if (output->GetBufferedRegion() != expectedRegion)
+  {
+    std::cerr << "Read " << output->GetBufferedRegion() << " instead of " << expectedRegion << " from " << fileName
+              << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIterator<ImageType> it(output, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != image->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Wrong value at " << it.GetIndex() << " in " << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkNrrdImageIOStreamingReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  ImageType::SizeType size = { { 13, 7, 5 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<short>(3 * i - 200);
+  }
+
+  // a block, a set of complete rows, and a single slice
+  ImageType::RegionType regions[3];
+  regions[0].SetIndex({ { 2, 1, 1 } });
+  regions[0].SetSize({ { 5, 4, 3 } });
+  regions[1].SetIndex({ { 0, 2, 3 } });
+  regions[1].SetSize({ { 13, 3, 2 } });
+  regions[2].SetIndex({ { 0, 0, 4 } });
+  regions[2].SetSize({ { 13, 7, 1 } });
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(itk::NrrdImageIO::New());
+
+  const std::string detachedFileName = directory + "/itkNrrdImageIOStreamingReadTest.nhdr";
+  writer->SetFileName(detachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  const std::string attachedFileName = directory + "/itkNrrdImageIOStreamingReadTest.nrrd";
+  writer->SetFileName(attachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Big endian data in a data file next to a hand written header
+  const std::string bigEndianFileName = directory + "/itkNrrdImageIOStreamingReadTestBigEndian.nhdr";
+  {
+    std::ofstream header(bigEndianFileName.c_str());
+    header << "NRRD0004\ntype: short\ndimension: 3\nsizes: 13 7 5\nendian: big\nencoding: raw\n"
+           << "data file: itkNrrdImageIOStreamingReadTestBigEndian.raw\n";
+    std::vector<short> pixels(image->GetBufferPointer(), image->GetBufferPointer() + image->GetPixelContainer()->Size());
+    itk::ByteSwapper<short>::SwapRangeFromSystemToBigEndian(pixels.data(), pixels.size());
+    std::ofstream data((directory + "/itkNrrdImageIOStreamingReadTestBigEndian.raw").c_str(), std::ios::binary);
+    data.write(reinterpret_cast<const char *>(pixels.data()), pixels.size() * sizeof(short));
+  }
+
+  // Compressed data is always read as a whole
+  const std::string compressedFileName = directory + "/itkNrrdImageIOStreamingReadTestCompressed.nrrd";
+  writer->SetFileName(compressedFileName);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  for (const auto & region : regions)
+  {
+    ITK_TEST_EXPECT_TRUE(ReadRegion(detachedFileName, image, region, true));
+    ITK_TEST_EXPECT_TRUE(ReadRegion(attachedFileName, image, region, true));
+    ITK_TEST_EXPECT_TRUE(ReadRegion(bigEndianFileName, image, region, true));
+    ITK_TEST_EXPECT_TRUE(ReadRegion(compressedFileName, image, region, false));
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,183 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkNrrdImageIO.h"
+#include "itkTestingMacros.h"
+#include "itkByteSwapper.h"
+
+#include <fstream>
+#include <vector>
+
+namespace
+{
+using ImageType = itk::Image<short, 3>;
+
+// Read the whole file and compare it with the image inside the region, and
+// with the background value outside of it
+bool
+CheckFile(const std::string & fileName, const ImageType * image, const ImageType::RegionType & region, short background)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->SetFileName(fileName);
+  reader->Update();
+  const ImageType * output = reader->GetOutput();
+
+  for (itk::ImageRegionConstIterator<ImageType> it(output, output->GetLargestPossibleRegion()); !it.IsAtEnd(); ++it)
+  {
+    const short expected = region.IsInside(it.GetIndex()) ? image->GetPixel(it.GetIndex()) : background;
+    if (it.Get() != expected)
+    {
+      std::cerr << "Wrong value " << it.Get() << " instead of " << expected << " at " << it.GetIndex() << " in "
+                << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+// Stream the source file into the output file with a streaming reader, so
+// that the writer really gets the pieces one by one
+bool
+StreamFile(const std::string & sourceFileName, const std::string & fileName, unsigned int numberOfDivisions)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->SetFileName(sourceFileName);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NrrdImageIO::New());
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetNumberOfStreamDivisions(numberOfDivisions);
+  writer->Update();
+
+  // the last piece is left in the output of the reader
+  if (reader->GetOutput()->GetBufferedRegion() == reader->GetOutput()->GetLargestPossibleRegion())
+  {
+    std::cerr << "Did not stream " << fileName << std::endl;
+    return false;
+  }
+  return true;
+}
+
+// Paste a region of the source file into the output file
+void
+PasteFile(const std::string & sourceFileName, const std::string & fileName, const ImageType::RegionType & region)
+{
+  auto reader = itk::ImageFileReader<ImageType>::New();
+  reader->SetImageIO(itk::NrrdImageIO::New());
+  reader->SetFileName(sourceFileName);
+
+  itk::ImageIORegion ioRegion(3);
+  for (unsigned int i = 0; i < 3; ++i)
+  {
+    ioRegion.SetIndex(i, region.GetIndex(i));
+    ioRegion.SetSize(i, region.GetSize(i));
+  }
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NrrdImageIO::New());
+  writer->SetInput(reader->GetOutput());
+  writer->SetFileName(fileName);
+  writer->SetIORegion(ioRegion);
+  writer->Update();
+}
+} // namespace
+
+int
+itkNrrdImageIOStreamingWriteTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  ImageType::SizeType size = { { 13, 7, 5 } };
+  ImageType::Pointer  image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+  for (itk::SizeValueType i = 0; i < image->GetPixelContainer()->Size(); ++i)
+  {
+    image->GetBufferPointer()[i] = static_cast<short>(3 * i - 200);
+  }
+  ImageType::Pointer zeros = ImageType::New();
+  zeros->SetRegions(size);
+  zeros->Allocate(true);
+
+  auto writer = itk::ImageFileWriter<ImageType>::New();
+  writer->SetImageIO(itk::NrrdImageIO::New());
+
+  const std::string sourceFileName = directory + "/itkNrrdImageIOStreamingWriteTestSource.nrrd";
+  writer->SetInput(image);
+  writer->SetFileName(sourceFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+
+  // Stream the whole image, into attached and detached data
+  const ImageType::RegionType largestRegion = image->GetLargestPossibleRegion();
+  const std::string           attachedFileName = directory + "/itkNrrdImageIOStreamingWriteTest.nrrd";
+  const std::string           detachedFileName = directory + "/itkNrrdImageIOStreamingWriteTest.nhdr";
+  ITK_TEST_EXPECT_TRUE(StreamFile(sourceFileName, attachedFileName, 4));
+  ITK_TEST_EXPECT_TRUE(CheckFile(attachedFileName, image, largestRegion, 0));
+  ITK_TEST_EXPECT_TRUE(StreamFile(sourceFileName, detachedFileName, 4));
+  ITK_TEST_EXPECT_TRUE(CheckFile(detachedFileName, image, largestRegion, 0));
+
+  // Paste a block into existing files of zeros
+  ImageType::RegionType block;
+  block.SetIndex({ { 2, 1, 1 } });
+  block.SetSize({ { 5, 4, 3 } });
+  writer->SetInput(zeros);
+  writer->SetFileName(attachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(PasteFile(sourceFileName, attachedFileName, block));
+  ITK_TEST_EXPECT_TRUE(CheckFile(attachedFileName, image, block, 0));
+
+  writer->SetFileName(detachedFileName);
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_NO_EXCEPTION(PasteFile(sourceFileName, detachedFileName, block));
+  ITK_TEST_EXPECT_TRUE(CheckFile(detachedFileName, image, block, 0));
+
+  // Paste into big endian data next to a hand written header
+  const std::string bigEndianFileName = directory + "/itkNrrdImageIOStreamingWriteTestBigEndian.nhdr";
+  {
+    std::ofstream header(bigEndianFileName.c_str());
+    header << "NRRD0004\ntype: short\ndimension: 3\nsizes: 13 7 5\nendian: big\nencoding: raw\n"
+           << "data file: itkNrrdImageIOStreamingWriteTestBigEndian.raw\n";
+    std::vector<short> pixels(zeros->GetPixelContainer()->Size(), -1);
+    std::ofstream      data((directory + "/itkNrrdImageIOStreamingWriteTestBigEndian.raw").c_str(), std::ios::binary);
+    data.write(reinterpret_cast<const char *>(pixels.data()), pixels.size() * sizeof(short));
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(PasteFile(sourceFileName, bigEndianFileName, block));
+  ITK_TEST_EXPECT_TRUE(CheckFile(bigEndianFileName, image, block, -1));
+
+  // Compressed data cannot be pasted into
+  const std::string compressedFileName = directory + "/itkNrrdImageIOStreamingWriteTestCompressed.nrrd";
+  writer->SetFileName(compressedFileName);
+  writer->UseCompressionOn();
+  ITK_TRY_EXPECT_NO_EXCEPTION(writer->Update());
+  ITK_TRY_EXPECT_EXCEPTION(PasteFile(sourceFileName, compressedFileName, block));
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
@@ -122,6 +122,11 @@ public:
   void
   Read(void * buffer) override;
 
+  /** Binary files can be memory mapped when their byte order is the one
+   * of this machine. */
+  bool
+  CanMemoryMapRead(std::string & fileName, SizeType & offset) override;
+
   /** Set/Get the Data mask. */
   itkGetConstReferenceMacro(ImageMask, unsigned short);
   void
@@ -162,6 +162,14 @@ RawImageIO<TPixel, VImageDimension>::Read(void * buffer)
   ReadRawBytesAfterSwapping(componentType, buffer, m_ByteOrder, numberOfComponents);
 }
 
+template <typename TPixel, unsigned int VImageDimension>
+bool
+RawImageIO<TPixel, VImageDimension>::CanMemoryMapRead(std::string & fileName, SizeType & offset)
+{
+  fileName = m_FileName;
+  return this->ComputeMemoryMapReadOffset(static_cast<SizeType>(this->GetHeaderSize()), offset);
+}
+
 template <typename TPixel, unsigned int VImageDimension>
 bool
 RawImageIO<TPixel, VImageDimension>::CanWriteFile(const char * fname)
@@ -37,6 +37,10 @@ class TIFFReaderInternal;
  * supports the compression level for JPEG quality parameter in the
  * range 0-100.
  *
+ * Images stored in strips are read in pieces (streamed) row by row and
+ * page by page. Tiled images which are read as RGBA are streamed tile by
+ * tile, provided they are stored top down.
+ *
  * \ingroup IOFilters
  * \ingroup ITKIOTIFF
  *
@@ -82,6 +86,18 @@ public:
   virtual void
   ReadVolume(void * buffer);
 
+  /** Whether the file, whose information was read, can be streamed. */
+  bool
+  CanStreamRead() override
+  {
+    return m_CanStreamRead;
+  }
+
+  /** Returns the requested region if streamed reading is enabled and
+   * possible, otherwise the whole image. */
+  ImageIORegion
+  GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const override;
+
   /*-------- This part of the interfaces deals with writing data. ----- */
 
   /** Determine the file type. Returns true if this ImageIO can read the
@@ -254,6 +270,10 @@ private:
   void
   ReadCurrentPage(void * out, size_t pixelOffset);
 
+  /** Read the IORegion of the current page of a tiled image tile by tile. */
+  void
+  ReadRGBATiles(void * out);
+
   template <typename TComponent>
   void
   ReadGenericImage(void * out, unsigned int width, unsigned int height);
@@ -308,6 +328,7 @@ private:
   uint16_t *   m_ColorBlue;
   uint64_t     m_TotalColors{ 0 };
   unsigned int m_ImageFormat{ TIFFImageIO::NOFORMAT };
+  bool         m_CanStreamRead{ false };
 };
 } // end namespace itk
 
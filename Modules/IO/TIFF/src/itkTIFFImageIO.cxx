@@ -22,9 +22,29 @@
 #include "itkMetaDataObject.h"
 
 #include "itk_tiff.h"
+#include <algorithm>
 
 namespace itk
 {
+namespace
+{
+// The start and size of the region along a dimension. A dimension the
+// region does not have is the first slice.
+void
+GetRegionExtent(const ImageIORegion & region, unsigned int dimension, size_t & start, size_t & size)
+{
+  if (dimension < region.GetImageDimension())
+  {
+    start = static_cast<size_t>(region.GetIndex(dimension));
+    size = region.GetSize(dimension);
+  }
+  else
+  {
+    start = 0;
+    size = 1;
+  }
+}
+} // namespace
 
 bool
 TIFFImageIO::CanReadFile(const char * file)
@@ -148,10 +168,15 @@ TIFFImageIO::GetFormat()
 void
 TIFFImageIO::ReadVolume(void * buffer)
 {
-  const size_t width{ m_InternalImage->m_Width };
-  const size_t height{ m_InternalImage->m_Height };
+  size_t startX, sizeX, startY, sizeY, startZ, sizeZ;
+  GetRegionExtent(m_IORegion, 0, startX, sizeX);
+  GetRegionExtent(m_IORegion, 1, startY, sizeY);
+  GetRegionExtent(m_IORegion, 2, startZ, sizeZ);
+  const size_t pageSize = sizeX * sizeY * this->GetNumberOfComponents();
 
-  for (uint16 page = 0; page < m_InternalImage->m_NumberOfPages; page++)
+  // only the pages in the IO region are decoded
+  size_t z = 0;
+  for (uint16 page = 0; page < m_InternalImage->m_NumberOfPages && z < startZ + sizeZ; page++)
   {
     if (m_InternalImage->m_IgnoredSubFiles > 0)
     {
@@ -167,10 +192,13 @@ TIFFImageIO::ReadVolume(void * buffer)
       }
     }
 
+    if (z >= startZ)
+    {
+      const size_t pixelOffset = pageSize * (z - startZ);
 
-    const size_t pixelOffset = width * height * this->GetNumberOfComponents() * page;
-
-    ReadCurrentPage(buffer, pixelOffset);
+      ReadCurrentPage(buffer, pixelOffset);
+    }
+    ++z;
 
     TIFFReadDirectory(m_InternalImage->m_Image);
   }
@@ -203,6 +231,16 @@ TIFFImageIO::Read(void * buffer)
   m_InternalImage->Clean();
 }
 
+ImageIORegion
+TIFFImageIO::GenerateStreamableReadRegionFromRequestedRegion(const ImageIORegion & requested) const
+{
+  if (m_UseStreamedReading && m_CanStreamRead)
+  {
+    return requested;
+  }
+  return Superclass::GenerateStreamableReadRegionFromRequestedRegion(requested);
+}
+
 TIFFImageIO::TIFFImageIO()
   : m_ColorPalette(0)
 
@@ -520,6 +558,12 @@ TIFFImageIO::ReadImageInformation()
     // make sure the palette is empty
     m_ColorPalette.resize(0);
   }
+
+  // Strips are read row by row. Tiles can only be read one at a time as
+  // RGBA, and TIFFReadRGBATile does not flip bottom up images.
+  m_CanStreamRead =
+    m_InternalImage->CanRead() || (m_InternalImage->m_NumberOfTiles > 0 && this->GetPixelType() == RGBA &&
+                                   m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT);
 }
 
 bool
@@ -1279,6 +1323,15 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
 
   if (!m_InternalImage->CanRead())
   {
+    size_t startX, sizeX, startY, sizeY;
+    GetRegionExtent(m_IORegion, 0, startX, sizeX);
+    GetRegionExtent(m_IORegion, 1, startY, sizeY);
+    if (m_CanStreamRead && (sizeX != width || sizeY != height))
+    {
+      this->ReadRGBATiles(static_cast<unsigned char *>(buffer) + pixelOffset);
+      return;
+    }
+
     uint32 * tempImage = nullptr;
 
     if (this->GetNumberOfComponents() == 4 && m_ComponentType == UCHAR)
@@ -1337,6 +1390,50 @@ TIFFImageIO::ReadCurrentPage(void * buffer, size_t pixelOffset)
   }
 }
 
+void
+TIFFImageIO::ReadRGBATiles(void * out)
+{
+  size_t startX, sizeX, startY, sizeY;
+  GetRegionExtent(m_IORegion, 0, startX, sizeX);
+  GetRegionExtent(m_IORegion, 1, startY, sizeY);
+
+  const size_t          tileWidth = m_InternalImage->m_TileWidth;
+  const size_t          tileHeight = m_InternalImage->m_TileHeight;
+  std::vector<uint32_t> tile(tileWidth * tileHeight);
+  auto *                image = static_cast<unsigned char *>(out);
+
+  for (size_t tileY = startY - startY % tileHeight; tileY < startY + sizeY; tileY += tileHeight)
+  {
+    for (size_t tileX = startX - startX % tileWidth; tileX < startX + sizeX; tileX += tileWidth)
+    {
+      if (!TIFFReadRGBATile(m_InternalImage->m_Image,
+                            static_cast<uint32>(tileX),
+                            static_cast<uint32>(tileY),
+                            reinterpret_cast<uint32 *>(tile.data())))
+      {
+        itkExceptionMacro(<< "Cannot read TIFF tile at " << tileX << ", " << tileY);
+      }
+
+      // copy the part of the tile inside the region, the tile is bottom up
+      const size_t beginX = std::max(tileX, startX);
+      const size_t endX = std::min(tileX + tileWidth, startX + sizeX);
+      const size_t endY = std::min(tileY + tileHeight, startY + sizeY);
+      for (size_t y = std::max(tileY, startY); y < endY; ++y)
+      {
+        const uint32_t * from = tile.data() + (tileHeight - 1 - (y - tileY)) * tileWidth + (beginX - tileX);
+        unsigned char *  to = image + ((y - startY) * sizeX + (beginX - startX)) * 4;
+        for (size_t x = beginX; x < endX; ++x, ++from, to += 4)
+        {
+          to[0] = static_cast<unsigned char>(TIFFGetR(*from));
+          to[1] = static_cast<unsigned char>(TIFFGetG(*from));
+          to[2] = static_cast<unsigned char>(TIFFGetB(*from));
+          to[3] = static_cast<unsigned char>(TIFFGetA(*from));
+        }
+      }
+    }
+  }
+}
+
 template <typename TComponent>
 void
 TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int height)
@@ -1393,41 +1490,66 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
       break;
   }
 
-  for (uint32 row = 0; row < height; ++row)
+  // Only the rows of the IO region are decoded, in file order, which is
+  // bottom up for ORIENTATION_BOTLEFT
+  size_t startX, sizeX, startY, sizeY;
+  GetRegionExtent(m_IORegion, 0, startX, sizeX);
+  GetRegionExtent(m_IORegion, 1, startY, sizeY);
+  if (startX + sizeX > width || startY + sizeY > height)
+  {
+    itkExceptionMacro(<< "The IO region " << m_IORegion << " is outside of the image.");
+  }
+  const bool   topLeft = (m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT);
+  const size_t firstRow = topLeft ? startY : height - startY - sizeY;
+  const size_t fromOffset = startX * m_InternalImage->m_SamplesPerPixel;
+  const auto   regionWidth = static_cast<unsigned int>(sizeX);
+
+  // Most codecs cannot start decoding in the middle of a strip, so the
+  // rows before the region in its first strip are decoded too.
+  uint32 rowsPerStrip = height;
+  TIFFGetFieldDefaulted(m_InternalImage->m_Image, TIFFTAG_ROWSPERSTRIP, &rowsPerStrip);
+  rowsPerStrip = std::max<uint32>(1, std::min<uint32>(rowsPerStrip, height));
+
+  for (auto row = static_cast<uint32>(firstRow - firstRow % rowsPerStrip); row < firstRow + sizeY; ++row)
   {
     if (TIFFReadScanline(m_InternalImage->m_Image, buf, row, 0) <= 0)
     {
       itkExceptionMacro(<< "Problem reading the row: " << row);
     }
+    if (row < firstRow)
+    {
+      continue;
+    }
 
-    if (m_InternalImage->m_Orientation == ORIENTATION_TOPLEFT)
+    if (topLeft)
     {
-      image = out + inc * row * width;
+      image = out + inc * (row - startY) * regionWidth;
     }
     else // bottom left
     {
-      image = out + inc * width * (height - (row + 1));
+      image = out + inc * regionWidth * (height - (row + 1) - startY);
     }
 
     switch (this->GetFormat())
     {
       case TIFFImageIO::GRAYSCALE:
         // check inverted
-        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutGrayscale<ComponentType>(image, static_cast<ComponentType *>(buf) + fromOffset, regionWidth, 1, 0, 0);
         break;
       case TIFFImageIO::RGB_:
-        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf), width, 1, 0, 0);
+        PutRGB_<ComponentType>(image, static_cast<ComponentType *>(buf) + fromOffset, regionWidth, 1, 0, 0);
         break;
 
       case TIFFImageIO::PALETTE_GRAYSCALE:
         switch (m_InternalImage->m_BitsPerSample)
         {
           case 8:
-            PutPaletteGrayscale<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+            PutPaletteGrayscale<ComponentType, unsigned char>(
+              image, static_cast<unsigned char *>(buf) + fromOffset, regionWidth, 1, 0, 0);
             break;
           case 16:
             PutPaletteGrayscale<ComponentType, unsigned short>(
-              image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              image, static_cast<unsigned short *>(buf) + fromOffset, regionWidth, 1, 0, 0);
             break;
           default:
             itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1440,10 +1562,12 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteRGB<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned char>(
+                image, static_cast<unsigned char *>(buf) + fromOffset, regionWidth, 1, 0, 0);
               break;
             case 16:
-              PutPaletteRGB<ComponentType, unsigned short>(image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+              PutPaletteRGB<ComponentType, unsigned short>(
+                image, static_cast<unsigned short *>(buf) + fromOffset, regionWidth, 1, 0, 0);
               break;
             default:
               itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
@@ -1455,11 +1579,12 @@ TIFFImageIO::ReadGenericImage(void * _out, unsigned int width, unsigned int heig
           switch (m_InternalImage->m_BitsPerSample)
           {
             case 8:
-              PutPaletteScalar<ComponentType, unsigned char>(image, static_cast<unsigned char *>(buf), width, 1, 0, 0);
+              PutPaletteScalar<ComponentType, unsigned char>(
+                image, static_cast<unsigned char *>(buf) + fromOffset, regionWidth, 1, 0, 0);
               break;
             case 16:
               PutPaletteScalar<ComponentType, unsigned short>(
-                image, static_cast<unsigned short *>(buf), width, 1, 0, 0);
+                image, static_cast<unsigned short *>(buf) + fromOffset, regionWidth, 1, 0, 0);
               break;
             default:
               itkExceptionMacro(<< "Sorry, can not handle image with " << m_InternalImage->m_BitsPerSample
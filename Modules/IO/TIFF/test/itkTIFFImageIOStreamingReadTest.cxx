@@ -0,0 +1,140 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkImageFileReader.h"
+#include "itkImageFileWriter.h"
+#include "itkImageRegionConstIterator.h"
+#include "itkRGBPixel.h"
+#include "itkTIFFImageIO.h"
+#include "itkTestingMacros.h"
+
+namespace
+{
+// Read a region of the file, and check the buffered region and the pixels of the output
+template <typename TImage>
+bool
+ReadRegion(const std::string & fileName, const TImage * image, const typename TImage::RegionType & region)
+{
+  auto reader = itk::ImageFileReader<TImage>::New();
+  reader->SetImageIO(itk::TIFFImageIO::New());
+  reader->SetFileName(fileName);
+  reader->GetOutput()->SetRequestedRegion(region);
+  reader->Update();
+  const TImage * output = reader->GetOutput();
+
+  if (output->GetBufferedRegion() != region)
+  {
+    std::cerr << "Read " << output->GetBufferedRegion() << " instead of " << region << " from " << fileName
+              << std::endl;
+    return false;
+  }
+  for (itk::ImageRegionConstIterator<TImage> it(output, region); !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() != image->GetPixel(it.GetIndex()))
+    {
+      std::cerr << "Wrong value at " << it.GetIndex() << " in " << fileName << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename TImage>
+void
+WriteImage(const TImage * image, const std::string & fileName, const std::string & compressor)
+{
+  auto io = itk::TIFFImageIO::New();
+  io->SetCompressor(compressor);
+  auto writer = itk::ImageFileWriter<TImage>::New();
+  writer->SetInput(image);
+  writer->SetImageIO(io);
+  writer->SetFileName(fileName);
+  writer->SetUseCompression(!compressor.empty());
+  writer->Update();
+}
+} // namespace
+
+int
+itkTIFFImageIOStreamingReadTest(int argc, char * argv[])
+{
+  if (argc < 2)
+  {
+    std::cerr << "Missing parameters." << std::endl;
+    std::cerr << "Usage: " << itkNameOfTestExecutableMacro(argv) << " outputDirectory" << std::endl;
+    return EXIT_FAILURE;
+  }
+  const std::string directory = argv[1];
+
+  // Multi-page scalar image
+  using VolumeType = itk::Image<unsigned short, 3>;
+  VolumeType::SizeType volumeSize = { { 37, 29, 6 } };
+  VolumeType::Pointer  volume = VolumeType::New();
+  volume->SetRegions(volumeSize);
+  volume->Allocate();
+  for (itk::SizeValueType i = 0; i < volume->GetPixelContainer()->Size(); ++i)
+  {
+    volume->GetBufferPointer()[i] = static_cast<unsigned short>(7 * i);
+  }
+
+  VolumeType::RegionType volumeRegions[3];
+  volumeRegions[0].SetIndex({ { 3, 5, 1 } });
+  volumeRegions[0].SetSize({ { 20, 11, 3 } });
+  volumeRegions[1].SetIndex({ { 0, 28, 0 } });
+  volumeRegions[1].SetSize({ { 37, 1, 6 } });
+  volumeRegions[2].SetIndex({ { 0, 0, 5 } });
+  volumeRegions[2].SetSize({ { 37, 29, 1 } });
+
+  // RGB image
+  using RGBImageType = itk::Image<itk::RGBPixel<unsigned char>, 2>;
+  RGBImageType::SizeType rgbSize = { { 53, 41 } };
+  RGBImageType::Pointer  rgbImage = RGBImageType::New();
+  rgbImage->SetRegions(rgbSize);
+  rgbImage->Allocate();
+  for (itk::SizeValueType i = 0; i < rgbImage->GetPixelContainer()->Size(); ++i)
+  {
+    RGBImageType::PixelType pixel;
+    pixel.Set(static_cast<unsigned char>(i), static_cast<unsigned char>(3 * i), static_cast<unsigned char>(i / 7));
+    rgbImage->GetBufferPointer()[i] = pixel;
+  }
+
+  RGBImageType::RegionType rgbRegions[2];
+  rgbRegions[0].SetIndex({ { 11, 17 } });
+  rgbRegions[0].SetSize({ { 30, 20 } });
+  rgbRegions[1].SetIndex({ { 52, 0 } });
+  rgbRegions[1].SetSize({ { 1, 41 } });
+
+  // Uncompressed and compressed strips
+  for (const std::string compressor : { "", "PACKBITS", "DEFLATE" })
+  {
+    const std::string volumeFileName = directory + "/itkTIFFImageIOStreamingReadTestVolume" + compressor + ".tif";
+    const std::string rgbFileName = directory + "/itkTIFFImageIOStreamingReadTestRGB" + compressor + ".tif";
+    ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage(volume.GetPointer(), volumeFileName, compressor));
+    ITK_TRY_EXPECT_NO_EXCEPTION(WriteImage(rgbImage.GetPointer(), rgbFileName, compressor));
+
+    for (const auto & region : volumeRegions)
+    {
+      ITK_TEST_EXPECT_TRUE(ReadRegion(volumeFileName, volume.GetPointer(), region));
+    }
+    for (const auto & region : rgbRegions)
+    {
+      ITK_TEST_EXPECT_TRUE(ReadRegion(rgbFileName, rgbImage.GetPointer(), region));
+    }
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
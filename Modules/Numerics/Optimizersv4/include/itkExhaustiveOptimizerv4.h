@@ -21,6 +21,8 @@
 #include "itkIntTypes.h"
 #include "itkObjectToObjectOptimizerBase.h"
 
+#include <vector>
+
 namespace itk
 {
 /** \class ExhaustiveOptimizerv4
@@ -105,6 +107,9 @@ public:
   /** Scales type */
   using ScalesType = typename Superclass::ScalesType;
 
+  /** Metric type */
+  using MetricType = typename Superclass::MetricType;
+
   void
   StartOptimization(bool doOnlyInitialization = false) override;
 
@@ -131,6 +136,18 @@ public:
   itkGetConstReferenceMacro(MaximumMetricValuePosition, ParametersType);
   itkGetConstReferenceMacro(CurrentIndex, ParametersType);
 
+  /** Evaluate the metric at the grid positions concurrently, with up to
+   * NumberOfWorkUnits clones of the metric (see
+   * ObjectToObjectOptimizerBaseTemplate::EvaluateConcurrently()). The values
+   * are computed when the walk starts, and are then reported one grid
+   * position after the other as in the serial walk, so observers see the
+   * same iteration events and positions. With several workers, the clones
+   * are evaluated with a single work unit each, so the values are those of
+   * the serial walk with a single-threaded metric. Off by default. */
+  itkSetMacro(UseConcurrentEvaluation, bool);
+  itkGetConstMacro(UseConcurrentEvaluation, bool);
+  itkBooleanMacro(UseConcurrentEvaluation);
+
   /** Get the reason for termination */
   const std::string
   GetStopConditionDescription() const override;
@@ -159,6 +176,11 @@ protected:
   void
   IncrementIndex(ParametersType & param);
 
+  /** Evaluate the metric at all grid positions concurrently, into
+   * m_ConcurrentValues. */
+  void
+  EvaluateGridConcurrently();
+
 protected:
   ParametersType m_InitialPosition;
   MeasureType    m_CurrentValue;
@@ -170,6 +192,11 @@ protected:
   MeasureType    m_MinimumMetricValue;
   ParametersType m_MinimumMetricValuePosition;
   ParametersType m_MaximumMetricValuePosition;
+  bool           m_UseConcurrentEvaluation{ false };
+
+  /** Metric values of the grid positions, in iteration order, when
+   * UseConcurrentEvaluation is on. */
+  std::vector<MeasureType> m_ConcurrentValues;
 
 private:
   std::ostringstream m_StopConditionDescription;
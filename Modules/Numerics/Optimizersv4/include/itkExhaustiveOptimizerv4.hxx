@@ -90,6 +90,12 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>::StartWalking()
   }
   this->m_Metric->SetParameters(position);
 
+  m_ConcurrentValues.clear();
+  if (m_UseConcurrentEvaluation)
+  {
+    this->EvaluateGridConcurrently();
+  }
+
   itkDebugMacro("Calling ResumeWalking");
 
   this->ResumeWalking();
@@ -112,7 +118,14 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>::ResumeWalking()
       break;
     }
 
-    m_CurrentValue = this->m_Metric->GetValue();
+    if (this->m_CurrentIteration < m_ConcurrentValues.size())
+    {
+      m_CurrentValue = m_ConcurrentValues[this->m_CurrentIteration];
+    }
+    else
+    {
+      m_CurrentValue = this->m_Metric->GetValue();
+    }
 
     if (m_CurrentValue > m_MaximumMetricValue)
     {
@@ -139,6 +152,11 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>::ResumeWalking()
     this->AdvanceOneStep();
     this->m_CurrentIteration++;
   }
+
+  if (this->m_CurrentIteration >= this->m_NumberOfIterations)
+  {
+    m_ConcurrentValues.clear();
+  }
 }
 
 template <typename TInternalComputationValueType>
@@ -205,6 +223,35 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>::IncrementIndex(ParametersT
   }
 }
 
+template <typename TInternalComputationValueType>
+void
+ExhaustiveOptimizerv4<TInternalComputationValueType>::EvaluateGridConcurrently()
+{
+  const unsigned int spaceDimension = this->m_Metric->GetParameters().GetSize();
+  const ScalesType & scales = this->GetScales();
+
+  m_ConcurrentValues.assign(this->m_NumberOfIterations, MeasureType{});
+
+  auto evaluatePosition = [this, spaceDimension, &scales](ThreadIdType, MetricType * metric, SizeValueType iteration) {
+    // The grid index and position that IncrementIndex() reaches at this iteration.
+    ParametersType index(spaceDimension);
+    ParametersType position(spaceDimension);
+    SizeValueType  remainder = iteration;
+    for (unsigned int i = 0; i < spaceDimension; i++)
+    {
+      const SizeValueType numberOfPositions = 2 * m_NumberOfSteps[i] + 1;
+      index[i] = remainder % numberOfPositions;
+      remainder /= numberOfPositions;
+      position[i] = (index[i] - m_NumberOfSteps[i]) * m_StepLength * scales[i] + m_InitialPosition[i];
+    }
+    metric->SetParameters(position);
+    m_ConcurrentValues[iteration] = metric->GetValue();
+  };
+  this->EvaluateConcurrently(this->m_NumberOfIterations,
+                             this->GetNumberOfConcurrentEvaluationWorkers(this->m_NumberOfIterations),
+                             evaluatePosition);
+}
+
 template <typename TInternalComputationValueType>
 const std::string
 ExhaustiveOptimizerv4<TInternalComputationValueType>::GetStopConditionDescription() const
@@ -236,6 +283,7 @@ ExhaustiveOptimizerv4<TInternalComputationValueType>::PrintSelf(std::ostream & o
   os << indent << "MinimumMetricValue = " << m_MinimumMetricValue << std::endl;
   os << indent << "MinimumMetricValuePosition = " << m_MinimumMetricValuePosition << std::endl;
   os << indent << "MaximumMetricValuePosition = " << m_MaximumMetricValuePosition << std::endl;
+  os << indent << "UseConcurrentEvaluation = " << m_UseConcurrentEvaluation << std::endl;
 }
 } // end namespace itk
 
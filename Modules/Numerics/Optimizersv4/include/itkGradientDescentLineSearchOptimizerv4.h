@@ -121,6 +121,10 @@ protected:
   /** Destructor */
   ~GradientDescentLineSearchOptimizerv4Template() override = default;
 
+  /** Clone the optimizer, including the line search settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
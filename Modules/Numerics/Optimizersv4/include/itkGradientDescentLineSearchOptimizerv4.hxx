@@ -40,6 +40,24 @@ GradientDescentLineSearchOptimizerv4Template<
   this->m_ReturnBestParametersAndValue = true;
 }
 
+template <typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentLineSearchOptimizerv4Template<TInternalComputationValueType>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+
+  rval->m_LowerLimit = this->m_LowerLimit;
+  rval->m_UpperLimit = this->m_UpperLimit;
+  rval->m_Epsilon = this->m_Epsilon;
+  rval->m_MaximumLineSearchIterations = this->m_MaximumLineSearchIterations;
+  return loPtr;
+}
+
 /**
  *PrintSelf
  */
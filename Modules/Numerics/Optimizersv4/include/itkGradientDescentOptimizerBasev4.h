@@ -183,6 +183,11 @@ protected:
   GradientDescentOptimizerBasev4Template();
   ~GradientDescentOptimizerBasev4Template() override = default;
 
+  /** Clone the optimizer, including the learning rate estimation options, the maximum step size and the
+   * convergence monitoring settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   /** Flag to control use of the ScalesEstimator (if set) for
    * automatic learning step estimation at *each* iteration.
    */
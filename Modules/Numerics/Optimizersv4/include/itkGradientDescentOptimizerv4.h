@@ -220,6 +220,11 @@ protected:
   /** Destructor */
   ~GradientDescentOptimizerv4Template() override = default;
 
+  /** Clone the optimizer, including the learning rate, the minimum convergence value and
+   * ReturnBestParametersAndValue. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
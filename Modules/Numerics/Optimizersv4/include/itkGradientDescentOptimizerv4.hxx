@@ -263,6 +263,23 @@ GradientDescentOptimizerv4Template<TInternalComputationValueType>::EstimateLearn
   }
 }
 
+template <typename TInternalComputationValueType>
+typename LightObject::Pointer
+GradientDescentOptimizerv4Template<TInternalComputationValueType>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+
+  rval->m_LearningRate = this->m_LearningRate;
+  rval->m_MinimumConvergenceValue = this->m_MinimumConvergenceValue;
+  rval->m_ReturnBestParametersAndValue = this->m_ReturnBestParametersAndValue;
+  return loPtr;
+}
+
 template <typename TInternalComputationValueType>
 void
 GradientDescentOptimizerv4Template<TInternalComputationValueType>::PrintSelf(std::ostream & os, Indent indent) const
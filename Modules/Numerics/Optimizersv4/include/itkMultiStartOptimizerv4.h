@@ -162,6 +162,21 @@ public:
     return this->m_BestParametersIndex;
   }
 
+  /** Run the local optimizations from the start points concurrently, with up
+   * to NumberOfWorkUnits workers that each use their own clone of the metric
+   * (see ObjectToObjectOptimizerBaseTemplate::EvaluateConcurrently()) and of
+   * the local optimizer. The local optimizer must be a gradient descent
+   * optimizer without a scales estimator, and its observers are not called
+   * by the clones. The results are computed when the optimization starts,
+   * and are then reported one start point after the other as in the serial
+   * search, so observers of this optimizer see the same iteration events.
+   * With several workers, the metric clones are evaluated with a single work
+   * unit each, so the parameters and values are those of the serial search
+   * with a single-threaded metric. Off by default. */
+  itkSetMacro(UseConcurrentEvaluation, bool);
+  itkGetConstMacro(UseConcurrentEvaluation, bool);
+  itkBooleanMacro(UseConcurrentEvaluation);
+
 protected:
   /** Default constructor */
   MultiStartOptimizerv4Template();
@@ -170,6 +185,18 @@ protected:
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
+  /** Run the local optimizations from all start points concurrently, into
+   * m_ParametersList and m_ConcurrentResults. */
+  void
+  OptimizeConcurrently();
+
+  /** Outcome of a local optimization run by OptimizeConcurrently(). */
+  struct ConcurrentResultType
+  {
+    MeasureType Value;
+    bool        Succeeded;
+  };
+
   /* Common variables for optimization control and reporting */
   bool                         m_Stop{ false };
   StopConditionEnum            m_StopCondition;
@@ -180,6 +207,11 @@ protected:
   MeasureType                  m_MaximumMetricValue;
   ParameterListSizeType        m_BestParametersIndex;
   OptimizerPointer             m_LocalOptimizer;
+  bool                         m_UseConcurrentEvaluation{ false };
+
+  /** Results of the start points, in iteration order, when
+   * UseConcurrentEvaluation is on. */
+  std::vector<ConcurrentResultType> m_ConcurrentResults;
 };
 
 /** This helps to meet backward compatibility */
@@ -46,6 +46,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::PrintSelf(std::ost
   Superclass::PrintSelf(os, indent);
   os << indent << "Stop condition:" << this->m_StopCondition << std::endl;
   os << indent << "Stop condition description: " << this->m_StopConditionDescription.str() << std::endl;
+  os << indent << "UseConcurrentEvaluation: " << this->m_UseConcurrentEvaluation << std::endl;
 }
 
 //-------------------------------------------------------------------
@@ -139,16 +140,73 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::StartOptimization(
   }
 
   this->m_CurrentIteration = static_cast<SizeValueType>(0);
+  this->m_ConcurrentResults.clear();
 
   if (!doOnlyInitialization)
   {
     if (this->m_NumberOfIterations > static_cast<SizeValueType>(0))
     {
+      if (this->m_UseConcurrentEvaluation)
+      {
+        this->OptimizeConcurrently();
+      }
       this->ResumeOptimization();
     }
   }
 }
 
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+void
+MultiStartOptimizerv4Template<TInternalComputationValueType>::OptimizeConcurrently()
+{
+  const SizeValueType numberOfStartPoints = this->m_NumberOfIterations;
+  const ThreadIdType  numberOfWorkers = this->GetNumberOfConcurrentEvaluationWorkers(numberOfStartPoints);
+
+  std::vector<OptimizerPointer> localOptimizers(numberOfWorkers);
+  if (this->m_LocalOptimizer)
+  {
+    // Only the gradient descent optimizers copy all their settings when cloned.
+    if (dynamic_cast<GradientDescentOptimizerBasev4Template<TInternalComputationValueType> *>(
+          this->m_LocalOptimizer.GetPointer()) == nullptr)
+    {
+      itkExceptionMacro("Concurrent evaluation requires a gradient descent local optimizer, not a "
+                        << this->m_LocalOptimizer->GetNameOfClass() << ".");
+    }
+    if (this->m_LocalOptimizer->GetScalesEstimator() != nullptr)
+    {
+      itkExceptionMacro("Concurrent evaluation does not support a local optimizer with a scales estimator.");
+    }
+    for (auto & localOptimizer : localOptimizers)
+    {
+      localOptimizer = dynamic_cast<OptimizerType *>(this->m_LocalOptimizer->Clone().GetPointer());
+    }
+  }
+
+  this->m_ConcurrentResults.assign(numberOfStartPoints, ConcurrentResultType{ MeasureType{}, false });
+
+  auto optimizeStartPoint = [this, &localOptimizers](ThreadIdType worker, MetricType * metric, SizeValueType index) {
+    ConcurrentResultType & result = this->m_ConcurrentResults[index];
+    try
+    {
+      metric->SetParameters(this->m_ParametersList[index]);
+      if (localOptimizers[worker])
+      {
+        localOptimizers[worker]->SetMetric(metric);
+        localOptimizers[worker]->StartOptimization();
+        this->m_ParametersList[index] = metric->GetParameters();
+      }
+      result.Value = metric->GetValue();
+      result.Succeeded = true;
+    }
+    catch (ExceptionObject &)
+    {
+      result.Succeeded = false;
+    }
+  };
+  this->EvaluateConcurrently(numberOfStartPoints, numberOfWorkers, optimizeStartPoint);
+}
+
 /**
  * Resume optimization.
  */
@@ -163,20 +221,41 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::ResumeOptimization
   this->m_Stop = false;
   while (!this->m_Stop)
   {
-    /* Compute metric value */
-    try
+    /* Compute metric value, or take it from the concurrent evaluation */
+    bool succeeded = true;
+    if (this->m_CurrentIteration < this->m_ConcurrentResults.size())
     {
+      const ConcurrentResultType & result = this->m_ConcurrentResults[this->m_CurrentIteration];
       this->m_Metric->SetParameters(this->m_ParametersList[this->m_CurrentIteration]);
-      if (this->m_LocalOptimizer)
+      succeeded = result.Succeeded;
+      if (succeeded)
       {
-        this->m_LocalOptimizer->SetMetric(this->m_Metric);
-        this->m_LocalOptimizer->StartOptimization();
-        this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        this->m_CurrentMetricValue = result.Value;
       }
-      this->m_CurrentMetricValue = this->m_Metric->GetValue();
+    }
+    else
+    {
+      try
+      {
+        this->m_Metric->SetParameters(this->m_ParametersList[this->m_CurrentIteration]);
+        if (this->m_LocalOptimizer)
+        {
+          this->m_LocalOptimizer->SetMetric(this->m_Metric);
+          this->m_LocalOptimizer->StartOptimization();
+          this->m_ParametersList[this->m_CurrentIteration] = this->m_Metric->GetParameters();
+        }
+        this->m_CurrentMetricValue = this->m_Metric->GetValue();
+      }
+      catch (ExceptionObject &)
+      {
+        succeeded = false;
+      }
+    }
+    if (succeeded)
+    {
       this->m_MetricValuesList.push_back(this->m_CurrentMetricValue);
     }
-    catch (ExceptionObject &)
+    else
     {
       /** We simply ignore this exception because it may just be a bad starting point.
        *  We hope that other start points are better.
@@ -208,6 +287,7 @@ MultiStartOptimizerv4Template<TInternalComputationValueType>::ResumeOptimization
       this->m_StopConditionDescription << "Maximum number of iterations (" << this->m_NumberOfIterations
                                        << ") exceeded.";
       this->m_StopCondition = StopEnum::MAXIMUM_NUMBER_OF_ITERATIONS;
+      this->m_ConcurrentResults.clear();
       this->StopOptimization();
       break;
     }
@@ -205,6 +205,15 @@ public:
   UpdateTransformParameters(const DerivativeType & derivative,
                             ParametersValueType    factor = NumericTraits<ParametersValueType>::OneValue()) = 0;
 
+  /** Set the number of work units that an evaluation of the metric is split
+   * into. Optimizers that evaluate clones of the metric concurrently set it
+   * to one, so that each clone runs on the thread that evaluates it instead of
+   * nesting its multi-threading in theirs. Metrics that are not
+   * multi-threaded ignore it. */
+  virtual void
+  SetNumberOfWorkUnits(ThreadIdType)
+  {}
+
   /** Get the current metric value stored in m_Value. This is only
    * meaningful after a call to GetValue() or GetValueAndDerivative().
    * Note that this would normally be called GetValue, but that name is
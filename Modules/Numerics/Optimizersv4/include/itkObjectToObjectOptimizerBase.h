@@ -25,6 +25,8 @@
 #include "itkObjectToObjectMetricBase.h"
 #include "itkIntTypes.h"
 
+#include <functional>
+
 namespace itk
 {
 /** \class ObjectToObjectOptimizerBaseTemplate
@@ -175,6 +177,7 @@ public:
    * \sa SetDoEstimateScales()
    */
   itkSetObjectMacro(ScalesEstimator, ScalesEstimatorType);
+  itkGetConstObjectMacro(ScalesEstimator, ScalesEstimatorType);
 
   /** Option to use ScalesEstimator for scales estimation.
    * The estimation is performed once at begin of
@@ -236,6 +239,36 @@ protected:
   ObjectToObjectOptimizerBaseTemplate();
   ~ObjectToObjectOptimizerBaseTemplate() override;
 
+  /** Clone the optimizer settings: the number of iterations and work units,
+   * the scales, the weights and DoEstimateScales. The metric and the scales
+   * estimator are not copied, as they are bound to the metric that is
+   * optimized. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
+  /** Function called by EvaluateConcurrently() for each candidate, with the
+   * index of the calling worker and the metric clone of that worker. */
+  using ConcurrentEvaluationFunctionType = std::function<void(ThreadIdType, MetricType *, SizeValueType)>;
+
+  /** Get the number of workers to use in EvaluateConcurrently() for a number
+   * of candidates: the number of work units, limited to the number of
+   * candidates. */
+  ThreadIdType
+  GetNumberOfConcurrentEvaluationWorkers(SizeValueType numberOfCandidates) const;
+
+  /** Call \c evaluate for the candidates 0 to numberOfCandidates - 1 from
+   * numberOfWorkers concurrent workers. Each worker gets its own initialized
+   * clone of the metric (see ImageToImageMetricv4::InternalClone()) and pulls
+   * the next unevaluated candidate until none are left. With more than one
+   * worker, the clones are set to a single work unit (see
+   * ObjectToObjectMetricBaseTemplate::SetNumberOfWorkUnits()), so that they
+   * are evaluated on the threads of their workers without nested
+   * multi-threading. Throws if the metric cannot be cloned. */
+  void
+  EvaluateConcurrently(SizeValueType                            numberOfCandidates,
+                       ThreadIdType                             numberOfWorkers,
+                       const ConcurrentEvaluationFunctionType & evaluate) const;
+
   MetricTypePointer m_Metric;
   ThreadIdType      m_NumberOfWorkUnits;
   SizeValueType     m_CurrentIteration;
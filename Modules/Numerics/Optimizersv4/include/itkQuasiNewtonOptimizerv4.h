@@ -197,6 +197,10 @@ protected:
   QuasiNewtonOptimizerv4Template();
   ~QuasiNewtonOptimizerv4Template() override = default;
 
+  /** Clone the optimizer, including the Newton step settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
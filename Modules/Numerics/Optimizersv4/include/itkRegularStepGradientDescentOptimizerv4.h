@@ -133,6 +133,10 @@ protected:
   /** Destructor. */
   ~RegularStepGradientDescentOptimizerv4() override = default;
 
+  /** Clone the optimizer, including the step length and relaxation settings. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -19,6 +19,9 @@
 #include "itkObjectToObjectOptimizerBase.h"
 #include "itkMultiThreaderBase.h"
 
+#include <algorithm>
+#include <atomic>
+
 namespace itk
 {
 
@@ -45,6 +48,101 @@ ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::ObjectToObje
 template <typename TInternalComputationValueType>
 ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::~ObjectToObjectOptimizerBaseTemplate() = default;
 
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+typename LightObject::Pointer
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+
+  rval->m_NumberOfWorkUnits = this->m_NumberOfWorkUnits;
+  rval->m_NumberOfIterations = this->m_NumberOfIterations;
+  rval->m_Scales = this->m_Scales;
+  rval->m_ScalesAreIdentity = this->m_ScalesAreIdentity;
+  rval->m_Weights = this->m_Weights;
+  rval->m_WeightsAreIdentity = this->m_WeightsAreIdentity;
+  rval->m_DoEstimateScales = this->m_DoEstimateScales;
+  return loPtr;
+}
+
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+ThreadIdType
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::GetNumberOfConcurrentEvaluationWorkers(
+  SizeValueType numberOfCandidates) const
+{
+  const SizeValueType numberOfWorkers = std::min<SizeValueType>(this->m_NumberOfWorkUnits, numberOfCandidates);
+  return static_cast<ThreadIdType>(std::max<SizeValueType>(numberOfWorkers, 1));
+}
+
+//-------------------------------------------------------------------
+template <typename TInternalComputationValueType>
+void
+ObjectToObjectOptimizerBaseTemplate<TInternalComputationValueType>::EvaluateConcurrently(
+  SizeValueType                            numberOfCandidates,
+  ThreadIdType                             numberOfWorkers,
+  const ConcurrentEvaluationFunctionType & evaluate) const
+{
+  if (this->m_Metric.IsNull())
+  {
+    itkExceptionMacro("m_Metric must be set.");
+  }
+
+  // Clone and initialize the metrics up front, as initialization may update
+  // pipelines and objects shared by the clones.
+  std::vector<MetricTypePointer> metrics(numberOfWorkers);
+  for (ThreadIdType worker = 0; worker < numberOfWorkers; ++worker)
+  {
+    metrics[worker] = dynamic_cast<MetricType *>(this->m_Metric->Clone().GetPointer());
+    if (metrics[worker].IsNull())
+    {
+      itkExceptionMacro("Cloning the " << this->m_Metric->GetNameOfClass() << " metric failed.");
+    }
+    if (numberOfWorkers > 1)
+    {
+      // The workers run on the threads of the multi-threader below, so the
+      // clones must not nest their own multi-threading: the pool threader
+      // would wait for jobs queued behind the workers occupying its threads.
+      metrics[worker]->SetNumberOfWorkUnits(1);
+    }
+    try
+    {
+      metrics[worker]->Initialize();
+    }
+    catch (ExceptionObject & exc)
+    {
+      itkExceptionMacro("The clone of the " << this->m_Metric->GetNameOfClass()
+                                            << " metric could not be initialized for concurrent evaluation: "
+                                            << exc.GetDescription());
+    }
+    if (metrics[worker]->GetNumberOfParameters() != this->m_Metric->GetNumberOfParameters())
+    {
+      itkExceptionMacro("The clone of the " << this->m_Metric->GetNameOfClass() << " metric has "
+                                            << metrics[worker]->GetNumberOfParameters() << " parameters instead of "
+                                            << this->m_Metric->GetNumberOfParameters() << ".");
+    }
+  }
+
+  std::atomic<SizeValueType> nextCandidate(0);
+  MultiThreaderBase::Pointer threader = MultiThreaderBase::New();
+  threader->SetNumberOfWorkUnits(numberOfWorkers);
+  threader->ParallelizeArray(0,
+                             numberOfWorkers,
+                             [&](SizeValueType worker) {
+                               for (SizeValueType candidate = nextCandidate++; candidate < numberOfCandidates;
+                                    candidate = nextCandidate++)
+                               {
+                                 evaluate(static_cast<ThreadIdType>(worker), metrics[worker], candidate);
+                               }
+                             },
+                             nullptr);
+}
+
 //-------------------------------------------------------------------
 template <typename TInternalComputationValueType>
 void
@@ -0,0 +1,339 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#include "itkExhaustiveOptimizerv4.h"
+#include "itkMultiStartOptimizerv4.h"
+#include "itkAmoebaOptimizerv4.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkEuler2DTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkCommand.h"
+#include "itkTestingMacros.h"
+
+/**
+ * Checks that ExhaustiveOptimizerv4 and MultiStartOptimizerv4 report the same
+ * iterations, values and positions when they evaluate their candidates
+ * concurrently on clones of the metric as when they evaluate them one after
+ * the other with a single-threaded metric. Also registered with the pool
+ * threader and one thread, where nested multi-threading of the clones would
+ * wait for jobs queued behind the workers.
+ */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using TransformType = itk::Euler2DTransform<double>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+
+ImageType::Pointer
+MakeBlobImage(double shiftX, double shiftY)
+{
+  ImageType::SizeType size;
+  size.Fill(48);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (; !it.IsAtEnd(); ++it)
+  {
+    const double x = it.GetIndex()[0] - shiftX;
+    const double y = it.GetIndex()[1] - shiftY;
+    const double blob1 = std::exp(-((x - 20) * (x - 20) + (y - 24) * (y - 24)) / 60.0);
+    const double blob2 = 0.5 * std::exp(-((x - 30) * (x - 30) + (y - 18) * (y - 18)) / 20.0);
+    it.Set(100.0 * (blob1 + blob2));
+  }
+  return image;
+}
+
+/** The serial optimizers get a single-threaded metric. The concurrent ones
+ * get a metric with several work units, which its clones must not use. */
+MetricType::Pointer
+MakeMetric(itk::ThreadIdType numberOfWorkUnits)
+{
+  static ImageType::Pointer fixedImage = MakeBlobImage(0.0, 0.0);
+  static ImageType::Pointer movingImage = MakeBlobImage(2.0, -1.0);
+
+  TransformType::Pointer        transform = TransformType::New();
+  TransformType::InputPointType center;
+  center.Fill(24.0);
+  transform->SetCenter(center);
+
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetMovingTransform(transform);
+  metric->SetNumberOfWorkUnits(numberOfWorkUnits);
+  metric->Initialize();
+  return metric;
+}
+
+/** Records the value and position of every iteration of an optimizer. */
+template <typename TOptimizer>
+class IterationRecorder : public itk::Command
+{
+public:
+  using Self = IterationRecorder;
+  using Superclass = itk::Command;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  std::vector<double>                              m_Values;
+  std::vector<typename TOptimizer::ParametersType> m_Positions;
+
+  void
+  Execute(itk::Object * caller, const itk::EventObject & event) override
+  {
+    Execute((const itk::Object *)caller, event);
+  }
+
+  void
+  Execute(const itk::Object * caller, const itk::EventObject & event) override
+  {
+    if (itk::IterationEvent().CheckEvent(&event))
+    {
+      const auto * optimizer = static_cast<const TOptimizer *>(caller);
+      m_Values.push_back(optimizer->GetCurrentMetricValue());
+      m_Positions.push_back(optimizer->GetCurrentPosition());
+    }
+  }
+};
+
+template <typename TOptimizer>
+bool
+SameIterations(const IterationRecorder<TOptimizer> * serial, const IterationRecorder<TOptimizer> * concurrent)
+{
+  if (serial->m_Values.empty() || serial->m_Values != concurrent->m_Values ||
+      serial->m_Positions != concurrent->m_Positions)
+  {
+    std::cerr << "The concurrent evaluation reported " << concurrent->m_Values.size()
+              << " iterations that differ from the " << serial->m_Values.size() << " serial iterations." << std::endl;
+    return false;
+  }
+  return true;
+}
+
+/** The exhaustive optimizer reports its values through GetCurrentValue(). */
+class ExhaustiveRecorder : public IterationRecorder<itk::ExhaustiveOptimizerv4<double>>
+{
+public:
+  using Self = ExhaustiveRecorder;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  void
+  Execute(const itk::Object * caller, const itk::EventObject & event) override
+  {
+    if (itk::IterationEvent().CheckEvent(&event))
+    {
+      const auto * optimizer = static_cast<const itk::ExhaustiveOptimizerv4<double> *>(caller);
+      m_Values.push_back(optimizer->GetCurrentValue());
+      m_Positions.push_back(optimizer->GetCurrentPosition());
+    }
+  }
+};
+
+int
+TestExhaustive()
+{
+  using OptimizerType = itk::ExhaustiveOptimizerv4<double>;
+
+  OptimizerType::StepsType steps(3);
+  steps[0] = 2;
+  steps[1] = 3;
+  steps[2] = 4;
+  OptimizerType::ScalesType scales(3);
+  scales[0] = 0.05;
+  scales[1] = 1.0;
+  scales[2] = 1.0;
+
+  OptimizerType::Pointer      optimizers[2];
+  ExhaustiveRecorder::Pointer recorders[2];
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    optimizers[i] = OptimizerType::New();
+    optimizers[i]->SetMetric(MakeMetric(i == 0 ? 1 : 4));
+    optimizers[i]->SetNumberOfSteps(steps);
+    optimizers[i]->SetStepLength(0.75);
+    optimizers[i]->SetScales(scales);
+    optimizers[i]->SetNumberOfWorkUnits(4);
+    recorders[i] = ExhaustiveRecorder::New();
+    optimizers[i]->AddObserver(itk::IterationEvent(), recorders[i]);
+  }
+  ITK_TEST_SET_GET_BOOLEAN(optimizers[1], UseConcurrentEvaluation, true);
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(optimizers[0]->StartOptimization());
+  ITK_TRY_EXPECT_NO_EXCEPTION(optimizers[1]->StartOptimization());
+
+  if (!SameIterations(recorders[0].GetPointer(), recorders[1].GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_EQUAL(recorders[1]->m_Values.size(), 5u * 7u * 9u);
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetMinimumMetricValue(), optimizers[1]->GetMinimumMetricValue());
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetMaximumMetricValue(), optimizers[1]->GetMaximumMetricValue());
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetMinimumMetricValuePosition(),
+                        optimizers[1]->GetMinimumMetricValuePosition());
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetMaximumMetricValuePosition(),
+                        optimizers[1]->GetMaximumMetricValuePosition());
+  std::cout << "Exhaustive minimum " << optimizers[1]->GetMinimumMetricValue() << " at "
+            << optimizers[1]->GetMinimumMetricValuePosition() << std::endl;
+  return EXIT_SUCCESS;
+}
+
+int
+TestMultiStart()
+{
+  using OptimizerType = itk::MultiStartOptimizerv4;
+  using LocalOptimizerType = itk::GradientDescentOptimizerv4;
+
+  OptimizerType::ParametersListType startPoints;
+  for (int i = 0; i < 7; ++i)
+  {
+    OptimizerType::ParametersType start(3);
+    start[0] = 0.02 * (i - 3);
+    start[1] = (i % 3) - 1.0;
+    start[2] = 1.5 - (i % 4);
+    startPoints.push_back(start);
+  }
+
+  OptimizerType::Pointer                    optimizers[2];
+  IterationRecorder<OptimizerType>::Pointer recorders[2];
+  OptimizerType::ParametersListType         parametersLists[2] = { startPoints, startPoints };
+  for (unsigned int i = 0; i < 2; ++i)
+  {
+    LocalOptimizerType::Pointer localOptimizer = LocalOptimizerType::New();
+    localOptimizer->SetLearningRate(0.01);
+    localOptimizer->SetNumberOfIterations(15);
+    localOptimizer->SetDoEstimateLearningRateOnce(false);
+    OptimizerType::ScalesType scales(3);
+    scales[0] = 1000.0;
+    scales[1] = 1.0;
+    scales[2] = 1.0;
+    localOptimizer->SetScales(scales);
+
+    optimizers[i] = OptimizerType::New();
+    optimizers[i]->SetMetric(MakeMetric(i == 0 ? 1 : 4));
+    optimizers[i]->SetParametersList(parametersLists[i]);
+    optimizers[i]->SetLocalOptimizer(localOptimizer);
+    optimizers[i]->SetNumberOfWorkUnits(3);
+    recorders[i] = IterationRecorder<OptimizerType>::New();
+    optimizers[i]->AddObserver(itk::IterationEvent(), recorders[i]);
+  }
+  ITK_TEST_SET_GET_BOOLEAN(optimizers[1], UseConcurrentEvaluation, true);
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(optimizers[0]->StartOptimization());
+  ITK_TRY_EXPECT_NO_EXCEPTION(optimizers[1]->StartOptimization());
+
+  if (!SameIterations(recorders[0].GetPointer(), recorders[1].GetPointer()))
+  {
+    return EXIT_FAILURE;
+  }
+  ITK_TEST_EXPECT_EQUAL(recorders[1]->m_Values.size(), startPoints.size());
+  ITK_TEST_EXPECT_TRUE(optimizers[0]->GetMetricValuesList() == optimizers[1]->GetMetricValuesList());
+  ITK_TEST_EXPECT_TRUE(optimizers[0]->GetParametersList() == optimizers[1]->GetParametersList());
+  ITK_TEST_EXPECT_TRUE(optimizers[0]->GetParametersList() != startPoints);
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetBestParametersIndex(), optimizers[1]->GetBestParametersIndex());
+  ITK_TEST_EXPECT_EQUAL(optimizers[0]->GetCurrentPosition(), optimizers[1]->GetCurrentPosition());
+  std::cout << "Multi-start best " << optimizers[1]->GetBestParameters() << std::endl;
+
+  // Only gradient descent local optimizers copy their settings when cloned.
+  optimizers[1]->SetParametersList(startPoints);
+  optimizers[1]->SetLocalOptimizer(itk::AmoebaOptimizerv4::New());
+  ITK_TRY_EXPECT_EXCEPTION(optimizers[1]->StartOptimization());
+  return EXIT_SUCCESS;
+}
+
+int
+TestClones()
+{
+  using MattesMetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+  MattesMetricType::Pointer metric = MattesMetricType::New();
+  metric->SetNumberOfHistogramBins(17);
+  metric->SetMovingTransform(TransformType::New());
+
+  MattesMetricType::Pointer metricClone = metric->Clone();
+  ITK_TEST_EXPECT_EQUAL(metricClone->GetNumberOfHistogramBins(), 17u);
+  ITK_TEST_EXPECT_TRUE(metricClone->GetMovingTransform() != nullptr);
+  ITK_TEST_EXPECT_TRUE(metricClone->GetMovingTransform() != metric->GetMovingTransform());
+
+  // Initializing a clone leaves the interpolators and the gradient tile cache
+  // of the cloned metric alone.
+  MetricType::Pointer meanSquares = MakeMetric(4);
+  meanSquares->SetUseMovingImageGradientFilter(false);
+  meanSquares->UseMovingImageGradientTileCacheOn();
+  meanSquares->GetMovingImageGradientTileCache()->SetTileSize(8);
+  meanSquares->Initialize();
+  MetricType::MeasureType    value;
+  MetricType::DerivativeType derivative;
+  meanSquares->GetValueAndDerivative(value, derivative);
+  const itk::SizeValueType numberOfCachedTiles =
+    meanSquares->GetMovingImageGradientTileCache()->GetNumberOfCachedTiles();
+  ITK_TEST_EXPECT_TRUE(numberOfCachedTiles > 0);
+
+  MetricType::Pointer meanSquaresClone = meanSquares->Clone();
+  ITK_TEST_EXPECT_TRUE(meanSquaresClone->GetMovingInterpolator() != meanSquares->GetMovingInterpolator());
+  ITK_TEST_EXPECT_TRUE(meanSquaresClone->GetMovingImageGradientTileCache() !=
+                       meanSquares->GetMovingImageGradientTileCache());
+  ITK_TEST_EXPECT_EQUAL(meanSquaresClone->GetMovingImageGradientTileCache()->GetTileSize(), 8u);
+  meanSquaresClone->SetNumberOfWorkUnits(1);
+  meanSquaresClone->Initialize();
+  ITK_TEST_EXPECT_EQUAL(meanSquares->GetMovingImageGradientTileCache()->GetNumberOfCachedTiles(),
+                        numberOfCachedTiles);
+
+  MetricType::MeasureType    cloneValue;
+  MetricType::DerivativeType cloneDerivative;
+  meanSquaresClone->GetValueAndDerivative(cloneValue, cloneDerivative);
+  ITK_TEST_EXPECT_EQUAL(meanSquaresClone->GetNumberOfWorkUnitsUsed(), 1u);
+  ITK_TEST_EXPECT_TRUE(std::abs(cloneValue - value) <= 1e-9 * std::abs(value));
+
+  using LocalOptimizerType = itk::GradientDescentOptimizerv4;
+  LocalOptimizerType::Pointer optimizer = LocalOptimizerType::New();
+  optimizer->SetLearningRate(0.25);
+  optimizer->SetNumberOfIterations(7);
+  optimizer->SetReturnBestParametersAndValue(true);
+
+  LocalOptimizerType::Pointer optimizerClone = optimizer->Clone();
+  ITK_TEST_EXPECT_EQUAL(optimizerClone->GetLearningRate(), 0.25);
+  ITK_TEST_EXPECT_EQUAL(optimizerClone->GetNumberOfIterations(), 7u);
+  ITK_TEST_EXPECT_TRUE(optimizerClone->GetReturnBestParametersAndValue());
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkOptimizerv4ConcurrentEvaluationTest(int, char *[])
+{
+  int result = EXIT_SUCCESS;
+  if (TestExhaustive() == EXIT_FAILURE)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (TestMultiStart() == EXIT_FAILURE)
+  {
+    result = EXIT_FAILURE;
+  }
+  if (TestClones() == EXIT_FAILURE)
+  {
+    result = EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return result;
+}
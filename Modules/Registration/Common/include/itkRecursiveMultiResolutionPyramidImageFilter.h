@@ -19,8 +19,11 @@
 #define itkRecursiveMultiResolutionPyramidImageFilter_h
 
 #include "itkMultiResolutionPyramidImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
 #include "vnl/vnl_matrix.h"
 
+#include <type_traits>
+
 namespace itk
 {
 /** \class RecursiveMultiResolutionPyramidImageFilter
@@ -47,7 +50,11 @@ namespace itk
  * This class is templated over the input image type and the output image type.
  *
  * This filter uses multithreaded filters to perform the smoothing and
- * downsampling.
+ * downsampling.  When the ShrinkImageFilter is used and the pixels are
+ * scalars, each level is smoothed and shrunk in a single separable pass,
+ * which evaluates the gaussian only at the pixels kept by the shrinking.
+ * The result is the one of a DiscreteGaussianImageFilter followed by a
+ * ShrinkImageFilter.
  *
  * This filter supports streaming.
  *
@@ -115,6 +122,57 @@ protected:
   /** Generate the output data. */
   void
   GenerateData() override;
+
+private:
+  using SmootherType = DiscreteGaussianImageFilter<TOutputImage, TOutputImage>;
+  using OutputPixelType = typename TOutputImage::PixelType;
+
+  /** Scalar type of the line buffers of the fused smoothing and shrinking,
+   * as in DiscreteGaussianImageFilter.  Like there, each pass is cast to
+   * the output pixel type. */
+  using LineRealType = typename std::conditional<std::is_same<OutputPixelType, float>::value, float, double>::type;
+  using IntermediateImageType = Image<OutputPixelType, ImageDimension>;
+
+  /** Whether the levels can be smoothed and shrunk in a single pass, see
+   * SmoothAndShrink. */
+  using CanSmoothAndShrink = std::integral_constant<
+    bool,
+    std::is_arithmetic<typename TInputImage::PixelType>::value && std::is_arithmetic<OutputPixelType>::value &&
+      std::is_same<TInputImage, Image<typename TInputImage::PixelType, ImageDimension>>::value &&
+      std::is_same<TOutputImage, Image<OutputPixelType, ImageDimension>>::value>;
+
+  /** Smooth the source as the smoother does and shrink it by the factors
+   * into a new image sharing the buffer of the output, in a single pass.
+   * Returns null when the image types do not allow it. */
+  template <typename TSourceImage>
+  OutputImagePointer
+  SmoothAndShrink(const TSourceImage * source,
+                  OutputImageType *    output,
+                  const SmootherType * smoother,
+                  const unsigned int   factors[],
+                  std::true_type);
+  template <typename TSourceImage>
+  OutputImagePointer
+  SmoothAndShrink(const TSourceImage *, OutputImageType *, const SmootherType *, const unsigned int[], std::false_type)
+  {
+    return nullptr;
+  }
+
+  /** Convolve the lines of the source along a direction with a symmetric
+   * kernel, at every factor-th pixel starting from the offset, into the
+   * region of the destination.  Source pixels outside of the bounds
+   * are replaced by the nearest ones inside, like
+   * ZeroFluxNeumannBoundaryCondition. */
+  template <typename TSourceValue, typename TSourceImage, typename TDestinationImage>
+  void
+  ShrinkLines(const TSourceImage *                         source,
+              TDestinationImage *                          destination,
+              const typename OutputImageType::RegionType & region,
+              const typename OutputImageType::RegionType & bounds,
+              const std::vector<LineRealType> &            kernel,
+              unsigned int                                 direction,
+              unsigned int                                 factor,
+              OffsetValueType                              offset);
 };
 } // namespace itk
 
@@ -26,6 +26,7 @@
 #include "itkResampleImageFilter.h"
 #include "itkShrinkImageFilter.h"
 #include "itkIdentityTransform.h"
+#include "itkImageRegionConstIteratorWithOnlyIndex.h"
 
 #include "itkMath.h"
 
@@ -60,7 +61,6 @@ RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::GenerateD
   // Create caster, smoother and resampleShrink filters
   using CasterType = CastImageFilter<TInputImage, TOutputImage>;
   using CopierType = CastImageFilter<TOutputImage, TOutputImage>;
-  using SmootherType = DiscreteGaussianImageFilter<TOutputImage, TOutputImage>;
 
   using ImageToImageType = ImageToImageFilter<TOutputImage, TOutputImage>;
   using ResampleShrinkerType = ResampleImageFilter<TOutputImage, TOutputImage>;
@@ -173,39 +173,60 @@ RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::GenerateD
     }
     else
     {
-      if (ilevel == static_cast<int>(this->GetNumberOfLevels()) - 1)
-      {
-        // use caster -> smoother -> shrinker piepline
-        caster->SetInput(inputPtr);
-        smoother->SetInput(caster->GetOutput());
-      }
-      else
+      smoother->SetVariance(variance);
+
+      // smooth and shrink in a single pass when possible
+      OutputImagePointer shrunkPtr;
+      if (this->GetUseShrinkImageFilter())
       {
-        // use smoother -> shrinker pipeline
-        smoother->SetInput(swapPtr);
+        if (ilevel == static_cast<int>(this->GetNumberOfLevels()) - 1)
+        {
+          shrunkPtr = this->SmoothAndShrink(inputPtr.GetPointer(), outputPtr, smoother, factors, CanSmoothAndShrink());
+        }
+        else
+        {
+          shrunkPtr = this->SmoothAndShrink(swapPtr.GetPointer(), outputPtr, smoother, factors, CanSmoothAndShrink());
+        }
       }
 
-      smoother->SetVariance(variance);
-
-      //      shrinker->SetShrinkFactors( factors );
-      //      shrinker->GraftOutput( outputPtr );
-      if (!this->GetUseShrinkImageFilter())
+      if (shrunkPtr)
       {
-        resampleShrinker->SetOutputParametersFromImage(outputPtr);
+        swapPtr = shrunkPtr;
       }
       else
       {
-        shrinker->SetShrinkFactors(factors);
+        if (ilevel == static_cast<int>(this->GetNumberOfLevels()) - 1)
+        {
+          // use caster -> smoother -> shrinker piepline
+          caster->SetInput(inputPtr);
+          smoother->SetInput(caster->GetOutput());
+        }
+        else
+        {
+          // use smoother -> shrinker pipeline
+          smoother->SetInput(swapPtr);
+        }
+
+        //      shrinker->SetShrinkFactors( factors );
+        //      shrinker->GraftOutput( outputPtr );
+        if (!this->GetUseShrinkImageFilter())
+        {
+          resampleShrinker->SetOutputParametersFromImage(outputPtr);
+        }
+        else
+        {
+          shrinker->SetShrinkFactors(factors);
+        }
+        shrinkerFilter->GraftOutput(outputPtr);
+        shrinkerFilter->Modified();
+        // ensure only the requested region is updated
+        shrinkerFilter->GetOutput()->UpdateOutputInformation();
+        shrinkerFilter->GetOutput()->SetRequestedRegion(outputPtr->GetRequestedRegion());
+        shrinkerFilter->GetOutput()->PropagateRequestedRegion();
+        shrinkerFilter->GetOutput()->UpdateOutputData();
+
+        swapPtr = shrinkerFilter->GetOutput();
       }
-      shrinkerFilter->GraftOutput(outputPtr);
-      shrinkerFilter->Modified();
-      // ensure only the requested region is updated
-      shrinkerFilter->GetOutput()->UpdateOutputInformation();
-      shrinkerFilter->GetOutput()->SetRequestedRegion(outputPtr->GetRequestedRegion());
-      shrinkerFilter->GetOutput()->PropagateRequestedRegion();
-      shrinkerFilter->GetOutput()->UpdateOutputData();
-
-      swapPtr = shrinkerFilter->GetOutput();
     }
 
     // graft pipeline output back onto this filter's output
@@ -217,6 +238,247 @@ RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::GenerateD
   }
 }
 
+/**
+ * SmoothAndShrink
+ */
+template <typename TInputImage, typename TOutputImage>
+template <typename TSourceImage>
+typename RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::OutputImagePointer
+RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::SmoothAndShrink(const TSourceImage * source,
+                                                                                       OutputImageType *    output,
+                                                                                       const SmootherType * smoother,
+                                                                                       const unsigned int factors[],
+                                                                                       std::true_type)
+{
+  using RegionType = typename OutputImageType::RegionType;
+  using IndexType = typename OutputImageType::IndexType;
+  using OperatorType = typename SmootherType::OperatorType;
+
+  // The shrunk image shares the buffer of the output, and gets the
+  // information ShrinkImageFilter computes from the source.
+  OutputImagePointer shrunk = OutputImageType::New();
+  shrunk->Graft(output);
+  shrunk->SetDirection(source->GetDirection());
+  shrunk->SetOrigin(source->GetOrigin());
+
+  const RegionType &                 sourceRegion = source->GetLargestPossibleRegion();
+  typename OutputImageType::SpacingType spacing;
+  RegionType                         shrunkRegion;
+  ContinuousIndex<SpacePrecisionType, ImageDimension> sourceCenterIndex;
+  ContinuousIndex<SpacePrecisionType, ImageDimension> shrunkCenterIndex;
+  for (unsigned int idim = 0; idim < ImageDimension; idim++)
+  {
+    spacing[idim] = source->GetSpacing()[idim] * static_cast<double>(factors[idim]);
+    shrunkRegion.SetSize(idim,
+                         std::max<SizeValueType>(static_cast<SizeValueType>(std::floor(
+                                                   static_cast<double>(sourceRegion.GetSize(idim)) / factors[idim])),
+                                                 1));
+    shrunkRegion.SetIndex(
+      idim,
+      static_cast<IndexValueType>(std::ceil(static_cast<double>(sourceRegion.GetIndex(idim)) / factors[idim])));
+    sourceCenterIndex[idim] = sourceRegion.GetIndex(idim) + (sourceRegion.GetSize(idim) - 1) / 2.0;
+    shrunkCenterIndex[idim] = shrunkRegion.GetIndex(idim) + (shrunkRegion.GetSize(idim) - 1) / 2.0;
+  }
+  shrunk->SetSpacing(spacing);
+
+  typename OutputImageType::PointType sourceCenterPoint;
+  typename OutputImageType::PointType shrunkCenterPoint;
+  source->TransformContinuousIndexToPhysicalPoint(sourceCenterIndex, sourceCenterPoint);
+  shrunk->TransformContinuousIndexToPhysicalPoint(shrunkCenterIndex, shrunkCenterPoint);
+  shrunk->SetOrigin(source->GetOrigin() + (sourceCenterPoint - shrunkCenterPoint));
+  shrunk->SetLargestPossibleRegion(shrunkRegion);
+
+  // The shrunk pixel at index i is the smoothed source pixel at index
+  // i * factor + offset.
+  typename OutputImageType::PointType shrunkStartPoint;
+  shrunk->TransformIndexToPhysicalPoint(shrunkRegion.GetIndex(), shrunkStartPoint);
+  const IndexType sourceStartIndex = source->TransformPhysicalPointToIndex(shrunkStartPoint);
+  OffsetValueType offsets[ImageDimension];
+  for (unsigned int idim = 0; idim < ImageDimension; idim++)
+  {
+    offsets[idim] =
+      std::max<OffsetValueType>(sourceStartIndex[idim] - shrunkRegion.GetIndex(idim) * factors[idim], 0);
+  }
+
+  // The smoother convolves along the last direction first.  Each pass
+  // convolves along one direction at the pixels kept along it, so that the
+  // intermediate images are shrunk along the directions already convolved.
+  // Only the requested region of the output is computed, and the source is
+  // clamped at its buffered region, like ZeroFluxNeumannBoundaryCondition.
+  const RegionType &                     bounds = source->GetBufferedRegion();
+  std::vector<std::vector<LineRealType>> kernels(ImageDimension);
+  std::vector<RegionType>                regions(ImageDimension + 1);
+  regions[ImageDimension] = output->GetRequestedRegion();
+  for (unsigned int stage = ImageDimension; stage-- > 0;)
+  {
+    const unsigned int direction = ImageDimension - 1 - stage;
+
+    OperatorType oper;
+    oper.SetDirection(direction);
+    oper.SetVariance(smoother->GetVariance()[direction]);
+    oper.SetMaximumKernelWidth(smoother->GetMaximumKernelWidth());
+    oper.SetMaximumError(smoother->GetMaximumError()[direction]);
+    oper.CreateDirectional();
+    kernels[stage].assign(oper.Begin(), oper.End());
+
+    // the region read by a pass is the region it writes, expanded along its
+    // direction and padded by the radius
+    const auto radius = static_cast<IndexValueType>(oper.GetRadius(direction));
+    const auto factor = static_cast<IndexValueType>(factors[direction]);
+    RegionType region = regions[stage + 1];
+    const IndexValueType first =
+      std::max(region.GetIndex(direction) * factor + offsets[direction] - radius, bounds.GetIndex(direction));
+    const IndexValueType last =
+      std::min((region.GetIndex(direction) + static_cast<IndexValueType>(region.GetSize(direction)) - 1) * factor +
+                 offsets[direction] + radius,
+               bounds.GetIndex(direction) + static_cast<IndexValueType>(bounds.GetSize(direction)) - 1);
+    region.SetIndex(direction, first);
+    region.SetSize(direction, static_cast<SizeValueType>(last - first + 1));
+    regions[stage] = region;
+  }
+
+  // the intermediate images take turns
+  typename IntermediateImageType::Pointer intermediate[2] = { IntermediateImageType::New(),
+                                                              IntermediateImageType::New() };
+  for (unsigned int stage = 0; stage < ImageDimension; stage++)
+  {
+    const unsigned int direction = ImageDimension - 1 - stage;
+    IntermediateImageType * destination = intermediate[stage % 2];
+    if (stage + 1 < ImageDimension)
+    {
+      destination->SetRegions(regions[stage + 1]);
+      destination->Allocate();
+    }
+
+    if (ImageDimension == 1)
+    {
+      // the caster converts the source pixels to output pixels first
+      this->template ShrinkLines<OutputPixelType>(source,
+                                                  shrunk.GetPointer(),
+                                                  regions[stage + 1],
+                                                  bounds,
+                                                  kernels[stage],
+                                                  direction,
+                                                  factors[direction],
+                                                  offsets[direction]);
+    }
+    else if (stage == 0)
+    {
+      this->template ShrinkLines<OutputPixelType>(source,
+                                                  destination,
+                                                  regions[stage + 1],
+                                                  bounds,
+                                                  kernels[stage],
+                                                  direction,
+                                                  factors[direction],
+                                                  offsets[direction]);
+    }
+    else if (stage + 1 < ImageDimension)
+    {
+      this->template ShrinkLines<OutputPixelType>(intermediate[(stage - 1) % 2].GetPointer(),
+                                                  destination,
+                                                  regions[stage + 1],
+                                                  bounds,
+                                                  kernels[stage],
+                                                  direction,
+                                                  factors[direction],
+                                                  offsets[direction]);
+    }
+    else
+    {
+      this->template ShrinkLines<OutputPixelType>(intermediate[(stage - 1) % 2].GetPointer(),
+                                                  shrunk.GetPointer(),
+                                                  regions[stage + 1],
+                                                  bounds,
+                                                  kernels[stage],
+                                                  direction,
+                                                  factors[direction],
+                                                  offsets[direction]);
+    }
+  }
+  return shrunk;
+}
+
+/**
+ * ShrinkLines
+ */
+template <typename TInputImage, typename TOutputImage>
+template <typename TSourceValue, typename TSourceImage, typename TDestinationImage>
+void
+RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::ShrinkLines(
+  const TSourceImage *                         source,
+  TDestinationImage *                          destination,
+  const typename OutputImageType::RegionType & region,
+  const typename OutputImageType::RegionType & bounds,
+  const std::vector<LineRealType> &            kernel,
+  unsigned int                                 direction,
+  unsigned int                                 factor,
+  OffsetValueType                              offset)
+{
+  using RegionType = typename OutputImageType::RegionType;
+  using IndexType = typename OutputImageType::IndexType;
+  using DestinationPixelType = typename TDestinationImage::PixelType;
+
+  const auto             radius = static_cast<IndexValueType>((kernel.size() - 1) / 2);
+  const IndexValueType   lowerBound = bounds.GetIndex(direction);
+  const IndexValueType   upperBound = lowerBound + static_cast<IndexValueType>(bounds.GetSize(direction)) - 1;
+  const IndexValueType   lineStart = region.GetIndex(direction);
+  const SizeValueType    lineLength = region.GetSize(direction);
+  const IndexValueType   sourceStart = lineStart * static_cast<IndexValueType>(factor) + offset - radius;
+  const SizeValueType    sourceLength = (lineLength - 1) * factor + 1 + 2 * static_cast<SizeValueType>(radius);
+  const OffsetValueType  sourceStride = source->GetOffsetTable()[direction];
+  const OffsetValueType  destinationStride = destination->GetOffsetTable()[direction];
+  const auto * const     sourceBuffer = source->GetBufferPointer();
+  DestinationPixelType * destinationBuffer = destination->GetBufferPointer();
+
+  // a line is identified by its first pixel
+  RegionType lineRegion = region;
+  lineRegion.SetSize(direction, 1);
+  if (lineRegion.GetNumberOfPixels() == 0)
+  {
+    return;
+  }
+
+  this->GetMultiThreader()->template ParallelizeImageRegion<ImageDimension>(
+    lineRegion,
+    [&](const RegionType & lines) {
+      std::vector<LineRealType> buffer(sourceLength);
+
+      ImageRegionConstIteratorWithOnlyIndex<TDestinationImage> it(destination, lines);
+      for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+      {
+        IndexType index = it.GetIndex();
+        index[direction] = 0;
+        const OffsetValueType sourceOffset = source->ComputeOffset(index);
+
+        // gather, clamping at the bounds
+        for (SizeValueType t = 0; t < sourceLength; t++)
+        {
+          const IndexValueType position =
+            std::min(std::max(sourceStart + static_cast<IndexValueType>(t), lowerBound), upperBound);
+          buffer[t] = static_cast<LineRealType>(
+            static_cast<TSourceValue>(sourceBuffer[sourceOffset + position * sourceStride]));
+        }
+
+        // convolve at the kept pixels only, summing the products in the
+        // order of DiscreteGaussianImageFilter
+        index[direction] = lineStart;
+        DestinationPixelType * destinationIt = destinationBuffer + destination->ComputeOffset(index);
+        for (SizeValueType t = 0; t < lineLength; t++, destinationIt += destinationStride)
+        {
+          const LineRealType * first = buffer.data() + t * factor;
+          LineRealType         result = kernel[0] * first[0];
+          for (SizeValueType k = 1; k < kernel.size(); k++)
+          {
+            result += kernel[k] * first[k];
+          }
+          *destinationIt = static_cast<DestinationPixelType>(result);
+        }
+      }
+    },
+    nullptr);
+}
+
 /**
  * PrintSelf method
  */
@@ -247,7 +509,6 @@ RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::GenerateO
   unsigned int refLevel;
   refLevel = static_cast<unsigned int>(refOutputPtr->GetSourceOutputIndex());
 
-  using OutputPixelType = typename TOutputImage::PixelType;
   using OperatorType = GaussianOperator<OutputPixelType, ImageDimension>;
 
   auto * oper = new OperatorType;
@@ -390,7 +651,6 @@ RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>::GenerateI
   baseRegion.SetSize(baseSize);
 
   // compute requirements for the smoothing part
-  using OutputPixelType = typename TOutputImage::PixelType;
   using OperatorType = GaussianOperator<OutputPixelType, ImageDimension>;
 
   auto * oper = new OperatorType;
@@ -0,0 +1,210 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkRecursiveMultiResolutionPyramidImageFilter.h"
+#include "itkCastImageFilter.h"
+#include "itkDiscreteGaussianImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkShrinkImageFilter.h"
+#include "itkTestingMacros.h"
+
+/* Verifies that the levels of RecursiveMultiResolutionPyramidImageFilter,
+ * which are smoothed and shrunk in a single pass, are the ones of a
+ * DiscreteGaussianImageFilter followed by a ShrinkImageFilter applied to the
+ * next finer level, also when only a part of the finest level is requested. */
+
+namespace
+{
+template <typename TInputImage, typename TOutputImage>
+bool
+CheckPyramid(const typename TInputImage::SizeType &  size,
+             const typename TInputImage::IndexType & start,
+             const itk::Array2D<unsigned int> &      schedule,
+             bool                                    cropped)
+{
+  constexpr unsigned int Dimension = TInputImage::ImageDimension;
+
+  auto input = TInputImage::New();
+  input->SetRegions(typename TInputImage::RegionType(start, size));
+  typename TInputImage::SpacingType spacing;
+  typename TInputImage::PointType   origin;
+  for (unsigned int d = 0; d < Dimension; d++)
+  {
+    spacing[d] = 0.7 + 0.2 * d;
+    origin[d] = -3.0 + d;
+  }
+  input->SetSpacing(spacing);
+  input->SetOrigin(origin);
+  typename TInputImage::DirectionType direction;
+  direction.SetIdentity();
+  direction[0][0] = std::cos(0.2);
+  direction[0][1] = -std::sin(0.2);
+  direction[1][0] = std::sin(0.2);
+  direction[1][1] = std::cos(0.2);
+  input->SetDirection(direction);
+  input->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<TInputImage> it(input, input->GetBufferedRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    double value = 0.0;
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      value += (d + 1) * it.GetIndex()[d] + ((it.GetIndex()[d] * 7 + d) % 5) * 11.0;
+    }
+    it.Set(static_cast<typename TInputImage::PixelType>(value));
+  }
+
+  using PyramidType = itk::RecursiveMultiResolutionPyramidImageFilter<TInputImage, TOutputImage>;
+  auto pyramid = PyramidType::New();
+  pyramid->SetInput(input);
+  pyramid->UseShrinkImageFilterOn();
+  pyramid->SetNumberOfLevels(schedule.rows());
+  pyramid->SetSchedule(schedule);
+  pyramid->SetMaximumError(0.05);
+  typename TOutputImage::RegionType requestedRegion;
+  if (cropped)
+  {
+    // request the middle of the finest level, the coarser levels and the
+    // input are then only computed and read around it
+    ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->UpdateOutputInformation());
+    requestedRegion = pyramid->GetOutput(0)->GetLargestPossibleRegion();
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      const auto quarter = static_cast<itk::IndexValueType>(requestedRegion.GetSize(d) / 4);
+      requestedRegion.SetIndex(d, requestedRegion.GetIndex(d) + quarter);
+      requestedRegion.SetSize(d, std::max<itk::SizeValueType>(requestedRegion.GetSize(d) - 2 * quarter, 1));
+    }
+    pyramid->GetOutput(0)->SetRequestedRegion(requestedRegion);
+    ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->GetOutput(0)->Update());
+    if (pyramid->GetOutput(0)->GetBufferedRegion() != requestedRegion)
+    {
+      std::cerr << "The pyramid was not cropped to " << requestedRegion << std::endl;
+      return false;
+    }
+  }
+  else
+  {
+    ITK_TRY_EXPECT_NO_EXCEPTION(pyramid->Update());
+  }
+
+  // Build the levels from the finest one with the separate filters.
+  using CasterType = itk::CastImageFilter<TInputImage, TOutputImage>;
+  using SmootherType = itk::DiscreteGaussianImageFilter<TOutputImage, TOutputImage>;
+  using ShrinkerType = itk::ShrinkImageFilter<TOutputImage, TOutputImage>;
+
+  auto caster = CasterType::New();
+  caster->SetInput(input);
+  caster->Update();
+  typename TOutputImage::Pointer previous = caster->GetOutput();
+  for (int level = static_cast<int>(schedule.rows()) - 1; level >= 0; level--)
+  {
+    typename SmootherType::ArrayType variance;
+    unsigned int                     factors[Dimension];
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      factors[d] = schedule[level][d];
+      if (level + 1 < static_cast<int>(schedule.rows()))
+      {
+        factors[d] /= schedule[level + 1][d];
+      }
+      variance[d] = (factors[d] == 1) ? 0.0 : itk::Math::sqr(0.5 * static_cast<float>(factors[d]));
+    }
+
+    auto smoother = SmootherType::New();
+    smoother->SetInput(previous);
+    smoother->SetUseImageSpacing(false);
+    smoother->SetMaximumError(0.05);
+    smoother->SetVariance(variance);
+    auto shrinker = ShrinkerType::New();
+    shrinker->SetInput(smoother->GetOutput());
+    shrinker->SetShrinkFactors(factors);
+    shrinker->Update();
+    previous = shrinker->GetOutput();
+
+    const TOutputImage * output = pyramid->GetOutput(level);
+    if (output->GetLargestPossibleRegion() != previous->GetLargestPossibleRegion() ||
+        output->GetOrigin() != previous->GetOrigin() || output->GetSpacing() != previous->GetSpacing() ||
+        output->GetDirection() != previous->GetDirection())
+    {
+      std::cerr << "The information of level " << level << " differs: " << output << previous << std::endl;
+      return false;
+    }
+
+    // only the requested part of the finest level is exact when cropped,
+    // the other levels are clamped at the border of their requested region
+    if (cropped && level > 0)
+    {
+      continue;
+    }
+    const typename TOutputImage::RegionType     region = cropped ? requestedRegion : output->GetLargestPossibleRegion();
+    itk::ImageRegionConstIterator<TOutputImage> outputIt(output, region);
+    itk::ImageRegionConstIterator<TOutputImage> expectedIt(previous, region);
+    for (; !outputIt.IsAtEnd(); ++outputIt, ++expectedIt)
+    {
+      if (itk::Math::NotExactlyEquals(outputIt.Get(), expectedIt.Get()))
+      {
+        std::cerr << "Level " << level << " differs at " << outputIt.GetIndex() << ": " << outputIt.Get()
+                  << " != " << expectedIt.Get() << std::endl;
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkRecursiveMultiResolutionPyramidImageFilterSmoothAndShrinkTest(int, char *[])
+{
+  // 3D, with a shrink factor of one along the last direction and a finest
+  // level which is shrunk too
+  using ShortImageType = itk::Image<short, 3>;
+  using FloatImageType = itk::Image<float, 3>;
+  ShortImageType::SizeType   size3D = { { 37, 30, 11 } };
+  ShortImageType::IndexType  start3D = { { 0, 0, 0 } };
+  itk::Array2D<unsigned int> schedule3D(3, 3);
+  const unsigned int         factors3D[3][3] = { { 8, 4, 1 }, { 4, 2, 1 }, { 2, 2, 1 } };
+  for (unsigned int level = 0; level < 3; level++)
+  {
+    for (unsigned int d = 0; d < 3; d++)
+    {
+      schedule3D[level][d] = factors3D[level][d];
+    }
+  }
+  bool passed = CheckPyramid<ShortImageType, FloatImageType>(size3D, start3D, schedule3D, false);
+  passed &= CheckPyramid<ShortImageType, FloatImageType>(size3D, start3D, schedule3D, true);
+
+  // 2D, with a start index and odd sizes
+  using DoubleImageType = itk::Image<double, 2>;
+  DoubleImageType::SizeType  size2D = { { 45, 29 } };
+  DoubleImageType::IndexType start2D = { { 3, -5 } };
+  itk::Array2D<unsigned int> schedule2D(3, 2);
+  const unsigned int         factors2D[3][2] = { { 6, 4 }, { 3, 2 }, { 1, 1 } };
+  for (unsigned int level = 0; level < 3; level++)
+  {
+    for (unsigned int d = 0; d < 2; d++)
+    {
+      schedule2D[level][d] = factors2D[level][d];
+    }
+  }
+  passed &= CheckPyramid<DoubleImageType, DoubleImageType>(size2D, start2D, schedule2D, false);
+  passed &= CheckPyramid<DoubleImageType, DoubleImageType>(size2D, start2D, schedule2D, true);
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
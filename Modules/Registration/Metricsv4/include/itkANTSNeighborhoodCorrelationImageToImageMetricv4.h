@@ -174,6 +174,11 @@ protected:
   ANTSNeighborhoodCorrelationImageToImageMetricv4();
   ~ANTSNeighborhoodCorrelationImageToImageMetricv4() override = default;
 
+  /** Clone the metric, including the correlation window radius.
+   * \sa ImageToImageMetricv4::InternalClone */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   friend class ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
     ThreadedImageRegionPartitioner<VirtualImageDimension>,
     Superclass,
@@ -148,7 +148,10 @@ public:
 protected:
   ANTSNeighborhoodCorrelationImageToImageMetricv4GetValueAndDerivativeThreader()
     : m_ANTSAssociate(nullptr)
-  {}
+  {
+    // ProcessVirtualPoint maps the points itself
+    this->m_MapMovingPointsInBatches = false;
+  }
 
   /**
    * Dense threader and sparse threader invoke different in multi-threading. This class uses overloaded
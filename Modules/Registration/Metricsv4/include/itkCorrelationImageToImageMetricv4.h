@@ -118,6 +118,11 @@ public:
   static constexpr typename TFixedImage::ImageDimensionType   FixedImageDimension = TFixedImage::ImageDimension;
   static constexpr typename TMovingImage::ImageDimensionType  MovingImageDimension = TMovingImage::ImageDimension;
 
+  /** Set the number of work units of the evaluations, including the
+   * computation of the averages. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType workUnits) override;
+
 protected:
   CorrelationImageToImageMetricv4();
   ~CorrelationImageToImageMetricv4() override = default;
@@ -48,6 +48,23 @@ CorrelationImageToImageMetricv4<TFixedImage,
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+CorrelationImageToImageMetricv4<TFixedImage,
+                                TMovingImage,
+                                TVirtualImage,
+                                TInternalComputationValueType,
+                                TMetricTraits>::SetNumberOfWorkUnits(ThreadIdType workUnits)
+{
+  Superclass::SetNumberOfWorkUnits(workUnits);
+  this->m_HelperDenseThreader->SetNumberOfWorkUnits(workUnits);
+  this->m_HelperSparseThreader->SetNumberOfWorkUnits(workUnits);
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
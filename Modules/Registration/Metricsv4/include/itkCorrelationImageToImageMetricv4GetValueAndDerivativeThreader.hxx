@@ -30,7 +30,10 @@ CorrelationImageToImageMetricv4GetValueAndDerivativeThreader<
   TCorrelationMetric>::CorrelationImageToImageMetricv4GetValueAndDerivativeThreader()
   : m_CorrelationMetricValueDerivativePerThreadVariables(nullptr)
   , m_CorrelationAssociate(nullptr)
-{}
+{
+  // ProcessVirtualPoint maps the points itself
+  this->m_MapMovingPointsInBatches = false;
+}
 
 
 template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
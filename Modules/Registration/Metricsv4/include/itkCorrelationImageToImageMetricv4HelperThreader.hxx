@@ -28,7 +28,10 @@ CorrelationImageToImageMetricv4HelperThreader<TDomainPartitioner, TImageToImageM
   CorrelationImageToImageMetricv4HelperThreader()
   : m_CorrelationMetricPerThreadVariables(nullptr)
   , m_CorrelationAssociate(nullptr)
-{}
+{
+  // ProcessVirtualPoint maps the points itself
+  this->m_MapMovingPointsInBatches = false;
+}
 
 
 template <typename TDomainPartitioner, typename TImageToImageMetric, typename TCorrelationMetric>
@@ -123,6 +123,11 @@ protected:
   DemonsImageToImageMetricv4();
   ~DemonsImageToImageMetricv4() override = default;
 
+  /** Clone the metric, including the intensity difference threshold.
+   * \sa ImageToImageMetricv4::InternalClone */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   friend class DemonsImageToImageMetricv4GetValueAndDerivativeThreader<
     ThreadedImageRegionPartitioner<Superclass::VirtualImageDimension>,
     Superclass,
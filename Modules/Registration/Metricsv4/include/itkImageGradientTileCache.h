@@ -0,0 +1,203 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageGradientTileCache_h
+#define itkImageGradientTileCache_h
+
+#include "itkNumericTraits.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace itk
+{
+
+/** \class ImageGradientTileCache
+ * \brief Lazily computed, tiled cache of the voxel gradients of an image.
+ *
+ * The buffered region of the input image of the gradient calculator is split
+ * into cubic tiles.  The gradients of the voxels of a tile are computed with
+ * the EvaluateAtIndex() method of the gradient calculator the first time the
+ * tile is needed, and are stored with \c TStorageValue components.  Evaluate()
+ * linearly interpolates the voxel gradients at a point, as the metrics do with
+ * a precomputed gradient image.
+ *
+ * The tiles are kept in a cache whose size is bounded by MaximumSizeInBytes,
+ * so that the memory of the cache does not grow with the image.  When the
+ * cache is full, the tile whose last use is the oldest is evicted, the uses
+ * being stamped with the number of tile computations at the time, so that
+ * the eviction order approximates the least recently used one.  The tiles of
+ * a registration are typically the ones the moving image overlaps with the
+ * virtual domain, and they are computed once.
+ *
+ * Evaluate() may be called concurrently from several threads.  The cached
+ * tiles are read without locking, with per tile atomic counts of their
+ * readers; a lock is only taken to insert a computed tile and evict another
+ * one.  Initialize() must be called again whenever the image or the gradient
+ * calculator changes.
+ *
+ * \ingroup ITKMetricsv4
+ */
+template <typename TGradientCalculator, typename TStorageValue = float>
+class ITK_TEMPLATE_EXPORT ImageGradientTileCache : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ImageGradientTileCache);
+
+  /** Standard class type aliases. */
+  using Self = ImageGradientTileCache;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(ImageGradientTileCache, Object);
+
+  using GradientCalculatorType = TGradientCalculator;
+  using InputImageType = typename GradientCalculatorType::InputImageType;
+  using GradientType = typename GradientCalculatorType::OutputType;
+  using PointType = typename GradientCalculatorType::PointType;
+  using IndexType = typename InputImageType::IndexType;
+  using RegionType = typename InputImageType::RegionType;
+  using StorageValueType = TStorageValue;
+
+  static constexpr unsigned int ImageDimension = InputImageType::ImageDimension;
+  static constexpr unsigned int GradientDimension = GradientType::Dimension;
+
+  /** Set/Get the calculator of the voxel gradients.  Its input image is the
+   * image of the cache. */
+  itkSetConstObjectMacro(GradientCalculator, GradientCalculatorType);
+  itkGetConstObjectMacro(GradientCalculator, GradientCalculatorType);
+
+  /** Set/Get the number of voxels along each side of the tiles.  Defaults to
+   * 16. */
+  itkSetClampMacro(TileSize, SizeValueType, 1, NumericTraits<SizeValueType>::max());
+  itkGetConstMacro(TileSize, SizeValueType);
+
+  /** Set/Get the maximum memory of the cached tiles, in bytes.  At least one
+   * tile is cached.  Defaults to 64 MiB. */
+  itkSetMacro(MaximumSizeInBytes, SizeValueType);
+  itkGetConstMacro(MaximumSizeInBytes, SizeValueType);
+
+  /** Lay out the tiles over the buffered region of the image and drop the
+   * cached tiles. */
+  virtual void
+  Initialize();
+
+  /** Linearly interpolate the voxel gradients at a point inside the buffered
+   * region of the image.  Thread safe. */
+  void
+  Evaluate(const PointType & point, GradientType & gradient) const;
+
+  /** Get the number of tiles covering the image. */
+  SizeValueType
+  GetNumberOfTiles() const
+  {
+    return this->m_NumberOfTiles;
+  }
+
+  /** Get the number of tiles currently cached. */
+  SizeValueType
+  GetNumberOfCachedTiles() const;
+
+  /** Get the number of tile computations since Initialize(), which exceeds the
+   * number of tiles used when the cache is too small. */
+  SizeValueType
+  GetNumberOfComputedTiles() const
+  {
+    return this->m_NumberOfComputedTiles;
+  }
+
+  /** Get the memory of a tile, in bytes. */
+  SizeValueType
+  GetTileSizeInBytes() const;
+
+protected:
+  ImageGradientTileCache() = default;
+  ~ImageGradientTileCache() override;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** The gradients of the voxels of a tile, with GradientDimension components
+   * per voxel and the first dimension varying fastest. */
+  using TileType = std::vector<StorageValueType>;
+
+  /** Compute the voxel gradients of the tile covering a region. */
+  virtual void
+  ComputeTile(const RegionType & tileRegion, TileType & tile) const;
+
+private:
+  /** A tile of the image, cached when Tile is not null.  Evicting the tile
+   * waits for NumberOfReaders to drop to zero before releasing it. */
+  struct TileSlot
+  {
+    std::atomic<TileType *>    Tile{ nullptr };
+    std::atomic<SizeValueType> NumberOfReaders{ 0 };
+    std::atomic<SizeValueType> LastUse{ 0 };
+  };
+
+  /** Get a tile, computing it if it is not cached, and register the calling
+   * thread as one of its readers until ReleaseTile() is called.  A thread
+   * reads one tile at a time. */
+  const TileType *
+  AcquireTile(SizeValueType tileId) const;
+
+  void
+  ReleaseTile(SizeValueType tileId) const;
+
+  /** Stamp the use of a tile with the current number of computed tiles. */
+  void
+  StampTileUse(TileSlot & slot) const;
+
+  /** Evict the cached tile whose last use is the oldest.  Called with the
+   * lock held. */
+  void
+  EvictTile() const;
+
+  /** Release the cached tiles.  Called with the lock held. */
+  void
+  ReleaseTiles();
+
+  typename GradientCalculatorType::ConstPointer m_GradientCalculator;
+  SizeValueType                                 m_TileSize{ 16 };
+  SizeValueType                                 m_MaximumSizeInBytes{ 64 * 1024 * 1024 };
+
+  RegionType    m_BufferedRegion;
+  SizeValueType m_NumberOfTilesPerDimension[ImageDimension]{};
+  SizeValueType m_NumberOfTiles{ 0 };
+  SizeValueType m_MaximumNumberOfCachedTiles{ 1 };
+
+  std::unique_ptr<TileSlot[]>        m_TileSlots;
+  mutable std::mutex                 m_Mutex;
+  mutable std::vector<SizeValueType> m_CachedTileIds;
+  mutable std::atomic<SizeValueType> m_NumberOfComputedTiles{ 0 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkImageGradientTileCache.hxx"
+#endif
+
+#endif
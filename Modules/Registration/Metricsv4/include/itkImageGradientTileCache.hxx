@@ -0,0 +1,326 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkImageGradientTileCache_hxx
+#define itkImageGradientTileCache_hxx
+
+#include "itkImageGradientTileCache.h"
+
+#include "itkContinuousIndex.h"
+#include "itkImageRegionConstIteratorWithOnlyIndex.h"
+#include "itkMath.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace itk
+{
+
+template <typename TGradientCalculator, typename TStorageValue>
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::~ImageGradientTileCache()
+{
+  this->ReleaseTiles();
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::Initialize()
+{
+  if (this->m_GradientCalculator.IsNull() || this->m_GradientCalculator->GetInputImage() == nullptr)
+  {
+    itkExceptionMacro("The gradient calculator and its input image must be set.");
+  }
+
+  this->m_BufferedRegion = this->m_GradientCalculator->GetInputImage()->GetBufferedRegion();
+  SizeValueType numberOfTiles = 1;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    this->m_NumberOfTilesPerDimension[d] =
+      (this->m_BufferedRegion.GetSize(d) + this->m_TileSize - 1) / this->m_TileSize;
+    numberOfTiles *= this->m_NumberOfTilesPerDimension[d];
+  }
+  this->m_MaximumNumberOfCachedTiles =
+    std::max<SizeValueType>(this->m_MaximumSizeInBytes / this->GetTileSizeInBytes(), 1);
+
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  this->ReleaseTiles();
+  this->m_NumberOfTiles = numberOfTiles;
+  this->m_TileSlots.reset(new TileSlot[numberOfTiles]);
+  this->m_CachedTileIds.clear();
+  this->m_CachedTileIds.reserve(this->m_MaximumNumberOfCachedTiles);
+  this->m_NumberOfComputedTiles = 0;
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::ReleaseTiles()
+{
+  for (SizeValueType tileId = 0; tileId < this->m_NumberOfTiles; tileId++)
+  {
+    delete this->m_TileSlots[tileId].Tile.exchange(nullptr);
+  }
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+SizeValueType
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::GetTileSizeInBytes() const
+{
+  SizeValueType numberOfVoxels = 1;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    numberOfVoxels *= this->m_TileSize;
+  }
+  return numberOfVoxels * GradientDimension * sizeof(StorageValueType);
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+SizeValueType
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::GetNumberOfCachedTiles() const
+{
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  return static_cast<SizeValueType>(this->m_CachedTileIds.size());
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::Evaluate(const PointType & point,
+                                                                     GradientType &    gradient) const
+{
+  const InputImageType *                  image = this->m_GradientCalculator->GetInputImage();
+  ContinuousIndex<double, ImageDimension> continuousIndex;
+  image->TransformPhysicalPointToContinuousIndex(point, continuousIndex);
+
+  const IndexType & start = this->m_BufferedRegion.GetIndex();
+  IndexType         baseIndex;
+  double            distance[ImageDimension];
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    baseIndex[d] = Math::Floor<IndexValueType>(continuousIndex[d]);
+    distance[d] = continuousIndex[d] - static_cast<double>(baseIndex[d]);
+  }
+
+  double interpolated[GradientDimension] = {};
+
+  // Neighbors outside of the buffered region are clamped to it, as in
+  // LinearInterpolateImageFunction.
+  const TileType * tile = nullptr;
+  SizeValueType    currentTileId = NumericTraits<SizeValueType>::max();
+  for (unsigned int corner = 0; corner < (1u << ImageDimension); corner++)
+  {
+    double        weight = 1.0;
+    SizeValueType tileId = 0;
+    SizeValueType tileStride = 1;
+    SizeValueType voxelOffset = 0;
+    SizeValueType voxelStride = 1;
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      IndexValueType index = baseIndex[d];
+      if (corner & (1u << d))
+      {
+        ++index;
+        weight *= distance[d];
+      }
+      else
+      {
+        weight *= 1.0 - distance[d];
+      }
+      const auto last = static_cast<IndexValueType>(start[d] + this->m_BufferedRegion.GetSize(d) - 1);
+      index = std::min(std::max(index, start[d]), last);
+
+      const auto position = static_cast<SizeValueType>(index - start[d]);
+      tileId += (position / this->m_TileSize) * tileStride;
+      tileStride *= this->m_NumberOfTilesPerDimension[d];
+      voxelOffset += (position % this->m_TileSize) * voxelStride;
+      voxelStride *= this->m_TileSize;
+    }
+    if (weight == 0.0)
+    {
+      continue;
+    }
+
+    if (tileId != currentTileId)
+    {
+      if (tile != nullptr)
+      {
+        this->ReleaseTile(currentTileId);
+      }
+      tile = this->AcquireTile(tileId);
+      currentTileId = tileId;
+    }
+    const StorageValueType * voxelGradient = tile->data() + voxelOffset * GradientDimension;
+    for (unsigned int c = 0; c < GradientDimension; c++)
+    {
+      interpolated[c] += weight * static_cast<double>(voxelGradient[c]);
+    }
+  }
+  if (tile != nullptr)
+  {
+    this->ReleaseTile(currentTileId);
+  }
+
+  for (unsigned int c = 0; c < GradientDimension; c++)
+  {
+    gradient[c] = interpolated[c];
+  }
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+const typename ImageGradientTileCache<TGradientCalculator, TStorageValue>::TileType *
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::AcquireTile(SizeValueType tileId) const
+{
+  // The reader is registered before the tile is loaded, and an evicting
+  // thread clears the tile before it checks the readers, so that either the
+  // reader sees no tile or the evicting thread waits for it.
+  TileSlot & slot = this->m_TileSlots[tileId];
+  ++slot.NumberOfReaders;
+  const TileType * tile = slot.Tile.load();
+  if (tile != nullptr)
+  {
+    this->StampTileUse(slot);
+    return tile;
+  }
+  --slot.NumberOfReaders;
+
+  // Compute the tile without holding the lock, so that the other threads
+  // keep using the cached tiles.  Two threads may compute the same tile, in
+  // which case the first one to finish is cached.
+  RegionType    tileRegion = this->m_BufferedRegion;
+  SizeValueType remainder = tileId;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    const SizeValueType tileIndex = remainder % this->m_NumberOfTilesPerDimension[d];
+    remainder /= this->m_NumberOfTilesPerDimension[d];
+    const SizeValueType position = tileIndex * this->m_TileSize;
+    tileRegion.SetIndex(d, this->m_BufferedRegion.GetIndex(d) + static_cast<IndexValueType>(position));
+    tileRegion.SetSize(d, std::min(this->m_TileSize, this->m_BufferedRegion.GetSize(d) - position));
+  }
+  std::unique_ptr<TileType> computedTile(new TileType);
+  this->ComputeTile(tileRegion, *computedTile);
+  ++this->m_NumberOfComputedTiles;
+
+  std::lock_guard<std::mutex> lock(this->m_Mutex);
+  ++slot.NumberOfReaders;
+  tile = slot.Tile.load();
+  if (tile == nullptr)
+  {
+    while (this->m_CachedTileIds.size() >= this->m_MaximumNumberOfCachedTiles)
+    {
+      this->EvictTile();
+    }
+    tile = computedTile.get();
+    slot.Tile.store(computedTile.release());
+    this->m_CachedTileIds.push_back(tileId);
+  }
+  this->StampTileUse(slot);
+  return tile;
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::ReleaseTile(SizeValueType tileId) const
+{
+  --this->m_TileSlots[tileId].NumberOfReaders;
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::StampTileUse(TileSlot & slot) const
+{
+  // The stamp only changes after a tile computation, so that the tiles in
+  // use are not written to by every read.
+  const SizeValueType stamp = this->m_NumberOfComputedTiles.load(std::memory_order_relaxed);
+  if (slot.LastUse.load(std::memory_order_relaxed) != stamp)
+  {
+    slot.LastUse.store(stamp, std::memory_order_relaxed);
+  }
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::EvictTile() const
+{
+  auto oldest = this->m_CachedTileIds.begin();
+  for (auto it = oldest + 1; it != this->m_CachedTileIds.end(); ++it)
+  {
+    if (this->m_TileSlots[*it].LastUse.load(std::memory_order_relaxed) <
+        this->m_TileSlots[*oldest].LastUse.load(std::memory_order_relaxed))
+    {
+      oldest = it;
+    }
+  }
+  TileSlot & slot = this->m_TileSlots[*oldest];
+  *oldest = this->m_CachedTileIds.back();
+  this->m_CachedTileIds.pop_back();
+
+  // The readers of the tile hold it for a few voxels, without waiting for
+  // another tile.
+  TileType * tile = slot.Tile.exchange(nullptr);
+  while (slot.NumberOfReaders.load() != 0)
+  {
+    std::this_thread::yield();
+  }
+  delete tile;
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::ComputeTile(const RegionType & tileRegion,
+                                                                        TileType &         tile) const
+{
+  SizeValueType numberOfVoxels = 1;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    numberOfVoxels *= this->m_TileSize;
+  }
+  tile.resize(numberOfVoxels * GradientDimension);
+
+  ImageRegionConstIteratorWithOnlyIndex<InputImageType> it(this->m_GradientCalculator->GetInputImage(), tileRegion);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const IndexType & index = it.GetIndex();
+    SizeValueType     voxelOffset = 0;
+    SizeValueType     voxelStride = 1;
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      voxelOffset += static_cast<SizeValueType>(index[d] - tileRegion.GetIndex(d)) * voxelStride;
+      voxelStride *= this->m_TileSize;
+    }
+
+    const GradientType gradient = this->m_GradientCalculator->EvaluateAtIndex(index);
+    StorageValueType * voxelGradient = tile.data() + voxelOffset * GradientDimension;
+    for (unsigned int c = 0; c < GradientDimension; c++)
+    {
+      voxelGradient[c] = static_cast<StorageValueType>(gradient[c]);
+    }
+  }
+}
+
+template <typename TGradientCalculator, typename TStorageValue>
+void
+ImageGradientTileCache<TGradientCalculator, TStorageValue>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "TileSize: " << this->m_TileSize << std::endl;
+  os << indent << "MaximumSizeInBytes: " << this->m_MaximumSizeInBytes << std::endl;
+  os << indent << "NumberOfTiles: " << this->GetNumberOfTiles() << std::endl;
+  os << indent << "NumberOfComputedTiles: " << this->GetNumberOfComputedTiles() << std::endl;
+  itkPrintSelfObjectMacro(GradientCalculator);
+}
+} // end namespace itk
+
+#endif
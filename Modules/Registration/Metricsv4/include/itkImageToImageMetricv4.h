@@ -20,6 +20,7 @@
 
 #include "itkCovariantVector.h"
 #include "itkImageFunction.h"
+#include "itkImageGradientTileCache.h"
 #include "itkObjectToObjectMetric.h"
 #include "itkInterpolateImageFunction.h"
 #include "itkSpatialObject.h"
@@ -31,6 +32,7 @@
 #include "itkPointSet.h"
 #include "itkDefaultConvertPixelTraits.h"
 #include "itkDefaultImageToImageMetricTraitsv4.h"
+#include "itkMultiTransform.h"
 
 namespace itk
 {
@@ -77,6 +79,15 @@ namespace itk
  *  gradients at each iteration of a registration instead of just computing
  *  once at the beginning. The user can supply a different function by calling
  *  SetFixedImageGradientCalculator and/or SetMovingImageGradientCalculator.
+ * 3) In between, when the gradient filter is not used and
+ *  \c Use[Fixed|Moving]ImageGradientTileCache is set to true, the gradient
+ *  calculator is evaluated at the voxels of tiles of the image, which are
+ *  computed the first time they are needed and kept in an
+ *  ImageGradientTileCache of bounded size, in single precision.  The voxel
+ *  gradients are then linearly interpolated, as with a gradient filter.  This
+ *  approaches the speed of a precomputed gradient image with a fraction of
+ *  its memory, e.g. on large moving images.  The cache is set up with
+ *  Get[Fixed|Moving]ImageGradientTileCache().
  *
  * Both image gradient calculation methods are threaded.
  * Generally it is not recommended to use different image gradient methods for
@@ -471,6 +482,37 @@ public:
   itkGetConstReferenceMacro(UseMovingImageGradientFilter, bool);
   itkBooleanMacro(UseMovingImageGradientFilter);
 
+  /** Type of the tiled caches of image gradients. */
+  using FixedImageGradientTileCacheType = ImageGradientTileCache<FixedImageGradientCalculatorType>;
+  using MovingImageGradientTileCacheType = ImageGradientTileCache<MovingImageGradientCalculatorType>;
+
+  /** Set/Get gradient computation via a tiled cache of the gradient
+   * calculator results, when the gradient filter is not used. */
+  itkSetMacro(UseFixedImageGradientTileCache, bool);
+  itkGetConstReferenceMacro(UseFixedImageGradientTileCache, bool);
+  itkBooleanMacro(UseFixedImageGradientTileCache);
+  itkSetMacro(UseMovingImageGradientTileCache, bool);
+  itkGetConstReferenceMacro(UseMovingImageGradientTileCache, bool);
+  itkBooleanMacro(UseMovingImageGradientTileCache);
+
+  /** Get the tiled caches of image gradients, e.g. to set their tile size and
+   * memory budget. */
+  itkGetModifiableObjectMacro(FixedImageGradientTileCache, FixedImageGradientTileCacheType);
+  itkGetModifiableObjectMacro(MovingImageGradientTileCache, MovingImageGradientTileCacheType);
+
+  /** Set/Get whether the mapped fixed point, fixed image value and fixed
+   * image gradient of each domain sample are cached and reused between
+   * evaluations. The cache is filled during the first evaluation after
+   * Initialize(), and is discarded by Initialize() and whenever the fixed
+   * image, fixed transform, fixed interpolator, fixed mask or sampled point
+   * set are modified.
+   * Registrations that only optimize the moving transform, e.g. rigid and
+   * affine registrations, then only evaluate the moving image at each
+   * iteration. Off by default. */
+  itkSetMacro(UseFixedSampleCache, bool);
+  itkGetConstReferenceMacro(UseFixedSampleCache, bool);
+  itkBooleanMacro(UseFixedSampleCache);
+
   /** Get number of work units to used in the the most recent
    * evaluation.  Only valid after GetValueAndDerivative() or
    * GetValue() has been called. */
@@ -485,6 +527,12 @@ public:
   virtual ThreadIdType
   GetMaximumNumberOfWorkUnits() const;
 
+  /** Set the number of work units that the evaluations are split into, one
+   * to evaluate the metric on the calling thread. The default is the number
+   * of work units of the default multi-threader. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType workUnits) override;
+
 #if !defined(ITK_LEGACY_REMOVE)
   /** Get number of threads to used in the the most recent
    * evaluation.  Only valid after GetValueAndDerivative() or
@@ -653,12 +701,35 @@ protected:
                                  FixedImagePointType &    mappedFixedPoint,
                                  FixedImagePixelType &    mappedFixedPixelValue) const;
 
+  /** Same as \c TransformAndEvaluateFixedPoint, followed by \c
+   * ComputeFixedImageGradientAtPoint when \c computeGradient is set, for the
+   * domain sample \c sampleId, i.e. the index of the point in the virtual
+   * sampled point set, or the offset of the point in the virtual region.
+   * When \c UseFixedSampleCache is on, the results are stored on first use
+   * and returned from the cache afterwards.
+   * \warning Called from the threaders; each sample must only be processed
+   * by one thread during an evaluation. */
+  bool
+  TransformAndEvaluateFixedSample(const SizeValueType      sampleId,
+                                  const VirtualPointType & virtualPoint,
+                                  const bool               computeGradient,
+                                  FixedImagePointType &    mappedFixedPoint,
+                                  FixedImagePixelType &    mappedFixedPixelValue,
+                                  FixedImageGradientType & mappedFixedImageGradient) const;
+
   /** Transform and evaluate a point from VirtualImage domain to MovingImage domain. */
   bool
   TransformAndEvaluateMovingPoint(const VirtualPointType & virtualPoint,
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const;
 
+  /** The second half of \c TransformAndEvaluateMovingPoint, for a point
+   * already mapped into the MovingImage domain, e.g. by the threaders in a
+   * batch: check it against the mask and the image buffer, and evaluate. */
+  bool
+  EvaluateMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                      MovingImagePixelType &       mappedMovingPixelValue) const;
+
   /** Compute image derivatives for a Fixed point. */
   virtual void
   ComputeFixedImageGradientAtPoint(const FixedImagePointType & mappedPoint, FixedImageGradientType & gradient) const;
@@ -734,6 +805,12 @@ protected:
   FixedImageGradientCalculatorPointer  m_FixedImageGradientCalculator;
   MovingImageGradientCalculatorPointer m_MovingImageGradientCalculator;
 
+  /** Tiled caches of the image gradient calculator results. */
+  bool                                               m_UseFixedImageGradientTileCache{ false };
+  bool                                               m_UseMovingImageGradientTileCache{ false };
+  typename FixedImageGradientTileCacheType::Pointer  m_FixedImageGradientTileCache;
+  typename MovingImageGradientTileCacheType::Pointer m_MovingImageGradientTileCache;
+
   /** Derivative results holder. User a raw pointer so we can point it
    * to a user-provided object. This is used in internal methods so
    * the user-provided variable does not have to be passed around. It also enables
@@ -757,9 +834,23 @@ protected:
   FixedSampledPointSet */
   bool m_UseVirtualSampledPointSet;
 
+  /** Flag to cache the fixed image data of the domain samples. */
+  bool m_UseFixedSampleCache;
+
   ImageToImageMetricv4();
   ~ImageToImageMetricv4() override = default;
 
+  /** Clone the metric, e.g. to evaluate it at several positions concurrently.
+   * The clone gets clones of the moving transform and the interpolators and
+   * gradient tile caches of its own, and shares the images, fixed transform,
+   * masks, point sets, gradient filters and calculators and the virtual domain
+   * with this metric. These shared objects must not be modified while the
+   * clone is in use. Initialize() must be
+   * called on the clone before evaluating it. Derived classes with settings of
+   * their own override this to copy them. */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   void
   PrintSelf(std::ostream & os, Indent indent) const override;
 
@@ -768,6 +859,16 @@ private:
   void
   MapFixedSampledPointSetToVirtual();
 
+  /** Discard the cached fixed samples if the cache is disabled, does not match
+   * the domain, or anything it was computed from has been modified since. */
+  void
+  UpdateFixedSampleCache() const;
+
+  /** Modification time of the fixed transform, including the transforms it
+   * is composed of. */
+  ModifiedTimeType
+  GetFixedTransformMTime() const;
+
   /** Transform a point. Avoid cast if possible */
   void
   LocalTransformPoint(const typename FixedTransformType::OutputPointType & virtualPoint,
@@ -830,6 +931,22 @@ private:
   /** Flag to know if derivative should be calculated */
   mutable bool m_ComputeDerivative;
 
+  /** Fixed image data of the domain samples, stored as one array per
+   * quantity and indexed by sample id. m_FixedSampleCacheState holds one of
+   * the FixedSampleCacheStateEnum values per sample. */
+  enum FixedSampleCacheStateEnum : uint8_t
+  {
+    FixedSampleNotComputed = 0,
+    FixedSampleInvalid,
+    FixedSampleValueComputed,
+    FixedSampleValueAndGradientComputed
+  };
+  mutable std::vector<uint8_t>                m_FixedSampleCacheState;
+  mutable std::vector<FixedImagePointType>    m_FixedSampleCachePoints;
+  mutable std::vector<FixedImagePixelType>    m_FixedSampleCacheValues;
+  mutable std::vector<FixedImageGradientType> m_FixedSampleCacheGradients;
+  mutable TimeStamp                           m_FixedSampleCacheTime;
+
 /** Only floating-point images are currently supported. To support integer images,
  * several small changes must be made */
 #ifdef ITK_USE_CONCEPT_CHECKING
@@ -62,11 +62,15 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   this->m_DefaultMovingImageGradientCalculator->UseImageDirectionOn();
   this->m_MovingImageGradientCalculator = this->m_DefaultMovingImageGradientCalculator;
 
+  this->m_FixedImageGradientTileCache = FixedImageGradientTileCacheType::New();
+  this->m_MovingImageGradientTileCache = MovingImageGradientTileCacheType::New();
+
   /* Setup default options assuming dense-sampling */
   this->m_UseFixedImageGradientFilter = true;
   this->m_UseMovingImageGradientFilter = true;
   this->m_UseSampledPointSet = false;
   this->m_UseVirtualSampledPointSet = false;
+  this->m_UseFixedSampleCache = false;
 
   this->m_FloatingPointCorrectionResolution = 1e6;
   this->m_UseFloatingPointCorrection = false;
@@ -162,12 +166,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize FixedImageGradientCalculator");
     this->m_FixedImageGradientImage = nullptr;
     this->m_FixedImageGradientCalculator->SetInputImage(this->m_FixedImage);
+    if (this->m_UseFixedImageGradientTileCache)
+    {
+      this->m_FixedImageGradientTileCache->SetGradientCalculator(this->m_FixedImageGradientCalculator);
+      this->m_FixedImageGradientTileCache->Initialize();
+    }
   }
   if (!this->m_UseMovingImageGradientFilter)
   {
     itkDebugMacro("Initialize MovingImageGradientCalculator");
     this->m_MovingImageGradientImage = nullptr;
     this->m_MovingImageGradientCalculator->SetInputImage(this->m_MovingImage);
+    if (this->m_UseMovingImageGradientTileCache)
+    {
+      this->m_MovingImageGradientTileCache->SetGradientCalculator(this->m_MovingImageGradientCalculator);
+      this->m_MovingImageGradientTileCache->Initialize();
+    }
   }
 
   /* Initialize default gradient image filters. */
@@ -192,6 +206,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     itkDebugMacro("Initialize: ComputeMovingImageGradientFilterImage");
     this->ComputeMovingImageGradientFilterImage();
   }
+
+  /* The domain, images or gradient sources may have changed: the cached
+   * fixed samples are recomputed during the next evaluation. */
+  this->m_FixedSampleCacheState.clear();
 }
 
 template <typename TFixedImage,
@@ -301,6 +319,91 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     /* Clear derivative final result. */
     this->m_DerivativeResult->Fill(NumericTraits<DerivativeValueType>::ZeroValue());
   }
+
+  this->UpdateFixedSampleCache();
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  UpdateFixedSampleCache() const
+{
+  if (!this->m_UseFixedSampleCache)
+  {
+    if (!this->m_FixedSampleCacheState.empty())
+    {
+      this->m_FixedSampleCacheState = std::vector<uint8_t>();
+      this->m_FixedSampleCachePoints = std::vector<FixedImagePointType>();
+      this->m_FixedSampleCacheValues = std::vector<FixedImagePixelType>();
+      this->m_FixedSampleCacheGradients = std::vector<FixedImageGradientType>();
+    }
+    return;
+  }
+
+  const auto             numberOfSamples = static_cast<size_t>(this->GetNumberOfDomainPoints());
+  const ModifiedTimeType cacheTime = this->m_FixedSampleCacheTime.GetMTime();
+  bool isOutdated = this->m_FixedSampleCacheState.size() != numberOfSamples ||
+                    this->m_FixedImage->GetMTime() > cacheTime || this->GetFixedTransformMTime() > cacheTime ||
+                    this->m_FixedInterpolator->GetMTime() > cacheTime;
+  if (this->m_FixedImageMask)
+  {
+    isOutdated = isOutdated || this->m_FixedImageMask->GetMTime() > cacheTime;
+  }
+  if (this->m_UseSampledPointSet)
+  {
+    // The sample ids index the sampled point set, whose points may be
+    // redrawn in place, e.g. for stochastic mini-batch sampling.
+    isOutdated = isOutdated || this->m_VirtualSampledPointSet->GetMTime() > cacheTime ||
+                 this->m_VirtualSampledPointSet->GetPoints()->GetMTime() > cacheTime;
+  }
+  if (isOutdated)
+  {
+    this->m_FixedSampleCacheState.assign(numberOfSamples, FixedSampleNotComputed);
+    this->m_FixedSampleCachePoints.resize(numberOfSamples);
+    this->m_FixedSampleCacheValues.resize(numberOfSamples);
+    this->m_FixedSampleCacheGradients.resize(numberOfSamples);
+    this->m_FixedSampleCacheTime.Modified();
+  }
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+ModifiedTimeType
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  GetFixedTransformMTime() const
+{
+  // A composite transform is not modified when one of its transforms is,
+  // e.g. when the displacement field of a SyN fixed transform is updated.
+  using FixedMultiTransformType = MultiTransform<ParametersValueType, VirtualImageDimension, FixedImageDimension>;
+
+  ModifiedTimeType                             mtime = this->m_FixedTransform->GetMTime();
+  std::vector<const FixedMultiTransformType *> pending;
+  if (const auto * multiTransform = dynamic_cast<const FixedMultiTransformType *>(this->m_FixedTransform.GetPointer()))
+  {
+    pending.push_back(multiTransform);
+  }
+  while (!pending.empty())
+  {
+    const FixedMultiTransformType * multiTransform = pending.back();
+    pending.pop_back();
+    for (SizeValueType n = 0; n < multiTransform->GetNumberOfTransforms(); ++n)
+    {
+      const auto * transform = multiTransform->GetNthTransformConstPointer(n);
+      mtime = std::max(mtime, transform->GetMTime());
+      if (const auto * subMultiTransform = dynamic_cast<const FixedMultiTransformType *>(transform))
+      {
+        pending.push_back(subMultiTransform);
+      }
+    }
+  }
+  return mtime;
 }
 
 template <typename TFixedImage,
@@ -344,6 +447,59 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   return pointIsValid;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  TransformAndEvaluateFixedSample(const SizeValueType      sampleId,
+                                  const VirtualPointType & virtualPoint,
+                                  const bool               computeGradient,
+                                  FixedImagePointType &    mappedFixedPoint,
+                                  FixedImagePixelType &    mappedFixedPixelValue,
+                                  FixedImageGradientType & mappedFixedImageGradient) const
+{
+  if (sampleId >= this->m_FixedSampleCacheState.size())
+  {
+    // Not cached
+    const bool pointIsValid =
+      this->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
+    if (pointIsValid && computeGradient)
+    {
+      this->ComputeFixedImageGradientAtPoint(mappedFixedPoint, mappedFixedImageGradient);
+    }
+    return pointIsValid;
+  }
+
+  uint8_t & state = this->m_FixedSampleCacheState[sampleId];
+  if (state == FixedSampleNotComputed)
+  {
+    state = this->TransformAndEvaluateFixedPoint(
+              virtualPoint, this->m_FixedSampleCachePoints[sampleId], this->m_FixedSampleCacheValues[sampleId])
+              ? FixedSampleValueComputed
+              : FixedSampleInvalid;
+  }
+  if (state == FixedSampleInvalid)
+  {
+    return false;
+  }
+  if (computeGradient && state == FixedSampleValueComputed)
+  {
+    this->ComputeFixedImageGradientAtPoint(this->m_FixedSampleCachePoints[sampleId],
+                                           this->m_FixedSampleCacheGradients[sampleId]);
+    state = FixedSampleValueAndGradientComputed;
+  }
+  mappedFixedPoint = this->m_FixedSampleCachePoints[sampleId];
+  mappedFixedPixelValue = this->m_FixedSampleCacheValues[sampleId];
+  if (computeGradient)
+  {
+    mappedFixedImageGradient = this->m_FixedSampleCacheGradients[sampleId];
+  }
+  return true;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -355,9 +511,6 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
                                   MovingImagePointType &   mappedMovingPoint,
                                   MovingImagePixelType &   mappedMovingPixelValue) const
 {
-  bool pointIsValid = true;
-  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
-
   // map the point into moving space
 
   // Before transforming points, we should convert their types from the ImagePointType (aka Point<double, dim>)
@@ -371,6 +524,22 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   localMappedMovingPoint = this->m_MovingTransform->TransformPoint(localVirtualPoint);
   mappedMovingPoint.CastFrom(localMappedMovingPoint);
 
+  return this->EvaluateMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+bool
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  EvaluateMovingPoint(const MovingImagePointType & mappedMovingPoint,
+                      MovingImagePixelType &       mappedMovingPixelValue) const
+{
+  bool pointIsValid = true;
+  mappedMovingPixelValue = NumericTraits<MovingImagePixelType>::ZeroValue();
+
   // check against the mask if one is assigned
   if (this->m_MovingImageMask)
   {
@@ -414,6 +583,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     }
     gradient = m_FixedImageGradientInterpolator->Evaluate(mappedPoint);
   }
+  else if (this->m_UseFixedImageGradientTileCache)
+  {
+    this->m_FixedImageGradientTileCache->Evaluate(mappedPoint, gradient);
+  }
   else
   {
     // if not using the gradient image
@@ -440,6 +613,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
     }
     gradient = m_MovingImageGradientInterpolator->Evaluate(mappedPoint);
   }
+  else if (this->m_UseMovingImageGradientTileCache)
+  {
+    this->m_MovingImageGradientTileCache->Evaluate(mappedPoint, gradient);
+  }
   else
   {
     // if not using the gradient image
@@ -546,6 +723,20 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  SetNumberOfWorkUnits(ThreadIdType workUnits)
+{
+  this->m_SparseGetValueAndDerivativeThreader->SetNumberOfWorkUnits(workUnits);
+  this->m_DenseGetValueAndDerivativeThreader->SetNumberOfWorkUnits(workUnits);
+  this->Modified();
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -658,6 +849,88 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   }
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputationValueType, TMetricTraits>::
+  InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+
+  rval->m_FixedImage = this->m_FixedImage;
+  rval->m_MovingImage = this->m_MovingImage;
+  rval->m_FixedTransform = this->m_FixedTransform;
+  if (this->m_MovingTransform)
+  {
+    rval->m_MovingTransform = this->m_MovingTransform->Clone();
+  }
+  if (this->m_UserHasSetVirtualDomain)
+  {
+    rval->m_VirtualImage = this->m_VirtualImage;
+    rval->m_UserHasSetVirtualDomain = true;
+  }
+  rval->m_GradientSource = this->m_GradientSource;
+
+  // The clone gets its own interpolators and tile caches, which its
+  // Initialize() sets up without touching those of this metric.  The
+  // gradient calculators are shared: setting the same input image again
+  // leaves them unchanged.
+  if (this->m_FixedInterpolator)
+  {
+    rval->m_FixedInterpolator = this->m_FixedInterpolator->Clone();
+  }
+  if (this->m_MovingInterpolator)
+  {
+    rval->m_MovingInterpolator = this->m_MovingInterpolator->Clone();
+  }
+  rval->m_UseFixedImageGradientFilter = this->m_UseFixedImageGradientFilter;
+  rval->m_UseMovingImageGradientFilter = this->m_UseMovingImageGradientFilter;
+  rval->m_FixedImageGradientFilter = this->m_FixedImageGradientFilter;
+  rval->m_MovingImageGradientFilter = this->m_MovingImageGradientFilter;
+  rval->m_FixedImageGradientCalculator = this->m_FixedImageGradientCalculator;
+  rval->m_MovingImageGradientCalculator = this->m_MovingImageGradientCalculator;
+  rval->m_UseFixedImageGradientTileCache = this->m_UseFixedImageGradientTileCache;
+  rval->m_UseMovingImageGradientTileCache = this->m_UseMovingImageGradientTileCache;
+  rval->m_FixedImageGradientTileCache->SetTileSize(this->m_FixedImageGradientTileCache->GetTileSize());
+  rval->m_FixedImageGradientTileCache->SetMaximumSizeInBytes(
+    this->m_FixedImageGradientTileCache->GetMaximumSizeInBytes());
+  rval->m_MovingImageGradientTileCache->SetTileSize(this->m_MovingImageGradientTileCache->GetTileSize());
+  rval->m_MovingImageGradientTileCache->SetMaximumSizeInBytes(
+    this->m_MovingImageGradientTileCache->GetMaximumSizeInBytes());
+
+  rval->m_FixedImageMask = this->m_FixedImageMask;
+  rval->m_MovingImageMask = this->m_MovingImageMask;
+  rval->m_FixedSampledPointSet = this->m_FixedSampledPointSet;
+  rval->m_UseSampledPointSet = this->m_UseSampledPointSet;
+  rval->m_UseVirtualSampledPointSet = this->m_UseVirtualSampledPointSet;
+  if (this->m_UseVirtualSampledPointSet)
+  {
+    rval->m_VirtualSampledPointSet = this->m_VirtualSampledPointSet;
+  }
+  rval->m_UseFixedSampleCache = this->m_UseFixedSampleCache;
+  rval->m_UseFloatingPointCorrection = this->m_UseFloatingPointCorrection;
+  rval->m_FloatingPointCorrectionResolution = this->m_FloatingPointCorrectionResolution;
+
+  rval->m_DenseGetValueAndDerivativeThreader->SetNumberOfWorkUnits(
+    this->m_DenseGetValueAndDerivativeThreader->GetNumberOfWorkUnits());
+  rval->m_SparseGetValueAndDerivativeThreader->SetNumberOfWorkUnits(
+    this->m_SparseGetValueAndDerivativeThreader->GetNumberOfWorkUnits());
+  rval->m_DenseGetValueAndDerivativeThreader->SetMaximumNumberOfThreads(
+    this->m_DenseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads());
+  rval->m_SparseGetValueAndDerivativeThreader->SetMaximumNumberOfThreads(
+    this->m_SparseGetValueAndDerivativeThreader->GetMaximumNumberOfThreads());
+
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -673,7 +946,10 @@ ImageToImageMetricv4<TFixedImage, TMovingImage, TVirtualImage, TInternalComputat
   os << indent << "ImageToImageMetricv4: " << std::endl
      << indent << "GetUseFixedImageGradientFilter: " << this->GetUseFixedImageGradientFilter() << std::endl
      << indent << "GetUseMovingImageGradientFilter: " << this->GetUseMovingImageGradientFilter() << std::endl
+     << indent << "UseFixedImageGradientTileCache: " << this->GetUseFixedImageGradientTileCache() << std::endl
+     << indent << "UseMovingImageGradientTileCache: " << this->GetUseMovingImageGradientTileCache() << std::endl
      << indent << "UseFloatingPointCorrection: " << this->GetUseFloatingPointCorrection() << std::endl
+     << indent << "UseFixedSampleCache: " << this->GetUseFixedSampleCache() << std::endl
      << indent << "FloatingPointCorrectionResolution: " << this->GetFloatingPointCorrectionResolution() << std::endl;
 
   itkPrintSelfObjectMacro(FixedImage);
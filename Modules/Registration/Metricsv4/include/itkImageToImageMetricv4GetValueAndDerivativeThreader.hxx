@@ -20,6 +20,7 @@
 
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkImageToImageMetricv4GetValueAndDerivativeThreader.h"
+#include <vector>
 
 namespace itk
 {
@@ -32,12 +33,26 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<
 {
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
   using IteratorType = ImageRegionConstIteratorWithIndex<VirtualImageType>;
-  VirtualPointType virtualPoint;
+
+  // Process the points one line of the region at a time, so that the moving
+  // transform maps each line in one batch
+  const SizeValueType           lineLength = imageSubRegion.GetSize(0);
+  std::vector<VirtualIndexType> virtualIndices(lineLength);
+  std::vector<VirtualPointType> virtualPoints(lineLength);
+  std::vector<SizeValueType>    sampleIds(lineLength);
+  SizeValueType                 numberOfPoints = 0;
   for (IteratorType it(virtualImage, imageSubRegion); !it.IsAtEnd(); ++it)
   {
     const VirtualIndexType & virtualIndex = it.GetIndex();
-    virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    virtualIndices[numberOfPoints] = virtualIndex;
+    virtualImage->TransformIndexToPhysicalPoint(virtualIndex, virtualPoints[numberOfPoints]);
+    sampleIds[numberOfPoints] = virtualImage->ComputeOffset(virtualIndex);
+    if (++numberOfPoints == lineLength)
+    {
+      this->ProcessVirtualPoints(
+        virtualIndices.data(), virtualPoints.data(), sampleIds.data(), numberOfPoints, threadId);
+      numberOfPoints = 0;
+    }
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
@@ -54,11 +69,25 @@ ImageToImageMetricv4GetValueAndDerivativeThreader<ThreadedIndexedContainerPartit
   const ElementIdentifierType             begin = indexSubRange[0];
   const ElementIdentifierType             end = indexSubRange[1];
   typename VirtualImageType::ConstPointer virtualImage = this->m_Associate->GetVirtualImage();
+
+  // Process the points in blocks, so that the moving transform maps each
+  // block in one batch
+  const SizeValueType           blockSize = 256;
+  std::vector<VirtualIndexType> virtualIndices(blockSize);
+  std::vector<VirtualPointType> virtualPoints(blockSize);
+  std::vector<SizeValueType>    sampleIds(blockSize);
+  SizeValueType                 numberOfPoints = 0;
   for (ElementIdentifierType i = begin; i <= end; ++i)
   {
-    const VirtualPointType & virtualPoint = virtualSampledPointSet->GetPoint(i);
-    const auto               virtualIndex = virtualImage->TransformPhysicalPointToIndex(virtualPoint);
-    this->ProcessVirtualPoint(virtualIndex, virtualPoint, threadId);
+    virtualPoints[numberOfPoints] = virtualSampledPointSet->GetPoint(i);
+    virtualIndices[numberOfPoints] = virtualImage->TransformPhysicalPointToIndex(virtualPoints[numberOfPoints]);
+    sampleIds[numberOfPoints] = i;
+    if (++numberOfPoints == blockSize || i == end)
+    {
+      this->ProcessVirtualPoints(
+        virtualIndices.data(), virtualPoints.data(), sampleIds.data(), numberOfPoints, threadId);
+      numberOfPoints = 0;
+    }
   }
   // Finalize per thread actions
   this->m_Associate->FinalizeThread(threadId);
@@ -75,6 +75,7 @@ public:
   using FixedTransformType = typename ImageToImageMetricv4Type::FixedTransformType;
   using FixedOutputPointType = typename FixedTransformType::OutputPointType;
   using MovingTransformType = typename ImageToImageMetricv4Type::MovingTransformType;
+  using MovingInputPointType = typename MovingTransformType::InputPointType;
   using MovingOutputPointType = typename MovingTransformType::OutputPointType;
 
   using MeasureType = typename ImageToImageMetricv4Type::MeasureType;
@@ -120,6 +121,19 @@ protected:
                       const VirtualPointType & virtualPoint,
                       const ThreadIdType       threadId);
 
+  /** Method called by the threaders to process a block of virtual points,
+   * with their domain sample ids, through \c ProcessVirtualPoint. When
+   * \c m_MapMovingPointsInBatches is set, the points are first mapped into
+   * the moving image domain by a single call to the moving transform's
+   * \c TransformPoints, and \c ProcessVirtualPoint finds each mapped point
+   * in \c MappedMovingPoint of the per-thread variables. */
+  void
+  ProcessVirtualPoints(const VirtualIndexType * virtualIndices,
+                       const VirtualPointType * virtualPoints,
+                       const SizeValueType *    sampleIds,
+                       const SizeValueType      numberOfPoints,
+                       const ThreadIdType       threadId);
+
   /** Method to calculate the metric value and derivative
    * given a point, value and image derivative for both fixed and moving
    * spaces. The provided values have been calculated from \c virtualPoint,
@@ -184,6 +198,18 @@ protected:
      * classes for efficiency. */
     JacobianType MovingTransformJacobian;
     JacobianType MovingTransformJacobianPositional;
+    /** Domain sample id of the point passed to \c ProcessVirtualPoint, set by
+     * threaders that know it, so that the metric's fixed sample cache can be
+     * used. NumericTraits<SizeValueType>::max() when unknown. */
+    SizeValueType SampleId;
+    /** The point passed to \c ProcessVirtualPoint, already mapped into the
+     * moving image domain by \c ProcessVirtualPoints, or nullptr when it
+     * must be mapped point by point. */
+    const MovingImagePointType * MappedMovingPoint;
+    /** Buffers of \c ProcessVirtualPoints for the block being mapped. */
+    std::vector<MovingInputPointType>  MovingTransformInputPoints;
+    std::vector<MovingOutputPointType> MovingTransformOutputPoints;
+    std::vector<MovingImagePointType>  MappedMovingPoints;
   };
   itkPadStruct(ITK_CACHE_LINE_ALIGNMENT,
                GetValueAndDerivativePerThreadStruct,
@@ -197,6 +223,12 @@ protected:
    *  These will only be set once threading has been started. */
   mutable NumberOfParametersType m_CachedNumberOfParameters;
   mutable NumberOfParametersType m_CachedNumberOfLocalParameters;
+
+  /** Whether \c ProcessVirtualPoints maps its points into the moving image
+   * domain in a batch. On by default; threaders overriding
+   * \c ProcessVirtualPoint with their own mapping turn it off, so that the
+   * points are not mapped twice. */
+  bool m_MapMovingPointsInBatches;
 };
 
 } // end namespace itk
@@ -30,6 +30,7 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   : m_GetValueAndDerivativePerThreadVariables(nullptr)
   , m_CachedNumberOfParameters(0)
   , m_CachedNumberOfLocalParameters(0)
+  , m_MapMovingPointsInBatches(true)
 {}
 
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
@@ -100,6 +101,8 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner,
   {
     this->m_GetValueAndDerivativePerThreadVariables[thread].NumberOfValidPoints =
       NumericTraits<SizeValueType>::ZeroValue();
+    this->m_GetValueAndDerivativePerThreadVariables[thread].SampleId = NumericTraits<SizeValueType>::max();
+    this->m_GetValueAndDerivativePerThreadVariables[thread].MappedMovingPoint = nullptr;
     this->m_GetValueAndDerivativePerThreadVariables[thread].Measure =
       NumericTraits<InternalComputationValueType>::ZeroValue();
     if (this->m_Associate->GetComputeDerivative())
@@ -201,13 +204,13 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
    * then we otherwise get when exceptions are caught in MultiThreaderBase. */
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateFixedPoint(virtualPoint, mappedFixedPoint, mappedFixedPixelValue);
-    if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
-        this->m_Associate->GetGradientSourceIncludesFixed())
-    {
-      this->m_Associate->ComputeFixedImageGradientAtPoint(mappedFixedPoint, mappedFixedImageGradient);
-    }
+    pointIsValid = this->m_Associate->TransformAndEvaluateFixedSample(
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].SampleId,
+      virtualPoint,
+      this->m_Associate->GetComputeDerivative() && this->m_Associate->GetGradientSourceIncludesFixed(),
+      mappedFixedPoint,
+      mappedFixedPixelValue,
+      mappedFixedImageGradient);
   }
   catch (ExceptionObject & exc)
   {
@@ -224,8 +227,18 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
 
   try
   {
-    pointIsValid =
-      this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+    const MovingImagePointType * mappedMovingPointInBatch =
+      this->m_GetValueAndDerivativePerThreadVariables[threadId].MappedMovingPoint;
+    if (mappedMovingPointInBatch != nullptr)
+    {
+      mappedMovingPoint = *mappedMovingPointInBatch;
+      pointIsValid = this->m_Associate->EvaluateMovingPoint(mappedMovingPoint, mappedMovingPixelValue);
+    }
+    else
+    {
+      pointIsValid =
+        this->m_Associate->TransformAndEvaluateMovingPoint(virtualPoint, mappedMovingPoint, mappedMovingPixelValue);
+    }
     if (pointIsValid && this->m_Associate->GetComputeDerivative() &&
         this->m_Associate->GetGradientSourceIncludesMoving())
     {
@@ -281,6 +294,57 @@ ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImage
   return pointIsValid;
 }
 
+template <typename TDomainPartitioner, typename TImageToImageMetricv4>
+void
+ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::ProcessVirtualPoints(
+  const VirtualIndexType * virtualIndices,
+  const VirtualPointType * virtualPoints,
+  const SizeValueType *    sampleIds,
+  const SizeValueType      numberOfPoints,
+  const ThreadIdType       threadId)
+{
+  AlignedGetValueAndDerivativePerThreadStruct & perThread = this->m_GetValueAndDerivativePerThreadVariables[threadId];
+
+  if (this->m_MapMovingPointsInBatches)
+  {
+    // Convert the types as TransformAndEvaluateMovingPoint does
+    perThread.MovingTransformInputPoints.resize(numberOfPoints);
+    perThread.MovingTransformOutputPoints.resize(numberOfPoints);
+    perThread.MappedMovingPoints.resize(numberOfPoints);
+    for (SizeValueType p = 0; p < numberOfPoints; ++p)
+    {
+      perThread.MovingTransformInputPoints[p].CastFrom(virtualPoints[p]);
+    }
+    try
+    {
+      this->m_Associate->m_MovingTransform->TransformPoints(
+        perThread.MovingTransformInputPoints.data(), perThread.MovingTransformOutputPoints.data(), numberOfPoints);
+    }
+    catch (ExceptionObject & exc)
+    {
+      std::string msg("Caught exception: \n");
+      msg += exc.what();
+      ExceptionObject err(__FILE__, __LINE__, msg);
+      throw err;
+    }
+    for (SizeValueType p = 0; p < numberOfPoints; ++p)
+    {
+      perThread.MappedMovingPoints[p].CastFrom(perThread.MovingTransformOutputPoints[p]);
+    }
+  }
+
+  for (SizeValueType p = 0; p < numberOfPoints; ++p)
+  {
+    perThread.SampleId = sampleIds[p];
+    if (this->m_MapMovingPointsInBatches)
+    {
+      perThread.MappedMovingPoint = &perThread.MappedMovingPoints[p];
+    }
+    this->ProcessVirtualPoint(virtualIndices[p], virtualPoints[p], threadId);
+  }
+  perThread.MappedMovingPoint = nullptr;
+}
+
 template <typename TDomainPartitioner, typename TImageToImageMetricv4>
 void
 ImageToImageMetricv4GetValueAndDerivativeThreaderBase<TDomainPartitioner, TImageToImageMetricv4>::
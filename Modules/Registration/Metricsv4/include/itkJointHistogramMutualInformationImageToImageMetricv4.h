@@ -149,10 +149,20 @@ public:
   MeasureType
   GetValue() const override;
 
+  /** Set the number of work units of the evaluations, including the
+   * computation of the joint PDF. */
+  void
+  SetNumberOfWorkUnits(ThreadIdType workUnits) override;
+
 protected:
   JointHistogramMutualInformationImageToImageMetricv4();
   ~JointHistogramMutualInformationImageToImageMetricv4() override = default;
 
+  /** Clone the metric, including the number of histogram bins and the joint PDF smoothing variance.
+   * \sa ImageToImageMetricv4::InternalClone */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   /** Update the histograms for use in GetValueAndDerivative
    *  Results are returned in \c value and \c derivative.
    */
@@ -419,6 +419,47 @@ JointHistogramMutualInformationImageToImageMetricv4<
   jointPDFpoint[1] = b;
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+JointHistogramMutualInformationImageToImageMetricv4<TFixedImage,
+                                                    TMovingImage,
+                                                    TVirtualImage,
+                                                    TInternalComputationValueType,
+                                                    TMetricTraits>::SetNumberOfWorkUnits(ThreadIdType workUnits)
+{
+  Superclass::SetNumberOfWorkUnits(workUnits);
+  this->m_JointHistogramMutualInformationDenseComputeJointPDFThreader->SetNumberOfWorkUnits(workUnits);
+  this->m_JointHistogramMutualInformationSparseComputeJointPDFThreader->SetNumberOfWorkUnits(workUnits);
+}
+
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+JointHistogramMutualInformationImageToImageMetricv4<TFixedImage,
+                                                    TMovingImage,
+                                                    TVirtualImage,
+                                                    TInternalComputationValueType,
+                                                    TMetricTraits>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_NumberOfHistogramBins = this->m_NumberOfHistogramBins;
+  rval->m_VarianceForJointPDFSmoothing = this->m_VarianceForJointPDFSmoothing;
+
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
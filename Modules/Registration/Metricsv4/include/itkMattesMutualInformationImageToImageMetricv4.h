@@ -157,6 +157,17 @@ public:
   itkSetClampMacro(NumberOfHistogramBins, SizeValueType, 5, NumericTraits<SizeValueType>::max());
   itkGetConstReferenceMacro(NumberOfHistogramBins, SizeValueType);
 
+  /** Accumulate the joint PDF derivatives of global-support transforms in
+   * per-thread sparse buffers that are summed after the threaded pass, instead
+   * of periodically flushing them into the shared joint PDF derivatives under
+   * a lock. Each thread only stores the joint PDF bins it touched. This removes
+   * the lock contention seen with many threads and transforms with many
+   * parameters (e.g. BSplineTransform), at the cost of up to one joint PDF
+   * derivatives sized buffer per thread. Off by default. */
+  itkSetMacro(UseLockFreeDerivativeAccumulation, bool);
+  itkGetConstMacro(UseLockFreeDerivativeAccumulation, bool);
+  itkBooleanMacro(UseLockFreeDerivativeAccumulation);
+
   void
   Initialize() override;
 
@@ -202,6 +213,11 @@ protected:
   MattesMutualInformationImageToImageMetricv4();
   ~MattesMutualInformationImageToImageMetricv4() override = default;
 
+  /** Clone the metric, including the number of histogram bins and the derivative accumulation mode.
+   * \sa ImageToImageMetricv4::InternalClone */
+  typename LightObject::Pointer
+  InternalClone() const override;
+
   friend class MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
     ThreadedImageRegionPartitioner<Superclass::VirtualImageDimension>,
     Superclass,
@@ -363,12 +379,61 @@ protected:
     typename JointPDFDerivativesType::Pointer m_ParentJointPDFDerivatives;
   };
 
+  /* \class SparseDerivativeAccumulator
+   * Per-thread accumulator of joint PDF derivatives, used instead of a
+   * DerivativeBufferManager when m_UseLockFreeDerivativeAccumulation is set.
+   * A row of derivative values is only allocated for the joint PDF bins the
+   * thread touches, so no synchronization is needed while threading; the rows
+   * of all threads are summed bin by bin after the threaded pass.
+   * \ingroup ITKMetricsv4
+   */
+  class SparseDerivativeAccumulator
+  {
+  public:
+    /** Prepare for a new pass, keeping previously allocated memory. */
+    void
+    Initialize(SizeValueType numberOfBins, size_t cachedNumberOfLocalParameters);
+
+    /** Row of derivative values of a joint PDF bin, zero on first access.
+     * The pointer is invalidated by the next call. */
+    PDFValueType *
+    GetRowForAccumulation(OffsetValueType bin)
+    {
+      OffsetValueType & rowOffset = m_RowOffsetByBin[bin];
+      if (rowOffset < 0)
+      {
+        rowOffset = static_cast<OffsetValueType>(m_Rows.size());
+        m_Rows.resize(m_Rows.size() + m_CachedNumberOfLocalParameters, 0.0);
+        m_TouchedBins.push_back(bin);
+      }
+      return m_Rows.data() + rowOffset;
+    }
+
+    /** Row of derivative values of a joint PDF bin, or nullptr when the
+     * thread did not touch the bin. */
+    const PDFValueType *
+    GetRow(OffsetValueType bin) const
+    {
+      const OffsetValueType rowOffset = m_RowOffsetByBin[bin];
+      return rowOffset < 0 ? nullptr : m_Rows.data() + rowOffset;
+    }
+
+  private:
+    std::vector<OffsetValueType> m_RowOffsetByBin;
+    std::vector<OffsetValueType> m_TouchedBins;
+    std::vector<PDFValueType>    m_Rows;
+    size_t                       m_CachedNumberOfLocalParameters{ 0 };
+  };
+
   std::vector<DerivativeBufferManager>      m_ThreaderDerivativeManager;
+  std::vector<SparseDerivativeAccumulator>  m_ThreaderSparseDerivativeAccumulator;
   std::mutex                                m_JointPDFDerivativesLock;
   typename JointPDFDerivativesType::Pointer m_JointPDFDerivatives;
 
   PDFValueType m_JointPDFSum;
 
+  bool m_UseLockFreeDerivativeAccumulation{ false };
+
   /** Store the per-point local derivative result by parzen window bin.
    * For local-support transforms only. */
   mutable std::vector<DerivativeType> m_LocalDerivativeByParzenBin;
@@ -288,7 +288,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TInternalComputationValueType,
                                             TMetricTraits>::FinalizeThread(const ThreadIdType threadId)
 {
-  if (this->GetComputeDerivative() && (!this->HasLocalSupport()))
+  if (this->GetComputeDerivative() && (!this->HasLocalSupport()) && !this->m_UseLockFreeDerivativeAccumulation)
   {
     this->m_ThreaderDerivativeManager[threadId].BlockAndReduce();
   }
@@ -483,6 +483,30 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
 }
 
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+typename LightObject::Pointer
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::InternalClone() const
+{
+  LightObject::Pointer loPtr = Superclass::InternalClone();
+  typename Self::Pointer rval = dynamic_cast<Self *>(loPtr.GetPointer());
+  if (rval.IsNull())
+  {
+    itkExceptionMacro(<< "downcast to type " << this->GetNameOfClass() << " failed.");
+  }
+  rval->m_NumberOfHistogramBins = this->m_NumberOfHistogramBins;
+  rval->m_UseLockFreeDerivativeAccumulation = this->m_UseLockFreeDerivativeAccumulation;
+
+  return loPtr;
+}
+
 template <typename TFixedImage,
           typename TMovingImage,
           typename TVirtualImage,
@@ -496,6 +520,7 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
                                             TMetricTraits>::PrintSelf(std::ostream & os, Indent indent) const
 {
   Superclass::PrintSelf(os, indent);
+  os << indent << "UseLockFreeDerivativeAccumulation: " << this->m_UseLockFreeDerivativeAccumulation << std::endl;
 }
 
 template <typename TFixedImage,
@@ -696,6 +721,36 @@ MattesMutualInformationImageToImageMetricv4<TFixedImage,
   m_CurrentFillSize = 0; // Reset fill size back to zero.
 }
 
+template <typename TFixedImage,
+          typename TMovingImage,
+          typename TVirtualImage,
+          typename TInternalComputationValueType,
+          typename TMetricTraits>
+void
+MattesMutualInformationImageToImageMetricv4<TFixedImage,
+                                            TMovingImage,
+                                            TVirtualImage,
+                                            TInternalComputationValueType,
+                                            TMetricTraits>::SparseDerivativeAccumulator ::
+  Initialize(SizeValueType numberOfBins, const size_t cachedNumberOfLocalParameters)
+{
+  if (m_RowOffsetByBin.size() != numberOfBins || m_CachedNumberOfLocalParameters != cachedNumberOfLocalParameters)
+  {
+    m_RowOffsetByBin.assign(numberOfBins, -1);
+  }
+  else
+  {
+    // Only the bins touched during the previous pass need to be reset
+    for (const OffsetValueType bin : m_TouchedBins)
+    {
+      m_RowOffsetByBin[bin] = -1;
+    }
+  }
+  m_TouchedBins.clear();
+  m_Rows.clear();
+  m_CachedNumberOfLocalParameters = cachedNumberOfLocalParameters;
+}
+
 } // end namespace itk
 
 #endif
@@ -211,6 +211,19 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
       // Initialize to zero for accumulation
       this->m_MattesAssociate->m_JointPDFDerivatives->FillBuffer(0.0F);
     }
+    if (this->m_MattesAssociate->m_UseLockFreeDerivativeAccumulation)
+    {
+      this->m_MattesAssociate->m_ThreaderDerivativeManager.clear();
+      this->m_MattesAssociate->m_ThreaderSparseDerivativeAccumulator.resize(localNumberOfWorkUnitsUsed);
+      for (ThreadIdType threadId = 0; threadId < localNumberOfWorkUnitsUsed; ++threadId)
+      {
+        this->m_MattesAssociate->m_ThreaderSparseDerivativeAccumulator[threadId].Initialize(
+          this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins,
+          this->GetCachedNumberOfLocalParameters());
+      }
+      return;
+    }
+    this->m_MattesAssociate->m_ThreaderSparseDerivativeAccumulator.clear();
     if ((this->m_MattesAssociate->m_ThreaderDerivativeManager.size() != localNumberOfWorkUnitsUsed))
     {
       this->m_MattesAssociate->m_ThreaderDerivativeManager.resize(localNumberOfWorkUnitsUsed);
@@ -373,6 +386,26 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
         this->ComputePDFDerivativesLocalSupportTransform(
           jacobian, movingImageGradient, cubicBSplineDerivativeValue, localSupportDerivativeResultPtr);
       }
+      else if (this->m_MattesAssociate->m_UseLockFreeDerivativeAccumulation)
+      {
+        // Accumulate into this thread's row for the current joint PDF bin
+        const OffsetValueType bin =
+          fixedImageParzenWindowIndex * this->m_MattesAssociate->m_NumberOfHistogramBins + pdfMovingIndex;
+        PDFValueType * derivativeContributionPtr =
+          this->m_MattesAssociate->m_ThreaderSparseDerivativeAccumulator[threadId].GetRowForAccumulation(bin);
+        for (NumberOfParametersType mu = 0, maxElement = this->GetCachedNumberOfLocalParameters(); mu < maxElement;
+             ++mu)
+        {
+          PDFValueType innerProduct = 0.0;
+          for (SizeValueType dim = 0, lastDim = this->m_MattesAssociate->MovingImageDimension; dim < lastDim; ++dim)
+          {
+            innerProduct += jacobian[dim][mu] * movingImageGradient[dim];
+          }
+
+          *(derivativeContributionPtr) += innerProduct * cubicBSplineDerivativeValue;
+          ++derivativeContributionPtr;
+        }
+      }
       else
       {
         // Update bins in the PDF derivatives for the current intensity pair
@@ -472,12 +505,51 @@ MattesMutualInformationImageToImageMetricv4GetValueAndDerivativeThreader<
 
     JointPDFDerivativesValueType * const accumulatorPdfDPtrStart =
       this->m_MattesAssociate->m_JointPDFDerivatives->GetBufferPointer();
-    JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
-    JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd =
-      accumulatorPdfDPtrStart + histogramTotalElementsSize;
-    while (accumulatorPdfDPtr < tempThreadPdfDPtrEnd)
+    if (this->m_MattesAssociate->m_UseLockFreeDerivativeAccumulation)
     {
-      *(accumulatorPdfDPtr++) *= nFactor;
+      // Sum the per-thread rows bin by bin. Bins are distributed over the
+      // work units, so each bin of the joint PDF derivatives has one writer,
+      // and the threads are always added in the same order.
+      const auto & accumulators = this->m_MattesAssociate->m_ThreaderSparseDerivativeAccumulator;
+      const NumberOfParametersType numberOfLocalParameters = this->GetCachedNumberOfLocalParameters();
+      this->GetMultiThreader()->ParallelizeArray(
+        0,
+        this->m_MattesAssociate->m_NumberOfHistogramBins * this->m_MattesAssociate->m_NumberOfHistogramBins,
+        [&](SizeValueType bin) {
+          JointPDFDerivativesValueType * const accumulatorRow =
+            accumulatorPdfDPtrStart + bin * numberOfLocalParameters;
+          bool touched = false;
+          for (const auto & accumulator : accumulators)
+          {
+            const PDFValueType * threadRow = accumulator.GetRow(bin);
+            if (threadRow != nullptr)
+            {
+              for (NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu)
+              {
+                accumulatorRow[mu] += threadRow[mu];
+              }
+              touched = true;
+            }
+          }
+          if (touched)
+          {
+            for (NumberOfParametersType mu = 0; mu < numberOfLocalParameters; ++mu)
+            {
+              accumulatorRow[mu] *= nFactor;
+            }
+          }
+        },
+        nullptr);
+    }
+    else
+    {
+      JointPDFDerivativesValueType *             accumulatorPdfDPtr = accumulatorPdfDPtrStart;
+      JointPDFDerivativesValueType const * const tempThreadPdfDPtrEnd =
+        accumulatorPdfDPtrStart + histogramTotalElementsSize;
+      while (accumulatorPdfDPtr < tempThreadPdfDPtrEnd)
+      {
+        *(accumulatorPdfDPtr++) *= nFactor;
+      }
     }
   }
 
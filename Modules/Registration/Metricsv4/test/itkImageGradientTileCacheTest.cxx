@@ -0,0 +1,311 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageGradientTileCache.h"
+#include "itkCentralDifferenceImageFunction.h"
+#include "itkGradientImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+/* Verifies that ImageGradientTileCache interpolates the voxel gradients of its
+ * calculator, within its memory budget, and that a metric using it gives the
+ * results of a precomputed gradient image. */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using CalculatorType = itk::CentralDifferenceImageFunction<ImageType, double>;
+
+ImageType::Pointer
+MakeImage(const double centerX, const double centerY)
+{
+  ImageType::SizeType size;
+  size[0] = 50;
+  size[1] = 37;
+  ImageType::IndexType start;
+  start[0] = 3;
+  start[1] = -2;
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(start, size));
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.8;
+  spacing[1] = 1.3;
+  image->SetSpacing(spacing);
+  ImageType::DirectionType direction;
+  direction[0][0] = std::cos(0.3);
+  direction[0][1] = -std::sin(0.3);
+  direction[1][0] = std::sin(0.3);
+  direction[1][1] = std::cos(0.3);
+  image->SetDirection(direction);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(std::exp(-(dx * dx + 2.0 * dy * dy) / 60.0));
+  }
+  return image;
+}
+
+template <typename TStorageValue>
+bool
+CheckTileCache(const ImageType * image, const double tolerance)
+{
+  auto calculator = CalculatorType::New();
+  calculator->UseImageDirectionOn();
+  calculator->SetInputImage(image);
+
+  using TileCacheType = itk::ImageGradientTileCache<CalculatorType, TStorageValue>;
+  auto tileCache = TileCacheType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(tileCache, ImageGradientTileCache, Object);
+  ITK_TRY_EXPECT_EXCEPTION(tileCache->Initialize());
+
+  tileCache->SetGradientCalculator(calculator);
+  ITK_TEST_SET_GET_VALUE(16, tileCache->GetTileSize());
+  tileCache->SetTileSize(8);
+  ITK_TEST_SET_GET_VALUE(8, tileCache->GetTileSize());
+  tileCache->SetMaximumSizeInBytes(3 * tileCache->GetTileSizeInBytes() + 1);
+  tileCache->Initialize();
+  ITK_TEST_EXPECT_EQUAL(7 * 5, tileCache->GetNumberOfTiles());
+  ITK_TEST_EXPECT_EQUAL(0, tileCache->GetNumberOfCachedTiles());
+
+  const ImageType::RegionType & region = image->GetBufferedRegion();
+  const ImageType::IndexType &  start = region.GetIndex();
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+
+  std::vector<ImageType::PointType>                    points;
+  std::vector<CalculatorType::OutputType>              expectedGradients;
+  std::vector<itk::ContinuousIndex<double, Dimension>> continuousIndices;
+  for (unsigned int n = 0; n < 500; n++)
+  {
+    itk::ContinuousIndex<double, Dimension> continuousIndex;
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      continuousIndex[d] = start[d] + generator->GetUniformVariate(0.0, region.GetSize(d) - 1.0);
+    }
+    ImageType::PointType point;
+    image->TransformContinuousIndexToPhysicalPoint(continuousIndex, point);
+
+    // Linearly interpolate the voxel gradients of the calculator.
+    CalculatorType::OutputType expected;
+    expected.Fill(0.0);
+    for (unsigned int corner = 0; corner < (1u << Dimension); corner++)
+    {
+      ImageType::IndexType index;
+      double               weight = 1.0;
+      for (unsigned int d = 0; d < Dimension; d++)
+      {
+        const auto   base = static_cast<itk::IndexValueType>(std::floor(continuousIndex[d]));
+        const double distance = continuousIndex[d] - base;
+        index[d] = std::min<itk::IndexValueType>(base + ((corner >> d) & 1u), start[d] + region.GetSize(d) - 1);
+        weight *= ((corner >> d) & 1u) ? distance : 1.0 - distance;
+      }
+      expected += calculator->EvaluateAtIndex(index) * weight;
+    }
+    points.push_back(point);
+    expectedGradients.push_back(expected);
+    continuousIndices.push_back(continuousIndex);
+  }
+
+  const auto isClose = [tolerance](const CalculatorType::OutputType & gradient,
+                                   const CalculatorType::OutputType & expected) {
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      if (std::abs(gradient[d] - expected[d]) > tolerance * (1.0 + std::abs(expected[d])))
+      {
+        return false;
+      }
+    }
+    return true;
+  };
+
+  for (size_t n = 0; n < points.size(); n++)
+  {
+    CalculatorType::OutputType gradient;
+    tileCache->Evaluate(points[n], gradient);
+    if (!isClose(gradient, expectedGradients[n]))
+    {
+      std::cerr << "Gradient at " << continuousIndices[n] << " is " << gradient << " instead of "
+                << expectedGradients[n] << std::endl;
+      return false;
+    }
+  }
+
+  // The cache stayed within its budget, and evicted tiles were recomputed.
+  if (tileCache->GetNumberOfCachedTiles() != 3 || tileCache->GetNumberOfComputedTiles() <= 7 * 5)
+  {
+    std::cerr << "The cache holds " << tileCache->GetNumberOfCachedTiles() << " tiles after "
+              << tileCache->GetNumberOfComputedTiles() << " computations." << std::endl;
+    return false;
+  }
+
+  // Threads evaluating the gradients concurrently evict the tiles the
+  // others use.
+  tileCache->Initialize();
+  constexpr unsigned int numberOfThreads = 4;
+  std::atomic<bool>        concurrentPassed(true);
+  std::vector<std::thread> threads;
+  for (unsigned int t = 0; t < numberOfThreads; t++)
+  {
+    threads.emplace_back([&, t]() {
+      for (unsigned int pass = 0; pass < 10; pass++)
+      {
+        for (size_t k = 0; k < points.size(); k++)
+        {
+          const size_t               n = (k + t * points.size() / numberOfThreads) % points.size();
+          CalculatorType::OutputType gradient;
+          tileCache->Evaluate(points[n], gradient);
+          if (!isClose(gradient, expectedGradients[n]))
+          {
+            concurrentPassed = false;
+          }
+        }
+      }
+    });
+  }
+  for (auto & thread : threads)
+  {
+    thread.join();
+  }
+  if (!concurrentPassed || tileCache->GetNumberOfCachedTiles() != 3 ||
+      tileCache->GetNumberOfComputedTiles() <= numberOfThreads * 7 * 5)
+  {
+    std::cerr << "Concurrent evaluations failed, with " << tileCache->GetNumberOfCachedTiles() << " tiles cached after "
+              << tileCache->GetNumberOfComputedTiles() << " computations." << std::endl;
+    return false;
+  }
+
+  tileCache->Initialize();
+  ITK_TEST_EXPECT_EQUAL(0, tileCache->GetNumberOfCachedTiles());
+  ITK_TEST_EXPECT_EQUAL(0, tileCache->GetNumberOfComputedTiles());
+  return true;
+}
+} // namespace
+
+int
+itkImageGradientTileCacheTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeImage(27.0, 16.0);
+  const ImageType::Pointer movingImage = MakeImage(29.0, 15.0);
+
+  bool passed = CheckTileCache<double>(movingImage, 1e-12);
+  passed &= CheckTileCache<float>(movingImage, 1e-6);
+
+  // A metric using the tile cache gives the results of a metric using the
+  // precomputed central difference gradient image.
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using TransformType = itk::TranslationTransform<double, Dimension>;
+  using GradientFilterType = itk::GradientImageFilter<ImageType, double, double>;
+
+  auto transform = TransformType::New();
+  auto reference = MetricType::New();
+  auto cached = MetricType::New();
+  auto evicting = MetricType::New();
+  for (MetricType * metric : { reference.GetPointer(), cached.GetPointer(), evicting.GetPointer() })
+  {
+    metric->SetFixedImage(fixedImage);
+    metric->SetMovingImage(movingImage);
+    metric->SetMovingTransform(transform);
+  }
+  auto gradientFilter = GradientFilterType::New();
+  gradientFilter->UseImageDirectionOn();
+  reference->SetMovingImageGradientFilter(gradientFilter);
+
+  ITK_TEST_SET_GET_BOOLEAN(cached, UseMovingImageGradientTileCache, false);
+  ITK_TEST_SET_GET_BOOLEAN(cached, UseFixedImageGradientTileCache, false);
+  cached->UseMovingImageGradientFilterOff();
+  cached->UseMovingImageGradientTileCacheOn();
+  cached->GetModifiableMovingImageGradientTileCache()->SetTileSize(8);
+
+  // Several work units share a cache of two tiles, and evict each other's.
+  evicting->UseMovingImageGradientFilterOff();
+  evicting->UseMovingImageGradientTileCacheOn();
+  evicting->SetNumberOfWorkUnits(4);
+  MetricType::MovingImageGradientTileCacheType * evictingCache = evicting->GetModifiableMovingImageGradientTileCache();
+  evictingCache->SetTileSize(4);
+  evictingCache->SetMaximumSizeInBytes(2 * evictingCache->GetTileSizeInBytes());
+
+  reference->Initialize();
+  cached->Initialize();
+  evicting->Initialize();
+
+  for (unsigned int iteration = 0; iteration < 3; iteration++)
+  {
+    TransformType::ParametersType parameters(Dimension);
+    parameters[0] = 0.7 * iteration;
+    parameters[1] = -0.4 * iteration;
+    transform->SetParameters(parameters);
+
+    MetricType::MeasureType    referenceValue;
+    MetricType::DerivativeType referenceDerivative;
+    reference->GetValueAndDerivative(referenceValue, referenceDerivative);
+
+    for (MetricType * metric : { cached.GetPointer(), evicting.GetPointer() })
+    {
+      MetricType::MeasureType    cachedValue;
+      MetricType::DerivativeType cachedDerivative;
+      metric->GetValueAndDerivative(cachedValue, cachedDerivative);
+      std::cout << "Value " << cachedValue << ", derivative " << cachedDerivative << std::endl;
+
+      // The work units of the evicting metric sum the value in another order.
+      const double valueTolerance = (metric == evicting.GetPointer()) ? 1e-12 * std::abs(referenceValue) : 0.0;
+      if (std::abs(cachedValue - referenceValue) > valueTolerance)
+      {
+        std::cerr << "Values differ at iteration " << iteration << ": " << cachedValue << " != " << referenceValue
+                  << std::endl;
+        passed = false;
+      }
+      for (unsigned int d = 0; d < Dimension; d++)
+      {
+        // The gradients differ on the image border only, where the blobs vanish.
+        if (std::abs(cachedDerivative[d] - referenceDerivative[d]) > 1e-6 * (1.0 + std::abs(referenceDerivative[d])))
+        {
+          std::cerr << "Derivatives differ at iteration " << iteration << ": " << cachedDerivative
+                    << " != " << referenceDerivative << std::endl;
+          passed = false;
+        }
+      }
+    }
+  }
+  if (cached->GetMovingImageGradientTileCache()->GetNumberOfComputedTiles() == 0)
+  {
+    std::cerr << "The metric did not use the tile cache." << std::endl;
+    passed = false;
+  }
+  if (evictingCache->GetNumberOfCachedTiles() != 2 ||
+      evictingCache->GetNumberOfComputedTiles() <= evictingCache->GetNumberOfTiles())
+  {
+    std::cerr << "The metric sharing two tiles cached " << evictingCache->GetNumberOfCachedTiles() << " tiles after "
+              << evictingCache->GetNumberOfComputedTiles() << " computations." << std::endl;
+    passed = false;
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
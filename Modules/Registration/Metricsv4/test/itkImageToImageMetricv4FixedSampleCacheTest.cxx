@@ -0,0 +1,216 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkDemonsImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkCompositeTransform.h"
+#include "itkTranslationTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Verifies that metrics evaluated with the fixed sample cache give the same
+ * results as without it, while the moving and fixed transforms change between
+ * evaluations. */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+using TranslationTransformType = itk::TranslationTransform<double, Dimension>;
+
+ImageType::Pointer
+MakeImage(const double centerX, const double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(32);
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(std::exp(-(dx * dx + 2.0 * dy * dy) / 50.0));
+  }
+  return image;
+}
+
+void
+Translate(TranslationTransformType * transform, const double offset)
+{
+  TranslationTransformType::ParametersType parameters(Dimension);
+  parameters.Fill(offset);
+  transform->SetParameters(parameters);
+}
+
+template <typename TMetric, typename TConfigure, typename TUpdate>
+bool
+CheckFixedSampleCache(const char * name, TConfigure configure, TUpdate update)
+{
+  std::cout << name << std::endl;
+
+  auto reference = TMetric::New();
+  configure(reference.GetPointer());
+  reference->Initialize();
+
+  auto cached = TMetric::New();
+  configure(cached.GetPointer());
+  ITK_TEST_SET_GET_BOOLEAN(cached, UseFixedSampleCache, true);
+  cached->Initialize();
+
+  for (unsigned int iteration = 0; iteration < 4; ++iteration)
+  {
+    update(iteration);
+
+    if (iteration == 0)
+    {
+      // Fill the cache without gradients first
+      ITK_TEST_EXPECT_EQUAL(cached->GetValue(), reference->GetValue());
+    }
+
+    typename TMetric::MeasureType    referenceValue;
+    typename TMetric::MeasureType    cachedValue;
+    typename TMetric::DerivativeType referenceDerivative;
+    typename TMetric::DerivativeType cachedDerivative;
+    reference->GetValueAndDerivative(referenceValue, referenceDerivative);
+    cached->GetValueAndDerivative(cachedValue, cachedDerivative);
+
+    if (cached->GetNumberOfValidPoints() != reference->GetNumberOfValidPoints() ||
+        itk::Math::NotExactlyEquals(cachedValue, referenceValue) || cachedDerivative != referenceDerivative)
+    {
+      std::cerr << "Results differ at iteration " << iteration << ": value " << cachedValue << " != " << referenceValue
+                << ", valid points " << cached->GetNumberOfValidPoints()
+                << " != " << reference->GetNumberOfValidPoints() << std::endl;
+      return false;
+    }
+  }
+  return true;
+}
+} // namespace
+
+int
+itkImageToImageMetricv4FixedSampleCacheTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeImage(15.0, 16.0);
+  const ImageType::Pointer movingImage = MakeImage(17.0, 15.0);
+
+  // Mean squares with an affine moving transform. The fixed transform is
+  // composed of a translation that is modified in place, which does not
+  // modify the composite transform itself.
+  using MeanSquaresMetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  using AffineTransformType = itk::AffineTransform<double, Dimension>;
+  using CompositeTransformType = itk::CompositeTransform<double, Dimension>;
+
+  auto affineTransform = AffineTransformType::New();
+  auto fixedTranslation = TranslationTransformType::New();
+  auto fixedComposite = CompositeTransformType::New();
+  fixedComposite->AddTransform(fixedTranslation);
+
+  const auto updateAffine = [&](const unsigned int iteration) {
+    AffineTransformType::ParametersType parameters = affineTransform->GetParameters();
+    parameters[0] = 1.0 + 0.01 * iteration;
+    parameters[4] = 0.5 * iteration;
+    affineTransform->SetParameters(parameters);
+    if (iteration == 2)
+    {
+      Translate(fixedTranslation, 1.25);
+    }
+  };
+
+  bool passed = CheckFixedSampleCache<MeanSquaresMetricType>(
+    "Dense sampling",
+    [&](MeanSquaresMetricType * metric) {
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetFixedTransform(fixedComposite);
+      metric->SetMovingTransform(affineTransform);
+    },
+    updateAffine);
+
+  Translate(fixedTranslation, 0.0);
+  affineTransform->SetIdentity();
+
+  // Sparse sampling, with samples mapped outside of the fixed image
+  using PointSetType = MeanSquaresMetricType::FixedSampledPointSetType;
+  auto                                         pointSet = PointSetType::New();
+  itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion());
+  for (unsigned int count = 0; !it.IsAtEnd(); ++it, ++count)
+  {
+    if (count % 3 == 0)
+    {
+      PointSetType::PointType point;
+      fixedImage->TransformIndexToPhysicalPoint(it.GetIndex(), point);
+      pointSet->SetPoint(pointSet->GetNumberOfPoints(), point);
+    }
+  }
+
+  passed &= CheckFixedSampleCache<MeanSquaresMetricType>(
+    "Sparse sampling",
+    [&](MeanSquaresMetricType * metric) {
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetFixedTransform(fixedComposite);
+      metric->SetMovingTransform(affineTransform);
+      metric->SetFixedSampledPointSet(pointSet);
+      metric->UseSampledPointSetOn();
+    },
+    updateAffine);
+
+  // Demons, which uses the fixed image gradient, with a displacement field
+  // moving transform
+  using DemonsMetricType = itk::DemonsImageToImageMetricv4<ImageType, ImageType>;
+  using DisplacementTransformType = itk::DisplacementFieldTransform<double, Dimension>;
+  using DisplacementFieldType = DisplacementTransformType::DisplacementFieldType;
+
+  auto field = DisplacementFieldType::New();
+  field->CopyInformation(fixedImage);
+  field->SetRegions(fixedImage->GetBufferedRegion());
+  field->Allocate(true);
+  auto displacementTransform = DisplacementTransformType::New();
+  displacementTransform->SetDisplacementField(field);
+  auto fixedTransform = TranslationTransformType::New();
+
+  passed &= CheckFixedSampleCache<DemonsMetricType>(
+    "Fixed image gradients",
+    [&](DemonsMetricType * metric) {
+      metric->SetFixedImage(fixedImage);
+      metric->SetMovingImage(movingImage);
+      metric->SetFixedTransform(fixedTransform);
+      metric->SetMovingTransform(displacementTransform);
+    },
+    [&](const unsigned int iteration) {
+      DisplacementFieldType::PixelType displacement;
+      displacement.Fill(0.3 * iteration);
+      field->FillBuffer(displacement);
+      if (iteration == 2)
+      {
+        Translate(fixedTransform, -0.75);
+      }
+    });
+
+  if (!passed)
+  {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
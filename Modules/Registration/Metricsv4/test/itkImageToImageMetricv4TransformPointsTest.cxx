@@ -0,0 +1,260 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+#include <vector>
+
+/* Verifies that the metric threaders map the moving points in batches, one
+ * image line at a time for dense sampling and in blocks for sparse sampling,
+ * and that the results match a direct computation of the metric. */
+
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using ImageType = itk::Image<double, Dimension>;
+
+// Counts the points mapped one at a time and in batches. Meant for a single
+// work unit, as the counts are not synchronized.
+class CountingAffineTransform : public itk::AffineTransform<double, Dimension>
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(CountingAffineTransform);
+
+  using Self = CountingAffineTransform;
+  using Superclass = itk::AffineTransform<double, Dimension>;
+  using Pointer = itk::SmartPointer<Self>;
+  using ConstPointer = itk::SmartPointer<const Self>;
+
+  itkNewMacro(Self);
+  itkTypeMacro(CountingAffineTransform, AffineTransform);
+
+  OutputPointType
+  TransformPoint(const InputPointType & point) const override
+  {
+    ++m_NumberOfSinglePoints;
+    return Superclass::TransformPoint(point);
+  }
+
+  void
+  TransformPoints(const InputPointType * inputPoints,
+                  OutputPointType *      outputPoints,
+                  itk::SizeValueType     numberOfPoints) const override
+  {
+    ++m_NumberOfBatches;
+    m_NumberOfBatchedPoints += numberOfPoints;
+    m_LargestBatch = std::max(m_LargestBatch, numberOfPoints);
+    Superclass::TransformPoints(inputPoints, outputPoints, numberOfPoints);
+  }
+
+  void
+  ResetCounts()
+  {
+    m_NumberOfSinglePoints = 0;
+    m_NumberOfBatches = 0;
+    m_NumberOfBatchedPoints = 0;
+    m_LargestBatch = 0;
+  }
+
+  mutable itk::SizeValueType m_NumberOfSinglePoints{ 0 };
+  mutable itk::SizeValueType m_NumberOfBatches{ 0 };
+  mutable itk::SizeValueType m_NumberOfBatchedPoints{ 0 };
+  mutable itk::SizeValueType m_LargestBatch{ 0 };
+
+protected:
+  CountingAffineTransform() = default;
+  ~CountingAffineTransform() override = default;
+
+  // TransformPoint only counts, so the batched matrix path maps the same points
+  bool
+  TransformPointUsesMatrixAndOffset() const override
+  {
+    return true;
+  }
+};
+
+ImageType::Pointer
+MakeImage(const double centerX, const double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(32);
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(std::exp(-(dx * dx + 2.0 * dy * dy) / 50.0));
+  }
+  return image;
+}
+
+// Mean squares over the given fixed indices, with the moving image shifted
+// by a whole number of pixels, so that no interpolation is involved
+double
+ComputeMeanSquares(const ImageType *                         fixedImage,
+                   const ImageType *                         movingImage,
+                   const std::vector<ImageType::IndexType> & fixedIndices,
+                   const ImageType::OffsetType &             shift,
+                   itk::SizeValueType &                      numberOfValidPoints)
+{
+  double sum = 0.0;
+  numberOfValidPoints = 0;
+  for (const auto & index : fixedIndices)
+  {
+    const ImageType::IndexType movingIndex = index + shift;
+    if (movingImage->GetBufferedRegion().IsInside(movingIndex))
+    {
+      const double difference = fixedImage->GetPixel(index) - movingImage->GetPixel(movingIndex);
+      sum += difference * difference;
+      ++numberOfValidPoints;
+    }
+  }
+  return sum / numberOfValidPoints;
+}
+
+template <typename TMetric>
+bool
+CheckBatches(const char *              name,
+             TMetric *                 metric,
+             CountingAffineTransform * transform,
+             const double              expectedValue,
+             const itk::SizeValueType  expectedNumberOfValidPoints,
+             const itk::SizeValueType  expectedNumberOfPoints,
+             const itk::SizeValueType  expectedLargestBatch)
+{
+  std::cout << name << std::endl;
+  bool passed = true;
+
+  transform->ResetCounts();
+  const typename TMetric::MeasureType value = metric->GetValue();
+  if (std::abs(value - expectedValue) > 1e-12 * std::abs(expectedValue) ||
+      metric->GetNumberOfValidPoints() != expectedNumberOfValidPoints)
+  {
+    std::cerr << "Test failed: value " << value << " with " << metric->GetNumberOfValidPoints()
+              << " valid points instead of " << expectedValue << " with " << expectedNumberOfValidPoints << std::endl;
+    passed = false;
+  }
+  if (transform->m_NumberOfSinglePoints != 0 || transform->m_NumberOfBatchedPoints != expectedNumberOfPoints ||
+      transform->m_LargestBatch != expectedLargestBatch)
+  {
+    std::cerr << "Test failed: " << transform->m_NumberOfSinglePoints << " points mapped one at a time and "
+              << transform->m_NumberOfBatchedPoints << " in " << transform->m_NumberOfBatches
+              << " batches of at most " << transform->m_LargestBatch << ", instead of " << expectedNumberOfPoints
+              << " in batches of at most " << expectedLargestBatch << std::endl;
+    passed = false;
+  }
+
+  // The derivative pass goes through the same threaders
+  typename TMetric::MeasureType    valueWithDerivative;
+  typename TMetric::DerivativeType derivative;
+  metric->GetValueAndDerivative(valueWithDerivative, derivative);
+  if (itk::Math::NotExactlyEquals(valueWithDerivative, value) || transform->m_NumberOfSinglePoints != 0)
+  {
+    std::cerr << "Test failed: GetValueAndDerivative gives " << valueWithDerivative << " instead of " << value
+              << ", with " << transform->m_NumberOfSinglePoints << " points mapped one at a time" << std::endl;
+    passed = false;
+  }
+  return passed;
+}
+} // namespace
+
+int
+itkImageToImageMetricv4TransformPointsTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeImage(15.0, 16.0);
+  const ImageType::Pointer movingImage = MakeImage(17.0, 15.0);
+
+  // Shift the moving image by whole pixels, so that part of the virtual
+  // domain maps outside of it
+  ImageType::OffsetType shift;
+  shift[0] = 3;
+  shift[1] = -2;
+  auto                                      transform = CountingAffineTransform::New();
+  CountingAffineTransform::OutputVectorType translation;
+  translation[0] = shift[0];
+  translation[1] = shift[1];
+  transform->SetTranslation(translation);
+
+  using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+  auto metric = MetricType::New();
+  metric->SetFixedImage(fixedImage);
+  metric->SetMovingImage(movingImage);
+  metric->SetMovingTransform(transform);
+  metric->SetNumberOfWorkUnits(1);
+  metric->Initialize();
+
+  std::vector<ImageType::IndexType>            allIndices;
+  std::vector<ImageType::IndexType>            sampledIndices;
+  itk::ImageRegionIteratorWithIndex<ImageType> it(fixedImage, fixedImage->GetBufferedRegion());
+  for (unsigned int count = 0; !it.IsAtEnd(); ++it, ++count)
+  {
+    allIndices.push_back(it.GetIndex());
+    if (count % 3 == 0)
+    {
+      sampledIndices.push_back(it.GetIndex());
+    }
+  }
+
+  // Dense sampling, one batch per line of 32 pixels
+  itk::SizeValueType numberOfValidPoints;
+  double expectedValue = ComputeMeanSquares(fixedImage, movingImage, allIndices, shift, numberOfValidPoints);
+  bool   passed = CheckBatches("Dense sampling",
+                             metric.GetPointer(),
+                             transform.GetPointer(),
+                             expectedValue,
+                             numberOfValidPoints,
+                             allIndices.size(),
+                             fixedImage->GetBufferedRegion().GetSize(0));
+
+  // Sparse sampling, in blocks of 256 points and a remainder
+  using PointSetType = MetricType::FixedSampledPointSetType;
+  auto pointSet = PointSetType::New();
+  for (const auto & index : sampledIndices)
+  {
+    PointSetType::PointType point;
+    fixedImage->TransformIndexToPhysicalPoint(index, point);
+    pointSet->SetPoint(pointSet->GetNumberOfPoints(), point);
+  }
+  metric->SetFixedSampledPointSet(pointSet);
+  metric->UseSampledPointSetOn();
+  metric->Initialize();
+
+  expectedValue = ComputeMeanSquares(fixedImage, movingImage, sampledIndices, shift, numberOfValidPoints);
+  passed &= CheckBatches("Sparse sampling",
+                         metric.GetPointer(),
+                         transform.GetPointer(),
+                         expectedValue,
+                         numberOfValidPoints,
+                         sampledIndices.size(),
+                         256);
+
+  if (!passed)
+  {
+    std::cerr << "Test failed." << std::endl;
+    return EXIT_FAILURE;
+  }
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
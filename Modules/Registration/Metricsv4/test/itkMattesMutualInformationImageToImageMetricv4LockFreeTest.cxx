@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMattesMutualInformationImageToImageMetricv4.h"
+#include "itkAffineTransform.h"
+#include "itkBSplineTransform.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkTestingMacros.h"
+
+/* Compares the value and derivative of the metric computed with the lock-free
+ * joint PDF derivative accumulation against the default buffered accumulation,
+ * for a dense and a BSpline transform and several work units. */
+
+namespace
+{
+using ImageType = itk::Image<double, 2>;
+using MetricType = itk::MattesMutualInformationImageToImageMetricv4<ImageType, ImageType>;
+
+ImageType::Pointer
+MakeBlobImage(const double centerX, const double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(64);
+  auto image = ImageType::New();
+  image->SetRegions(ImageType::RegionType(size));
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetBufferedRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + 2.0 * dy * dy) / 200.0) + 0.1 * ((it.GetIndex()[0] * 7) % 5));
+  }
+  return image;
+}
+
+bool
+CompareAccumulationModes(MetricType::MovingTransformType * transform)
+{
+  auto metric = MetricType::New();
+  metric->SetFixedImage(MakeBlobImage(30.0, 32.0));
+  metric->SetMovingImage(MakeBlobImage(34.0, 30.0));
+  metric->SetMovingTransform(transform);
+  metric->SetNumberOfHistogramBins(20);
+  metric->SetMaximumNumberOfWorkUnits(4);
+
+  MetricType::MeasureType    referenceValue;
+  MetricType::DerivativeType referenceDerivative;
+  metric->SetUseLockFreeDerivativeAccumulation(false);
+  metric->Initialize();
+  metric->GetValueAndDerivative(referenceValue, referenceDerivative);
+  std::cout << "Work units used: " << metric->GetNumberOfWorkUnitsUsed() << std::endl;
+
+  metric->UseLockFreeDerivativeAccumulationOn();
+  metric->Initialize();
+
+  // Evaluate twice to check that the per-thread buffers are reset
+  for (unsigned int pass = 0; pass < 2; ++pass)
+  {
+    MetricType::MeasureType    value;
+    MetricType::DerivativeType derivative;
+    metric->GetValueAndDerivative(value, derivative);
+
+    if (itk::Math::abs(value - referenceValue) > 1e-12 * itk::Math::abs(referenceValue))
+    {
+      std::cerr << "Value mismatch: " << value << " != " << referenceValue << std::endl;
+      return false;
+    }
+    if (derivative.GetSize() != referenceDerivative.GetSize())
+    {
+      std::cerr << "Derivative size mismatch." << std::endl;
+      return false;
+    }
+    const double tolerance = 1e-10 * referenceDerivative.inf_norm();
+    for (unsigned int p = 0; p < derivative.GetSize(); ++p)
+    {
+      if (itk::Math::abs(derivative[p] - referenceDerivative[p]) > tolerance)
+      {
+        std::cerr << "Derivative mismatch at parameter " << p << ": " << derivative[p]
+                  << " != " << referenceDerivative[p] << std::endl;
+        return false;
+      }
+    }
+  }
+  if (referenceDerivative.inf_norm() <= 0.0)
+  {
+    std::cerr << "Expected a non-zero derivative." << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkMattesMutualInformationImageToImageMetricv4LockFreeTest(int, char *[])
+{
+  // Several work units are needed to exercise the reduction of the per-thread buffers
+  itk::MultiThreaderBase::SetGlobalDefaultNumberOfThreads(4);
+
+  auto metric = MetricType::New();
+  ITK_TEST_SET_GET_BOOLEAN(metric, UseLockFreeDerivativeAccumulation, false);
+
+  using AffineTransformType = itk::AffineTransform<double, 2>;
+  auto                                  affine = AffineTransformType::New();
+  AffineTransformType::OutputVectorType translation;
+  translation[0] = 1.5;
+  translation[1] = -0.5;
+  affine->SetTranslation(translation);
+  if (!CompareAccumulationModes(affine))
+  {
+    std::cerr << "Test failed with AffineTransform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  using BSplineTransformType = itk::BSplineTransform<double, 2, 3>;
+  auto                                         bspline = BSplineTransformType::New();
+  BSplineTransformType::PhysicalDimensionsType physicalDimensions;
+  BSplineTransformType::MeshSizeType           meshSize;
+  physicalDimensions.Fill(63.0);
+  meshSize.Fill(4);
+  bspline->SetTransformDomainPhysicalDimensions(physicalDimensions);
+  bspline->SetTransformDomainMeshSize(meshSize);
+  BSplineTransformType::ParametersType parameters(bspline->GetNumberOfParameters());
+  for (unsigned int p = 0; p < parameters.GetSize(); ++p)
+  {
+    parameters[p] = 0.25 * std::sin(0.7 * p);
+  }
+  bspline->SetParameters(parameters);
+  if (!CompareAccumulationModes(bspline))
+  {
+    std::cerr << "Test failed with BSplineTransform." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
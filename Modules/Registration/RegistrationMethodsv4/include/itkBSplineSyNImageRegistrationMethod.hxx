@@ -152,50 +152,86 @@ BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, T
       }
     }
 
-    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
+    // Add the update field to both displacement fields (from fixed/moving to middle image), smooth and invert.
+    // The fixed and moving sides are updated in turn, and the intermediate fields of a side are released
+    // before the other side is processed, to reduce the number of full resolution fields held at once.
 
     using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
 
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
-    fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
-    fixedComposer->Update();
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp =
-      this->BSplineSmoothDisplacementField(fixedComposer->GetOutput(),
-                                           this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
-                                           nullptr,
-                                           nullptr);
-
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
-    movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
-    movingComposer->Update();
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp =
-      this->BSplineSmoothDisplacementField(movingComposer->GetOutput(),
-                                           this->m_MovingToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
-                                           nullptr,
-                                           nullptr);
-
-    // Iteratively estimate the inverse fields.
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField =
-      this->InvertDisplacementField(fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp);
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
-    DisplacementFieldPointer movingToMiddleSmoothTotalField =
-      this->InvertDisplacementField(movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp);
-
-    // Assign the displacement fields and their inverses to the proper transforms.
-    this->m_FixedToMiddleTransform->SetDisplacementField(fixedToMiddleSmoothTotalField);
-    this->m_FixedToMiddleTransform->SetInverseDisplacementField(fixedToMiddleSmoothTotalFieldInverse);
+    {
+      typename ComposerType::Pointer fixedComposer = ComposerType::New();
+      fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
+      fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
+      fixedComposer->Update();
+
+      DisplacementFieldPointer fixedToMiddleTotalField = fixedComposer->GetOutput();
+      fixedToMiddleTotalField->DisconnectPipeline();
+      fixedComposer = nullptr;
+      fixedToMiddleSmoothUpdateField = nullptr;
+
+      DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField(
+        fixedToMiddleTotalField,
+        this->m_FixedToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
+        nullptr,
+        nullptr);
+      fixedToMiddleTotalField = nullptr;
+
+      // Iteratively estimate the inverse fields.
+      DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
+        fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
+      DisplacementFieldPointer fixedToMiddleSmoothTotalField =
+        this->InvertDisplacementField(fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp);
+
+      // Assign the displacement field and its inverse to the proper transform.
+      this->m_FixedToMiddleTransform->SetDisplacementField(fixedToMiddleSmoothTotalField);
+      this->m_FixedToMiddleTransform->SetInverseDisplacementField(fixedToMiddleSmoothTotalFieldInverse);
+
+      // The metric holds the composite transform, which references the previous fields. Rebuild it with the new
+      // ones, so that the metric evaluates the current transform and the previous fields are released.
+      fixedComposite->ClearTransformQueue();
+      if (fixedInitialTransform != nullptr)
+      {
+        fixedComposite->AddTransform(fixedInitialTransform);
+      }
+      fixedComposite->AddTransform(this->m_FixedToMiddleTransform->GetInverseTransform());
+      fixedComposite->FlattenTransformQueue();
+      fixedComposite->SetOnlyMostRecentTransformToOptimizeOn();
+    }
 
-    this->m_MovingToMiddleTransform->SetDisplacementField(movingToMiddleSmoothTotalField);
-    this->m_MovingToMiddleTransform->SetInverseDisplacementField(movingToMiddleSmoothTotalFieldInverse);
+    {
+      typename ComposerType::Pointer movingComposer = ComposerType::New();
+      movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
+      movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
+      movingComposer->Update();
+
+      DisplacementFieldPointer movingToMiddleTotalField = movingComposer->GetOutput();
+      movingToMiddleTotalField->DisconnectPipeline();
+      movingComposer = nullptr;
+      movingToMiddleSmoothUpdateField = nullptr;
+
+      DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->BSplineSmoothDisplacementField(
+        movingToMiddleTotalField,
+        this->m_MovingToMiddleTransform->GetNumberOfControlPointsForTheTotalField(),
+        nullptr,
+        nullptr);
+      movingToMiddleTotalField = nullptr;
+
+      // Iteratively estimate the inverse fields.
+      DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
+        movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
+      DisplacementFieldPointer movingToMiddleSmoothTotalField =
+        this->InvertDisplacementField(movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp);
+
+      // Assign the displacement field and its inverse to the proper transform.
+      this->m_MovingToMiddleTransform->SetDisplacementField(movingToMiddleSmoothTotalField);
+      this->m_MovingToMiddleTransform->SetInverseDisplacementField(movingToMiddleSmoothTotalFieldInverse);
+
+      movingComposite->ClearTransformQueue();
+      movingComposite->AddTransform(this->m_CompositeTransform);
+      movingComposite->AddTransform(this->m_MovingToMiddleTransform->GetInverseTransform());
+      movingComposite->FlattenTransformQueue();
+      movingComposite->SetOnlyMostRecentTransformToOptimizeOn();
+    }
 
     this->m_CurrentMetricValue = 0.5 * (movingMetricValue + fixedMetricValue);
 
@@ -372,18 +408,16 @@ typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTra
                                    const WeightedMaskImageType * mask,
                                    const BSplinePointSetType *   gradientPointSet)
 {
-  using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage(field);
-  duplicator->Update();
-
-  DisplacementFieldPointer smoothField = duplicator->GetOutput();
-
   for (unsigned int d = 0; d < numberOfControlPoints.Size(); d++)
   {
     if (numberOfControlPoints[d] <= 0)
     {
-      return smoothField;
+      using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
+      typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+      duplicator->SetInputImage(field);
+      duplicator->Update();
+
+      return duplicator->GetOutput();
     }
   }
 
@@ -410,7 +444,7 @@ typename BSplineSyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTra
   bspliner->SetEstimateInverse(false);
   bspliner->Update();
 
-  smoothField = bspliner->GetOutput();
+  DisplacementFieldPointer smoothField = bspliner->GetOutput();
 
   return smoothField;
 }
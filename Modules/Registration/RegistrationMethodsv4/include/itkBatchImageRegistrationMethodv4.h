@@ -0,0 +1,165 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_h
+#define itkBatchImageRegistrationMethodv4_h
+
+#include "itkMultiThreaderBase.h"
+#include "itkObject.h"
+#include "itkObjectFactory.h"
+#include "itkRealTimeClock.h"
+
+#include <string>
+#include <vector>
+
+namespace itk
+{
+
+/** \class BatchImageRegistrationMethodv4
+ * \brief Register many moving images to the same fixed images.
+ *
+ * Each moving image is registered by its own registration method, e.g. an
+ * ImageRegistrationMethodv4 or a SyNImageRegistrationMethod, which is set up
+ * as usual and added with AddRegistrationMethod().  All the registration
+ * methods must share the fixed images, the number of levels and the
+ * smoothing sigmas of the first one.
+ *
+ * Update() smooths the fixed images for each level once and hands the
+ * smoothed images to all the registration methods, then runs up to
+ * NumberOfConcurrentRegistrations registrations at a time.  Once a
+ * registration has run, the batch keeps its output transform and its wall
+ * clock time, and releases its registration method.  The number of
+ * concurrent registrations therefore bounds the memory in use, provided the
+ * caller does not keep references to the registration methods and the moving
+ * images are produced by upstream pipelines, e.g. an ImageFileReader, that
+ * only execute when their registration starts.
+ *
+ * Each concurrent registration runs on a thread of its own and multi-threads
+ * its metric, optimizer and filters as usual, so their work units share the
+ * threads of the default multi-threader, e.g. the ITK thread pool.  The
+ * registration methods must not share moving images, metrics, optimizers or
+ * transforms, and the fixed images must not release their data.
+ *
+ * \ingroup ITKRegistrationMethodsv4
+ */
+template <typename TRegistrationMethod>
+class ITK_TEMPLATE_EXPORT BatchImageRegistrationMethodv4 : public Object
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(BatchImageRegistrationMethodv4);
+
+  /** Standard class type aliases. */
+  using Self = BatchImageRegistrationMethodv4;
+  using Superclass = Object;
+  using Pointer = SmartPointer<Self>;
+  using ConstPointer = SmartPointer<const Self>;
+
+  /** Method for creation through the object factory. */
+  itkNewMacro(Self);
+
+  /** Run-time type information (and related methods). */
+  itkTypeMacro(BatchImageRegistrationMethodv4, Object);
+
+  /** Registration method type alias. */
+  using RegistrationMethodType = TRegistrationMethod;
+  using RegistrationMethodPointer = typename RegistrationMethodType::Pointer;
+  using FixedSmoothImagesPerLevelContainerType =
+    typename RegistrationMethodType::FixedSmoothImagesPerLevelContainerType;
+
+  /** Output transform type alias. */
+  using OutputTransformType = typename RegistrationMethodType::OutputTransformType;
+  using OutputTransformPointer = typename OutputTransformType::Pointer;
+
+  using TimeStampType = RealTimeClock::TimeStampType;
+
+  /** Add the registration method of a moving image and return its index. */
+  SizeValueType
+  AddRegistrationMethod(RegistrationMethodType * registration);
+
+  /** Remove all the registration methods and their results. */
+  void
+  ClearRegistrationMethods();
+
+  /** Get the number of registration methods added since the last clear. */
+  SizeValueType
+  GetNumberOfRegistrationMethods() const
+  {
+    return static_cast<SizeValueType>(this->m_RegistrationMethods.size());
+  }
+
+  /** Get a registration method, or null once its registration has run. */
+  RegistrationMethodType *
+  GetRegistrationMethod(SizeValueType index) const;
+
+  /** Get the output transform of a registration, or null if it has not run
+   * or has failed. */
+  OutputTransformType *
+  GetModifiableTransform(SizeValueType index);
+  const OutputTransformType *
+  GetTransform(SizeValueType index) const;
+
+  /** Get the wall clock time, in seconds, spent in a registration. */
+  TimeStampType
+  GetRegistrationTime(SizeValueType index) const;
+
+  /** Get the error of a failed registration, or an empty string. */
+  const std::string &
+  GetRegistrationError(SizeValueType index) const;
+
+  /** Set/Get the maximum number of registrations run at a time.  Defaults to
+   * one. */
+  itkSetClampMacro(NumberOfConcurrentRegistrations, ThreadIdType, 1, ITK_MAX_THREADS);
+  itkGetConstMacro(NumberOfConcurrentRegistrations, ThreadIdType);
+
+  /** Get the smoothed fixed images shared by the registrations of the last
+   * Update(). */
+  itkGetConstReferenceMacro(FixedSmoothImagesPerLevel, FixedSmoothImagesPerLevelContainerType);
+
+  /** Run the registrations that have not run yet.  The registrations that
+   * fail do not stop the others; an exception listing them is thrown once all
+   * the registrations have run. */
+  virtual void
+  Update();
+
+protected:
+  BatchImageRegistrationMethodv4() = default;
+  ~BatchImageRegistrationMethodv4() override = default;
+
+  void
+  PrintSelf(std::ostream & os, Indent indent) const override;
+
+  /** Check that a registration method shares the fixed-side set up of the
+   * reference registration method. */
+  virtual void
+  VerifyRegistrationMethod(const RegistrationMethodType * registration,
+                           const RegistrationMethodType * reference) const;
+
+private:
+  std::vector<RegistrationMethodPointer> m_RegistrationMethods;
+  std::vector<OutputTransformPointer>    m_Transforms;
+  std::vector<TimeStampType>             m_RegistrationTimes;
+  std::vector<std::string>               m_RegistrationErrors;
+  FixedSmoothImagesPerLevelContainerType m_FixedSmoothImagesPerLevel;
+  ThreadIdType                           m_NumberOfConcurrentRegistrations{ 1 };
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkBatchImageRegistrationMethodv4.hxx"
+#endif
+
+#endif
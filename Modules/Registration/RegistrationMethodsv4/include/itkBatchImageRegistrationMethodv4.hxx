@@ -0,0 +1,269 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkBatchImageRegistrationMethodv4_hxx
+#define itkBatchImageRegistrationMethodv4_hxx
+
+#include "itkBatchImageRegistrationMethodv4.h"
+
+#include "itkTimeProbe.h"
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+namespace itk
+{
+
+template <typename TRegistrationMethod>
+SizeValueType
+BatchImageRegistrationMethodv4<TRegistrationMethod>::AddRegistrationMethod(RegistrationMethodType * registration)
+{
+  if (registration == nullptr)
+  {
+    itkExceptionMacro("The registration method is null.");
+  }
+  this->m_RegistrationMethods.push_back(registration);
+  this->m_Transforms.push_back(nullptr);
+  this->m_RegistrationTimes.push_back(0.0);
+  this->m_RegistrationErrors.emplace_back();
+  this->Modified();
+  return static_cast<SizeValueType>(this->m_RegistrationMethods.size() - 1);
+}
+
+template <typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>::ClearRegistrationMethods()
+{
+  this->m_RegistrationMethods.clear();
+  this->m_Transforms.clear();
+  this->m_RegistrationTimes.clear();
+  this->m_RegistrationErrors.clear();
+  this->m_FixedSmoothImagesPerLevel.clear();
+  this->Modified();
+}
+
+template <typename TRegistrationMethod>
+typename BatchImageRegistrationMethodv4<TRegistrationMethod>::RegistrationMethodType *
+BatchImageRegistrationMethodv4<TRegistrationMethod>::GetRegistrationMethod(SizeValueType index) const
+{
+  if (index >= this->m_RegistrationMethods.size())
+  {
+    itkExceptionMacro("Registration " << index << " is out of range.");
+  }
+  return this->m_RegistrationMethods[index];
+}
+
+template <typename TRegistrationMethod>
+typename BatchImageRegistrationMethodv4<TRegistrationMethod>::OutputTransformType *
+BatchImageRegistrationMethodv4<TRegistrationMethod>::GetModifiableTransform(SizeValueType index)
+{
+  if (index >= this->m_Transforms.size())
+  {
+    itkExceptionMacro("Registration " << index << " is out of range.");
+  }
+  return this->m_Transforms[index];
+}
+
+template <typename TRegistrationMethod>
+const typename BatchImageRegistrationMethodv4<TRegistrationMethod>::OutputTransformType *
+BatchImageRegistrationMethodv4<TRegistrationMethod>::GetTransform(SizeValueType index) const
+{
+  if (index >= this->m_Transforms.size())
+  {
+    itkExceptionMacro("Registration " << index << " is out of range.");
+  }
+  return this->m_Transforms[index];
+}
+
+template <typename TRegistrationMethod>
+typename BatchImageRegistrationMethodv4<TRegistrationMethod>::TimeStampType
+BatchImageRegistrationMethodv4<TRegistrationMethod>::GetRegistrationTime(SizeValueType index) const
+{
+  if (index >= this->m_RegistrationTimes.size())
+  {
+    itkExceptionMacro("Registration " << index << " is out of range.");
+  }
+  return this->m_RegistrationTimes[index];
+}
+
+template <typename TRegistrationMethod>
+const std::string &
+BatchImageRegistrationMethodv4<TRegistrationMethod>::GetRegistrationError(SizeValueType index) const
+{
+  if (index >= this->m_RegistrationErrors.size())
+  {
+    itkExceptionMacro("Registration " << index << " is out of range.");
+  }
+  return this->m_RegistrationErrors[index];
+}
+
+template <typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>::VerifyRegistrationMethod(
+  const RegistrationMethodType * registration,
+  const RegistrationMethodType * reference) const
+{
+  if (registration->GetNumberOfLevels() != reference->GetNumberOfLevels() ||
+      registration->GetSmoothingSigmasPerLevel() != reference->GetSmoothingSigmasPerLevel() ||
+      registration->GetSmoothingSigmasAreSpecifiedInPhysicalUnits() !=
+        reference->GetSmoothingSigmasAreSpecifiedInPhysicalUnits())
+  {
+    itkExceptionMacro("The registration methods do not share the levels and the smoothing sigmas.");
+  }
+  if (registration->GetNumberOfIndexedInputs() != reference->GetNumberOfIndexedInputs())
+  {
+    itkExceptionMacro("The registration methods do not share the fixed images.");
+  }
+  // The fixed images and point sets are the even inputs.
+  for (SizeValueType n = 0; 2 * n < reference->GetNumberOfIndexedInputs(); n++)
+  {
+    if (registration->GetFixedImage(n) != reference->GetFixedImage(n))
+    {
+      itkExceptionMacro("The registration methods do not share the fixed images.");
+    }
+    if (reference->GetFixedImage(n) != nullptr && reference->GetFixedImage(n)->GetReleaseDataFlag())
+    {
+      itkExceptionMacro("The fixed images shared by the registration methods must not release their data.");
+    }
+  }
+}
+
+template <typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>::Update()
+{
+  std::vector<SizeValueType> pending;
+  for (SizeValueType index = 0; index < this->m_RegistrationMethods.size(); index++)
+  {
+    if (this->m_RegistrationMethods[index].IsNotNull())
+    {
+      pending.push_back(index);
+    }
+  }
+  if (pending.empty())
+  {
+    return;
+  }
+
+  const RegistrationMethodType * reference = this->m_RegistrationMethods[pending[0]];
+  for (SizeValueType index : pending)
+  {
+    this->VerifyRegistrationMethod(this->m_RegistrationMethods[index], reference);
+  }
+
+  // Preprocess the fixed side once for all the registrations.
+  this->m_FixedSmoothImagesPerLevel = reference->ComputeFixedSmoothImagesPerLevel();
+
+  // The pipeline requests of the registrations reach their shared fixed
+  // images, so only the pipeline execution runs concurrently.
+  for (SizeValueType index : pending)
+  {
+    RegistrationMethodType * registration = this->m_RegistrationMethods[index];
+    registration->SetFixedSmoothImagesPerLevel(this->m_FixedSmoothImagesPerLevel);
+    registration->GetOutput()->UpdateOutputInformation();
+    registration->GetOutput()->PropagateRequestedRegion();
+  }
+  for (SizeValueType n = 0; 2 * n < reference->GetNumberOfIndexedInputs(); n++)
+  {
+    if (reference->GetFixedImage(n) != nullptr)
+    {
+      const_cast<typename RegistrationMethodType::FixedImageType *>(reference->GetFixedImage(n))->UpdateOutputData();
+    }
+  }
+
+  // The workers run on threads of their own rather than as work units of
+  // the multi-threader. A worker on a pool thread would wait for the nested
+  // multi-threading of its registration, which is queued to the same pool,
+  // so the pool threads taken by workers would be lost to the registrations.
+  const SizeValueType numberOfWorkers =
+    std::min<SizeValueType>(this->m_NumberOfConcurrentRegistrations, pending.size());
+
+  std::atomic<SizeValueType> nextPending(0);
+
+  const auto runRegistrations = [&]() {
+    for (SizeValueType p = nextPending++; p < pending.size(); p = nextPending++)
+    {
+      const SizeValueType index = pending[p];
+      TimeProbe           probe;
+      probe.Start();
+      try
+      {
+        this->m_RegistrationMethods[index]->GetOutput()->UpdateOutputData();
+        this->m_Transforms[index] = this->m_RegistrationMethods[index]->GetModifiableTransform();
+      }
+      catch (ExceptionObject & exc)
+      {
+        this->m_RegistrationErrors[index] = exc.GetDescription();
+      }
+      catch (std::exception & exc)
+      {
+        this->m_RegistrationErrors[index] = exc.what();
+      }
+      catch (...)
+      {
+        this->m_RegistrationErrors[index] = "Unknown exception";
+      }
+      probe.Stop();
+      this->m_RegistrationTimes[index] = probe.GetTotal();
+
+      // Release the intermediate images of the registration.
+      this->m_RegistrationMethods[index] = nullptr;
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (SizeValueType worker = 1; worker < numberOfWorkers; worker++)
+  {
+    workers.emplace_back(runRegistrations);
+  }
+  runRegistrations();
+  for (auto & worker : workers)
+  {
+    worker.join();
+  }
+
+  SizeValueType numberOfFailures = 0;
+  SizeValueType firstFailure = 0;
+  for (SizeValueType index : pending)
+  {
+    if (!this->m_RegistrationErrors[index].empty() && numberOfFailures++ == 0)
+    {
+      firstFailure = index;
+    }
+  }
+  if (numberOfFailures > 0)
+  {
+    itkExceptionMacro(<< numberOfFailures << " of " << pending.size() << " registrations failed, the first one is "
+                      << firstFailure << ": " << this->m_RegistrationErrors[firstFailure]);
+  }
+}
+
+template <typename TRegistrationMethod>
+void
+BatchImageRegistrationMethodv4<TRegistrationMethod>::PrintSelf(std::ostream & os, Indent indent) const
+{
+  Superclass::PrintSelf(os, indent);
+
+  os << indent << "Number of registration methods: " << this->m_RegistrationMethods.size() << std::endl;
+  os << indent << "Number of concurrent registrations: " << this->m_NumberOfConcurrentRegistrations << std::endl;
+  os << indent << "Number of levels of smoothed fixed images: " << this->m_FixedSmoothImagesPerLevel.size()
+     << std::endl;
+}
+} // end namespace itk
+
+#endif
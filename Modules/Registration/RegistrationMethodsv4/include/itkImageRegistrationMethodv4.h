@@ -28,9 +28,12 @@
 #include "itkImageToImageMetricv4.h"
 #include "itkPointSetToPointSetMetricv4.h"
 #include "itkShrinkImageFilter.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
 #include "itkIdentityTransform.h"
 #include "itkTransformParametersAdaptorBase.h"
 
+#include <future>
+#include <utility>
 #include <vector>
 
 namespace itk
@@ -307,6 +310,19 @@ public:
   SetMetricSamplingPercentagePerLevel(const MetricSamplingPercentageArrayType & samplingPercentages);
   itkGetConstMacro(MetricSamplingPercentagePerLevel, MetricSamplingPercentageArrayType);
 
+  /** Set/Get the number of metric samples evaluated at each optimizer
+   * iteration. When non-zero, the metric is evaluated at each iteration on a
+   * new random subset of this size, drawn without replacement from the
+   * samples selected by the REGULAR or RANDOM sampling strategy for the
+   * current level, i.e. the optimizer performs stochastic mini-batch gradient
+   * descent. The metric is still initialized on all the samples of the level,
+   * e.g. the Mattes histogram range covers all of them. As the metric value
+   * then fluctuates between iterations, the convergence window of the
+   * optimizer should be chosen accordingly. Zero, the default, evaluates all
+   * the samples at every iteration. */
+  itkSetMacro(NumberOfMetricSamplesPerIteration, SizeValueType);
+  itkGetConstMacro(NumberOfMetricSamplesPerIteration, SizeValueType);
+
   /** Set/Get the initial fixed transform. */
   itkSetGetDecoratedObjectInputMacro(FixedInitialTransform, InitialTransformType);
 
@@ -408,6 +424,46 @@ public:
   itkGetConstMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits, bool);
   itkBooleanMacro(SmoothingSigmasAreSpecifiedInPhysicalUnits);
 
+  /**
+   * Set/Get whether the images of the next level are smoothed while the
+   * current level is registered.  The smoothing then runs concurrently with
+   * the metric, so that the finer levels are built while the coarser ones are
+   * registered, at the cost of the memory of the smoothed images of one more
+   * level.  The smoothing of a level starts when the previous level is
+   * initialized, so that the smoothing sigmas and the inputs must not be
+   * changed by the observers of the registration.  Off by default.
+   */
+  itkSetMacro(SmoothNextLevelConcurrently, bool);
+  itkGetConstMacro(SmoothNextLevelConcurrently, bool);
+  itkBooleanMacro(SmoothNextLevelConcurrently);
+
+  /** Type of the smoothed fixed images, indexed by level and then by metric. */
+  using FixedSmoothImagesPerLevelContainerType = std::vector<FixedImagesContainerType>;
+
+  /**
+   * Set/Get the smoothed fixed images of each level.  When set, they are used
+   * at each level instead of smoothing the fixed images, so that registrations
+   * of many moving images to the same fixed images can share the fixed-side
+   * preprocessing.  They are typically computed once with
+   * ComputeFixedSmoothImagesPerLevel().  Empty by default.
+   * \sa BatchImageRegistrationMethodv4
+   */
+  virtual void
+  SetFixedSmoothImagesPerLevel(const FixedSmoothImagesPerLevelContainerType & fixedSmoothImagesPerLevel)
+  {
+    this->m_FixedSmoothImagesPerLevel = fixedSmoothImagesPerLevel;
+    this->Modified();
+  }
+  itkGetConstReferenceMacro(FixedSmoothImagesPerLevel, FixedSmoothImagesPerLevelContainerType);
+
+  /**
+   * Smooth the fixed images with the smoothing sigmas of each level, as is
+   * done at the start of each level.  The entries of the fixed point sets are
+   * null.
+   */
+  virtual FixedSmoothImagesPerLevelContainerType
+  ComputeFixedSmoothImagesPerLevel() const;
+
   /** Make a DataObject of the correct type to be used as the specified output. */
   using DataObjectPointerArraySizeType = ProcessObject::DataObjectPointerArraySizeType;
   using Superclass::MakeOutput;
@@ -506,6 +562,28 @@ protected:
   virtual void
   SetMetricSamplePoints();
 
+  /** Replace the metric samples of the level by mini-batches that are
+   * redrawn at each optimizer iteration.
+   * \sa SetNumberOfMetricSamplesPerIteration() */
+  virtual void
+  InitializeMetricSampleBatches();
+
+  /** Draw a new mini-batch of metric samples. */
+  virtual void
+  DrawMetricSampleBatches();
+
+  /** Restore the metric samples of the level. */
+  virtual void
+  FinalizeMetricSampleBatches();
+
+  /** Smooth a fixed image with the smoothing sigma of a level. */
+  virtual FixedImageConstPointer
+  SmoothFixedImage(const FixedImageType *, SizeValueType level) const;
+
+  /** Smooth a moving image with the smoothing sigma of a level. */
+  virtual MovingImageConstPointer
+  SmoothMovingImage(const MovingImageType *, SizeValueType level) const;
+
   SizeValueType m_CurrentLevel;
   SizeValueType m_NumberOfLevels;
   SizeValueType m_CurrentIteration;
@@ -513,6 +591,8 @@ protected:
   RealType      m_CurrentConvergenceValue;
   bool          m_IsConverged;
 
+  FixedSmoothImagesPerLevelContainerType m_FixedSmoothImagesPerLevel;
+
   FixedImagesContainerType      m_FixedSmoothImages;
   MovingImagesContainerType     m_MovingSmoothImages;
   FixedImageMasksContainerType  m_FixedImageMasks;
@@ -535,11 +615,22 @@ protected:
   std::vector<ShrinkFactorsPerDimensionContainerType> m_ShrinkFactorsPerLevel;
   SmoothingSigmasArrayType                            m_SmoothingSigmasPerLevel;
   bool                                                m_SmoothingSigmasAreSpecifiedInPhysicalUnits;
+  bool                                                m_SmoothNextLevelConcurrently;
 
   bool m_ReseedIterator;
   int  m_RandomSeed;
   int  m_CurrentRandomSeed;
 
+  using MetricSampleBatchPointSetType = typename ImageMetricType::VirtualPointSetType;
+  using MetricSampleBatchRandomizerType = Statistics::MersenneTwisterRandomVariateGenerator;
+
+  SizeValueType                                                     m_NumberOfMetricSamplesPerIteration;
+  std::vector<typename ImageMetricType::Pointer>                    m_MetricSampleBatchMetrics;
+  std::vector<typename MetricSampleBatchPointSetType::Pointer>      m_MetricSamplePools;
+  std::vector<typename MetricSampleBatchPointSetType::Pointer>      m_MetricSampleBatches;
+  std::vector<std::vector<SizeValueType>>                           m_MetricSamplePoolPermutations;
+  typename MetricSampleBatchRandomizerType::Pointer                 m_MetricSampleBatchRandomizer;
+  unsigned long                                                     m_MetricSampleBatchObserverTag;
 
   TransformParametersAdaptorsContainerType m_TransformParametersAdaptorsPerLevel;
 
@@ -551,10 +642,26 @@ protected:
 
 
 private:
+  using SmoothImagesType = std::pair<FixedImagesContainerType, MovingImagesContainerType>;
+
+  /** Smooth the fixed and moving images of the image metrics for a level.
+   * The images of the point set metrics are null, as are the fixed images
+   * when the smoothed fixed images per level are set.  The inputs are grafted
+   * first when the smoothing runs concurrently with the registration, so that
+   * their pipeline information is not modified. */
+  SmoothImagesType
+  SmoothImages(SizeValueType level, bool graftInputs) const;
+
   bool m_InPlace;
 
   bool m_InitializeCenterOfLinearOutputTransform;
 
+  // The smoothing of the images of the next level, which runs while the
+  // current level is registered.  Declared last so that it is waited for
+  // before the other members are destroyed.
+  std::future<SmoothImagesType> m_NextLevelSmoothImages;
+  SizeValueType                 m_NextLevelSmoothImagesLevel;
+
   // helper function to create the right kind of concrete transform
   template <typename TTransform>
   static void
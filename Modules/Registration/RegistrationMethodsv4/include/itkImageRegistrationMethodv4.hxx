@@ -21,6 +21,7 @@
 #include "itkImageRegistrationMethodv4.h"
 
 #include "itkSmoothingRecursiveGaussianImageFilter.h"
+#include "itkCommand.h"
 #include "itkGradientDescentOptimizerv4.h"
 #include "itkImageRandomConstIteratorWithIndex.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
@@ -120,6 +121,8 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   this->m_SmoothingSigmasPerLevel[2] = 0;
 
   this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits = true;
+  this->m_SmoothNextLevelConcurrently = false;
+  this->m_NextLevelSmoothImagesLevel = 0;
 
   this->m_ReseedIterator = false;
   this->m_RandomSeed = Statistics::MersenneTwisterRandomVariateGenerator::GetNextSeed();
@@ -128,6 +131,9 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   this->m_MetricSamplingStrategy = NONE;
   this->m_MetricSamplingPercentagePerLevel.SetSize(this->m_NumberOfLevels);
   this->m_MetricSamplingPercentagePerLevel.Fill(1.0);
+
+  this->m_NumberOfMetricSamplesPerIteration = 0;
+  this->m_MetricSampleBatchObserverTag = 0;
 }
 
 template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
@@ -591,10 +597,31 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   // Although this isn't necessary, we want to leave the option for
   // changing the point sets per level.
 
-  this->m_FixedSmoothImages.clear();
-  this->m_FixedSmoothImages.resize(this->m_NumberOfMetrics);
-  this->m_MovingSmoothImages.clear();
-  this->m_MovingSmoothImages.resize(this->m_NumberOfMetrics);
+  // The smoothed images of this level were computed while the previous level
+  // was registered, unless the registration started over.
+  SmoothImagesType smoothImages;
+  if (this->m_NextLevelSmoothImages.valid() && level > 0 && this->m_NextLevelSmoothImagesLevel == level)
+  {
+    smoothImages = this->m_NextLevelSmoothImages.get();
+  }
+  else
+  {
+    if (this->m_NextLevelSmoothImages.valid())
+    {
+      this->m_NextLevelSmoothImages.wait();
+      this->m_NextLevelSmoothImages = std::future<SmoothImagesType>();
+    }
+    smoothImages = this->SmoothImages(level, false);
+  }
+  if (this->m_SmoothNextLevelConcurrently && level + 1 < this->m_NumberOfLevels)
+  {
+    this->m_NextLevelSmoothImagesLevel = level + 1;
+    this->m_NextLevelSmoothImages =
+      std::async(std::launch::async, &Self::SmoothImages, this, static_cast<SizeValueType>(level + 1), true);
+  }
+
+  this->m_FixedSmoothImages = std::move(smoothImages.first);
+  this->m_MovingSmoothImages = std::move(smoothImages.second);
   this->m_FixedPointSets.clear();
   this->m_FixedPointSets.resize(this->m_NumberOfMetrics);
   this->m_MovingPointSets.clear();
@@ -602,8 +629,6 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
   for (SizeValueType n = 0; n < this->m_NumberOfMetrics; n++)
   {
-    this->m_FixedSmoothImages[n] = nullptr;
-    this->m_MovingSmoothImages[n] = nullptr;
     this->m_FixedPointSets[n] = nullptr;
     this->m_MovingPointSets[n] = nullptr;
 
@@ -611,54 +636,9 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
         (this->m_Metric->GetMetricCategory() == MetricType::MULTI_METRIC &&
          multiMetric->GetMetricQueue()[n]->GetMetricCategory() == MetricType::IMAGE_METRIC))
     {
-      if (this->m_SmoothingSigmasPerLevel[level] > 0)
-      {
-        using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
-        typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter =
-          FixedImageSmoothingFilterType::New();
-        typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(
-          this->m_SmoothingSigmasPerLevel[level]);
-
-        if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
-        {
-          auto & fixedSpacing = this->GetFixedImage(n)->GetSpacing();
-          for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
-          {
-            fixedImageSigmaArray[i] *= fixedSpacing[i];
-          }
-        }
-        fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
-        fixedImageSmoothingFilter->SetInput(this->GetFixedImage(n));
-
-        this->m_FixedSmoothImages[n] = fixedImageSmoothingFilter->GetOutput();
-        fixedImageSmoothingFilter->Update();
-        fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
-
-        using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
-        typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter =
-          MovingImageSmoothingFilterType::New();
-        typename MovingImageSmoothingFilterType::SigmaArrayType movingImageSigmaArray(
-          this->m_SmoothingSigmasPerLevel[level]);
-
-        if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
-        {
-          auto & movingSpacing = this->GetMovingImage(n)->GetSpacing();
-          for (unsigned int i = 0; i < movingImageSigmaArray.Size(); ++i)
-          {
-            movingImageSigmaArray[i] *= movingSpacing[i];
-          }
-        }
-        movingImageSmoothingFilter->SetSigmaArray(movingImageSigmaArray);
-        movingImageSmoothingFilter->SetInput(this->GetMovingImage(n));
-
-        this->m_MovingSmoothImages[n] = movingImageSmoothingFilter->GetOutput();
-        movingImageSmoothingFilter->Update();
-        movingImageSmoothingFilter->GetOutput()->DisconnectPipeline();
-      }
-      else
+      if (this->m_FixedSmoothImages[n].IsNull() || this->m_MovingSmoothImages[n].IsNull())
       {
-        this->m_MovingSmoothImages[n] = this->GetMovingImage(n);
-        this->m_FixedSmoothImages[n] = this->GetFixedImage(n);
+        itkExceptionMacro("The fixed and moving images of metric " << n << " are not set.");
       }
 
       // Update the image metric
@@ -735,6 +715,161 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   }
 }
 
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  FixedImageConstPointer
+  ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SmoothFixedImage(
+    const FixedImageType * image,
+    SizeValueType          level) const
+{
+  if (this->m_SmoothingSigmasPerLevel[level] <= 0)
+  {
+    return image;
+  }
+
+  using FixedImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<FixedImageType, FixedImageType>;
+  typename FixedImageSmoothingFilterType::Pointer fixedImageSmoothingFilter = FixedImageSmoothingFilterType::New();
+  typename FixedImageSmoothingFilterType::SigmaArrayType fixedImageSigmaArray(this->m_SmoothingSigmasPerLevel[level]);
+
+  if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+  {
+    auto & fixedSpacing = image->GetSpacing();
+    for (unsigned int i = 0; i < fixedImageSigmaArray.Size(); ++i)
+    {
+      fixedImageSigmaArray[i] *= fixedSpacing[i];
+    }
+  }
+  fixedImageSmoothingFilter->SetSigmaArray(fixedImageSigmaArray);
+  fixedImageSmoothingFilter->SetInput(image);
+
+  FixedImageConstPointer smoothImage = fixedImageSmoothingFilter->GetOutput();
+  fixedImageSmoothingFilter->Update();
+  fixedImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+  return smoothImage;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  MovingImageConstPointer
+  ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SmoothMovingImage(
+    const MovingImageType * image,
+    SizeValueType           level) const
+{
+  if (this->m_SmoothingSigmasPerLevel[level] <= 0)
+  {
+    return image;
+  }
+
+  using MovingImageSmoothingFilterType = SmoothingRecursiveGaussianImageFilter<MovingImageType, MovingImageType>;
+  typename MovingImageSmoothingFilterType::Pointer movingImageSmoothingFilter = MovingImageSmoothingFilterType::New();
+  typename MovingImageSmoothingFilterType::SigmaArrayType movingImageSigmaArray(
+    this->m_SmoothingSigmasPerLevel[level]);
+
+  if (!this->m_SmoothingSigmasAreSpecifiedInPhysicalUnits)
+  {
+    auto & movingSpacing = image->GetSpacing();
+    for (unsigned int i = 0; i < movingImageSigmaArray.Size(); ++i)
+    {
+      movingImageSigmaArray[i] *= movingSpacing[i];
+    }
+  }
+  movingImageSmoothingFilter->SetSigmaArray(movingImageSigmaArray);
+  movingImageSmoothingFilter->SetInput(image);
+
+  MovingImageConstPointer smoothImage = movingImageSmoothingFilter->GetOutput();
+  movingImageSmoothingFilter->Update();
+  movingImageSmoothingFilter->GetOutput()->DisconnectPipeline();
+  return smoothImage;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SmoothImagesType
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::SmoothImages(
+  SizeValueType level,
+  bool          graftInputs) const
+{
+  // Smoothing a grafted input leaves the requested region of the input, which
+  // may be used by the metric of the current level, untouched.
+  const bool graft = graftInputs && this->m_SmoothingSigmasPerLevel[level] > 0;
+
+  SmoothImagesType smoothImages;
+  smoothImages.first.resize(this->m_NumberOfMetrics);
+  smoothImages.second.resize(this->m_NumberOfMetrics);
+  for (SizeValueType n = 0; n < this->m_NumberOfMetrics; n++)
+  {
+    // The inputs of the point set metrics are left null.
+    const auto * fixedImage = dynamic_cast<const FixedImageType *>(this->ProcessObject::GetInput(2 * n));
+    const auto * movingImage = dynamic_cast<const MovingImageType *>(this->ProcessObject::GetInput(2 * n + 1));
+
+    if (fixedImage)
+    {
+      if (!this->m_FixedSmoothImagesPerLevel.empty())
+      {
+        if (this->m_FixedSmoothImagesPerLevel.size() != this->m_NumberOfLevels ||
+            this->m_FixedSmoothImagesPerLevel[level].size() <= n ||
+            this->m_FixedSmoothImagesPerLevel[level][n].IsNull())
+        {
+          itkExceptionMacro("The smoothed fixed images per level do not match the levels and the metrics.");
+        }
+        smoothImages.first[n] = this->m_FixedSmoothImagesPerLevel[level][n];
+      }
+      else if (graft)
+      {
+        typename FixedImageType::Pointer input = FixedImageType::New();
+        input->Graft(fixedImage);
+        smoothImages.first[n] = this->SmoothFixedImage(input, level);
+      }
+      else
+      {
+        smoothImages.first[n] = this->SmoothFixedImage(fixedImage, level);
+      }
+    }
+
+    if (movingImage)
+    {
+      if (graft)
+      {
+        typename MovingImageType::Pointer input = MovingImageType::New();
+        input->Graft(movingImage);
+        smoothImages.second[n] = this->SmoothMovingImage(input, level);
+      }
+      else
+      {
+        smoothImages.second[n] = this->SmoothMovingImage(movingImage, level);
+      }
+    }
+  }
+  return smoothImages;
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+typename ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  FixedSmoothImagesPerLevelContainerType
+  ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+    ComputeFixedSmoothImagesPerLevel() const
+{
+  if (this->m_SmoothingSigmasPerLevel.Size() < this->m_NumberOfLevels)
+  {
+    itkExceptionMacro("The smoothing sigmas are not specified for each level.");
+  }
+
+  FixedSmoothImagesPerLevelContainerType fixedSmoothImagesPerLevel(this->m_NumberOfLevels);
+  for (SizeValueType level = 0; level < this->m_NumberOfLevels; level++)
+  {
+    fixedSmoothImagesPerLevel[level].resize(this->m_NumberOfFixedObjects);
+    for (SizeValueType n = 0; n < this->m_NumberOfFixedObjects; n++)
+    {
+      // The inputs of the point set metrics are left null.
+      const auto * fixedImage = dynamic_cast<const FixedImageType *>(this->ProcessObject::GetInput(2 * n));
+      if (fixedImage)
+      {
+        fixedSmoothImagesPerLevel[level][n] = this->SmoothFixedImage(fixedImage, level);
+      }
+    }
+  }
+  return fixedSmoothImagesPerLevel;
+}
+
 
 template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
 void
@@ -823,7 +958,24 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
 
     this->m_Metric->Initialize();
 
-    this->m_Optimizer->StartOptimization();
+    if (this->m_NumberOfMetricSamplesPerIteration > 0)
+    {
+      this->InitializeMetricSampleBatches();
+      try
+      {
+        this->m_Optimizer->StartOptimization();
+      }
+      catch (...)
+      {
+        this->FinalizeMetricSampleBatches();
+        throw;
+      }
+      this->FinalizeMetricSampleBatches();
+    }
+    else
+    {
+      this->m_Optimizer->StartOptimization();
+    }
   }
 }
 
@@ -1062,6 +1214,145 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   }
 }
 
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  InitializeMetricSampleBatches()
+{
+  if (this->m_MetricSamplingStrategy == NONE)
+  {
+    itkExceptionMacro("Drawing " << this->m_NumberOfMetricSamplesPerIteration
+                                 << " metric samples per iteration requires the REGULAR or RANDOM metric sampling "
+                                    "strategy.");
+  }
+
+  this->m_MetricSampleBatchMetrics.clear();
+  typename MultiMetricType::Pointer multiMetric = dynamic_cast<MultiMetricType *>(this->m_Metric.GetPointer());
+  if (multiMetric)
+  {
+    for (SizeValueType n = 0; n < multiMetric->GetNumberOfMetrics(); n++)
+    {
+      this->m_MetricSampleBatchMetrics.push_back(
+        dynamic_cast<ImageMetricType *>(multiMetric->GetMetricQueue()[n].GetPointer()));
+    }
+  }
+  else
+  {
+    this->m_MetricSampleBatchMetrics.push_back(dynamic_cast<ImageMetricType *>(this->m_Metric.GetPointer()));
+  }
+
+  const SizeValueType numberOfMetrics = this->m_MetricSampleBatchMetrics.size();
+  this->m_MetricSamplePools.resize(numberOfMetrics);
+  this->m_MetricSampleBatches.resize(numberOfMetrics);
+  this->m_MetricSamplePoolPermutations.resize(numberOfMetrics);
+
+  for (SizeValueType n = 0; n < numberOfMetrics; n++)
+  {
+    // The samples of the level, as set by SetMetricSamplePoints().
+    auto * pool = const_cast<MetricSampleBatchPointSetType *>(
+      this->m_MetricSampleBatchMetrics[n]->GetVirtualSampledPointSet());
+    const SizeValueType poolSize = pool->GetNumberOfPoints();
+
+    this->m_MetricSamplePools[n] = pool;
+    this->m_MetricSampleBatches[n] = nullptr;
+    this->m_MetricSamplePoolPermutations[n].clear();
+    if (poolSize <= this->m_NumberOfMetricSamplesPerIteration)
+    {
+      // The whole pool is evaluated at each iteration.
+      continue;
+    }
+
+    std::vector<SizeValueType> & permutation = this->m_MetricSamplePoolPermutations[n];
+    permutation.resize(poolSize);
+    for (SizeValueType i = 0; i < poolSize; i++)
+    {
+      permutation[i] = i;
+    }
+
+    typename MetricSampleBatchPointSetType::PointsContainerPointer batchPoints =
+      MetricSampleBatchPointSetType::PointsContainer::New();
+    batchPoints->Reserve(this->m_NumberOfMetricSamplesPerIteration);
+
+    typename MetricSampleBatchPointSetType::Pointer batch = MetricSampleBatchPointSetType::New();
+    batch->SetPoints(batchPoints);
+    this->m_MetricSampleBatches[n] = batch;
+    this->m_MetricSampleBatchMetrics[n]->SetVirtualSampledPointSet(batch);
+  }
+
+  if (this->m_MetricSampleBatchRandomizer.IsNull())
+  {
+    this->m_MetricSampleBatchRandomizer = MetricSampleBatchRandomizerType::New();
+  }
+  if (m_ReseedIterator)
+  {
+    this->m_MetricSampleBatchRandomizer->SetSeed();
+  }
+  else
+  {
+    this->m_MetricSampleBatchRandomizer->SetSeed(m_CurrentRandomSeed++);
+  }
+
+  this->DrawMetricSampleBatches();
+
+  using BatchCommandType = SimpleMemberCommand<Self>;
+  typename BatchCommandType::Pointer batchCommand = BatchCommandType::New();
+  batchCommand->SetCallbackFunction(this, &Self::DrawMetricSampleBatches);
+  this->m_MetricSampleBatchObserverTag = this->m_Optimizer->AddObserver(IterationEvent(), batchCommand);
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::DrawMetricSampleBatches()
+{
+  const SizeValueType batchSize = this->m_NumberOfMetricSamplesPerIteration;
+
+  for (SizeValueType n = 0; n < this->m_MetricSampleBatches.size(); n++)
+  {
+    if (this->m_MetricSampleBatches[n].IsNull())
+    {
+      continue;
+    }
+
+    // Partial Fisher-Yates shuffle of the pool indices: the first batchSize
+    // entries of the permutation are a uniform draw without replacement.
+    using PointsContainerType = typename MetricSampleBatchPointSetType::PointsContainer;
+    using IntegerType = MetricSampleBatchRandomizerType::IntegerType;
+
+    std::vector<SizeValueType> & permutation = this->m_MetricSamplePoolPermutations[n];
+    const PointsContainerType &  poolPoints = *this->m_MetricSamplePools[n]->GetPoints();
+    PointsContainerType &        batchPoints = *this->m_MetricSampleBatches[n]->GetPoints();
+    const auto                   poolSize = static_cast<IntegerType>(permutation.size());
+    for (SizeValueType i = 0; i < batchSize; i++)
+    {
+      const SizeValueType j =
+        i + this->m_MetricSampleBatchRandomizer->GetIntegerVariate(poolSize - static_cast<IntegerType>(i) - 1);
+      std::swap(permutation[i], permutation[j]);
+      batchPoints.ElementAt(i) = poolPoints.ElementAt(permutation[i]);
+    }
+    batchPoints.Modified();
+  }
+}
+
+template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
+void
+ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
+  FinalizeMetricSampleBatches()
+{
+  this->m_Optimizer->RemoveObserver(this->m_MetricSampleBatchObserverTag);
+
+  for (SizeValueType n = 0; n < this->m_MetricSampleBatches.size(); n++)
+  {
+    if (this->m_MetricSampleBatches[n].IsNotNull())
+    {
+      this->m_MetricSampleBatchMetrics[n]->SetVirtualSampledPointSet(this->m_MetricSamplePools[n]);
+    }
+  }
+  this->m_MetricSampleBatchMetrics.clear();
+  this->m_MetricSamplePools.clear();
+  this->m_MetricSampleBatches.clear();
+  this->m_MetricSamplePoolPermutations.clear();
+}
+
 template <typename TFixedImage, typename TMovingImage, typename TTransform, typename TVirtualImage, typename TPointSet>
 void
 ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage, TPointSet>::
@@ -1172,6 +1463,10 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   {
     os << indent2 << "Smoothing sigmas are specified in voxel units." << std::endl;
   }
+  os << indent << "Smooth next level concurrently: " << (this->m_SmoothNextLevelConcurrently ? "On" : "Off")
+     << std::endl;
+  os << indent << "Precomputed smoothed fixed images: " << (this->m_FixedSmoothImagesPerLevel.empty() ? "No" : "Yes")
+     << std::endl;
 
   if (this->m_OptimizerWeights.Size() > 0)
   {
@@ -1187,6 +1482,8 @@ ImageRegistrationMethodv4<TFixedImage, TMovingImage, TTransform, TVirtualImage,
   }
   os << std::endl;
 
+  os << indent << "NumberOfMetricSamplesPerIteration: " << this->m_NumberOfMetricSamplesPerIteration << std::endl;
+
   os << indent << "ReseedIterator: " << m_ReseedIterator << std::endl;
   os << indent << "RandomSeed: " << m_RandomSeed << std::endl;
   os << indent << "CurrentRandomSeed: " << m_CurrentRandomSeed << std::endl;
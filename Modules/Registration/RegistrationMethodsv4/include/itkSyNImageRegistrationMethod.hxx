@@ -213,44 +213,80 @@ SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtual
       }
     }
 
-    // Add the update field to both displacement fields (from fixed/moving to middle image) and then smooth
+    // Add the update field to both displacement fields (from fixed/moving to middle image), smooth and invert.
+    // The fixed and moving sides are updated in turn, and the intermediate fields of a side are released
+    // before the other side is processed, to reduce the number of full resolution fields held at once.
 
     using ComposerType = ComposeDisplacementFieldsImageFilter<DisplacementFieldType>;
 
-    typename ComposerType::Pointer fixedComposer = ComposerType::New();
-    fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
-    fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
-    fixedComposer->Update();
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      fixedComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
-
-    typename ComposerType::Pointer movingComposer = ComposerType::New();
-    movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
-    movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
-    movingComposer->Update();
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
-      movingComposer->GetOutput(), this->m_GaussianSmoothingVarianceForTheTotalField);
-
-    // Iteratively estimate the inverse fields.
-
-    DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
-    DisplacementFieldPointer fixedToMiddleSmoothTotalField =
-      this->InvertDisplacementField(fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp);
-
-    DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
-      movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
-    DisplacementFieldPointer movingToMiddleSmoothTotalField =
-      this->InvertDisplacementField(movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp);
-
-    // Assign the displacement fields and their inverses to the proper transforms.
-    this->m_FixedToMiddleTransform->SetDisplacementField(fixedToMiddleSmoothTotalField);
-    this->m_FixedToMiddleTransform->SetInverseDisplacementField(fixedToMiddleSmoothTotalFieldInverse);
+    {
+      typename ComposerType::Pointer fixedComposer = ComposerType::New();
+      fixedComposer->SetDisplacementField(fixedToMiddleSmoothUpdateField);
+      fixedComposer->SetWarpingField(this->m_FixedToMiddleTransform->GetDisplacementField());
+      fixedComposer->Update();
+
+      DisplacementFieldPointer fixedToMiddleTotalField = fixedComposer->GetOutput();
+      fixedToMiddleTotalField->DisconnectPipeline();
+      fixedComposer = nullptr;
+      fixedToMiddleSmoothUpdateField = nullptr;
+
+      DisplacementFieldPointer fixedToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
+        fixedToMiddleTotalField, this->m_GaussianSmoothingVarianceForTheTotalField);
+      fixedToMiddleTotalField = nullptr;
+
+      // Iteratively estimate the inverse fields.
+      DisplacementFieldPointer fixedToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
+        fixedToMiddleSmoothTotalFieldTmp, this->m_FixedToMiddleTransform->GetInverseDisplacementField());
+      DisplacementFieldPointer fixedToMiddleSmoothTotalField =
+        this->InvertDisplacementField(fixedToMiddleSmoothTotalFieldInverse, fixedToMiddleSmoothTotalFieldTmp);
+
+      // Assign the displacement field and its inverse to the proper transform.
+      this->m_FixedToMiddleTransform->SetDisplacementField(fixedToMiddleSmoothTotalField);
+      this->m_FixedToMiddleTransform->SetInverseDisplacementField(fixedToMiddleSmoothTotalFieldInverse);
+
+      // The metric holds the composite transform, which references the previous fields. Rebuild it with the new
+      // ones, so that the metric evaluates the current transform and the previous fields are released.
+      fixedComposite->ClearTransformQueue();
+      if (fixedInitialTransform != nullptr)
+      {
+        fixedComposite->AddTransform(fixedInitialTransform);
+      }
+      fixedComposite->AddTransform(this->m_FixedToMiddleTransform->GetInverseTransform());
+      fixedComposite->FlattenTransformQueue();
+      fixedComposite->SetOnlyMostRecentTransformToOptimizeOn();
+    }
 
-    this->m_MovingToMiddleTransform->SetDisplacementField(movingToMiddleSmoothTotalField);
-    this->m_MovingToMiddleTransform->SetInverseDisplacementField(movingToMiddleSmoothTotalFieldInverse);
+    {
+      typename ComposerType::Pointer movingComposer = ComposerType::New();
+      movingComposer->SetDisplacementField(movingToMiddleSmoothUpdateField);
+      movingComposer->SetWarpingField(this->m_MovingToMiddleTransform->GetDisplacementField());
+      movingComposer->Update();
+
+      DisplacementFieldPointer movingToMiddleTotalField = movingComposer->GetOutput();
+      movingToMiddleTotalField->DisconnectPipeline();
+      movingComposer = nullptr;
+      movingToMiddleSmoothUpdateField = nullptr;
+
+      DisplacementFieldPointer movingToMiddleSmoothTotalFieldTmp = this->GaussianSmoothDisplacementField(
+        movingToMiddleTotalField, this->m_GaussianSmoothingVarianceForTheTotalField);
+      movingToMiddleTotalField = nullptr;
+
+      // Iteratively estimate the inverse fields.
+      DisplacementFieldPointer movingToMiddleSmoothTotalFieldInverse = this->InvertDisplacementField(
+        movingToMiddleSmoothTotalFieldTmp, this->m_MovingToMiddleTransform->GetInverseDisplacementField());
+      DisplacementFieldPointer movingToMiddleSmoothTotalField =
+        this->InvertDisplacementField(movingToMiddleSmoothTotalFieldInverse, movingToMiddleSmoothTotalFieldTmp);
+
+      // Assign the displacement field and its inverse to the proper transform.
+      this->m_MovingToMiddleTransform->SetDisplacementField(movingToMiddleSmoothTotalField);
+      this->m_MovingToMiddleTransform->SetInverseDisplacementField(movingToMiddleSmoothTotalFieldInverse);
+
+      movingComposite->ClearTransformQueue();
+      movingComposite->AddTransform(this->m_CompositeTransform);
+      movingComposite->AddTransform(this->m_MovingToMiddleTransform->GetInverseTransform());
+      movingComposite->FlattenTransformQueue();
+      movingComposite->SetOnlyMostRecentTransformToOptimizeOn();
+    }
 
     this->m_CurrentMetricValue = 0.5 * (movingMetricValue + fixedMetricValue);
 
@@ -604,13 +640,30 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
 
   this->m_Metric->Initialize();
 
+  // The metric derivative is computed directly in the buffer of the gradient
+  // field, which avoids a second full resolution copy of the gradient.
+  const DisplacementVectorType zeroVector(0.0);
+
+  typename DisplacementFieldType::Pointer gradientField = DisplacementFieldType::New();
+  gradientField->CopyInformation(virtualDomainImage);
+  gradientField->SetRegions(virtualDomainImage->GetLargestPossibleRegion());
+  gradientField->Allocate();
+  gradientField->FillBuffer(zeroVector);
+
   using MetricDerivativeType = typename ImageMetricType::DerivativeType;
-  const typename MetricDerivativeType::SizeValueType metricDerivativeSize =
-    virtualDomainImage->GetLargestPossibleRegion().GetNumberOfPixels() * ImageDimension;
-  MetricDerivativeType metricDerivative(metricDerivativeSize);
+  using MetricDerivativeValueType = typename MetricDerivativeType::ValueType;
+  static_assert(std::is_same<MetricDerivativeValueType, typename DisplacementVectorType::ValueType>::value &&
+                  sizeof(DisplacementVectorType) == ImageDimension * sizeof(MetricDerivativeValueType),
+                "The displacement field buffer must be layout compatible with the metric derivative.");
+  auto * gradientFieldBuffer = reinterpret_cast<MetricDerivativeValueType *>(gradientField->GetBufferPointer());
+  MetricDerivativeType metricDerivative(
+    gradientFieldBuffer, gradientField->GetBufferedRegion().GetNumberOfPixels() * ImageDimension, false);
 
-  metricDerivative.Fill(NumericTraits<typename MetricDerivativeType::ValueType>::ZeroValue());
   this->m_Metric->GetValueAndDerivative(value, metricDerivative);
+  if (metricDerivative.data_block() != gradientFieldBuffer)
+  {
+    itkExceptionMacro("The size of the metric derivative does not match the virtual domain.");
+  }
 
   // Ensure that the size of the optimizer weights is the same as the
   // number of local transform parameters (=ImageDimension)
@@ -626,28 +679,6 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
     }
   }
 
-  // we rescale the update velocity field at each time point.
-  // we first need to convert to a displacement field to look
-  // at the max norm of the field.
-
-  typename DisplacementFieldType::Pointer gradientField = DisplacementFieldType::New();
-  gradientField->CopyInformation(virtualDomainImage);
-  gradientField->SetRegions(virtualDomainImage->GetRequestedRegion());
-  gradientField->Allocate();
-
-  ImageRegionIterator<DisplacementFieldType> ItG(gradientField, gradientField->GetRequestedRegion());
-
-  SizeValueType count = 0;
-  for (ItG.GoToBegin(); !ItG.IsAtEnd(); ++ItG)
-  {
-    DisplacementVectorType displacement;
-    for (SizeValueType d = 0; d < ImageDimension; d++)
-    {
-      displacement[d] = metricDerivative[count++];
-    }
-    ItG.Set(displacement);
-  }
-
   return gradientField;
 }
 
@@ -737,18 +768,19 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
   SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform, TVirtualImage, TPointSet>::
     GaussianSmoothDisplacementField(const DisplacementFieldType * field, const RealType variance)
 {
-  using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
-  typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
-  duplicator->SetInputImage(field);
-  duplicator->Update();
-
-  DisplacementFieldPointer smoothField = duplicator->GetOutput();
-
   if (variance <= 0.0)
   {
-    return smoothField;
+    using DuplicatorType = ImageDuplicator<DisplacementFieldType>;
+    typename DuplicatorType::Pointer duplicator = DuplicatorType::New();
+    duplicator->SetInputImage(field);
+    duplicator->Update();
+
+    return duplicator->GetOutput();
   }
 
+  // The first pass reads the input field directly, so no full copy of it is made.
+  DisplacementFieldPointer smoothField;
+
   using GaussianSmoothingOperatorType = GaussianOperator<RealType, ImageDimension>;
   GaussianSmoothingOperatorType gaussianSmoothingOperator;
 
@@ -762,12 +794,19 @@ typename SyNImageRegistrationMethod<TFixedImage, TMovingImage, TOutputTransform,
     gaussianSmoothingOperator.SetDirection(d);
     gaussianSmoothingOperator.SetVariance(variance);
     gaussianSmoothingOperator.SetMaximumError(0.001);
-    gaussianSmoothingOperator.SetMaximumKernelWidth(smoothField->GetRequestedRegion().GetSize()[d]);
+    gaussianSmoothingOperator.SetMaximumKernelWidth(field->GetLargestPossibleRegion().GetSize()[d]);
     gaussianSmoothingOperator.CreateDirectional();
 
     // todo: make sure we only smooth within the buffered region
     smoother->SetOperator(gaussianSmoothingOperator);
-    smoother->SetInput(smoothField);
+    if (d == 0)
+    {
+      smoother->SetInput(field);
+    }
+    else
+    {
+      smoother->SetInput(smoothField);
+    }
     try
     {
       smoother->Update();
@@ -0,0 +1,275 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkBatchImageRegistrationMethodv4.h"
+#include "itkCommand.h"
+#include "itkThreadPool.h"
+#include "itkImageRegistrationMethodv4.h"
+
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+/*
+ * Register several moving images to the same fixed image with
+ * BatchImageRegistrationMethodv4 and compare with independent registrations.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using OptimizerType = itk::GradientDescentOptimizerv4;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+using BatchRegistrationType = itk::BatchImageRegistrationMethodv4<RegistrationType>;
+
+ImageType::Pointer
+MakeBlobImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(48);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + dy * dy) / (2.0 * 7.0 * 7.0)));
+  }
+  return image;
+}
+
+RegistrationType::Pointer
+MakeRegistration(const ImageType * fixedImage, const ImageType * movingImage)
+{
+  MetricType::Pointer metric = MetricType::New();
+
+  using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+  ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric(metric);
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetNumberOfIterations(100);
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetMaximumStepSizeInPhysicalUnits(0.25);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(true);
+  optimizer->SetMinimumConvergenceValue(-1.0);
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetNumberOfLevels(2);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(2);
+  shrinkFactors[0] = 2;
+  shrinkFactors[1] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(2);
+  smoothingSigmas[0] = 2.0;
+  smoothingSigmas[1] = 0.0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  registration->SetSmoothingSigmasAreSpecifiedInPhysicalUnits(false);
+  return registration;
+}
+
+// Counts the registrations that have started. Each registration waits on its
+// StartEvent until the expected number have started, which only happens when
+// they run concurrently.
+struct ConcurrentStart
+{
+  unsigned int              expected{ 0 };
+  std::atomic<unsigned int> started{ 0 };
+  std::atomic<bool>         timedOut{ false };
+};
+
+void
+WaitForConcurrentStart(itk::Object *, const itk::EventObject &, void * clientData)
+{
+  auto * concurrentStart = static_cast<ConcurrentStart *>(clientData);
+  ++concurrentStart->started;
+  const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+  while (concurrentStart->started < concurrentStart->expected && std::chrono::steady_clock::now() < deadline)
+  {
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  if (concurrentStart->started < concurrentStart->expected)
+  {
+    concurrentStart->timedOut = true;
+  }
+}
+} // namespace
+
+int
+itkBatchImageRegistrationMethodv4Test(int, char *[])
+{
+  const double movingCenters[][2] = { { 27.0, 22.0 }, { 21.0, 25.0 }, { 25.5, 26.0 }, { 22.0, 21.5 }, { 26.0, 24.0 } };
+  constexpr unsigned int numberOfMovingImages = sizeof(movingCenters) / sizeof(movingCenters[0]);
+
+  ImageType::Pointer              fixedImage = MakeBlobImage(24.0, 24.0);
+  std::vector<ImageType::Pointer> movingImages;
+  for (const auto & center : movingCenters)
+  {
+    movingImages.push_back(MakeBlobImage(center[0], center[1]));
+  }
+
+  BatchRegistrationType::Pointer batch = BatchRegistrationType::New();
+  ITK_EXERCISE_BASIC_OBJECT_METHODS(batch, BatchImageRegistrationMethodv4, Object);
+
+  ITK_TEST_SET_GET_VALUE(1, batch->GetNumberOfConcurrentRegistrations());
+  batch->SetNumberOfConcurrentRegistrations(2);
+  ITK_TEST_SET_GET_VALUE(2, batch->GetNumberOfConcurrentRegistrations());
+
+  for (unsigned int i = 0; i < numberOfMovingImages; i++)
+  {
+    ITK_TEST_EXPECT_EQUAL(i, batch->AddRegistrationMethod(MakeRegistration(fixedImage, movingImages[i])));
+  }
+  ITK_TEST_EXPECT_EQUAL(numberOfMovingImages, batch->GetNumberOfRegistrationMethods());
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(batch->Update());
+
+  // The fixed image is smoothed once, and not at all at full resolution.
+  const BatchRegistrationType::FixedSmoothImagesPerLevelContainerType & fixedSmoothImages =
+    batch->GetFixedSmoothImagesPerLevel();
+  if (fixedSmoothImages.size() != 2 || fixedSmoothImages[0].size() != 1 || fixedSmoothImages[1].size() != 1 ||
+      fixedSmoothImages[0][0] == fixedImage.GetPointer() || fixedSmoothImages[1][0] != fixedImage.GetPointer())
+  {
+    std::cerr << "The fixed image was not smoothed once per level." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  for (unsigned int i = 0; i < numberOfMovingImages; i++)
+  {
+    if (batch->GetRegistrationMethod(i) != nullptr || batch->GetTransform(i) == nullptr ||
+        !batch->GetRegistrationError(i).empty() || batch->GetRegistrationTime(i) <= 0.0)
+    {
+      std::cerr << "Registration " << i << " did not run." << std::endl;
+      return EXIT_FAILURE;
+    }
+
+    // The batch gives the results of an independent registration.
+    RegistrationType::Pointer registration = MakeRegistration(fixedImage, movingImages[i]);
+    ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+
+    const TransformType::ParametersType & parameters = registration->GetTransform()->GetParameters();
+    const TransformType::ParametersType & batchParameters = batch->GetTransform(i)->GetParameters();
+    std::cout << "Registration " << i << ": " << batchParameters << " in " << batch->GetRegistrationTime(i) << " s"
+              << std::endl;
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      if (std::abs(parameters[d] - batchParameters[d]) > 1e-10)
+      {
+        std::cerr << "Registration " << i << " differs from an independent registration: " << parameters
+                  << std::endl;
+        return EXIT_FAILURE;
+      }
+      if (std::abs(batchParameters[d] - (movingCenters[i][d] - 24.0)) > 0.25)
+      {
+        std::cerr << "Registration " << i << " did not recover the translation." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+
+  // The registrations run concurrently whatever the number of threads of the
+  // multi-threader, whose threads are left to their nested multi-threading.
+  std::cout << "Default multi-threader: " << itk::MultiThreaderBase::New()->GetNameOfClass() << " with "
+            << itk::MultiThreaderBase::GetGlobalDefaultNumberOfThreads() << " threads, pool "
+            << itk::ThreadPool::GetInstance()->GetMaximumNumberOfThreads() << std::endl;
+  batch->ClearRegistrationMethods();
+  batch->SetNumberOfConcurrentRegistrations(3);
+  ConcurrentStart concurrentStart;
+  concurrentStart.expected = 3;
+  auto startCommand = itk::CStyleCommand::New();
+  startCommand->SetCallback(WaitForConcurrentStart);
+  startCommand->SetClientData(&concurrentStart);
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    RegistrationType::Pointer registration = MakeRegistration(fixedImage, movingImages[i]);
+    registration->AddObserver(itk::StartEvent(), startCommand);
+    batch->AddRegistrationMethod(registration);
+  }
+  ITK_TRY_EXPECT_NO_EXCEPTION(batch->Update());
+  if (concurrentStart.timedOut)
+  {
+    std::cerr << "The registrations did not run concurrently." << std::endl;
+    return EXIT_FAILURE;
+  }
+  for (unsigned int i = 0; i < 3; i++)
+  {
+    const TransformType::ParametersType & batchParameters = batch->GetTransform(i)->GetParameters();
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      if (std::abs(batchParameters[d] - (movingCenters[i][d] - 24.0)) > 0.25)
+      {
+        std::cerr << "Concurrent registration " << i << " did not recover the translation." << std::endl;
+        return EXIT_FAILURE;
+      }
+    }
+  }
+  batch->SetNumberOfConcurrentRegistrations(2);
+
+  // A failed registration does not stop the others.
+  batch->ClearRegistrationMethods();
+  ITK_TEST_EXPECT_EQUAL(0, batch->GetNumberOfRegistrationMethods());
+  batch->AddRegistrationMethod(MakeRegistration(fixedImage, movingImages[0]));
+  RegistrationType::Pointer failingRegistration = MakeRegistration(fixedImage, movingImages[1]);
+  failingRegistration->SetNumberOfMetricSamplesPerIteration(100);
+  batch->AddRegistrationMethod(failingRegistration);
+  failingRegistration = nullptr;
+  batch->AddRegistrationMethod(MakeRegistration(fixedImage, movingImages[2]));
+  ITK_TRY_EXPECT_EXCEPTION(batch->Update());
+  if (batch->GetTransform(0) == nullptr || batch->GetTransform(2) == nullptr || batch->GetTransform(1) != nullptr ||
+      batch->GetRegistrationError(1).empty())
+  {
+    std::cerr << "The failed registration was not reported on its own." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The registrations must share the fixed image.
+  batch->ClearRegistrationMethods();
+  batch->AddRegistrationMethod(MakeRegistration(fixedImage, movingImages[0]));
+  batch->AddRegistrationMethod(MakeRegistration(MakeBlobImage(24.0, 24.0), movingImages[1]));
+  ITK_TRY_EXPECT_EXCEPTION(batch->Update());
+
+  // The registrations must share the smoothing sigmas.
+  batch->ClearRegistrationMethods();
+  batch->AddRegistrationMethod(MakeRegistration(fixedImage, movingImages[0]));
+  RegistrationType::Pointer otherSigmasRegistration = MakeRegistration(fixedImage, movingImages[1]);
+  otherSigmasRegistration->SetSmoothingSigmasAreSpecifiedInPhysicalUnits(true);
+  batch->AddRegistrationMethod(otherSigmasRegistration);
+  ITK_TRY_EXPECT_EXCEPTION(batch->Update());
+
+  ITK_TRY_EXPECT_EXCEPTION(batch->AddRegistrationMethod(nullptr));
+
+  return EXIT_SUCCESS;
+}
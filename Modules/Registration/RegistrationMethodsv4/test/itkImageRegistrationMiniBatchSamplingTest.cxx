@@ -0,0 +1,219 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Test the stochastic mini-batch sampling of SetNumberOfMetricSamplesPerIteration:
+ * the metric is evaluated on a new subset of the level samples at each
+ * optimizer iteration, the level samples are restored afterwards and the
+ * fixed sample cache follows the redrawn samples.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using OptimizerType = itk::GradientDescentOptimizerv4;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+
+constexpr itk::SizeValueType NumberOfMetricSamplesPerIteration = 150;
+
+ImageType::Pointer
+MakeBlobImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size.Fill(48);
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + dy * dy) / (2.0 * 7.0 * 7.0)));
+  }
+  return image;
+}
+
+class MiniBatchObserver : public itk::Command
+{
+public:
+  using Self = MiniBatchObserver;
+  using Superclass = itk::Command;
+  using Pointer = itk::SmartPointer<Self>;
+  itkNewMacro(Self);
+
+  void
+  Execute(itk::Object * caller, const itk::EventObject & event) override
+  {
+    Execute((const itk::Object *)caller, event);
+  }
+
+  void
+  Execute(const itk::Object *, const itk::EventObject & event) override
+  {
+    if (typeid(event) != typeid(itk::IterationEvent))
+    {
+      return;
+    }
+    // The observer is added before the registration starts, so the batch
+    // evaluated at this iteration has not been redrawn yet.
+    const MetricType::VirtualPointSetType * samples = m_Metric->GetVirtualSampledPointSet();
+    if (samples->GetNumberOfPoints() != NumberOfMetricSamplesPerIteration)
+    {
+      std::cerr << "Unexpected batch size " << samples->GetNumberOfPoints() << std::endl;
+      m_Failed = true;
+    }
+    const MetricType::VirtualPointSetType::PointType firstPoint = samples->GetPoint(0);
+    if (m_NumberOfIterations > 0 && firstPoint == m_PreviousFirstPoint)
+    {
+      ++m_NumberOfRepeatedBatches;
+    }
+    m_PreviousFirstPoint = firstPoint;
+    ++m_NumberOfIterations;
+  }
+
+  const MetricType *                         m_Metric{ nullptr };
+  MetricType::VirtualPointSetType::PointType m_PreviousFirstPoint;
+  unsigned int                               m_NumberOfIterations{ 0 };
+  unsigned int                               m_NumberOfRepeatedBatches{ 0 };
+  bool                                       m_Failed{ false };
+
+protected:
+  MiniBatchObserver() = default;
+};
+
+int
+RunMiniBatchRegistration(bool useFixedSampleCache, TransformType::ParametersType & parameters)
+{
+  MetricType::Pointer metric = MetricType::New();
+  metric->SetUseFixedSampleCache(useFixedSampleCache);
+
+  using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+  ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric(metric);
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetNumberOfIterations(60);
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetMaximumStepSizeInPhysicalUnits(0.5);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(true);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(false);
+  optimizer->SetMinimumConvergenceValue(-1.0);
+
+  MiniBatchObserver::Pointer observer = MiniBatchObserver::New();
+  observer->m_Metric = metric;
+  optimizer->AddObserver(itk::IterationEvent(), observer);
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage(MakeBlobImage(24.0, 24.0));
+  registration->SetMovingImage(MakeBlobImage(27.0, 22.0));
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetNumberOfLevels(1);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(1);
+  shrinkFactors.Fill(1);
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(1);
+  smoothingSigmas.Fill(0.0);
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  registration->SetMetricSamplingStrategy(RegistrationType::RANDOM);
+  registration->SetMetricSamplingPercentage(0.5);
+  registration->MetricSamplingReinitializeSeed(1234);
+  registration->SetNumberOfMetricSamplesPerIteration(NumberOfMetricSamplesPerIteration);
+  ITK_TEST_SET_GET_VALUE(NumberOfMetricSamplesPerIteration, registration->GetNumberOfMetricSamplesPerIteration());
+
+  ITK_TRY_EXPECT_NO_EXCEPTION(registration->Update());
+
+  if (observer->m_Failed || observer->m_NumberOfIterations != 60)
+  {
+    std::cerr << "Mini-batches were not evaluated at each of the " << observer->m_NumberOfIterations << " iterations."
+              << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (observer->m_NumberOfRepeatedBatches > 1)
+  {
+    std::cerr << "Mini-batches were not redrawn at each iteration." << std::endl;
+    return EXIT_FAILURE;
+  }
+  if (metric->GetVirtualSampledPointSet()->GetNumberOfPoints() <= NumberOfMetricSamplesPerIteration)
+  {
+    std::cerr << "The metric samples of the level were not restored." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  parameters = registration->GetModifiableTransform()->GetParameters();
+  std::cout << "Parameters with" << (useFixedSampleCache ? "" : "out") << " fixed sample cache: " << parameters
+            << std::endl;
+  return EXIT_SUCCESS;
+}
+} // namespace
+
+int
+itkImageRegistrationMiniBatchSamplingTest(int, char *[])
+{
+  TransformType::ParametersType parameters;
+  if (RunMiniBatchRegistration(false, parameters) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  if (std::abs(parameters[0] - 3.0) > 0.1 || std::abs(parameters[1] + 2.0) > 0.1)
+  {
+    std::cerr << "The translation was not recovered." << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  // The fixed sample cache must be refreshed for each batch.
+  TransformType::ParametersType cachedParameters;
+  if (RunMiniBatchRegistration(true, cachedParameters) != EXIT_SUCCESS)
+  {
+    return EXIT_FAILURE;
+  }
+  for (unsigned int d = 0; d < Dimension; d++)
+  {
+    if (std::abs(parameters[d] - cachedParameters[d]) > 1e-10)
+    {
+      std::cerr << "The fixed sample cache was not refreshed for each batch." << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+
+  // Mini-batches are drawn from the samples of a sampling strategy.
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage(MakeBlobImage(24.0, 24.0));
+  registration->SetMovingImage(MakeBlobImage(27.0, 22.0));
+  registration->SetNumberOfLevels(1);
+  registration->SetMetricSamplingStrategy(RegistrationType::NONE);
+  registration->SetNumberOfMetricSamplesPerIteration(NumberOfMetricSamplesPerIteration);
+  ITK_TRY_EXPECT_EXCEPTION(registration->Update());
+
+  return EXIT_SUCCESS;
+}
@@ -0,0 +1,153 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkImageRegistrationMethodv4.h"
+
+#include "itkGradientDescentOptimizerv4.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMeanSquaresImageToImageMetricv4.h"
+#include "itkRegistrationParameterScalesFromPhysicalShift.h"
+#include "itkTranslationTransform.h"
+#include "itkTestingMacros.h"
+
+/*
+ * Test SmoothNextLevelConcurrently: smoothing the images of the next level
+ * while the current level is registered gives the results of smoothing them
+ * when the level starts, also when the registration is run again.
+ */
+namespace
+{
+constexpr unsigned int Dimension = 2;
+using PixelType = double;
+using ImageType = itk::Image<PixelType, Dimension>;
+using MetricType = itk::MeanSquaresImageToImageMetricv4<ImageType, ImageType>;
+using OptimizerType = itk::GradientDescentOptimizerv4;
+using TransformType = itk::TranslationTransform<double, Dimension>;
+using RegistrationType = itk::ImageRegistrationMethodv4<ImageType, ImageType, TransformType>;
+
+ImageType::Pointer
+MakeBlobImage(double centerX, double centerY)
+{
+  ImageType::SizeType size;
+  size[0] = 64;
+  size[1] = 52;
+  ImageType::SpacingType spacing;
+  spacing[0] = 0.9;
+  spacing[1] = 1.2;
+  ImageType::Pointer image = ImageType::New();
+  image->SetRegions(size);
+  image->SetSpacing(spacing);
+  image->Allocate();
+
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, image->GetLargestPossibleRegion());
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const double dx = it.GetIndex()[0] - centerX;
+    const double dy = it.GetIndex()[1] - centerY;
+    it.Set(100.0 * std::exp(-(dx * dx + 2.0 * dy * dy) / (2.0 * 8.0 * 8.0)) + ((it.GetIndex()[0] * 7) % 3));
+  }
+  return image;
+}
+
+void
+RunRegistration(RegistrationType * registration, TransformType::ParametersType & parameters)
+{
+  TransformType::Pointer transform = TransformType::New();
+  transform->SetIdentity();
+  registration->SetInitialTransform(transform);
+  registration->InPlaceOn();
+  registration->Update();
+  parameters = registration->GetTransform()->GetParameters();
+}
+
+RegistrationType::Pointer
+MakeRegistration(const ImageType * fixedImage, const ImageType * movingImage, bool physicalUnits)
+{
+  MetricType::Pointer metric = MetricType::New();
+
+  using ScalesEstimatorType = itk::RegistrationParameterScalesFromPhysicalShift<MetricType>;
+  ScalesEstimatorType::Pointer scalesEstimator = ScalesEstimatorType::New();
+  scalesEstimator->SetMetric(metric);
+
+  OptimizerType::Pointer optimizer = OptimizerType::New();
+  optimizer->SetNumberOfIterations(15);
+  optimizer->SetLearningRate(1.0);
+  optimizer->SetMaximumStepSizeInPhysicalUnits(0.5);
+  optimizer->SetScalesEstimator(scalesEstimator);
+  optimizer->SetDoEstimateLearningRateOnce(false);
+  optimizer->SetDoEstimateLearningRateAtEachIteration(true);
+  optimizer->SetMinimumConvergenceValue(-1.0);
+
+  RegistrationType::Pointer registration = RegistrationType::New();
+  registration->SetFixedImage(fixedImage);
+  registration->SetMovingImage(movingImage);
+  registration->SetMetric(metric);
+  registration->SetOptimizer(optimizer);
+  registration->SetNumberOfLevels(3);
+  RegistrationType::ShrinkFactorsArrayType shrinkFactors(3);
+  shrinkFactors[0] = 4;
+  shrinkFactors[1] = 2;
+  shrinkFactors[2] = 1;
+  registration->SetShrinkFactorsPerLevel(shrinkFactors);
+  RegistrationType::SmoothingSigmasArrayType smoothingSigmas(3);
+  smoothingSigmas[0] = 3.0;
+  smoothingSigmas[1] = 1.5;
+  smoothingSigmas[2] = 0.0;
+  registration->SetSmoothingSigmasPerLevel(smoothingSigmas);
+  registration->SetSmoothingSigmasAreSpecifiedInPhysicalUnits(physicalUnits);
+  return registration;
+}
+} // namespace
+
+int
+itkImageRegistrationSmoothNextLevelTest(int, char *[])
+{
+  const ImageType::Pointer fixedImage = MakeBlobImage(30.0, 26.0);
+  const ImageType::Pointer movingImage = MakeBlobImage(33.5, 24.0);
+
+  bool passed = true;
+  for (bool physicalUnits : { true, false })
+  {
+    TransformType::ParametersType expected;
+    RegistrationType::Pointer     reference = MakeRegistration(fixedImage, movingImage, physicalUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(RunRegistration(reference, expected));
+
+    RegistrationType::Pointer registration = MakeRegistration(fixedImage, movingImage, physicalUnits);
+    ITK_TEST_SET_GET_BOOLEAN(registration, SmoothNextLevelConcurrently, false);
+    registration->SmoothNextLevelConcurrentlyOn();
+
+    // The second run must not use the images smoothed for the first one.
+    for (unsigned int run = 0; run < 2; run++)
+    {
+      TransformType::ParametersType parameters;
+      ITK_TRY_EXPECT_NO_EXCEPTION(RunRegistration(registration, parameters));
+      std::cout << "Parameters (physical units " << physicalUnits << ", run " << run << "): " << parameters
+                << std::endl;
+      for (unsigned int d = 0; d < Dimension; d++)
+      {
+        if (itk::Math::NotExactlyEquals(parameters[d], expected[d]))
+        {
+          std::cerr << "The parameters " << parameters << " differ from " << expected << std::endl;
+          passed = false;
+        }
+      }
+    }
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
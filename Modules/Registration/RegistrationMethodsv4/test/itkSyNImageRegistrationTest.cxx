@@ -26,6 +26,7 @@
 #include "itkANTSNeighborhoodCorrelationImageToImageMetricv4.h"
 #include "itkCompositeTransform.h"
 #include "itkDisplacementFieldTransformParametersAdaptor.h"
+#include "itkMemoryProbesCollectorBase.h"
 #include "itkVector.h"
 #include "itkTestingMacros.h"
 
@@ -373,10 +374,13 @@ PerformDisplacementFieldImageRegistration(int itkNotUsed(argc), char * argv[])
   typename DisplacementFieldCommandType::Pointer DisplacementFieldObserver = DisplacementFieldCommandType::New();
   displacementFieldRegistration->AddObserver(itk::IterationEvent(), DisplacementFieldObserver);
 
+  itk::MemoryProbesCollectorBase memorymeter;
   try
   {
     std::cout << "SyN registration" << std::endl;
+    memorymeter.Start("SyN registration");
     displacementFieldRegistration->Update();
+    memorymeter.Stop("SyN registration");
   }
   catch (const itk::ExceptionObject & e)
   {
@@ -384,6 +388,9 @@ PerformDisplacementFieldImageRegistration(int itkNotUsed(argc), char * argv[])
     return EXIT_FAILURE;
   }
 
+  // Report the memory taken by the registration
+  memorymeter.Report(std::cout);
+
   compositeTransform->AddTransform(outputTransform);
 
   using ResampleFilterType = itk::ResampleImageFilter<MovingImageType, FixedImageType>;
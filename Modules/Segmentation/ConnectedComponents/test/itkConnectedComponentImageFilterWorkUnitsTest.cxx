@@ -0,0 +1,152 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedComponentImageFilter.h"
+#include "itkConstNeighborhoodIterator.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <queue>
+
+/* Verifies that ConnectedComponentImageFilter, which merges the equivalences
+ * of its work units concurrently, labels a random 3D mask as a flood fill
+ * visiting the objects in raster order does, whatever the number of work
+ * units. */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using MaskImageType = itk::Image<unsigned char, Dimension>;
+using LabelImageType = itk::Image<unsigned int, Dimension>;
+
+LabelImageType::Pointer
+FloodFill(const MaskImageType * mask, bool fullyConnected, unsigned int & numberOfObjects)
+{
+  const MaskImageType::RegionType region = mask->GetLargestPossibleRegion();
+  auto                            labels = LabelImageType::New();
+  labels->SetRegions(region);
+  labels->Allocate(true);
+
+  std::vector<LabelImageType::OffsetType> offsets;
+  itk::Size<Dimension>                    radius;
+  radius.Fill(1);
+  itk::ConstNeighborhoodIterator<MaskImageType> neighborhood(radius, mask, region);
+  for (unsigned int i = 0; i < neighborhood.Size(); i++)
+  {
+    const LabelImageType::OffsetType offset = neighborhood.GetOffset(i);
+    unsigned int                     nonZero = 0;
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      nonZero += offset[d] != 0;
+    }
+    if (nonZero == 1 || (fullyConnected && nonZero > 1))
+    {
+      offsets.push_back(offset);
+    }
+  }
+
+  numberOfObjects = 0;
+  itk::ImageRegionIteratorWithIndex<LabelImageType> it(labels, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    if (mask->GetPixel(it.GetIndex()) == 0 || it.Get() != 0)
+    {
+      continue;
+    }
+    ++numberOfObjects;
+    std::queue<LabelImageType::IndexType> front;
+    front.push(it.GetIndex());
+    it.Set(numberOfObjects);
+    while (!front.empty())
+    {
+      const LabelImageType::IndexType index = front.front();
+      front.pop();
+      for (const auto & offset : offsets)
+      {
+        const LabelImageType::IndexType neighbor = index + offset;
+        if (region.IsInside(neighbor) && mask->GetPixel(neighbor) != 0 && labels->GetPixel(neighbor) == 0)
+        {
+          labels->SetPixel(neighbor, numberOfObjects);
+          front.push(neighbor);
+        }
+      }
+    }
+  }
+  return labels;
+}
+} // namespace
+
+int
+itkConnectedComponentImageFilterWorkUnitsTest(int, char *[])
+{
+  // Sparse enough to produce many objects, some of which span several work
+  // units along each direction.
+  MaskImageType::SizeType size = { { 41, 37, 33 } };
+  auto                    mask = MaskImageType::New();
+  mask->SetRegions(size);
+  mask->Allocate();
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+  itk::ImageRegionIteratorWithIndex<MaskImageType> maskIt(mask, mask->GetLargestPossibleRegion());
+  for (maskIt.GoToBegin(); !maskIt.IsAtEnd(); ++maskIt)
+  {
+    maskIt.Set(generator->GetUniformVariate(0.0, 1.0) < 0.3 ? 1 : 0);
+  }
+
+  using FilterType = itk::ConnectedComponentImageFilter<MaskImageType, LabelImageType>;
+  bool passed = true;
+  for (bool fullyConnected : { false, true })
+  {
+    unsigned int                  numberOfObjects;
+    const LabelImageType::Pointer expected = FloodFill(mask, fullyConnected, numberOfObjects);
+    std::cout << (fullyConnected ? "Fully" : "Face") << " connected objects: " << numberOfObjects << std::endl;
+
+    for (unsigned int numberOfWorkUnits : { 1, 2, 7, 33, 200 })
+    {
+      auto filter = FilterType::New();
+      filter->SetInput(mask);
+      filter->SetFullyConnected(fullyConnected);
+      filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+      ITK_TRY_EXPECT_NO_EXCEPTION(filter->Update());
+
+      if (filter->GetObjectCount() != numberOfObjects)
+      {
+        std::cerr << filter->GetObjectCount() << " objects with " << numberOfWorkUnits << " work units instead of "
+                  << numberOfObjects << std::endl;
+        passed = false;
+        continue;
+      }
+      itk::ImageRegionConstIteratorWithIndex<LabelImageType> outputIt(filter->GetOutput(),
+                                                                      filter->GetOutput()->GetBufferedRegion());
+      for (; !outputIt.IsAtEnd(); ++outputIt)
+      {
+        if (outputIt.Get() != expected->GetPixel(outputIt.GetIndex()))
+        {
+          std::cerr << "Label " << outputIt.Get() << " instead of " << expected->GetPixel(outputIt.GetIndex())
+                    << " at " << outputIt.GetIndex() << " with " << numberOfWorkUnits << " work units" << std::endl;
+          passed = false;
+          break;
+        }
+      }
+    }
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -30,6 +30,10 @@ namespace itk
  * connected to an initial Seed AND lie within a Lower and Upper
  * threshold range.
  *
+ * The region is grown by runs along the first axis, with the work split
+ * over the work units of the filter (see ParallelScanlineFloodFiller). The
+ * output does not depend on the number of work units.
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  * \sphinx
@@ -29,6 +29,9 @@ namespace itk
  * are connected to an initial Seed AND whose neighbors all lie within a
  * Lower and Upper threshold range.
  *
+ * The region is grown by runs along the first axis, with the work split
+ * over the work units of the filter (see ParallelScanlineFloodFiller).
+ *
  * \ingroup RegionGrowingSegmentation
  * \ingroup ITKRegionGrowing
  */
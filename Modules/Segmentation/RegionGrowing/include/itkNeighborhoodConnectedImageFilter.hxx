@@ -19,9 +19,9 @@
 #define itkNeighborhoodConnectedImageFilter_hxx
 
 #include "itkNeighborhoodConnectedImageFilter.h"
-#include "itkNeighborhoodBinaryThresholdImageFunction.h"
-#include "itkFloodFilledImageFunctionConditionalIterator.h"
-#include "itkProgressReporter.h"
+#include "itkParallelScanlineFloodFiller.h"
+
+#include <algorithm>
 
 namespace itk
 {
@@ -114,22 +114,71 @@ NeighborhoodConnectedImageFilter<TInputImage, TOutputImage>::GenerateData()
   outputImage->Allocate();
   outputImage->FillBuffer(NumericTraits<OutputImagePixelType>::ZeroValue());
 
-  using FunctionType = NeighborhoodBinaryThresholdImageFunction<InputImageType>;
-  using IteratorType = FloodFilledImageFunctionConditionalIterator<OutputImageType, FunctionType>;
+  // A pixel is inside when all the pixels of the neighborhood of m_Radius
+  // around it lie within the thresholds. The neighborhood is clamped to the
+  // buffered region of the input, as with a zero flux Neumann boundary.
+  const InputImagePixelType *  inputBuffer = inputImage->GetBufferPointer();
+  const InputImageRegionType & inputRegion = inputImage->GetBufferedRegion();
+  const OffsetValueType *      inputOffsetTable = inputImage->GetOffsetTable();
+  const InputImagePixelType    lower = m_Lower;
+  const InputImagePixelType    upper = m_Upper;
+  const InputImageSizeType     radius = m_Radius;
 
-  typename FunctionType::Pointer function = FunctionType::New();
-  function->SetInputImage(inputImage);
-  function->ThresholdBetween(m_Lower, m_Upper);
-  function->SetRadius(m_Radius);
-  IteratorType it = IteratorType(outputImage, function, m_Seeds);
+  auto inside = [=](const IndexType & index, SizeValueType) -> bool {
+    if (!inputRegion.IsInside(index))
+    {
+      return false;
+    }
+    IndexValueType first[InputImageDimension];
+    IndexValueType last[InputImageDimension];
+    for (unsigned int j = 0; j < InputImageDimension; ++j)
+    {
+      const IndexValueType start = inputRegion.GetIndex(j);
+      const IndexValueType end = start + static_cast<IndexValueType>(inputRegion.GetSize(j)) - 1;
+      first[j] = std::max(index[j] - static_cast<IndexValueType>(radius[j]), start) - start;
+      last[j] = std::min(index[j] + static_cast<IndexValueType>(radius[j]), end) - start;
+    }
 
-  ProgressReporter progress(this, 0, outputImage->GetRequestedRegion().GetNumberOfPixels());
-  while (!it.IsAtEnd())
-  {
-    it.Set(m_ReplaceValue);
-    ++it;
-    progress.CompletedPixel();
-  }
+    // Walk the clamped neighborhood line by line along the first axis
+    IndexValueType position[InputImageDimension];
+    std::copy(first, first + InputImageDimension, position);
+    while (true)
+    {
+      OffsetValueType lineOffset = 0;
+      for (unsigned int j = 1; j < InputImageDimension; ++j)
+      {
+        lineOffset += position[j] * inputOffsetTable[j];
+      }
+      const InputImagePixelType * lineEnd = inputBuffer + lineOffset + last[0] + 1;
+      for (const InputImagePixelType * it = inputBuffer + lineOffset + first[0]; it != lineEnd; ++it)
+      {
+        if (lower > *it || *it > upper)
+        {
+          return false;
+        }
+      }
+
+      unsigned int j = 1;
+      for (; j < InputImageDimension && position[j] == last[j]; ++j)
+      {
+        position[j] = first[j];
+      }
+      if (j == InputImageDimension)
+      {
+        return true;
+      }
+      ++position[j];
+    }
+  };
+
+  OutputImagePixelType *     outputBuffer = outputImage->GetBufferPointer();
+  const OutputImagePixelType replaceValue = m_ReplaceValue;
+  auto                       fillRun = [outputBuffer, replaceValue](SizeValueType offset, SizeValueType length) {
+    std::fill_n(outputBuffer + offset, length, replaceValue);
+  };
+
+  ParallelScanlineFloodFiller<OutputImageDimension> floodFiller(outputImage->GetBufferedRegion(), false);
+  floodFiller.Fill(m_Seeds, inside, fillRun, this);
 }
 } // end namespace itk
 
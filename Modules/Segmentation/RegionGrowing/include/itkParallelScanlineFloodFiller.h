@@ -0,0 +1,131 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelScanlineFloodFiller_h
+#define itkParallelScanlineFloodFiller_h
+
+#include "itkImageRegion.h"
+#include "itkProcessObject.h"
+
+#include <atomic>
+#include <vector>
+
+namespace itk
+{
+/** \class ParallelScanlineFloodFiller
+ * \brief Multithreaded flood fill of the region connected to a set of seeds.
+ *
+ * The fill proceeds by runs along the first (fastest) axis: a run is grown
+ * left and right from a pixel, then the pixels of the neighboring lines
+ * which touch it are queued as segments to scan for new runs. Segments are
+ * processed in rounds; in each round the pending segments are split over the
+ * work units of the calling filter, and each work unit keeps the segments
+ * it discovers in its own frontier.
+ *
+ * Pixels are claimed with an atomic bit per pixel before they are tested, so
+ * that the inside function is evaluated at most once per pixel and each
+ * filled pixel is reported by exactly one work unit. The filled region does
+ * not depend on the number of work units.
+ *
+ * This is a helper for the region growing filters; it is not a filter itself.
+ *
+ * \sa ConnectedThresholdImageFilter
+ * \sa NeighborhoodConnectedImageFilter
+ * \ingroup ITKRegionGrowing
+ */
+template <unsigned int VDimension>
+class ITK_TEMPLATE_EXPORT ParallelScanlineFloodFiller
+{
+public:
+  ITK_DISALLOW_COPY_AND_ASSIGN(ParallelScanlineFloodFiller);
+
+  static constexpr unsigned int ImageDimension = VDimension;
+
+  using RegionType = ImageRegion<VDimension>;
+  using IndexType = typename RegionType::IndexType;
+  using SizeType = typename RegionType::SizeType;
+  using SeedContainerType = std::vector<IndexType>;
+
+  /** Fill within region, using face (2*N neighbors) or full (3^N-1
+   * neighbors) connectivity. */
+  ParallelScanlineFloodFiller(const RegionType & region, bool fullyConnected);
+
+  /** Fill the pixels connected to the seeds for which
+   * inside( const IndexType & index, SizeValueType offset ) is true, where
+   * offset is the position of index in a buffer of the region. Seeds outside
+   * the region or not inside are ignored. fillRun( SizeValueType offset,
+   * SizeValueType length ) is called once for each run of filled pixels
+   * along the first axis. Both functions are called concurrently from the
+   * work units of filter, which also receives the progress and may abort
+   * the fill. */
+  template <typename TInsideFunction, typename TFillRunFunction>
+  void
+  Fill(const SeedContainerType & seeds,
+       const TInsideFunction &   inside,
+       const TFillRunFunction &  fillRun,
+       ProcessObject *           filter);
+
+private:
+  /** Pixels [m_Begin, m_End) of line m_Line to scan for new runs */
+  struct Segment
+  {
+    SizeValueType m_Line;
+    SizeValueType m_Begin;
+    SizeValueType m_End;
+  };
+  using SegmentContainerType = std::vector<Segment>;
+
+  /** Mark the pixel as visited. \return false if it already was */
+  bool
+  Claim(SizeValueType offset)
+  {
+    std::atomic<uint64_t> & word = m_Visited[offset >> 6];
+    const uint64_t          bit = uint64_t{ 1 } << (offset & 63);
+    if (word.load(std::memory_order_relaxed) & bit)
+    {
+      return false;
+    }
+    return (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+  }
+
+  /** Scan a segment, fill its runs and push the neighboring segments.
+   * \return the number of filled pixels */
+  template <typename TInsideFunction, typename TFillRunFunction>
+  SizeValueType
+  ProcessSegment(const Segment &          segment,
+                 const TInsideFunction &  inside,
+                 const TFillRunFunction & fillRun,
+                 SegmentContainerType &   frontier);
+
+  RegionType    m_Region;
+  bool          m_FullyConnected;
+  SizeValueType m_LineLength;
+
+  /** Position of the neighboring lines, relative to the current one, along
+   * the axes but the first one */
+  std::vector<IndexType> m_LineNeighbors;
+  SizeValueType          m_LineStrides[VDimension];
+
+  std::vector<std::atomic<uint64_t>> m_Visited;
+};
+} // end namespace itk
+
+#ifndef ITK_MANUAL_INSTANTIATION
+#  include "itkParallelScanlineFloodFiller.hxx"
+#endif
+
+#endif
@@ -0,0 +1,230 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+#ifndef itkParallelScanlineFloodFiller_hxx
+#define itkParallelScanlineFloodFiller_hxx
+
+#include "itkParallelScanlineFloodFiller.h"
+#include "itkMultiThreaderBase.h"
+
+#include <algorithm>
+
+namespace itk
+{
+
+template <unsigned int VDimension>
+ParallelScanlineFloodFiller<VDimension>::ParallelScanlineFloodFiller(const RegionType & region, bool fullyConnected)
+  : m_Region(region)
+  , m_FullyConnected(fullyConnected)
+  , m_LineLength(region.GetSize(0))
+  , m_Visited((region.GetNumberOfPixels() + 63) / 64)
+{
+  m_LineStrides[0] = 0;
+  for (unsigned int j = 1; j < ImageDimension; ++j)
+  {
+    m_LineStrides[j] = (j == 1) ? 1 : m_LineStrides[j - 1] * region.GetSize(j - 1);
+  }
+
+  // Neighboring lines: one step along one axis for face connectivity, any
+  // combination of steps for full connectivity
+  SizeValueType numberOfCombinations = 1;
+  for (unsigned int j = 1; j < ImageDimension; ++j)
+  {
+    numberOfCombinations *= 3;
+  }
+  for (SizeValueType combination = 0; combination < numberOfCombinations; ++combination)
+  {
+    IndexType     neighbor;
+    SizeValueType remainder = combination;
+    unsigned int  numberOfSteps = 0;
+    neighbor[0] = 0;
+    for (unsigned int j = 1; j < ImageDimension; ++j)
+    {
+      neighbor[j] = static_cast<IndexValueType>(remainder % 3) - 1;
+      remainder /= 3;
+      numberOfSteps += (neighbor[j] != 0) ? 1 : 0;
+    }
+    if (numberOfSteps == 1 || (numberOfSteps > 1 && m_FullyConnected))
+    {
+      m_LineNeighbors.push_back(neighbor);
+    }
+  }
+}
+
+template <unsigned int VDimension>
+template <typename TInsideFunction, typename TFillRunFunction>
+void
+ParallelScanlineFloodFiller<VDimension>::Fill(const SeedContainerType & seeds,
+                                              const TInsideFunction &   inside,
+                                              const TFillRunFunction &  fillRun,
+                                              ProcessObject *           filter)
+{
+  SegmentContainerType frontier;
+  for (const IndexType & seed : seeds)
+  {
+    if (m_Region.IsInside(seed))
+    {
+      SizeValueType line = 0;
+      for (unsigned int j = 1; j < ImageDimension; ++j)
+      {
+        line += static_cast<SizeValueType>(seed[j] - m_Region.GetIndex(j)) * m_LineStrides[j];
+      }
+      const auto x = static_cast<SizeValueType>(seed[0] - m_Region.GetIndex(0));
+      frontier.push_back(Segment{ line, x, x + 1 });
+    }
+  }
+
+  // Segments a work unit processes in a round before handing the rest of its
+  // frontier back for redistribution. A single work unit never needs to.
+  constexpr SizeValueType segmentsPerRound = 4096;
+
+  MultiThreaderBase * multiThreader = filter->GetMultiThreader();
+  const ThreadIdType  numberOfWorkUnits = std::max(filter->GetNumberOfWorkUnits(), ThreadIdType{ 1 });
+  const SizeValueType budget = (numberOfWorkUnits == 1) ? NumericTraits<SizeValueType>::max() : segmentsPerRound;
+  const SizeValueType numberOfPixels = m_Region.GetNumberOfPixels();
+  SizeValueType       numberOfFilledPixels = 0;
+
+  while (!frontier.empty())
+  {
+    const auto numberOfChunks =
+      static_cast<ThreadIdType>(std::min(static_cast<SizeValueType>(numberOfWorkUnits), frontier.size()));
+
+    std::vector<SegmentContainerType> frontiers(numberOfChunks);
+    std::vector<SizeValueType>        filledPixels(numberOfChunks, 0);
+
+    multiThreader->SetNumberOfWorkUnits(numberOfChunks);
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfChunks,
+      [&](SizeValueType chunk) {
+        // Take a share of the frontier, last segment on top
+        const SizeValueType    first = chunk * frontier.size() / numberOfChunks;
+        const SizeValueType    last = (chunk + 1) * frontier.size() / numberOfChunks;
+        SegmentContainerType & localFrontier = frontiers[chunk];
+        localFrontier.assign(frontier.begin() + first, frontier.begin() + last);
+        std::reverse(localFrontier.begin(), localFrontier.end());
+
+        for (SizeValueType n = 0; n < budget && !localFrontier.empty(); ++n)
+        {
+          const Segment segment = localFrontier.back();
+          localFrontier.pop_back();
+          filledPixels[chunk] += this->ProcessSegment(segment, inside, fillRun, localFrontier);
+        }
+      },
+      nullptr);
+
+    frontier.clear();
+    for (ThreadIdType chunk = 0; chunk < numberOfChunks; ++chunk)
+    {
+      frontier.insert(frontier.end(), frontiers[chunk].begin(), frontiers[chunk].end());
+      numberOfFilledPixels += filledPixels[chunk];
+    }
+
+    filter->UpdateProgress(static_cast<float>(numberOfFilledPixels) / static_cast<float>(numberOfPixels));
+    if (filter->GetAbortGenerateData())
+    {
+      std::string    msg;
+      ProcessAborted e(__FILE__, __LINE__);
+      msg += "Object " + std::string(filter->GetNameOfClass()) + ": AbortGenerateDataOn";
+      e.SetDescription(msg);
+      throw e;
+    }
+  }
+}
+
+template <unsigned int VDimension>
+template <typename TInsideFunction, typename TFillRunFunction>
+SizeValueType
+ParallelScanlineFloodFiller<VDimension>::ProcessSegment(const Segment &          segment,
+                                                        const TInsideFunction &  inside,
+                                                        const TFillRunFunction & fillRun,
+                                                        SegmentContainerType &   frontier)
+{
+  const SizeType &  size = m_Region.GetSize();
+  const IndexType & start = m_Region.GetIndex();
+
+  // Index of the line
+  IndexType     index = start;
+  SizeValueType remainder = segment.m_Line;
+  for (unsigned int j = 1; j < ImageDimension; ++j)
+  {
+    index[j] += static_cast<IndexValueType>(remainder % size[j]);
+    remainder /= size[j];
+  }
+  const SizeValueType lineOffset = segment.m_Line * m_LineLength;
+
+  auto isInside = [&](SizeValueType x) -> bool {
+    index[0] = start[0] + static_cast<IndexValueType>(x);
+    return inside(static_cast<const IndexType &>(index), lineOffset + x);
+  };
+
+  SizeValueType numberOfFilledPixels = 0;
+  SizeValueType x = segment.m_Begin;
+  while (x < segment.m_End)
+  {
+    if (!this->Claim(lineOffset + x) || !isInside(x))
+    {
+      ++x;
+      continue;
+    }
+
+    // Grow the run in both directions
+    SizeValueType first = x;
+    while (first > 0 && this->Claim(lineOffset + first - 1) && isInside(first - 1))
+    {
+      --first;
+    }
+    SizeValueType last = x + 1;
+    while (last < m_LineLength && this->Claim(lineOffset + last) && isInside(last))
+    {
+      ++last;
+    }
+
+    fillRun(lineOffset + first, last - first);
+    numberOfFilledPixels += last - first;
+
+    // Scan the neighboring lines along the run, one pixel further at both
+    // ends for full connectivity
+    const SizeValueType begin = (m_FullyConnected && first > 0) ? first - 1 : first;
+    const SizeValueType end = (m_FullyConnected && last < m_LineLength) ? last + 1 : last;
+    for (const IndexType & neighbor : m_LineNeighbors)
+    {
+      OffsetValueType line = static_cast<OffsetValueType>(segment.m_Line);
+      bool            isInRegion = true;
+      for (unsigned int j = 1; j < ImageDimension && isInRegion; ++j)
+      {
+        const IndexValueType position = index[j] - start[j] + neighbor[j];
+        isInRegion = position >= 0 && position < static_cast<IndexValueType>(size[j]);
+        line += neighbor[j] * static_cast<OffsetValueType>(m_LineStrides[j]);
+      }
+      if (isInRegion)
+      {
+        frontier.push_back(Segment{ static_cast<SizeValueType>(line), begin, end });
+      }
+    }
+
+    // The pixel after the run is either filled by another work unit or
+    // outside
+    x = last + 1;
+  }
+
+  return numberOfFilledPixels;
+}
+
+} // end namespace itk
+
+#endif
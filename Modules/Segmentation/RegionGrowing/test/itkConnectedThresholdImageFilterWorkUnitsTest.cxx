@@ -0,0 +1,200 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkConnectedThresholdImageFilter.h"
+#include "itkNeighborhoodConnectedImageFilter.h"
+#include "itkBinaryThresholdImageFunction.h"
+#include "itkNeighborhoodBinaryThresholdImageFunction.h"
+#include "itkFloodFilledImageFunctionConditionalIterator.h"
+#include "itkShapedFloodFilledImageFunctionConditionalIterator.h"
+#include "itkImageRegionIterator.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+// Check that the region growing filters fill the same region as the flood
+// filled iterators, whatever the number of work units.
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<unsigned char, Dimension>;
+using IndexType = ImageType::IndexType;
+using IndexValueType = itk::IndexValueType;
+using SeedContainerType = std::vector<IndexType>;
+
+template <typename TIterator>
+ImageType::Pointer
+FillWithIterator(TIterator & it, const ImageType * input)
+{
+  ImageType::Pointer output = ImageType::New();
+  output->CopyInformation(input);
+  output->SetRegions(input->GetBufferedRegion());
+  output->Allocate(true);
+
+  it.GoToBegin();
+  while (!it.IsAtEnd())
+  {
+    output->SetPixel(it.GetIndex(), 255);
+    ++it;
+  }
+  return output;
+}
+
+bool
+SameImages(const ImageType * expected, const ImageType * output, const std::string & what)
+{
+  itk::ImageRegionConstIterator<ImageType> expectedIt(expected, expected->GetBufferedRegion());
+  itk::ImageRegionConstIterator<ImageType> outputIt(output, expected->GetBufferedRegion());
+  itk::SizeValueType                       numberOfDifferences = 0;
+  itk::SizeValueType                       numberOfFilledPixels = 0;
+  for (; !expectedIt.IsAtEnd(); ++expectedIt, ++outputIt)
+  {
+    numberOfDifferences += (expectedIt.Get() != outputIt.Get()) ? 1 : 0;
+    numberOfFilledPixels += (expectedIt.Get() != 0) ? 1 : 0;
+  }
+  if (numberOfDifferences != 0 || numberOfFilledPixels < 100)
+  {
+    std::cerr << "Test failed for " << what << ": " << numberOfDifferences << " different pixels, "
+              << numberOfFilledPixels << " filled pixels expected" << std::endl;
+    return false;
+  }
+  return true;
+}
+} // namespace
+
+int
+itkConnectedThresholdImageFilterWorkUnitsTest(int, char *[])
+{
+  // Random image, with a region that does not start at the origin
+  ImageType::RegionType region;
+  region.SetIndex({ { -3, 5, 2 } });
+  region.SetSize({ { 37, 29, 23 } });
+  ImageType::Pointer input = ImageType::New();
+  input->SetRegions(region);
+  input->Allocate();
+
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+  for (itk::ImageRegionIterator<ImageType> it(input, region); !it.IsAtEnd(); ++it)
+  {
+    it.Set(static_cast<unsigned char>(generator->GetIntegerVariate(255)));
+  }
+
+  // Seeds and their neighbors along the first axis set within the thresholds, one of them outside the image
+  SeedContainerType seeds;
+  seeds.push_back({ { 0, 10, 10 } });
+  seeds.push_back({ { 30, 30, 20 } });
+  seeds.push_back({ { 100, 10, 10 } });
+  seeds.push_back({ { 20, 25, 5 } });
+  for (const IndexType & seed : seeds)
+  {
+    for (IndexValueType x = -1; x <= 1; ++x)
+    {
+      IndexType index = seed;
+      index[0] += x;
+      if (region.IsInside(index))
+      {
+        input->SetPixel(index, 50);
+      }
+    }
+  }
+
+  bool testPassed = true;
+
+  // ConnectedThresholdImageFilter
+  constexpr unsigned char lower = 20;
+  constexpr unsigned char upper = 120;
+
+  using FunctionType = itk::BinaryThresholdImageFunction<ImageType, double>;
+  FunctionType::Pointer function = FunctionType::New();
+  function->SetInputImage(input);
+  function->ThresholdBetween(lower, upper);
+
+  itk::FloodFilledImageFunctionConditionalConstIterator<ImageType, FunctionType> faceIt(input, function, seeds);
+  const ImageType::Pointer expectedFace = FillWithIterator(faceIt, input);
+
+  itk::ShapedFloodFilledImageFunctionConditionalConstIterator<ImageType, FunctionType> fullIt(input, function, seeds);
+  fullIt.FullyConnectedOn();
+  const ImageType::Pointer expectedFull = FillWithIterator(fullIt, input);
+
+  using ConnectedThresholdFilterType = itk::ConnectedThresholdImageFilter<ImageType, ImageType>;
+  ConnectedThresholdFilterType::Pointer connectedThreshold = ConnectedThresholdFilterType::New();
+  connectedThreshold->SetInput(input);
+  connectedThreshold->SetLower(lower);
+  connectedThreshold->SetUpper(upper);
+  connectedThreshold->SetReplaceValue(255);
+  for (const IndexType & seed : seeds)
+  {
+    connectedThreshold->AddSeed(seed);
+  }
+
+  // NeighborhoodConnectedImageFilter
+  constexpr unsigned char neighborhoodUpper = 220;
+  constexpr unsigned char neighborhoodLower = 10;
+  ImageType::SizeType     radius = { { 1, 0, 0 } };
+
+  using NeighborhoodFunctionType = itk::NeighborhoodBinaryThresholdImageFunction<ImageType>;
+  NeighborhoodFunctionType::Pointer neighborhoodFunction = NeighborhoodFunctionType::New();
+  neighborhoodFunction->SetInputImage(input);
+  neighborhoodFunction->ThresholdBetween(neighborhoodLower, neighborhoodUpper);
+  neighborhoodFunction->SetRadius(radius);
+
+  itk::FloodFilledImageFunctionConditionalConstIterator<ImageType, NeighborhoodFunctionType> neighborhoodIt(
+    input, neighborhoodFunction, seeds);
+  const ImageType::Pointer expectedNeighborhood = FillWithIterator(neighborhoodIt, input);
+
+  using NeighborhoodConnectedFilterType = itk::NeighborhoodConnectedImageFilter<ImageType, ImageType>;
+  NeighborhoodConnectedFilterType::Pointer neighborhoodConnected = NeighborhoodConnectedFilterType::New();
+  neighborhoodConnected->SetInput(input);
+  neighborhoodConnected->SetLower(neighborhoodLower);
+  neighborhoodConnected->SetUpper(neighborhoodUpper);
+  neighborhoodConnected->SetRadius(radius);
+  neighborhoodConnected->SetReplaceValue(255);
+  for (const IndexType & seed : seeds)
+  {
+    neighborhoodConnected->AddSeed(seed);
+  }
+
+  for (itk::ThreadIdType numberOfWorkUnits : { 1, 2, 3, 8 })
+  {
+    const std::string workUnits = " with " + std::to_string(numberOfWorkUnits) + " work units";
+
+    connectedThreshold->SetNumberOfWorkUnits(numberOfWorkUnits);
+    connectedThreshold->SetConnectivity(ConnectedThresholdFilterType::FaceConnectivity);
+    ITK_TRY_EXPECT_NO_EXCEPTION(connectedThreshold->Update());
+    testPassed &= SameImages(expectedFace, connectedThreshold->GetOutput(), "face connectivity" + workUnits);
+
+    connectedThreshold->SetConnectivity(ConnectedThresholdFilterType::FullConnectivity);
+    ITK_TRY_EXPECT_NO_EXCEPTION(connectedThreshold->Update());
+    testPassed &= SameImages(expectedFull, connectedThreshold->GetOutput(), "full connectivity" + workUnits);
+
+    neighborhoodConnected->SetNumberOfWorkUnits(numberOfWorkUnits);
+    ITK_TRY_EXPECT_NO_EXCEPTION(neighborhoodConnected->Update());
+    testPassed &=
+      SameImages(expectedNeighborhood, neighborhoodConnected->GetOutput(), "neighborhood connected" + workUnits);
+  }
+
+  if (!testPassed)
+  {
+    return EXIT_FAILURE;
+  }
+
+  std::cout << "Test finished." << std::endl;
+  return EXIT_SUCCESS;
+}
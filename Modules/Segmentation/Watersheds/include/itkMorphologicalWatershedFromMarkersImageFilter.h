@@ -19,6 +19,10 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_h
 
 #include "itkImageToImageFilter.h"
+#include <algorithm>
+#include <map>
+#include <type_traits>
+#include <vector>
 
 namespace itk
 {
@@ -60,6 +64,14 @@ namespace itk
  * the markers. The labels of the output image are the label of the marker
  * image.
  *
+ * The pixels adjacent to the markers are collected in parallel. The flooding
+ * itself is sequential by default, because the order in which the pixels of a
+ * gray level are flooded decides where the regions meet. ParallelFlooding
+ * floods the pixels of a gray level in parallel instead, see
+ * SetParallelFlooding(). The flooding works on the buffer offsets of the
+ * pixels, and its hierarchical queue is an array of buckets, one per gray
+ * level, for the integer pixel types of up to 16 bits.
+ *
  * The morphological watershed transform algorithm is described in
  * Chapter 9.2 of Pierre Soille's book "Morphological Image Analysis:
  * Principles and Applications", Second Edition, Springer, 2003.
@@ -161,6 +173,26 @@ public:
   itkGetConstReferenceMacro(MarkWatershedLine, bool);
   itkBooleanMacro(MarkWatershedLine);
 
+  /**
+   * Set/Get whether the pixels of a gray level are flooded in parallel.
+   * Default is false.
+   *
+   * The gray levels are flooded in increasing order as usual, but the pixels
+   * of a gray level are flooded front by front: the pixels of a front all
+   * get their label from the pixels flooded before the front, and queue the
+   * pixels of the next front. Where several markers reach a plateau, the
+   * regions may then meet elsewhere than with the sequential flooding. With
+   * MarkWatershedLine, a pixel of a front is also marked as watershed when a
+   * neighbor before it in the buffer gets another label in the same front,
+   * so that the watershed lines may differ and be thicker. The result does
+   * not depend on the number of work units. The parallel flooding visits
+   * the neighbors of the pixels up to three times, and uses an additional
+   * byte per pixel, so that it only pays off with several cores.
+   */
+  itkSetMacro(ParallelFlooding, bool);
+  itkGetConstReferenceMacro(ParallelFlooding, bool);
+  itkBooleanMacro(ParallelFlooding);
+
 protected:
   MorphologicalWatershedFromMarkersImageFilter();
   ~MorphologicalWatershedFromMarkersImageFilter() override = default;
@@ -179,14 +211,152 @@ protected:
   void
   EnlargeOutputRequestedRegion(DataObject * itkNotUsed(output)) override;
 
-  /** The filter is single threaded. */
+  /** The markers are processed by several work units, the flooding by a
+   * single one unless ParallelFlooding is on. */
   void
   GenerateData() override;
 
 private:
+  /** Hierarchical queue of the flooding: the buffer offsets of the pixels, by
+   * increasing gray level, and first in, first out within a gray level.  The
+   * pixels of the level being flooded are moved out of the queue. */
+  template <typename TLevels>
+  class HierarchicalQueue
+  {
+  public:
+    void
+    Push(const InputImagePixelType & value, OffsetValueType offset)
+    {
+      m_Levels.Push(value, offset);
+    }
+
+    /** Push a pixel at the level being flooded. */
+    void
+    PushCurrent(OffsetValueType offset)
+    {
+      m_Current.push_back(offset);
+    }
+
+    bool
+    Pop(OffsetValueType & offset)
+    {
+      if (m_Head == m_Current.size())
+      {
+        return false;
+      }
+      offset = m_Current[m_Head++];
+      return true;
+    }
+
+    /** Start flooding the lowest gray level of the queue. */
+    bool
+    NextLevel(InputImagePixelType & value)
+    {
+      m_Current.clear();
+      m_Head = 0;
+      return m_Levels.PopLowest(value, m_Current);
+    }
+
+    /** Move the pixels of the lowest gray level of the queue to an empty
+     * vector, for the parallel flooding. */
+    bool
+    NextLevel(InputImagePixelType & value, std::vector<OffsetValueType> & offsets)
+    {
+      return m_Levels.PopLowest(value, offsets);
+    }
+
+  private:
+    TLevels                      m_Levels;
+    std::vector<OffsetValueType> m_Current;
+    size_t                       m_Head{ 0 };
+  };
+
+  /** The gray levels of a hierarchical queue, in a map. */
+  class MapLevels
+  {
+  public:
+    void
+    Push(const InputImagePixelType & value, OffsetValueType offset)
+    {
+      m_Levels[value].push_back(offset);
+    }
+
+    bool
+    PopLowest(InputImagePixelType & value, std::vector<OffsetValueType> & offsets)
+    {
+      if (m_Levels.empty())
+      {
+        return false;
+      }
+      value = m_Levels.begin()->first;
+      offsets.swap(m_Levels.begin()->second);
+      m_Levels.erase(m_Levels.begin());
+      return true;
+    }
+
+  private:
+    std::map<InputImagePixelType, std::vector<OffsetValueType>> m_Levels;
+  };
+
+  /** The gray levels of a hierarchical queue, in one bucket per value of a
+   * small integer type.  The pixels are always pushed above the level being
+   * flooded, so that the buckets are visited once. */
+  class BucketLevels
+  {
+  public:
+    BucketLevels()
+      : m_Buckets(size_t{ 1 } << (8 * sizeof(InputImagePixelType)))
+    {}
+
+    void
+    Push(const InputImagePixelType & value, OffsetValueType offset)
+    {
+      const size_t bucket = ToBucket(value);
+      m_Buckets[bucket].push_back(offset);
+      m_Lowest = std::min(m_Lowest, bucket);
+    }
+
+    bool
+    PopLowest(InputImagePixelType & value, std::vector<OffsetValueType> & offsets)
+    {
+      while (m_Lowest < m_Buckets.size() && m_Buckets[m_Lowest].empty())
+      {
+        ++m_Lowest;
+      }
+      if (m_Lowest == m_Buckets.size())
+      {
+        return false;
+      }
+      value = static_cast<InputImagePixelType>(static_cast<long long>(m_Lowest) +
+                                               NumericTraits<InputImagePixelType>::NonpositiveMin());
+      offsets.swap(m_Buckets[m_Lowest]);
+      std::vector<OffsetValueType>().swap(m_Buckets[m_Lowest]);
+      return true;
+    }
+
+  private:
+    static size_t
+    ToBucket(const InputImagePixelType & value)
+    {
+      return static_cast<size_t>(static_cast<long long>(value) -
+                                 static_cast<long long>(NumericTraits<InputImagePixelType>::NonpositiveMin()));
+    }
+
+    std::vector<std::vector<OffsetValueType>> m_Buckets;
+    size_t                                    m_Lowest{ 0 };
+  };
+
+  using QueueType = HierarchicalQueue<typename std::conditional<std::is_integral<InputImagePixelType>::value &&
+                                                                  !std::is_same<InputImagePixelType, bool>::value &&
+                                                                  sizeof(InputImagePixelType) <= 2,
+                                                                BucketLevels,
+                                                                MapLevels>::type>;
+
   bool m_FullyConnected{ false };
 
   bool m_MarkWatershedLine{ true };
+
+  bool m_ParallelFlooding{ false };
 }; // end of class
 } // end namespace itk
 
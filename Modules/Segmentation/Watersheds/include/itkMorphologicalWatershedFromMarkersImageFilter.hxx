@@ -19,10 +19,14 @@
 #define itkMorphologicalWatershedFromMarkersImageFilter_hxx
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <queue>
 #include <list>
 #include "itkMorphologicalWatershedFromMarkersImageFilter.h"
 #include "itkProgressReporter.h"
+#include "itkProgressTransformer.h"
 #include "itkImageRegionIterator.h"
 #include "itkImageRegionConstIteratorWithIndex.h"
 #include "itkConstShapedNeighborhoodIterator.h"
@@ -86,7 +90,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   // The 2 algorithms are very similar and so are integrated in the same filter.
 
   //---------------------------------------------------------------------------
-  // declare the vars common to the 2 algorithms: constants, iterators,
+  // declare the vars common to the 2 algorithms: constants, neighbor offsets,
   // hierarchical queue, progress reporter, and status image
   // also allocate output images and verify preconditions
   //---------------------------------------------------------------------------
@@ -102,214 +106,412 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
   const InputImageType * inputImage = this->GetInput();
   LabelImageType *       outputImage = this->GetOutput();
 
-  // Set up the progress reporter
-  // we can't found the exact number of pixel to process in the 2nd pass, so we
-  // use the maximum number possible.
-  ProgressReporter progress(this, 0, markerImage->GetRequestedRegion().GetNumberOfPixels() * 2);
-
   // mask and marker must have the same size
   if (markerImage->GetRequestedRegion().GetSize() != inputImage->GetRequestedRegion().GetSize())
   {
     itkExceptionMacro(<< "Marker and input must have the same size.");
   }
 
+  // The whole images are buffered, so that the pixels are addressed by their
+  // offset in the buffers.
+  const typename LabelImageType::SizeType size = outputImage->GetBufferedRegion().GetSize();
+  const LabelImagePixelType *             markerBuffer = markerImage->GetBufferPointer();
+  const InputImagePixelType *             inputBuffer = inputImage->GetBufferPointer();
+  LabelImagePixelType *                   outputBuffer = outputImage->GetBufferPointer();
+
+  OffsetValueType strides[ImageDimension];
+  strides[0] = 1;
+  for (unsigned int d = 1; d < ImageDimension; d++)
+  {
+    strides[d] = strides[d - 1] * static_cast<OffsetValueType>(size[d - 1]);
+  }
+
+  // The neighbors, in the order of the shaped neighborhood iterators set up
+  // by setConnectivity().
+  using OffsetType = typename LabelImageType::OffsetType;
+  std::vector<OffsetType>      neighborOffsets;
+  std::vector<OffsetValueType> neighborBufferOffsets;
+  unsigned int                 numberOfPositions = 1;
+  for (unsigned int d = 0; d < ImageDimension; d++)
+  {
+    numberOfPositions *= 3;
+  }
+  for (unsigned int position = 0; position < numberOfPositions; position++)
+  {
+    OffsetType      offset;
+    OffsetValueType bufferOffset = 0;
+    unsigned int    numberOfNonZero = 0;
+    for (unsigned int d = 0, remainder = position; d < ImageDimension; d++, remainder /= 3)
+    {
+      offset[d] = static_cast<OffsetValueType>(remainder % 3) - 1;
+      bufferOffset += offset[d] * strides[d];
+      numberOfNonZero += (offset[d] != 0);
+    }
+    if (numberOfNonZero == 1 || (m_FullyConnected && numberOfNonZero > 1))
+    {
+      neighborOffsets.push_back(offset);
+      neighborBufferOffsets.push_back(bufferOffset);
+    }
+  }
+  const unsigned int numberOfNeighbors = static_cast<unsigned int>(neighborOffsets.size());
+
+  // Fills the buffer offsets of the neighbors of a pixel, -1 for the
+  // neighbors outside of the image.
+  auto computeNeighbors = [&](OffsetValueType pixel, OffsetValueType * neighbors) {
+    IndexType index;
+    bool      inside = true;
+    for (unsigned int d = 0; d < ImageDimension; d++)
+    {
+      index[d] = (pixel / strides[d]) % static_cast<OffsetValueType>(size[d]);
+      inside = inside && index[d] > 0 && index[d] + 1 < static_cast<OffsetValueType>(size[d]);
+    }
+    for (unsigned int n = 0; n < numberOfNeighbors; n++)
+    {
+      neighbors[n] = pixel + neighborBufferOffsets[n];
+      for (unsigned int d = 0; !inside && d < ImageDimension; d++)
+      {
+        const OffsetValueType neighborIndex = index[d] + neighborOffsets[n][d];
+        if (neighborIndex < 0 || neighborIndex >= static_cast<OffsetValueType>(size[d]))
+        {
+          neighbors[n] = -1;
+          break;
+        }
+      }
+    }
+  };
+
+  // The markers are processed by blocks of slices along the last dimension,
+  // so that the pixels of a block are contiguous in the buffers, and the
+  // pixels to flood first are queued in the order of a raster scan.
+  MultiThreaderBase * multiThreader = this->GetMultiThreader();
+  multiThreader->SetNumberOfWorkUnits(this->GetNumberOfWorkUnits());
+  const SizeValueType numberOfSlices = size[ImageDimension - 1];
+  const SizeValueType numberOfBlocks =
+    std::min<SizeValueType>(numberOfSlices, 4 * static_cast<SizeValueType>(this->GetNumberOfWorkUnits()));
+  std::vector<std::vector<OffsetValueType>> blockSeeds(numberOfBlocks);
+  auto blockBegin = [&](SizeValueType block) -> OffsetValueType {
+    return static_cast<OffsetValueType>(block * numberOfSlices / numberOfBlocks) * strides[ImageDimension - 1];
+  };
+
   // FAH (in french: File d'Attente Hierarchique)
-  using QueueType = std::queue<IndexType>;
-  using MapType = std::map<InputImagePixelType, QueueType>;
-  MapType fah;
-
-  // the radius which will be used for all the shaped iterators
-  Size<ImageDimension> radius;
-  radius.Fill(1);
-
-  // iterator for the marker image
-  using MarkerIteratorType = ConstShapedNeighborhoodIterator<LabelImageType>;
-  typename MarkerIteratorType::ConstIterator nmIt;
-  MarkerIteratorType                         markerIt(radius, markerImage, markerImage->GetRequestedRegion());
-  // add a boundary constant to avoid adding pixels on the border in the fah
-  ConstantBoundaryCondition<LabelImageType> lcbc;
-  lcbc.SetConstant(NumericTraits<LabelImagePixelType>::max());
-  markerIt.OverrideBoundaryCondition(&lcbc);
-  setConnectivity(&markerIt, m_FullyConnected);
-
-  // iterator for the input image
-  using InputIteratorType = ConstShapedNeighborhoodIterator<InputImageType>;
-  InputIteratorType                         inputIt(radius, inputImage, inputImage->GetRequestedRegion());
-  typename InputIteratorType::ConstIterator niIt;
-  setConnectivity(&inputIt, m_FullyConnected);
-
-  // iterator for the output image
-  using OutputIteratorType = ShapedNeighborhoodIterator<LabelImageType>;
-  using OffsetType = typename OutputIteratorType::OffsetType;
-  typename OutputIteratorType::Iterator noIt;
-  OutputIteratorType                    outputIt(radius, outputImage, outputImage->GetRequestedRegion());
-  setConnectivity(&outputIt, m_FullyConnected);
+  QueueType fah;
+
+  // we can't found the exact number of pixel to process in the flooding, so
+  // we use the maximum number possible.
+  const SizeValueType numberOfPixels = outputImage->GetBufferedRegion().GetNumberOfPixels();
+  ProgressTransformer initProgress(0.0f, 0.5f, this);
+
+  std::vector<OffsetValueType> neighbors(numberOfNeighbors);
+
+  // The parallel flooding processes the pixels of a front by chunks, in
+  // parallel when the front is large enough.  Each chunk collects the pixels
+  // it queues, and the chunks are merged in order.  Each pixel has a state,
+  // which the chunks update atomically.
+  enum PixelState : unsigned char
+  {
+    FreePixel,
+    QueuedPixel,
+    FrontPixel,
+    DonePixel
+  };
+  using PixelStateArrayType = std::unique_ptr<std::atomic<unsigned char>[]>;
+  using ChunkFunctionType = std::function<void(SizeValueType, SizeValueType, SizeValueType)>;
+  constexpr SizeValueType minimumChunkSize = 4096;
+  const SizeValueType     maximumNumberOfChunks = 4 * static_cast<SizeValueType>(this->GetNumberOfWorkUnits());
+  std::vector<std::vector<OffsetValueType>> chunkPixels(maximumNumberOfChunks);
+  auto forEachChunk = [&](SizeValueType numberOfElements, const ChunkFunctionType & function) {
+    const SizeValueType numberOfChunks =
+      std::max<SizeValueType>(1, std::min(maximumNumberOfChunks, numberOfElements / minimumChunkSize));
+    auto processChunk = [&](SizeValueType chunk) {
+      function(chunk * numberOfElements / numberOfChunks, (chunk + 1) * numberOfElements / numberOfChunks, chunk);
+    };
+    if (numberOfChunks == 1)
+    {
+      processChunk(0);
+    }
+    else
+    {
+      multiThreader->ParallelizeArray(0, numberOfChunks, processChunk, nullptr);
+    }
+  };
 
   //---------------------------------------------------------------------------
   // Meyer's algorithm
   //---------------------------------------------------------------------------
   if (m_MarkWatershedLine)
   {
-    // first stage:
-    //  - set markers pixels to already processed status
-    //  - copy markers pixels to output image
-    //  - init FAH with indexes of background pixels with marker pixel(s) in
-    //    their neighborhood
-
-    ConstantBoundaryCondition<LabelImageType> lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(wsLabel);
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
     // create a temporary image to store the state of each pixel (processed or
     // not)
     using StatusImageType = Image<bool, ImageDimension>;
     typename StatusImageType::Pointer statusImage = StatusImageType::New();
     statusImage->SetRegions(markerImage->GetLargestPossibleRegion());
     statusImage->Allocate();
+    bool * statusBuffer = statusImage->GetBufferPointer();
 
-    // iterator for the status image
-    using StatusIteratorType = ShapedNeighborhoodIterator<StatusImageType>;
-    typename StatusIteratorType::Iterator      nsIt;
-    StatusIteratorType                         statusIt(radius, statusImage, outputImage->GetRequestedRegion());
-    ConstantBoundaryCondition<StatusImageType> bcbc;
-    bcbc.SetConstant(true); // outside pixel are already processed
-    statusIt.OverrideBoundaryCondition(&bcbc);
-    setConnectivity(&statusIt, m_FullyConnected);
-
-    // the status image must be initialized before the first stage. In the
-    // first stage, the set to true are the neighbors of the marker (and the
-    // marker) so it's difficult (impossible ?) to init the status image at
-    // the same time
-    // the overhead should be small
-    statusImage->FillBuffer(false);
-
-    for (markerIt.GoToBegin(), statusIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin(); !markerIt.IsAtEnd();
-         ++markerIt, ++outputIt)
-    {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
-      if (markerPixel != bgLabel)
-      {
-        IndexType idx = markerIt.GetIndex();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - statusIt.GetIndex();
-        statusIt += shift;
-        inputIt += shift;
-
-        // this pixel belongs to a marker
-        // mark it as already processed
-        statusIt.SetCenterPixel(true);
-        // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
-        // and increase progress because this pixel will not be used in the
-        // flooding stage.
-        progress.CompletedPixel();
-
-        // search the background pixels in the neighborhood
-        for (nmIt = markerIt.Begin(), nsIt = statusIt.Begin(), niIt = inputIt.Begin(); nmIt != markerIt.End();
-             nmIt++, nsIt++, niIt++)
+    // first stage:
+    //  - set markers pixels to already processed status
+    //  - copy markers pixels to output image
+    //  - init FAH with indexes of background pixels with marker pixel(s) in
+    //    their neighborhood.  A background pixel is queued by its first
+    //    marker neighbor in the raster order.
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        std::vector<OffsetValueType> pixelNeighbors(numberOfNeighbors);
+        std::vector<OffsetValueType> backgroundNeighbors(numberOfNeighbors);
+        std::vector<OffsetValueType> & seeds = blockSeeds[block];
+        const OffsetValueType          end = blockBegin(block + 1);
+        for (OffsetValueType pixel = blockBegin(block); pixel < end; ++pixel)
         {
-          if (!nsIt.Get() && nmIt.Get() == bgLabel)
+          const LabelImagePixelType markerPixel = markerBuffer[pixel];
+          if (markerPixel != bgLabel)
           {
-            // this neighbor is a background pixel and is not already
-            // processed; add its index to fah
-            fah[niIt.Get()].push(markerIt.GetIndex() + nmIt.GetNeighborhoodOffset());
-            // mark it as already in the fah to avoid adding it several times
-            nsIt.Set(true);
+            // this pixel belongs to a marker: mark it as already processed and
+            // copy it to the output image
+            statusBuffer[pixel] = true;
+            outputBuffer[pixel] = markerPixel;
+
+            // search the background pixels in the neighborhood
+            computeNeighbors(pixel, pixelNeighbors.data());
+            for (unsigned int n = 0; n < numberOfNeighbors; n++)
+            {
+              const OffsetValueType neighbor = pixelNeighbors[n];
+              if (neighbor < 0 || markerBuffer[neighbor] != bgLabel)
+              {
+                continue;
+              }
+              // queue it unless a previous marker pixel queued it already
+              bool queued = false;
+              computeNeighbors(neighbor, backgroundNeighbors.data());
+              for (unsigned int m = 0; m < numberOfNeighbors && !queued; m++)
+              {
+                queued = backgroundNeighbors[m] >= 0 && backgroundNeighbors[m] < pixel &&
+                         markerBuffer[backgroundNeighbors[m]] != bgLabel;
+              }
+              if (!queued)
+              {
+                seeds.push_back(neighbor);
+              }
+            }
+          }
+          else
+          {
+            // Some pixels may be never processed so, by default, non marked
+            // pixels must be marked as watershed
+            statusBuffer[pixel] = false;
+            outputBuffer[pixel] = wsLabel;
           }
         }
-      }
-      else
+      },
+      initProgress.GetProcessObject());
+
+    for (auto & seeds : blockSeeds)
+    {
+      for (const OffsetValueType seed : seeds)
       {
-        // Some pixels may be never processed so, by default, non marked pixels
-        // must be marked as watershed
-        outputIt.SetCenterPixel(wsLabel);
+        fah.Push(inputBuffer[seed], seed);
+        // mark it as already in the fah to avoid adding it several times
+        statusBuffer[seed] = true;
       }
-      // one more pixel done in the init stage
-      progress.CompletedPixel();
+      std::vector<OffsetValueType>().swap(seeds);
     }
-    // fill the borders of the status image with "true"
-    // FillSides<StatusImageType>(statusImage, true);
-    // Now disable the boundary checks
-    // outputIt.NeedToUseBoundaryConditionOff();
-    // statusIt.NeedToUseBoundaryConditionOff();
-    // inputIt.NeedToUseBoundaryConditionOff();
-    // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    statusIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
-    while (!fah.empty())
+    ProgressReporter progress(this, 0, numberOfPixels, 100, 0.5f, 0.5f);
+    if (m_ParallelFlooding)
     {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
+      PixelStateArrayType states(new std::atomic<unsigned char>[numberOfPixels]);
+      forEachChunk(numberOfPixels, [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+        for (auto pixel = static_cast<OffsetValueType>(begin); pixel < static_cast<OffsetValueType>(end); ++pixel)
+        {
+          const unsigned char state =
+            !statusBuffer[pixel] ? FreePixel : (outputBuffer[pixel] != wsLabel ? DonePixel : QueuedPixel);
+          states[pixel].store(state, std::memory_order_relaxed);
+        }
+      });
 
-      while (!currentQueue.empty())
+      std::vector<OffsetValueType> front;
+      std::vector<char>            watershedInFront;
+      InputImagePixelType          currentValue;
+      while (fah.NextLevel(currentValue, front))
       {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        statusIt += shift;
-        inputIt += shift;
-
-        // iterate over the neighbors. If there is only one marker value, give
-        // that value to the pixel, else keep it as is (watershed line)
-        LabelImagePixelType marker = wsLabel;
-        bool                collision = false;
-        for (noIt = outputIt.Begin(); noIt != outputIt.End(); noIt++)
+        while (!front.empty())
         {
-          LabelImagePixelType o = noIt.Get();
-          if (o != wsLabel)
-          {
-            if (marker != wsLabel && o != marker)
+          // give the pixels of the front the marker value of their processed
+          // neighbors, or mark them as watershed if there are several ones
+          forEachChunk(front.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+            std::vector<OffsetValueType> pixelNeighbors(numberOfNeighbors);
+            for (SizeValueType i = begin; i < end; ++i)
             {
-              collision = true;
-              break;
+              const OffsetValueType pixel = front[i];
+              states[pixel].store(FrontPixel, std::memory_order_relaxed);
+              computeNeighbors(pixel, pixelNeighbors.data());
+              LabelImagePixelType marker = wsLabel;
+              for (unsigned int n = 0; n < numberOfNeighbors; n++)
+              {
+                const OffsetValueType neighbor = pixelNeighbors[n];
+                if (neighbor < 0 || states[neighbor].load(std::memory_order_relaxed) != DonePixel)
+                {
+                  continue;
+                }
+                const LabelImagePixelType o = outputBuffer[neighbor];
+                if (o != wsLabel)
+                {
+                  if (marker != wsLabel && o != marker)
+                  {
+                    marker = wsLabel;
+                    break;
+                  }
+                  marker = o;
+                }
+              }
+              outputBuffer[pixel] = marker;
             }
-            else
+          });
+
+          // two neighbors of the front with different marker values would not
+          // be separated by a watershed line: the second one in the buffer
+          // becomes watershed
+          watershedInFront.assign(front.size(), 0);
+          forEachChunk(front.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+            std::vector<OffsetValueType> pixelNeighbors(numberOfNeighbors);
+            for (SizeValueType i = begin; i < end; ++i)
             {
-              marker = o;
+              const OffsetValueType     pixel = front[i];
+              const LabelImagePixelType marker = outputBuffer[pixel];
+              if (marker == wsLabel)
+              {
+                continue;
+              }
+              computeNeighbors(pixel, pixelNeighbors.data());
+              for (unsigned int n = 0; n < numberOfNeighbors; n++)
+              {
+                const OffsetValueType neighbor = pixelNeighbors[n];
+                if (neighbor >= 0 && neighbor < pixel &&
+                    states[neighbor].load(std::memory_order_relaxed) == FrontPixel &&
+                    outputBuffer[neighbor] != wsLabel && outputBuffer[neighbor] != marker)
+                {
+                  watershedInFront[i] = 1;
+                  break;
+                }
+              }
+            }
+          });
+
+          // propagate the marker values to the neighbors not yet processed
+          forEachChunk(front.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType chunk) {
+            std::vector<OffsetValueType>   pixelNeighbors(numberOfNeighbors);
+            std::vector<OffsetValueType> & queued = chunkPixels[chunk];
+            for (SizeValueType i = begin; i < end; ++i)
+            {
+              const OffsetValueType pixel = front[i];
+              if (watershedInFront[i])
+              {
+                outputBuffer[pixel] = wsLabel;
+              }
+              else if (outputBuffer[pixel] != wsLabel)
+              {
+                computeNeighbors(pixel, pixelNeighbors.data());
+                for (unsigned int n = 0; n < numberOfNeighbors; n++)
+                {
+                  const OffsetValueType neighbor = pixelNeighbors[n];
+                  unsigned char         state = FreePixel;
+                  if (neighbor >= 0 &&
+                      states[neighbor].compare_exchange_strong(state, QueuedPixel, std::memory_order_relaxed))
+                  {
+                    queued.push_back(neighbor);
+                  }
+                }
+              }
+              states[pixel].store(DonePixel, std::memory_order_relaxed);
             }
+          });
+
+          for (SizeValueType i = 0; i < front.size(); ++i)
+          {
+            progress.CompletedPixel();
+          }
+          front.clear();
+          for (auto & queued : chunkPixels)
+          {
+            for (const OffsetValueType pixel : queued)
+            {
+              if (inputBuffer[pixel] <= currentValue)
+              {
+                front.push_back(pixel);
+              }
+              else
+              {
+                fah.Push(inputBuffer[pixel], pixel);
+              }
+            }
+            queued.clear();
           }
         }
-        if (!collision)
+      }
+    }
+    else
+    {
+      InputImagePixelType currentValue;
+      while (fah.NextLevel(currentValue))
+      {
+        OffsetValueType pixel;
+        while (fah.Pop(pixel))
         {
-          // set the marker value
-          outputIt.SetCenterPixel(marker);
-          // and propagate to the neighbors
-          for (niIt = inputIt.Begin(), nsIt = statusIt.Begin(); niIt != inputIt.End(); niIt++, nsIt++)
+          // iterate over the neighbors. If there is only one marker value, give
+          // that value to the pixel, else keep it as is (watershed line).
+          // outside pixel are watershed so they won't be use to find real
+          // watershed pixels
+          computeNeighbors(pixel, neighbors.data());
+          LabelImagePixelType marker = wsLabel;
+          bool                collision = false;
+          for (unsigned int n = 0; n < numberOfNeighbors; n++)
           {
-            if (!nsIt.Get())
+            if (neighbors[n] < 0)
             {
-              // the pixel is not yet processed. add it to the fah
-              InputImagePixelType GrayVal = niIt.Get();
-              if (GrayVal <= currentValue)
+              continue;
+            }
+            const LabelImagePixelType o = outputBuffer[neighbors[n]];
+            if (o != wsLabel)
+            {
+              if (marker != wsLabel && o != marker)
               {
-                currentQueue.push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
+                collision = true;
+                break;
               }
-              else
+              marker = o;
+            }
+          }
+          if (!collision)
+          {
+            // set the marker value
+            outputBuffer[pixel] = marker;
+            // and propagate to the neighbors; outside pixel are already
+            // processed
+            for (unsigned int n = 0; n < numberOfNeighbors; n++)
+            {
+              const OffsetValueType neighbor = neighbors[n];
+              if (neighbor >= 0 && !statusBuffer[neighbor])
               {
-                fah[GrayVal].push(inputIt.GetIndex() + niIt.GetNeighborhoodOffset());
+                // the pixel is not yet processed. add it to the fah
+                const InputImagePixelType GrayVal = inputBuffer[neighbor];
+                if (GrayVal <= currentValue)
+                {
+                  fah.PushCurrent(neighbor);
+                }
+                else
+                {
+                  fah.Push(GrayVal, neighbor);
+                }
+                // mark it as already in the fah
+                statusBuffer[neighbor] = true;
               }
-              // mark it as already in the fah
-              nsIt.Set(true);
             }
           }
+          // one more pixel in the flooding stage
+          progress.CompletedPixel();
         }
-        // one more pixel in the flooding stage
-        progress.CompletedPixel();
       }
     }
   }
@@ -323,103 +525,160 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::Generate
     //  - copy markers pixels to output image
     //  - init FAH with indexes of pixels with background pixel in their
     //    neighborhood
-
-    ConstantBoundaryCondition<LabelImageType> lcbc2;
-    // outside pixel are watershed so they won't be use to find real watershed
-    // pixels
-    lcbc2.SetConstant(NumericTraits<LabelImagePixelType>::max());
-    outputIt.OverrideBoundaryCondition(&lcbc2);
-
-    for (markerIt.GoToBegin(), outputIt.GoToBegin(), inputIt.GoToBegin(); !markerIt.IsAtEnd(); ++markerIt, ++outputIt)
-    {
-      LabelImagePixelType markerPixel = markerIt.GetCenterPixel();
-      if (markerPixel != bgLabel)
-      {
-        IndexType  idx = markerIt.GetIndex();
-        OffsetType shift = idx - inputIt.GetIndex();
-        inputIt += shift;
-
-        // this pixels belongs to a marker
-        // copy it to the output image
-        outputIt.SetCenterPixel(markerPixel);
-        // search if it has background pixel in its neighborhood
-        bool haveBgNeighbor = false;
-        for (nmIt = markerIt.Begin(); nmIt != markerIt.End(); nmIt++)
+    multiThreader->ParallelizeArray(
+      0,
+      numberOfBlocks,
+      [&](SizeValueType block) {
+        std::vector<OffsetValueType>   pixelNeighbors(numberOfNeighbors);
+        std::vector<OffsetValueType> & seeds = blockSeeds[block];
+        const OffsetValueType          end = blockBegin(block + 1);
+        for (OffsetValueType pixel = blockBegin(block); pixel < end; ++pixel)
         {
-          if (nmIt.Get() == bgLabel)
+          const LabelImagePixelType markerPixel = markerBuffer[pixel];
+          outputBuffer[pixel] = (markerPixel != bgLabel) ? markerPixel : wsLabel;
+          if (markerPixel != bgLabel)
           {
-            haveBgNeighbor = true;
-            break;
+            // search if it has background pixel in its neighborhood
+            computeNeighbors(pixel, pixelNeighbors.data());
+            for (unsigned int n = 0; n < numberOfNeighbors; n++)
+            {
+              if (pixelNeighbors[n] >= 0 && markerBuffer[pixelNeighbors[n]] == bgLabel)
+              {
+                seeds.push_back(pixel);
+                break;
+              }
+            }
           }
         }
-        if (haveBgNeighbor)
-        {
-          // there is a background pixel in the neighborhood; add to fah
-          fah[inputIt.GetCenterPixel()].push(markerIt.GetIndex());
-        }
-        else
-        {
-          // increase progress because this pixel will not be used in the
-          // flooding stage.
-          progress.CompletedPixel();
-        }
-      }
-      else
+      },
+      initProgress.GetProcessObject());
+
+    for (auto & seeds : blockSeeds)
+    {
+      for (const OffsetValueType seed : seeds)
       {
-        outputIt.SetCenterPixel(wsLabel);
+        fah.Push(inputBuffer[seed], seed);
       }
-      progress.CompletedPixel();
+      std::vector<OffsetValueType>().swap(seeds);
     }
-    // end of init stage
 
     // flooding
-    // init all the iterators
-    outputIt.GoToBegin();
-    inputIt.GoToBegin();
-
-    // and start flooding
-    while (!fah.empty())
+    ProgressReporter progress(this, 0, numberOfPixels, 100, 0.5f, 0.5f);
+    if (m_ParallelFlooding)
     {
-      // store the current vars
-      InputImagePixelType currentValue = fah.begin()->first;
-      QueueType           currentQueue = fah.begin()->second;
-      // and remove them from the fah
-      fah.erase(fah.begin());
+      PixelStateArrayType states(new std::atomic<unsigned char>[numberOfPixels]);
+      forEachChunk(numberOfPixels, [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+        for (auto pixel = static_cast<OffsetValueType>(begin); pixel < static_cast<OffsetValueType>(end); ++pixel)
+        {
+          states[pixel].store(outputBuffer[pixel] != wsLabel ? QueuedPixel : FreePixel, std::memory_order_relaxed);
+        }
+      });
 
-      while (!currentQueue.empty())
+      std::vector<OffsetValueType> front;
+      std::vector<OffsetValueType> labeled;
+      InputImagePixelType          currentValue;
+      while (fah.NextLevel(currentValue, front))
       {
-        IndexType idx = currentQueue.front();
-        currentQueue.pop();
-
-        // move the iterators to the right place
-        OffsetType shift = idx - outputIt.GetIndex();
-        outputIt += shift;
-        inputIt += shift;
-
-        LabelImagePixelType currentMarker = outputIt.GetCenterPixel();
-        // get the current value of the pixel
-        // iterate over neighbors to propagate the marker
-        for (noIt = outputIt.Begin(), niIt = inputIt.Begin(); noIt != outputIt.End(); noIt++, niIt++)
+        while (!front.empty())
         {
-          if (noIt.Get() == wsLabel)
+          // the pixels of the front claim their neighbors not yet labeled
+          forEachChunk(front.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType chunk) {
+            std::vector<OffsetValueType>   pixelNeighbors(numberOfNeighbors);
+            std::vector<OffsetValueType> & claimed = chunkPixels[chunk];
+            for (SizeValueType i = begin; i < end; ++i)
+            {
+              const OffsetValueType pixel = front[i];
+              states[pixel].store(DonePixel, std::memory_order_relaxed);
+              computeNeighbors(pixel, pixelNeighbors.data());
+              for (unsigned int n = 0; n < numberOfNeighbors; n++)
+              {
+                const OffsetValueType neighbor = pixelNeighbors[n];
+                unsigned char         state = FreePixel;
+                if (neighbor >= 0 &&
+                    states[neighbor].compare_exchange_strong(state, QueuedPixel, std::memory_order_relaxed))
+                {
+                  claimed.push_back(neighbor);
+                }
+              }
+            }
+          });
+          labeled.clear();
+          for (auto & claimed : chunkPixels)
+          {
+            labeled.insert(labeled.end(), claimed.begin(), claimed.end());
+            claimed.clear();
+          }
+
+          // the claimed pixels get the label of their first neighbor in the
+          // front, whichever pixel of the front claimed them
+          forEachChunk(labeled.size(), [&](SizeValueType begin, SizeValueType end, SizeValueType) {
+            std::vector<OffsetValueType> pixelNeighbors(numberOfNeighbors);
+            for (SizeValueType i = begin; i < end; ++i)
+            {
+              const OffsetValueType pixel = labeled[i];
+              computeNeighbors(pixel, pixelNeighbors.data());
+              for (unsigned int n = 0; n < numberOfNeighbors; n++)
+              {
+                const OffsetValueType neighbor = pixelNeighbors[n];
+                if (neighbor >= 0 && states[neighbor].load(std::memory_order_relaxed) == DonePixel)
+                {
+                  outputBuffer[pixel] = outputBuffer[neighbor];
+                  break;
+                }
+              }
+            }
+          });
+
+          front.clear();
+          for (const OffsetValueType pixel : labeled)
           {
-            // the pixel is not yet processed. It can be labeled with the
-            // current label
-            noIt.Set(currentMarker);
-            InputImagePixelType GrayVal = niIt.Get();
-            if (GrayVal <= currentValue)
+            if (inputBuffer[pixel] <= currentValue)
             {
-              currentQueue.push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
+              front.push_back(pixel);
             }
             else
             {
-              fah[GrayVal].push(inputIt.GetIndex() + noIt.GetNeighborhoodOffset());
+              fah.Push(inputBuffer[pixel], pixel);
             }
             progress.CompletedPixel();
           }
         }
       }
     }
+    else
+    {
+      InputImagePixelType currentValue;
+      while (fah.NextLevel(currentValue))
+      {
+        OffsetValueType pixel;
+        while (fah.Pop(pixel))
+        {
+          const LabelImagePixelType currentMarker = outputBuffer[pixel];
+          // iterate over neighbors to propagate the marker
+          computeNeighbors(pixel, neighbors.data());
+          for (unsigned int n = 0; n < numberOfNeighbors; n++)
+          {
+            const OffsetValueType neighbor = neighbors[n];
+            if (neighbor >= 0 && outputBuffer[neighbor] == wsLabel)
+            {
+              // the pixel is not yet processed. It can be labeled with the
+              // current label
+              outputBuffer[neighbor] = currentMarker;
+              const InputImagePixelType GrayVal = inputBuffer[neighbor];
+              if (GrayVal <= currentValue)
+              {
+                fah.PushCurrent(neighbor);
+              }
+              else
+              {
+                fah.Push(GrayVal, neighbor);
+              }
+              progress.CompletedPixel();
+            }
+          }
+        }
+      }
+    }
   }
 }
 
@@ -433,6 +692,7 @@ MorphologicalWatershedFromMarkersImageFilter<TInputImage, TLabelImage>::PrintSel
 
   os << indent << "FullyConnected: " << m_FullyConnected << std::endl;
   os << indent << "MarkWatershedLine: " << m_MarkWatershedLine << std::endl;
+  os << indent << "ParallelFlooding: " << m_ParallelFlooding << std::endl;
 }
 
 } // end namespace itk
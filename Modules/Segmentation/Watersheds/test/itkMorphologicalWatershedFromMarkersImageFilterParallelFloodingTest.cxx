@@ -0,0 +1,247 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+#include <vector>
+
+/* Verifies that the parallel flooding of MorphologicalWatershedFromMarkersImageFilter
+ * gives the basins of the sequential flooding, up to the pixels where the
+ * basins meet, that its watershed lines separate the basins, and that its
+ * result does not depend on the number of work units. */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ImageType = itk::Image<short, Dimension>;
+using LabelImageType = itk::Image<unsigned short, Dimension>;
+
+LabelImageType::Pointer
+Flood(const ImageType *      input,
+      const LabelImageType * markers,
+      bool                   markWatershedLine,
+      bool                   fullyConnected,
+      bool                   parallelFlooding,
+      unsigned int           numberOfWorkUnits)
+{
+  using FilterType = itk::MorphologicalWatershedFromMarkersImageFilter<ImageType, LabelImageType>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetMarkerImage(markers);
+  filter->SetMarkWatershedLine(markWatershedLine);
+  filter->SetFullyConnected(fullyConnected);
+  filter->SetParallelFlooding(parallelFlooding);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  filter->Update();
+  return filter->GetOutput();
+}
+
+// Whether a pixel is within the given distance of a pixel of another label,
+// the watershed label included.
+bool
+IsNearBoundary(const LabelImageType * labels, const LabelImageType::IndexType & index, int distance)
+{
+  const LabelImageType::RegionType & region = labels->GetBufferedRegion();
+  const LabelImageType::PixelType    label = labels->GetPixel(index);
+  for (int dz = -distance; dz <= distance; dz++)
+  {
+    for (int dy = -distance; dy <= distance; dy++)
+    {
+      for (int dx = -distance; dx <= distance; dx++)
+      {
+        LabelImageType::IndexType neighbor = index;
+        neighbor[0] += dx;
+        neighbor[1] += dy;
+        neighbor[2] += dz;
+        if (region.IsInside(neighbor) && labels->GetPixel(neighbor) != label)
+        {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+// Whether two neighbors have different labels, none of them the watershed
+// label.
+bool
+HasUnseparatedBasins(const LabelImageType * labels, bool fullyConnected)
+{
+  const LabelImageType::RegionType &                     region = labels->GetBufferedRegion();
+  itk::ImageRegionConstIteratorWithIndex<LabelImageType> it(labels, region);
+  for (; !it.IsAtEnd(); ++it)
+  {
+    if (it.Get() == 0)
+    {
+      continue;
+    }
+    for (int dz = -1; dz <= 1; dz++)
+    {
+      for (int dy = -1; dy <= 1; dy++)
+      {
+        for (int dx = -1; dx <= 1; dx++)
+        {
+          if (!fullyConnected && std::abs(dx) + std::abs(dy) + std::abs(dz) != 1)
+          {
+            continue;
+          }
+          LabelImageType::IndexType neighbor = it.GetIndex();
+          neighbor[0] += dx;
+          neighbor[1] += dy;
+          neighbor[2] += dz;
+          if (region.IsInside(neighbor) && labels->GetPixel(neighbor) != 0 && labels->GetPixel(neighbor) != it.Get())
+          {
+            std::cerr << "Labels " << it.Get() << " and " << labels->GetPixel(neighbor) << " touch at "
+                      << it.GetIndex() << "." << std::endl;
+            return true;
+          }
+        }
+      }
+    }
+  }
+  return false;
+}
+} // namespace
+
+int
+itkMorphologicalWatershedFromMarkersImageFilterParallelFloodingTest(int, char *[])
+{
+  ImageType::SizeType  size = { { 80, 72, 56 } };
+  ImageType::IndexType start = { { -4, 2, 0 } };
+  ImageType::RegionType region(start, size);
+
+  auto image = ImageType::New();
+  image->SetRegions(region);
+  image->Allocate();
+  auto markers = LabelImageType::New();
+  markers->SetRegions(region);
+  markers->Allocate();
+  markers->FillBuffer(0);
+
+  // Basins around random centers, with thick plateaus, so that the fronts
+  // are large and several markers reach the same plateaus.
+  constexpr int plateauWidth = 3;
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+  std::vector<ImageType::IndexType> centers(12);
+  for (unsigned int c = 0; c < centers.size(); c++)
+  {
+    for (unsigned int d = 0; d < Dimension; d++)
+    {
+      centers[c][d] = start[d] + static_cast<itk::IndexValueType>(generator->GetIntegerVariate(size[d] - 1));
+    }
+    markers->SetPixel(centers[c], static_cast<LabelImageType::PixelType>(c + 1));
+  }
+  itk::ImageRegionIteratorWithIndex<ImageType> it(image, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    double minimumDistance = itk::NumericTraits<double>::max();
+    for (const auto & center : centers)
+    {
+      double distance = 0.0;
+      for (unsigned int d = 0; d < Dimension; d++)
+      {
+        distance += itk::Math::sqr(static_cast<double>(it.GetIndex()[d] - center[d]));
+      }
+      minimumDistance = std::min(minimumDistance, std::sqrt(distance));
+    }
+    it.Set(static_cast<short>(minimumDistance / plateauWidth));
+  }
+
+  bool passed = true;
+  for (bool markWatershedLine : { true, false })
+  {
+    for (bool fullyConnected : { false, true })
+    {
+      std::cout << "MarkWatershedLine " << markWatershedLine << ", FullyConnected " << fullyConnected << std::endl;
+
+      LabelImageType::Pointer expected;
+      ITK_TRY_EXPECT_NO_EXCEPTION(expected = Flood(image, markers, markWatershedLine, fullyConnected, false, 1));
+
+      LabelImageType::Pointer parallel;
+      for (unsigned int numberOfWorkUnits : { 1, 3, 16 })
+      {
+        LabelImageType::Pointer output;
+        ITK_TRY_EXPECT_NO_EXCEPTION(
+          output = Flood(image, markers, markWatershedLine, fullyConnected, true, numberOfWorkUnits));
+        if (parallel.IsNull())
+        {
+          parallel = output;
+          continue;
+        }
+        itk::ImageRegionConstIteratorWithIndex<LabelImageType> outputIt(output, region);
+        for (; !outputIt.IsAtEnd(); ++outputIt)
+        {
+          if (outputIt.Get() != parallel->GetPixel(outputIt.GetIndex()))
+          {
+            std::cerr << "Label " << outputIt.Get() << " instead of " << parallel->GetPixel(outputIt.GetIndex())
+                      << " at " << outputIt.GetIndex() << " with " << numberOfWorkUnits << " work units" << std::endl;
+            passed = false;
+            break;
+          }
+        }
+      }
+
+      // The basins only differ where they meet, by where the plateaus are
+      // split.
+      unsigned int                                           numberOfDifferences = 0;
+      unsigned int                                           numberOfWatershedPixels = 0;
+      itk::ImageRegionConstIteratorWithIndex<LabelImageType> parallelIt(parallel, region);
+      for (; !parallelIt.IsAtEnd(); ++parallelIt)
+      {
+        numberOfWatershedPixels += (parallelIt.Get() == 0);
+        if (parallelIt.Get() == expected->GetPixel(parallelIt.GetIndex()))
+        {
+          continue;
+        }
+        ++numberOfDifferences;
+        if (!IsNearBoundary(expected, parallelIt.GetIndex(), 2 * plateauWidth))
+        {
+          std::cerr << "Label " << parallelIt.Get() << " instead of " << expected->GetPixel(parallelIt.GetIndex())
+                    << " at " << parallelIt.GetIndex() << ", away from the sequential watershed." << std::endl;
+          passed = false;
+          break;
+        }
+      }
+      std::cout << "  " << numberOfDifferences << " pixels differ from the sequential flooding" << std::endl;
+      if (numberOfDifferences > region.GetNumberOfPixels() / 20)
+      {
+        std::cerr << "Too many pixels differ from the sequential flooding." << std::endl;
+        passed = false;
+      }
+
+      if (markWatershedLine && HasUnseparatedBasins(parallel, fullyConnected))
+      {
+        passed = false;
+      }
+      // Without watershed lines, every pixel is reached by a marker.
+      if (!markWatershedLine && numberOfWatershedPixels != 0)
+      {
+        std::cerr << numberOfWatershedPixels << " pixels are not labeled." << std::endl;
+        passed = false;
+      }
+    }
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}
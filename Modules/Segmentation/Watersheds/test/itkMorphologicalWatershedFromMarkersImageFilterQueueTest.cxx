@@ -0,0 +1,130 @@
+/*=========================================================================
+ *
+ *  Copyright Insight Software Consortium
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *         http://www.apache.org/licenses/LICENSE-2.0.txt
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ *
+ *=========================================================================*/
+
+#include "itkMorphologicalWatershedFromMarkersImageFilter.h"
+#include "itkImageRegionIteratorWithIndex.h"
+#include "itkMersenneTwisterRandomVariateGenerator.h"
+#include "itkTestingMacros.h"
+
+/* Verifies that MorphologicalWatershedFromMarkersImageFilter floods an image
+ * with many plateaus the same way with its bucket queue, used for the 16 bits
+ * integers, and with its map queue, used for the other pixel types, and that
+ * the number of work units collecting the markers does not change the
+ * result. */
+
+namespace
+{
+constexpr unsigned int Dimension = 3;
+using ShortImageType = itk::Image<short, Dimension>;
+using FloatImageType = itk::Image<float, Dimension>;
+using LabelImageType = itk::Image<unsigned short, Dimension>;
+
+template <typename TInputImage>
+typename LabelImageType::Pointer
+Flood(const TInputImage *    input,
+      const LabelImageType * markers,
+      bool                   markWatershedLine,
+      bool                   fullyConnected,
+      unsigned int           numberOfWorkUnits)
+{
+  using FilterType = itk::MorphologicalWatershedFromMarkersImageFilter<TInputImage, LabelImageType>;
+  auto filter = FilterType::New();
+  filter->SetInput(input);
+  filter->SetMarkerImage(markers);
+  filter->SetMarkWatershedLine(markWatershedLine);
+  filter->SetFullyConnected(fullyConnected);
+  filter->SetNumberOfWorkUnits(numberOfWorkUnits);
+  filter->Update();
+  return filter->GetOutput();
+}
+} // namespace
+
+int
+itkMorphologicalWatershedFromMarkersImageFilterQueueTest(int, char *[])
+{
+  ShortImageType::SizeType  size = { { 29, 23, 17 } };
+  ShortImageType::IndexType start = { { -4, 2, 0 } };
+  ShortImageType::RegionType region(start, size);
+
+  auto shortImage = ShortImageType::New();
+  shortImage->SetRegions(region);
+  shortImage->Allocate();
+  auto floatImage = FloatImageType::New();
+  floatImage->SetRegions(region);
+  floatImage->Allocate();
+  auto markers = LabelImageType::New();
+  markers->SetRegions(region);
+  markers->Allocate();
+
+  // Few gray levels, negative ones included, so that the flooding order
+  // within the plateaus decides the result.
+  using GeneratorType = itk::Statistics::MersenneTwisterRandomVariateGenerator;
+  GeneratorType::Pointer generator = GeneratorType::New();
+  generator->Initialize(1234);
+  itk::ImageRegionIteratorWithIndex<ShortImageType> it(shortImage, region);
+  for (it.GoToBegin(); !it.IsAtEnd(); ++it)
+  {
+    const auto value = static_cast<short>(generator->GetIntegerVariate(8)) - 4;
+    it.Set(value);
+    floatImage->SetPixel(it.GetIndex(), value);
+    markers->SetPixel(it.GetIndex(),
+                      generator->GetUniformVariate(0.0, 1.0) < 0.01 ? 1 + generator->GetIntegerVariate(4) : 0);
+  }
+
+  bool passed = true;
+  for (bool markWatershedLine : { true, false })
+  {
+    for (bool fullyConnected : { false, true })
+    {
+      LabelImageType::Pointer expected;
+      ITK_TRY_EXPECT_NO_EXCEPTION(
+        expected = Flood(floatImage.GetPointer(), markers, markWatershedLine, fullyConnected, 1));
+
+      for (unsigned int numberOfWorkUnits : { 1, 3, 16 })
+      {
+        LabelImageType::Pointer output;
+        ITK_TRY_EXPECT_NO_EXCEPTION(
+          output = Flood(shortImage.GetPointer(), markers, markWatershedLine, fullyConnected, numberOfWorkUnits));
+
+        itk::ImageRegionIteratorWithIndex<LabelImageType> outputIt(output, region);
+        unsigned int                                      numberOfWatershedPixels = 0;
+        for (; !outputIt.IsAtEnd(); ++outputIt)
+        {
+          numberOfWatershedPixels += (outputIt.Get() == 0);
+          if (outputIt.Get() != expected->GetPixel(outputIt.GetIndex()))
+          {
+            std::cerr << "Label " << outputIt.Get() << " instead of " << expected->GetPixel(outputIt.GetIndex())
+                      << " at " << outputIt.GetIndex() << " (MarkWatershedLine " << markWatershedLine
+                      << ", FullyConnected " << fullyConnected << ", " << numberOfWorkUnits << " work units)"
+                      << std::endl;
+            passed = false;
+            break;
+          }
+        }
+        // Without watershed lines, every pixel is reached by a marker.
+        if (!markWatershedLine && numberOfWatershedPixels != 0)
+        {
+          std::cerr << numberOfWatershedPixels << " pixels are not labeled." << std::endl;
+          passed = false;
+        }
+      }
+    }
+  }
+
+  return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}